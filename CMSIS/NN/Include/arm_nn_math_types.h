@@ -106,6 +106,17 @@ extern "C" {
 #endif
 #endif
 
+/* x86 hosts: SSE4.1 paths of the q15 kernels, 256-bit wide with AVX2, for host builds of the model.
+ * The DSP extension does not exist there, so ARM_MATH_DSP (which the generated models define
+ * unconditionally) is dropped and the kernels fall back to their reference paths without SSE4.1.
+ * ARM_NN_NO_X86 keeps the selection as is, e.g. to run the ARM paths through an emulation layer. */
+#if (defined(__x86_64__) || defined(__i386__)) && !defined(ARM_MATH_NEON) && !defined(ARM_NN_NO_X86)
+#undef ARM_MATH_DSP
+#if defined(__SSE4_1__) && !defined(ARM_NN_X86)
+#define ARM_NN_X86
+#endif
+#endif
+
 /* Compiler specific diagnostic adjustment */
 #if defined(__CC_ARM)
 
@@ -136,6 +147,10 @@ extern "C" {
 #include <arm_mve.h>
 #endif
 
+#if defined(ARM_NN_X86)
+#include <immintrin.h>
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -522,6 +522,34 @@ arm_status arm_convolve_HWC_q7_basic_nonsquare(const q7_t *Im_in,
                                                q15_t *bufferA,
                                                q7_t *bufferB);
 
+/**
+ * @brief Same as arm_convolve_HWC_q7_basic_nonsquare() followed by arm_relu_q7() on Im_out
+ *
+ * The ReLU is applied when each output is saturated, so the activations are written once and
+ * not read back. The arguments, buffer sizes and constraints are those of arm_convolve_HWC_q7_basic_nonsquare().
+ */
+
+arm_status arm_convolve_HWC_q7_basic_nonsquare_relu(const q7_t *Im_in,
+                                                    const uint16_t dim_im_in_x,
+                                                    const uint16_t dim_im_in_y,
+                                                    const uint16_t ch_im_in,
+                                                    const q7_t *wt,
+                                                    const uint16_t ch_im_out,
+                                                    const uint16_t dim_kernel_x,
+                                                    const uint16_t dim_kernel_y,
+                                                    const uint16_t padding_x,
+                                                    const uint16_t padding_y,
+                                                    const uint16_t stride_x,
+                                                    const uint16_t stride_y,
+                                                    const q7_t *bias,
+                                                    const uint16_t bias_shift,
+                                                    const uint16_t out_shift,
+                                                    q7_t *Im_out,
+                                                    const uint16_t dim_im_out_x,
+                                                    const uint16_t dim_im_out_y,
+                                                    q15_t *bufferA,
+                                                    q7_t *bufferB);
+
 /**
  * @brief Basic Q15 convolution function
  * @param[in]       Im_in       pointer to input tensor
@@ -603,6 +631,34 @@ arm_status arm_convolve_HWC_q15_basic_nonsquare(const q15_t *Im_in,
                                       q15_t *bufferA,
                                       q7_t *bufferB);
 
+/**
+ * @brief Same as arm_convolve_HWC_q15_basic_nonsquare() followed by arm_relu_q15() on Im_out
+ *
+ * The ReLU is applied when each output is saturated, so the activations are written once and
+ * not read back. The arguments, buffer sizes and constraints are those of arm_convolve_HWC_q15_basic_nonsquare().
+ */
+
+arm_status arm_convolve_HWC_q15_basic_nonsquare_relu(const q15_t *Im_in,
+                                                     const uint16_t dim_im_in_x,
+                                                     const uint16_t dim_im_in_y,
+                                                     const uint16_t ch_im_in,
+                                                     const q15_t *wt,
+                                                     const uint16_t ch_im_out,
+                                                     const uint16_t dim_kernel_x,
+                                                     const uint16_t dim_kernel_y,
+                                                     const uint16_t padding_x,
+                                                     const uint16_t padding_y,
+                                                     const uint16_t stride_x,
+                                                     const uint16_t stride_y,
+                                                     const q15_t *bias,
+                                                     const uint16_t bias_shift,
+                                                     const uint16_t out_shift,
+                                                     q15_t *Im_out,
+                                                     const uint16_t dim_im_out_x,
+                                                     const uint16_t dim_im_out_y,
+                                                     q15_t *bufferA,
+                                                     q7_t *bufferB);
+
 /**
  * @brief Fast Q7 convolution function
  * @param[in]       Im_in       pointer to input tensor
@@ -696,6 +752,34 @@ arm_status arm_convolve_HWC_q7_fast_nonsquare(const q7_t *Im_in,
                                               q15_t *bufferA,
                                               q7_t *bufferB);
 
+/**
+ * @brief Same as arm_convolve_HWC_q7_fast_nonsquare() followed by arm_relu_q7() on Im_out
+ *
+ * The ReLU is applied when each output is saturated, so the activations are written once and
+ * not read back. The arguments, buffer sizes and constraints are those of arm_convolve_HWC_q7_fast_nonsquare().
+ */
+
+arm_status arm_convolve_HWC_q7_fast_nonsquare_relu(const q7_t *Im_in,
+                                                   const uint16_t dim_im_in_x,
+                                                   const uint16_t dim_im_in_y,
+                                                   const uint16_t ch_im_in,
+                                                   const q7_t *wt,
+                                                   const uint16_t ch_im_out,
+                                                   const uint16_t dim_kernel_x,
+                                                   const uint16_t dim_kernel_y,
+                                                   const uint16_t padding_x,
+                                                   const uint16_t padding_y,
+                                                   const uint16_t stride_x,
+                                                   const uint16_t stride_y,
+                                                   const q7_t *bias,
+                                                   const uint16_t bias_shift,
+                                                   const uint16_t out_shift,
+                                                   q7_t *Im_out,
+                                                   const uint16_t dim_im_out_x,
+                                                   const uint16_t dim_im_out_y,
+                                                   q15_t *bufferA,
+                                                   q7_t *bufferB);
+
 /**
  * @brief Fast Q7 version of 1x1 convolution (non-sqaure shape)
  * @param[in]       Im_in        pointer to input tensor
@@ -986,6 +1070,8 @@ arm_status arm_convolve_HWC_q15_fast(const q15_t *Im_in,
  *
  * ch_im_out is multipe of 2
  *
+ * except on 1-D layers, which go to arm_convolve_1_x_n_HWC_q15()
+ *
  */
 
 arm_status arm_convolve_HWC_q15_fast_nonsquare(const q15_t *Im_in,
@@ -1009,6 +1095,283 @@ arm_status arm_convolve_HWC_q15_fast_nonsquare(const q15_t *Im_in,
                                                q15_t *bufferA,
                                                q7_t *bufferB);
 
+/**
+ * @brief Same as arm_convolve_HWC_q15_fast_nonsquare() followed by arm_relu_q15() on Im_out
+ *
+ * The ReLU is applied when each output is saturated, so the activations are written once and
+ * not read back. The arguments, buffer sizes and constraints are those of arm_convolve_HWC_q15_fast_nonsquare().
+ */
+
+arm_status arm_convolve_HWC_q15_fast_nonsquare_relu(const q15_t *Im_in,
+                                                    const uint16_t dim_im_in_x,
+                                                    const uint16_t dim_im_in_y,
+                                                    const uint16_t ch_im_in,
+                                                    const q15_t *wt,
+                                                    const uint16_t ch_im_out,
+                                                    const uint16_t dim_kernel_x,
+                                                    const uint16_t dim_kernel_y,
+                                                    const uint16_t padding_x,
+                                                    const uint16_t padding_y,
+                                                    const uint16_t stride_x,
+                                                    const uint16_t stride_y,
+                                                    const q15_t *bias,
+                                                    const uint16_t bias_shift,
+                                                    const uint16_t out_shift,
+                                                    q15_t *Im_out,
+                                                    const uint16_t dim_im_out_x,
+                                                    const uint16_t dim_im_out_y,
+                                                    q15_t *bufferA,
+                                                    q7_t *bufferB);
+
+/**
+ * @brief Direct Q15 convolution function for 1 x n inputs and kernels
+ * @param[in]       Im_in        pointer to input tensor
+ * @param[in]       dim_im_in_x  input tensor dimension x
+ * @param[in]       dim_im_in_y  input tensor dimension y, must be 1
+ * @param[in]       ch_im_in     number of input tensor channels
+ * @param[in]       wt           pointer to kernel weights
+ * @param[in]       ch_im_out    number of filters, i.e., output tensor channels
+ * @param[in]       dim_kernel_x filter kernel size x
+ * @param[in]       dim_kernel_y filter kernel size y, must be 1
+ * @param[in]       padding_x    padding size x
+ * @param[in]       padding_y    padding size y, must be 0
+ * @param[in]       stride_x     convolution stride x
+ * @param[in]       stride_y     convolution stride y
+ * @param[in]       bias         pointer to bias
+ * @param[in]       bias_shift   amount of left-shift for bias
+ * @param[in]       out_shift    amount of right-shift for output
+ * @param[in,out]   Im_out       pointer to output tensor
+ * @param[in]       dim_im_out_x output tensor dimension x
+ * @param[in]       dim_im_out_y output tensor dimension y, must be 1
+ * @param[in,out]   bufferA      unused
+ * @param[in,out]   bufferB      unused
+ * @return     The function returns either
+ * <code>ARM_MATH_SIZE_MISMATCH</code> or <code>ARM_MATH_SUCCESS</code> based on the outcome of size checking.
+ *
+ * Same signature and results as arm_convolve_HWC_q15_basic_nonsquare(), reading the input
+ * windows in place instead of copying them to an im2col buffer. The basic and fast
+ * nonsquare q15 convolutions forward 1-D layers to it.
+ */
+
+arm_status arm_convolve_1_x_n_HWC_q15(const q15_t *Im_in,
+                                      const uint16_t dim_im_in_x,
+                                      const uint16_t dim_im_in_y,
+                                      const uint16_t ch_im_in,
+                                      const q15_t *wt,
+                                      const uint16_t ch_im_out,
+                                      const uint16_t dim_kernel_x,
+                                      const uint16_t dim_kernel_y,
+                                      const uint16_t padding_x,
+                                      const uint16_t padding_y,
+                                      const uint16_t stride_x,
+                                      const uint16_t stride_y,
+                                      const q15_t *bias,
+                                      const uint16_t bias_shift,
+                                      const uint16_t out_shift,
+                                      q15_t *Im_out,
+                                      const uint16_t dim_im_out_x,
+                                      const uint16_t dim_im_out_y,
+                                      q15_t *bufferA,
+                                      q7_t *bufferB);
+
+/**
+ * @brief Same as arm_convolve_1_x_n_HWC_q15() followed by arm_relu_q15() on Im_out
+ *
+ * The ReLU is applied when each output is saturated, so the activations are written once and
+ * not read back. The arguments, buffer sizes and constraints are those of arm_convolve_1_x_n_HWC_q15().
+ */
+
+arm_status arm_convolve_1_x_n_HWC_q15_relu(const q15_t *Im_in,
+                                           const uint16_t dim_im_in_x,
+                                           const uint16_t dim_im_in_y,
+                                           const uint16_t ch_im_in,
+                                           const q15_t *wt,
+                                           const uint16_t ch_im_out,
+                                           const uint16_t dim_kernel_x,
+                                           const uint16_t dim_kernel_y,
+                                           const uint16_t padding_x,
+                                           const uint16_t padding_y,
+                                           const uint16_t stride_x,
+                                           const uint16_t stride_y,
+                                           const q15_t *bias,
+                                           const uint16_t bias_shift,
+                                           const uint16_t out_shift,
+                                           q15_t *Im_out,
+                                           const uint16_t dim_im_out_x,
+                                           const uint16_t dim_im_out_y,
+                                           q15_t *bufferA,
+                                           q7_t *bufferB);
+
+/**
+ * @brief Direct Q15 convolution function for 1 x n inputs and kernels over a batch of tensors
+ * @param[in]       Im_in        pointers to the batch input tensors
+ * @param[in]       dim_im_in_x  input tensor dimension x
+ * @param[in]       dim_im_in_y  input tensor dimension y, must be 1
+ * @param[in]       ch_im_in     number of input tensor channels
+ * @param[in]       wt           pointer to kernel weights
+ * @param[in]       ch_im_out    number of filters, i.e., output tensor channels
+ * @param[in]       dim_kernel_x filter kernel size x
+ * @param[in]       dim_kernel_y filter kernel size y, must be 1
+ * @param[in]       padding_x    padding size x
+ * @param[in]       padding_y    padding size y, must be 0
+ * @param[in]       stride_x     convolution stride x
+ * @param[in]       stride_y     convolution stride y
+ * @param[in]       bias         pointer to bias
+ * @param[in]       bias_shift   amount of left-shift for bias
+ * @param[in]       out_shift    amount of right-shift for output
+ * @param[in,out]   Im_out       pointers to the batch output tensors
+ * @param[in]       dim_im_out_x output tensor dimension x
+ * @param[in]       dim_im_out_y output tensor dimension y, must be 1
+ * @param[in]       batch        number of tensors
+ * @param[in,out]   bufferA      unused
+ * @param[in,out]   bufferB      unused
+ * @return     The function returns either
+ * <code>ARM_MATH_SIZE_MISMATCH</code> or <code>ARM_MATH_SUCCESS</code> based on the outcome of size checking.
+ *
+ * Same results as arm_convolve_1_x_n_HWC_q15() on each tensor, each tile of filters going over
+ * the whole batch while it stays in L1.
+ */
+
+arm_status arm_convolve_1_x_n_HWC_q15_batch(const q15_t *const *Im_in,
+                                            const uint16_t dim_im_in_x,
+                                            const uint16_t dim_im_in_y,
+                                            const uint16_t ch_im_in,
+                                            const q15_t *wt,
+                                            const uint16_t ch_im_out,
+                                            const uint16_t dim_kernel_x,
+                                            const uint16_t dim_kernel_y,
+                                            const uint16_t padding_x,
+                                            const uint16_t padding_y,
+                                            const uint16_t stride_x,
+                                            const uint16_t stride_y,
+                                            const q15_t *bias,
+                                            const uint16_t bias_shift,
+                                            const uint16_t out_shift,
+                                            q15_t *const *Im_out,
+                                            const uint16_t dim_im_out_x,
+                                            const uint16_t dim_im_out_y,
+                                            const uint16_t batch,
+                                            q15_t *bufferA,
+                                            q7_t *bufferB);
+
+/**
+ * @brief Fast Q15 convolution function (non-square shape) tiled for the L1 data cache
+ * @param[in]       Im_in        pointer to input tensor
+ * @param[in]       dim_im_in_x  input tensor dimension x
+ * @param[in]       dim_im_in_y  input tensor dimension y
+ * @param[in]       ch_im_in     number of input tensor channels
+ * @param[in]       wt           pointer to kernel weights
+ * @param[in]       ch_im_out    number of filters, i.e., output tensor channels
+ * @param[in]       dim_kernel_x filter kernel size x
+ * @param[in]       dim_kernel_y filter kernel size y
+ * @param[in]       padding_x    padding size x
+ * @param[in]       padding_y    padding size y
+ * @param[in]       stride_x     convolution stride x
+ * @param[in]       stride_y     convolution stride y
+ * @param[in]       bias         pointer to bias
+ * @param[in]       bias_shift   amount of left-shift for bias
+ * @param[in]       out_shift    amount of right-shift for output
+ * @param[in,out]   Im_out       pointer to output tensor
+ * @param[in]       dim_im_out_x output tensor dimension x
+ * @param[in]       dim_im_out_y output tensor dimension y
+ * @param[in,out]   bufferA      pointer to buffer space for input, 4-byte aligned
+ * @param[in,out]   bufferB      unused
+ * @return     The function returns <code>ARM_MATH_SUCCESS</code>
+ *
+ * @details
+ *
+ * Same results as arm_convolve_HWC_q15_basic_nonsquare(), computed the way of
+ * arm_convolve_HWC_q15_fast_nonsquare() but blocked for the L1 data cache. The im2col columns
+ * of a group of output pixels are built once, then each tile of filters, cut in depth slices
+ * when the columns are long, goes over the whole group while it stays in L1, the partial sums
+ * of the slices being kept in bufferA. Tile sizes are the ARM_NN_CONV_Q15_TILE_* of the layer
+ * shape for ARM_NN_L1_TILE_BYTES. Layers one row high go to arm_convolve_1_x_n_HWC_q15().
+ *
+ * <b>Buffer size:</b>
+ *
+ * bufferA size: ARM_NN_CONV_Q15_TILED_BUFFER_SIZE(ch_im_in, dim_kernel_x, dim_kernel_y, ch_im_out)
+ *
+ * bufferB size: 0
+ *
+ * <b>Input dimension constraints:</b>
+ *
+ * none, unlike arm_convolve_HWC_q15_fast_nonsquare() every output pixel is computed
+ *
+ */
+
+arm_status arm_convolve_HWC_q15_fast_nonsquare_tiled(const q15_t *Im_in,
+                                                     const uint16_t dim_im_in_x,
+                                                     const uint16_t dim_im_in_y,
+                                                     const uint16_t ch_im_in,
+                                                     const q15_t *wt,
+                                                     const uint16_t ch_im_out,
+                                                     const uint16_t dim_kernel_x,
+                                                     const uint16_t dim_kernel_y,
+                                                     const uint16_t padding_x,
+                                                     const uint16_t padding_y,
+                                                     const uint16_t stride_x,
+                                                     const uint16_t stride_y,
+                                                     const q15_t *bias,
+                                                     const uint16_t bias_shift,
+                                                     const uint16_t out_shift,
+                                                     q15_t *Im_out,
+                                                     const uint16_t dim_im_out_x,
+                                                     const uint16_t dim_im_out_y,
+                                                     q15_t *bufferA,
+                                                     q7_t *bufferB);
+
+/**
+ * @brief Fast Q15 convolution function (non-square shape) tiled for the L1 data cache followed by a ReLU
+ * @param[in]       Im_in        pointer to input tensor
+ * @param[in]       dim_im_in_x  input tensor dimension x
+ * @param[in]       dim_im_in_y  input tensor dimension y
+ * @param[in]       ch_im_in     number of input tensor channels
+ * @param[in]       wt           pointer to kernel weights
+ * @param[in]       ch_im_out    number of filters, i.e., output tensor channels
+ * @param[in]       dim_kernel_x filter kernel size x
+ * @param[in]       dim_kernel_y filter kernel size y
+ * @param[in]       padding_x    padding size x
+ * @param[in]       padding_y    padding size y
+ * @param[in]       stride_x     convolution stride x
+ * @param[in]       stride_y     convolution stride y
+ * @param[in]       bias         pointer to bias
+ * @param[in]       bias_shift   amount of left-shift for bias
+ * @param[in]       out_shift    amount of right-shift for output
+ * @param[in,out]   Im_out       pointer to output tensor
+ * @param[in]       dim_im_out_x output tensor dimension x
+ * @param[in]       dim_im_out_y output tensor dimension y
+ * @param[in,out]   bufferA      pointer to buffer space for input, 4-byte aligned
+ * @param[in,out]   bufferB      unused
+ * @return     The function returns <code>ARM_MATH_SUCCESS</code>
+ *
+ * @details
+ *
+ * Same results as arm_convolve_HWC_q15_fast_nonsquare_tiled() followed by arm_relu_q15() on
+ * Im_out, the ReLU being applied when each output is saturated.
+ *
+ */
+
+arm_status arm_convolve_HWC_q15_fast_nonsquare_tiled_relu(const q15_t *Im_in,
+                                                          const uint16_t dim_im_in_x,
+                                                          const uint16_t dim_im_in_y,
+                                                          const uint16_t ch_im_in,
+                                                          const q15_t *wt,
+                                                          const uint16_t ch_im_out,
+                                                          const uint16_t dim_kernel_x,
+                                                          const uint16_t dim_kernel_y,
+                                                          const uint16_t padding_x,
+                                                          const uint16_t padding_y,
+                                                          const uint16_t stride_x,
+                                                          const uint16_t stride_y,
+                                                          const q15_t *bias,
+                                                          const uint16_t bias_shift,
+                                                          const uint16_t out_shift,
+                                                          q15_t *Im_out,
+                                                          const uint16_t dim_im_out_x,
+                                                          const uint16_t dim_im_out_y,
+                                                          q15_t *bufferA,
+                                                          q7_t *bufferB);
+
 /**
  * @brief Q7 depthwise separable convolution function
  * @param[in]       Im_in       pointer to input tensor
@@ -1369,6 +1732,23 @@ arm_status arm_fully_connected_q7(const q7_t *pV,
                                   q7_t *pOut,
                                   q15_t *vec_buffer);
 
+/**
+ * @brief Same as arm_fully_connected_q7() followed by arm_relu_q7() on pOut
+ *
+ * The ReLU is applied when each output is saturated, so the activations are written once and
+ * not read back. The arguments, buffer sizes and constraints are those of arm_fully_connected_q7().
+ */
+
+arm_status arm_fully_connected_q7_relu(const q7_t *pV,
+                                       const q7_t *pM,
+                                       const uint16_t dim_vec,
+                                       const uint16_t num_of_rows,
+                                       const uint16_t bias_shift,
+                                       const uint16_t out_shift,
+                                       const q7_t *bias,
+                                       q7_t *pOut,
+                                       q15_t *vec_buffer);
+
 /**
  * @brief Basic s8 Fully Connected function.
  *
@@ -1506,6 +1886,23 @@ arm_status arm_fully_connected_q7_opt(const q7_t *pV,
                                       q7_t *pOut,
                                       q15_t *vec_buffer);
 
+/**
+ * @brief Same as arm_fully_connected_q7_opt() followed by arm_relu_q7() on pOut
+ *
+ * The ReLU is applied when each output is saturated, so the activations are written once and
+ * not read back. The arguments, buffer sizes and constraints are those of arm_fully_connected_q7_opt().
+ */
+
+arm_status arm_fully_connected_q7_opt_relu(const q7_t *pV,
+                                           const q7_t *pM,
+                                           const uint16_t dim_vec,
+                                           const uint16_t num_of_rows,
+                                           const uint16_t bias_shift,
+                                           const uint16_t out_shift,
+                                           const q7_t *bias,
+                                           q7_t *pOut,
+                                           q15_t *vec_buffer);
+
 /**
  * @brief Q15 basic fully-connected layer function
  * @param[in]       pV          pointer to input vector
@@ -1531,6 +1928,52 @@ arm_status arm_fully_connected_q15(const q15_t *pV,
                                    q15_t *pOut,
                                    q15_t *vec_buffer);
 
+/**
+ * @brief Same as arm_fully_connected_q15() followed by arm_relu_q15() on pOut
+ *
+ * The ReLU is applied when each output is saturated, so the activations are written once and
+ * not read back. The arguments, buffer sizes and constraints are those of arm_fully_connected_q15().
+ */
+
+arm_status arm_fully_connected_q15_relu(const q15_t *pV,
+                                        const q15_t *pM,
+                                        const uint16_t dim_vec,
+                                        const uint16_t num_of_rows,
+                                        const uint16_t bias_shift,
+                                        const uint16_t out_shift,
+                                        const q15_t *bias,
+                                        q15_t *pOut,
+                                        q15_t *vec_buffer);
+
+/**
+ * @brief Q15 fully-connected layer function over a batch of vectors
+ * @param[in]       pV          pointers to the batch input vectors
+ * @param[in]       pM          pointer to matrix weights
+ * @param[in]       dim_vec     length of one vector
+ * @param[in]       num_of_rows number of rows in weight matrix
+ * @param[in]       bias_shift  amount of left-shift for bias
+ * @param[in]       out_shift   amount of right-shift for output
+ * @param[in]       bias        pointer to bias
+ * @param[in,out]   pOut        pointers to the batch output vectors
+ * @param[in]       batch       number of vectors
+ * @param[in,out]   vec_buffer  pointer to buffer space for input
+ * @return     The function returns <code>ARM_MATH_SUCCESS</code>
+ *
+ * Same results as arm_fully_connected_q15() on each vector, each tile of weight rows being
+ * applied to the whole batch while it stays in L1.
+ */
+
+arm_status arm_fully_connected_q15_batch(const q15_t *const *pV,
+                                         const q15_t *pM,
+                                         const uint16_t dim_vec,
+                                         const uint16_t num_of_rows,
+                                         const uint16_t bias_shift,
+                                         const uint16_t out_shift,
+                                         const q15_t *bias,
+                                         q15_t *const *pOut,
+                                         const uint16_t batch,
+                                         q15_t *vec_buffer);
+
 /**
  * @brief Q15 opt fully-connected layer function
  * @param[in]       pV          pointer to input vector
@@ -630,6 +630,263 @@ __STATIC_FORCEINLINE q31_t arm_nn_read_q7x4(const q7_t *in_q7)
     return (val);
 }
 
+/**
+  @brief         Saturate a shifted q15 accumulator, optionally with the ReLU folded in.
+  @param[in]     val      accumulator after the output shift
+  @param[in]     relu     non-zero to also clamp negative values to 0
+  @return        q15 value, in [0, 32767] with relu
+
+  @details       __USAT to 15 bits gives the same result as __SSAT to 16 bits followed by
+                 arm_relu_q15(), in a single instruction.
+ */
+__STATIC_FORCEINLINE q15_t arm_nn_sat_q15(const q31_t val, const int32_t relu)
+{
+    return relu ? (q15_t)__USAT(val, 15) : (q15_t)__SSAT(val, 16);
+}
+
+/**
+  @brief         Saturate a shifted q7 accumulator, optionally with the ReLU folded in.
+  @param[in]     val      accumulator after the output shift
+  @param[in]     relu     non-zero to also clamp negative values to 0
+  @return        q7 value, in [0, 127] with relu
+ */
+__STATIC_FORCEINLINE q7_t arm_nn_sat_q7(const q31_t val, const int32_t relu)
+{
+    return relu ? (q7_t)__USAT(val, 7) : (q7_t)__SSAT(val, 8);
+}
+
+#if defined(ARM_NN_X86)
+
+/**
+  @brief         Horizontal sum of the 32-bit lanes of an x86 accumulator, wrapping mod 2^32.
+ */
+__STATIC_FORCEINLINE q31_t arm_nn_x86_hsum_q31(__m128i v)
+{
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(v);
+}
+
+/**
+  @brief         Dot products of up to 4 q15 weight rows with one or two q15 columns on x86.
+  @param[in]     wt         first weight row
+  @param[in]     wt_stride  distance in values between two weight rows
+  @param[in]     col        first column
+  @param[in]     col2       second column, NULL for a single one
+  @param[in]     len        values per row and column
+  @param[in]     rows       number of weight rows, 1 to 4
+  @param[in,out] sum        sum[r][c] accumulates row r times column c
+
+  @details       pmaddwd multiplies q15 pairs and adds them into 32-bit lanes that wrap mod 2^32,
+                 the only overflowing pair (-32768 * -32768 twice) included, so the sums are
+                 the same as the __SMLAD ones. 16 values per step with AVX2, 8 with SSE4.1.
+ */
+__STATIC_FORCEINLINE void arm_nn_x86_dot_q15(const q15_t *wt,
+                                             const int32_t wt_stride,
+                                             const q15_t *col,
+                                             const q15_t *col2,
+                                             const int32_t len,
+                                             const int32_t rows,
+                                             q31_t sum[4][2])
+{
+    __m128i acc[4][2];
+    int32_t r, k = 0;
+
+    for (r = 0; r < rows; r++)
+    {
+        acc[r][0] = _mm_setzero_si128();
+        acc[r][1] = _mm_setzero_si128();
+    }
+
+#if defined(__AVX2__)
+    {
+        __m256i acc256[4][2];
+        for (r = 0; r < rows; r++)
+        {
+            acc256[r][0] = _mm256_setzero_si256();
+            acc256[r][1] = _mm256_setzero_si256();
+        }
+        for (; k + 16 <= len; k += 16)
+        {
+            const __m256i in1 = _mm256_loadu_si256((const __m256i *)(col + k));
+            const __m256i in2 = col2 ? _mm256_loadu_si256((const __m256i *)(col2 + k)) : in1;
+            for (r = 0; r < rows; r++)
+            {
+                const __m256i w = _mm256_loadu_si256((const __m256i *)(wt + r * wt_stride + k));
+                acc256[r][0] = _mm256_add_epi32(acc256[r][0], _mm256_madd_epi16(w, in1));
+                acc256[r][1] = _mm256_add_epi32(acc256[r][1], _mm256_madd_epi16(w, in2));
+            }
+        }
+        for (r = 0; r < rows; r++)
+        {
+            acc[r][0] = _mm_add_epi32(_mm256_castsi256_si128(acc256[r][0]), _mm256_extracti128_si256(acc256[r][0], 1));
+            acc[r][1] = _mm_add_epi32(_mm256_castsi256_si128(acc256[r][1]), _mm256_extracti128_si256(acc256[r][1], 1));
+        }
+    }
+#endif
+
+    for (; k + 8 <= len; k += 8)
+    {
+        const __m128i in1 = _mm_loadu_si128((const __m128i *)(col + k));
+        const __m128i in2 = col2 ? _mm_loadu_si128((const __m128i *)(col2 + k)) : in1;
+        for (r = 0; r < rows; r++)
+        {
+            const __m128i w = _mm_loadu_si128((const __m128i *)(wt + r * wt_stride + k));
+            acc[r][0] = _mm_add_epi32(acc[r][0], _mm_madd_epi16(w, in1));
+            acc[r][1] = _mm_add_epi32(acc[r][1], _mm_madd_epi16(w, in2));
+        }
+    }
+
+    for (r = 0; r < rows; r++)
+    {
+        uint32_t s1 = (uint32_t)sum[r][0] + (uint32_t)arm_nn_x86_hsum_q31(acc[r][0]);
+        uint32_t s2 = (uint32_t)sum[r][1] + (uint32_t)arm_nn_x86_hsum_q31(acc[r][1]);
+        int32_t j;
+
+        /* left-over of the row */
+        for (j = k; j < len; j++)
+        {
+            s1 += (uint32_t)(wt[r * wt_stride + j] * col[j]);
+            if (col2)
+            {
+                s2 += (uint32_t)(wt[r * wt_stride + j] * col2[j]);
+            }
+        }
+        sum[r][0] = (q31_t)s1;
+        sum[r][1] = (q31_t)s2;
+    }
+}
+
+#endif /* ARM_NN_X86 */
+
+/**
+  @brief         L1 data cache budget of the tiled q15 convolutions in bytes: half of the 32 KB of
+                 the Cortex-A9, the rest being left to the stack, the outputs and the conflicts of
+                 its 4 ways. 0 turns the filter tiling of arm_convolve_1_x_n_HWC_q15() off.
+ */
+#ifndef ARM_NN_L1_TILE_BYTES
+#define ARM_NN_L1_TILE_BYTES 16384
+#endif
+
+/**
+  @brief         Tile sizes of arm_convolve_HWC_q15_fast_nonsquare_tiled() for im2col columns of
+                 col_len values, constant expressions for a constant layer shape.
+  @details       A tile of filters and the matching slices of a group of columns take half of
+                 ARM_NN_L1_TILE_BYTES each. TILE_DEPTH is the slice length, whole columns as long
+                 as four filters of them fit (a multiple of 8 otherwise), TILE_CH the filters per
+                 tile (a multiple of 4 below ch_out) and TILE_PIXELS the columns per group (even).
+ */
+#define ARM_NN_CONV_Q15_TILE_DEPTH(col_len) MIN((col_len), MAX(8, ARM_NN_L1_TILE_BYTES / 16 / 8 * 8))
+#define ARM_NN_CONV_Q15_TILE_CH(col_len, ch_out)                                                                       \
+    MIN((ch_out), MAX(4, ARM_NN_L1_TILE_BYTES / 4 / ARM_NN_CONV_Q15_TILE_DEPTH(col_len) / 4 * 4))
+#define ARM_NN_CONV_Q15_TILE_PIXELS(col_len) MAX(2, ARM_NN_L1_TILE_BYTES / 4 / ARM_NN_CONV_Q15_TILE_DEPTH(col_len) / 2 * 2)
+
+/**
+  @brief         bufferA size of arm_convolve_HWC_q15_fast_nonsquare_tiled() in q15 values: the
+                 im2col columns of a pixel group and the 32-bit partial sums of a tile.
+ */
+#define ARM_NN_CONV_Q15_TILED_BUFFER_SIZE(ch_im_in, dim_kernel_x, dim_kernel_y, ch_im_out)                             \
+    (ARM_NN_CONV_Q15_TILE_PIXELS((ch_im_in) * (dim_kernel_x) * (dim_kernel_y)) *                                       \
+     ((ch_im_in) * (dim_kernel_x) * (dim_kernel_y) +                                                                   \
+      2 * ARM_NN_CONV_Q15_TILE_CH((ch_im_in) * (dim_kernel_x) * (dim_kernel_y), (ch_im_out))))
+
+/**
+  @brief         One part of a layer split over a thread team, called as task(ctx, part, parts).
+ */
+typedef void (*arm_nn_team_task)(void *ctx, int32_t part, int32_t parts);
+
+/**
+  @brief         Threads a layer can split its output channels over (intra-layer parallelism).
+  @details       parts() returns how many parts a layer of `work` multiply-accumulates should be
+                 split into, at most max_parts, 1 when the layer is too small for a fork/join to
+                 pay off or the calling thread does not own the team. run() calls task once for
+                 every part, part 0 on the calling thread, and returns once all of them are done.
+ */
+typedef struct
+{
+    int32_t (*parts)(int64_t work, int32_t max_parts);
+    void (*run)(arm_nn_team_task task, void *ctx, int32_t parts);
+} arm_nn_team_t;
+
+/**
+  @brief         Team set by the application (arm_nn_team.c), NULL runs every layer on the calling
+                 thread. Only kernels built with ARM_NN_TEAM look at it.
+ */
+extern const arm_nn_team_t *arm_nn_team;
+
+/**
+  @brief         Output channels per part boundary: 16 (32 bytes of q15, one Cortex-A9 cache line)
+                 on wide layers so the parts do not write the same output lines, else a kernel
+                 block of 4.
+ */
+__STATIC_FORCEINLINE int32_t arm_nn_team_grain(const int32_t count)
+{
+    return count >= 32 ? 16 : 4;
+}
+
+/**
+  @brief         Number of parts to split `count` output channels of a layer of `work`
+                 multiply-accumulates into, 1 without a team.
+ */
+__STATIC_FORCEINLINE int32_t arm_nn_team_parts(const int64_t work, const int32_t count)
+{
+    const arm_nn_team_t *team = arm_nn_team;
+    return team ? team->parts(work, count / arm_nn_team_grain(count)) : 1;
+}
+
+/**
+  @brief         First output channel of `part` when `count` channels go out in `parts` parts,
+                 `count` for part == parts. Boundaries are multiples of arm_nn_team_grain() and
+                 no part is empty as long as parts <= count / arm_nn_team_grain(count).
+ */
+__STATIC_FORCEINLINE int32_t arm_nn_team_bound(const int32_t count, const int32_t part, const int32_t parts)
+{
+    const int32_t grain = arm_nn_team_grain(count);
+    return part >= parts ? count : count * part / parts / grain * grain;
+}
+
+/**
+  @brief         Most windows a batched model call runs at once, see arm_nn_batch_t.
+ */
+#define ARM_NN_BATCH_MAX 8
+
+/**
+  @brief         Weight rows per tile of arm_fully_connected_q15_batch(): the rows of a tile take
+                 half of ARM_NN_L1_TILE_BYTES (a multiple of 4 below num_of_rows), all of them
+                 without L1 tiling.
+ */
+#if ARM_NN_L1_TILE_BYTES > 0
+#define ARM_NN_FC_Q15_TILE_ROWS(dim_vec, num_of_rows)                                                                  \
+    MIN((num_of_rows), MAX(4, ARM_NN_L1_TILE_BYTES / 4 / (dim_vec) / 4 * 4))
+#else
+#define ARM_NN_FC_Q15_TILE_ROWS(dim_vec, num_of_rows) (num_of_rows)
+#endif
+
+/**
+  @brief         The same layer call of every window of a batch, run as task(ctx, lanes) with
+                 ctx[i] the arguments the call got on lane i.
+ */
+typedef void (*arm_nn_batch_task)(void *const *ctx, int32_t lanes);
+
+/**
+  @brief         Lanes of a batched model call (inter-window batching).
+  @details       Each window of a batch runs cnn() on a lane thread of its own. join() hands the
+                 arguments of the calling lane to the batch and returns 1 once the batch ran task
+                 over the same layer call of every lane, which then loads each weight once for the
+                 whole batch. It returns 0 without running anything when the calling thread is not
+                 a lane of a batch of two or more windows, the kernel then runs the call itself.
+ */
+typedef struct
+{
+    int32_t (*join)(arm_nn_batch_task task, void *ctx);
+} arm_nn_batch_t;
+
+/**
+  @brief         Batch set by the application (arm_nn_batch.c), NULL runs every window on its own.
+                 Only kernels built with ARM_NN_BATCH look at it.
+ */
+extern const arm_nn_batch_t *arm_nn_batch;
+
 /**
   @brief         Write four q7 to q7 pointer and increment pointer afterwards.
   @param[in]     in       Double pointer to input value
@@ -729,6 +986,230 @@ read_and_pad_reordered_with_offset(const q7_t *source, q31_t *out1, q31_t *out2,
 
 #endif
 
+/**
+  @brief         Dot products of up to 4 q7 weight rows with one or two q7 columns.
+  @param[in]     wt         first weight row
+  @param[in]     wt_stride  distance in values between two weight rows
+  @param[in]     col        first column
+  @param[in]     col2       second column, NULL for a single one
+  @param[in]     len        values per row and column
+  @param[in]     rows       number of weight rows, 1 to 4
+  @param[in,out] sum        sum[r][c] accumulates row r times column c
+
+  @details       q7 products fit in 16 bits, so NEON multiplies 16 pairs with vmull_s8 and adds
+                 them pairwise into 32-bit lanes with vpadal_s16, x86 sign-extends 8 (16 with
+                 AVX2) values and uses pmaddwd, the DSP extension expands 4 values into two
+                 q15x2 words for __SMLAD. Every path gives the sums of the plain loop.
+ */
+__STATIC_FORCEINLINE void arm_nn_dot_q7(const q7_t *wt,
+                                        const int32_t wt_stride,
+                                        const q7_t *col,
+                                        const q7_t *col2,
+                                        const int32_t len,
+                                        const int32_t rows,
+                                        q31_t sum[4][2])
+{
+    int32_t r, k = 0;
+
+#if defined(ARM_MATH_NEON)
+    {
+        int32x4_t acc[4][2];
+        for (r = 0; r < rows; r++)
+        {
+            acc[r][0] = vdupq_n_s32(0);
+            acc[r][1] = vdupq_n_s32(0);
+        }
+        for (; k + 16 <= len; k += 16)
+        {
+            const int8x16_t in1 = vld1q_s8(col + k);
+            const int8x16_t in2 = col2 ? vld1q_s8(col2 + k) : in1;
+            for (r = 0; r < rows; r++)
+            {
+                const int8x16_t w = vld1q_s8(wt + r * wt_stride + k);
+                acc[r][0] = vpadalq_s16(acc[r][0], vmull_s8(vget_low_s8(w), vget_low_s8(in1)));
+                acc[r][0] = vpadalq_s16(acc[r][0], vmull_s8(vget_high_s8(w), vget_high_s8(in1)));
+                acc[r][1] = vpadalq_s16(acc[r][1], vmull_s8(vget_low_s8(w), vget_low_s8(in2)));
+                acc[r][1] = vpadalq_s16(acc[r][1], vmull_s8(vget_high_s8(w), vget_high_s8(in2)));
+            }
+        }
+        for (r = 0; r < rows; r++)
+        {
+            int32x2_t s = vpadd_s32(vget_low_s32(acc[r][0]), vget_high_s32(acc[r][0]));
+            int32x2_t s2 = vpadd_s32(vget_low_s32(acc[r][1]), vget_high_s32(acc[r][1]));
+            s = vpadd_s32(s, s2);
+            sum[r][0] = (q31_t)((uint32_t)sum[r][0] + (uint32_t)vget_lane_s32(s, 0));
+            sum[r][1] = (q31_t)((uint32_t)sum[r][1] + (uint32_t)vget_lane_s32(s, 1));
+        }
+    }
+#elif defined(ARM_NN_X86)
+    {
+        __m128i acc[4][2];
+        for (r = 0; r < rows; r++)
+        {
+            acc[r][0] = _mm_setzero_si128();
+            acc[r][1] = _mm_setzero_si128();
+        }
+#if defined(__AVX2__)
+        {
+            __m256i acc256[4][2];
+            for (r = 0; r < rows; r++)
+            {
+                acc256[r][0] = _mm256_setzero_si256();
+                acc256[r][1] = _mm256_setzero_si256();
+            }
+            for (; k + 16 <= len; k += 16)
+            {
+                const __m256i in1 = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i *)(col + k)));
+                const __m256i in2 = col2 ? _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i *)(col2 + k))) : in1;
+                for (r = 0; r < rows; r++)
+                {
+                    const __m256i w = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i *)(wt + r * wt_stride + k)));
+                    acc256[r][0] = _mm256_add_epi32(acc256[r][0], _mm256_madd_epi16(w, in1));
+                    acc256[r][1] = _mm256_add_epi32(acc256[r][1], _mm256_madd_epi16(w, in2));
+                }
+            }
+            for (r = 0; r < rows; r++)
+            {
+                acc[r][0] =
+                    _mm_add_epi32(_mm256_castsi256_si128(acc256[r][0]), _mm256_extracti128_si256(acc256[r][0], 1));
+                acc[r][1] =
+                    _mm_add_epi32(_mm256_castsi256_si128(acc256[r][1]), _mm256_extracti128_si256(acc256[r][1], 1));
+            }
+        }
+#endif
+        for (; k + 8 <= len; k += 8)
+        {
+            const __m128i in1 = _mm_cvtepi8_epi16(_mm_loadl_epi64((const __m128i *)(col + k)));
+            const __m128i in2 = col2 ? _mm_cvtepi8_epi16(_mm_loadl_epi64((const __m128i *)(col2 + k))) : in1;
+            for (r = 0; r < rows; r++)
+            {
+                const __m128i w = _mm_cvtepi8_epi16(_mm_loadl_epi64((const __m128i *)(wt + r * wt_stride + k)));
+                acc[r][0] = _mm_add_epi32(acc[r][0], _mm_madd_epi16(w, in1));
+                acc[r][1] = _mm_add_epi32(acc[r][1], _mm_madd_epi16(w, in2));
+            }
+        }
+        for (r = 0; r < rows; r++)
+        {
+            sum[r][0] = (q31_t)((uint32_t)sum[r][0] + (uint32_t)arm_nn_x86_hsum_q31(acc[r][0]));
+            sum[r][1] = (q31_t)((uint32_t)sum[r][1] + (uint32_t)arm_nn_x86_hsum_q31(acc[r][1]));
+        }
+    }
+#elif defined(ARM_MATH_DSP) && !defined(ARM_MATH_MVEI)
+    for (; k + 4 <= len; k += 4)
+    {
+        q31_t in1a, in1b, in2a, in2b;
+        read_and_pad_reordered(col + k, &in1a, &in1b);
+        in2a = in1a;
+        in2b = in1b;
+        if (col2)
+        {
+            read_and_pad_reordered(col2 + k, &in2a, &in2b);
+        }
+        for (r = 0; r < rows; r++)
+        {
+            q31_t wa, wb;
+            read_and_pad_reordered(wt + r * wt_stride + k, &wa, &wb);
+            sum[r][0] = __SMLAD(wa, in1a, sum[r][0]);
+            sum[r][0] = __SMLAD(wb, in1b, sum[r][0]);
+            sum[r][1] = __SMLAD(wa, in2a, sum[r][1]);
+            sum[r][1] = __SMLAD(wb, in2b, sum[r][1]);
+        }
+    }
+#endif
+
+    /* left-over of the rows */
+    for (; k < len; k++)
+    {
+        for (r = 0; r < rows; r++)
+        {
+            sum[r][0] = (q31_t)((uint32_t)sum[r][0] + (uint32_t)(wt[r * wt_stride + k] * col[k]));
+            if (col2)
+            {
+                sum[r][1] = (q31_t)((uint32_t)sum[r][1] + (uint32_t)(wt[r * wt_stride + k] * col2[k]));
+            }
+        }
+    }
+}
+
+/**
+  @brief         im2col column of one output pixel of a q7 HWC convolution.
+  @param[in]     x0, y0   input position of the top left tap, negative inside the padding
+  @param[out]    col      ch_im_in * dim_kernel_x * dim_kernel_y values, taps outside the input
+                          set to 0
+
+  @details       In HWC layout the taps of a kernel row that fall inside the input are one
+                 contiguous run, copied with a single memcpy.
+ */
+__STATIC_FORCEINLINE void arm_nn_im2col_q7(const q7_t *Im_in,
+                                           const int32_t dim_im_in_x,
+                                           const int32_t dim_im_in_y,
+                                           const int32_t ch_im_in,
+                                           const int32_t dim_kernel_x,
+                                           const int32_t dim_kernel_y,
+                                           const int32_t x0,
+                                           const int32_t y0,
+                                           q7_t *col)
+{
+    const int32_t row_len = ch_im_in * dim_kernel_x;
+    int32_t first = x0 < 0 ? -x0 : 0;
+    int32_t last = x0 + dim_kernel_x > dim_im_in_x ? dim_im_in_x - x0 : dim_kernel_x;
+    int32_t i_ker_y;
+
+    if (first > dim_kernel_x)
+    {
+        first = dim_kernel_x;
+    }
+    if (last < first)
+    {
+        last = first;
+    }
+
+    for (i_ker_y = y0; i_ker_y < y0 + dim_kernel_y; i_ker_y++, col += row_len)
+    {
+        if (i_ker_y < 0 || i_ker_y >= dim_im_in_y || last == first)
+        {
+            memset(col, 0, row_len);
+            continue;
+        }
+        memset(col, 0, ch_im_in * first);
+        memcpy(col + ch_im_in * first, Im_in + (i_ker_y * dim_im_in_x + x0 + first) * ch_im_in,
+               ch_im_in * (last - first));
+        memset(col + ch_im_in * last, 0, ch_im_in * (dim_kernel_x - last));
+    }
+}
+
+/**
+  @brief         Column of the output pixel (i_out_x, i_out_y) of a q7 HWC convolution.
+  @param[out]    scratch  ch_im_in * dim_kernel_x * dim_kernel_y values, used when the column
+                          has to be built
+  @return        the column, in place in Im_in when the filters are one row high and the window
+                 lies inside the input (the taps are then contiguous), otherwise in scratch
+ */
+__STATIC_FORCEINLINE const q7_t *arm_nn_conv_q7_column(const q7_t *Im_in,
+                                                       const int32_t dim_im_in_x,
+                                                       const int32_t dim_im_in_y,
+                                                       const int32_t ch_im_in,
+                                                       const int32_t dim_kernel_x,
+                                                       const int32_t dim_kernel_y,
+                                                       const int32_t padding_x,
+                                                       const int32_t padding_y,
+                                                       const int32_t stride_x,
+                                                       const int32_t stride_y,
+                                                       const int32_t i_out_x,
+                                                       const int32_t i_out_y,
+                                                       q7_t *scratch)
+{
+    const int32_t x0 = i_out_x * stride_x - padding_x;
+    const int32_t y0 = i_out_y * stride_y - padding_y;
+
+    if (dim_kernel_y == 1 && y0 >= 0 && y0 < dim_im_in_y && x0 >= 0 && x0 + dim_kernel_x <= dim_im_in_x)
+    {
+        return Im_in + (y0 * dim_im_in_x + x0) * ch_im_in;
+    }
+    arm_nn_im2col_q7(Im_in, dim_im_in_x, dim_im_in_y, ch_im_in, dim_kernel_x, dim_kernel_y, x0, y0, scratch);
+    return scratch;
+}
+
 /**
  * @defgroup NNBasicMath Basic Math Functions for Neural Network Computation
  *
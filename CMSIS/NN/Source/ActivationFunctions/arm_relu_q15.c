@@ -47,14 +47,36 @@
  *
  * @details
  *
- * Optimized relu with QSUB instructions.
+ * Optimized relu with QSUB instructions, or signed 16-bit max on x86 hosts (ARM_NN_X86).
  *
  */
 
 void arm_relu_q15(q15_t *data, uint16_t size)
 {
 
-#if defined(ARM_MATH_DSP) && !defined(ARM_MATH_MVEI)
+#if defined(ARM_NN_X86)
+    /* Run the following code for x86 hosts with SSE4.1 or AVX2 */
+    uint16_t i = 0;
+
+#if defined(__AVX2__)
+    for (; i + 16 <= size; i += 16)
+    {
+        const __m256i in = _mm256_loadu_si256((const __m256i *)(data + i));
+        _mm256_storeu_si256((__m256i *)(data + i), _mm256_max_epi16(in, _mm256_setzero_si256()));
+    }
+#endif
+    for (; i + 8 <= size; i += 8)
+    {
+        const __m128i in = _mm_loadu_si128((const __m128i *)(data + i));
+        _mm_storeu_si128((__m128i *)(data + i), _mm_max_epi16(in, _mm_setzero_si128()));
+    }
+    for (; i < size; i++)
+    {
+        if (data[i] < 0)
+            data[i] = 0;
+    }
+
+#elif defined(ARM_MATH_DSP) && !defined(ARM_MATH_MVEI)
     /* Run the following code for M cores with DSP extension */
 
     uint16_t i = size >> 1;
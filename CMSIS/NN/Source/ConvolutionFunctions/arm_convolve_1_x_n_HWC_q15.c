@@ -0,0 +1,568 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS NN Library
+ * Title:        arm_convolve_1_x_n_HWC_q15.c
+ * Description:  Direct Q15 convolution for inputs and kernels one row high
+ *
+ * Target Processor:  Cortex-A9 (ARMv7-A with DSP extension and NEON)
+ *
+ * -------------------------------------------------------------------- */
+
+#include "arm_nnfunctions.h"
+#include "arm_nnsupportfunctions.h"
+
+/**
+ *  @ingroup groupNN
+ */
+
+/**
+ * @addtogroup NNConv
+ * @{
+ */
+
+/*
+ * `rows` (1 to 4) consecutive filters over one or two input windows of `len` values. In HWC
+ * layout the window of an output pixel is a contiguous slice of the input row, so it is read
+ * in place. col2 == NULL computes a single pixel, relu clamps the outputs at 0.
+ */
+static inline void arm_nn_conv_1_x_n_q15_block(const q15_t *wt,
+                                               const int32_t wt_stride,
+                                               const q15_t *col,
+                                               const q15_t *col2,
+                                               const int32_t len,
+                                               const int32_t rows,
+                                               const q15_t *bias,
+                                               const uint16_t bias_shift,
+                                               const uint16_t out_shift,
+                                               q15_t *pOut,
+                                               q15_t *pOut2,
+                                               const int32_t relu)
+{
+    q31_t sum[4][2];
+    int32_t r, k = 0;
+
+    for (r = 0; r < rows; r++)
+    {
+        sum[r][0] = ((q31_t)bias[r] << bias_shift) + NN_ROUND(out_shift);
+        sum[r][1] = sum[r][0];
+    }
+
+#if defined(ARM_MATH_NEON)
+    {
+        int32x4_t acc[4][2];
+        for (r = 0; r < rows; r++)
+        {
+            acc[r][0] = vdupq_n_s32(0);
+            acc[r][1] = vdupq_n_s32(0);
+        }
+        for (; k + 8 <= len; k += 8)
+        {
+            const int16x8_t in1 = vld1q_s16(col + k);
+            const int16x8_t in2 = col2 ? vld1q_s16(col2 + k) : in1;
+            for (r = 0; r < rows; r++)
+            {
+                const int16x8_t w = vld1q_s16(wt + r * wt_stride + k);
+                acc[r][0] = vmlal_s16(acc[r][0], vget_low_s16(w), vget_low_s16(in1));
+                acc[r][0] = vmlal_s16(acc[r][0], vget_high_s16(w), vget_high_s16(in1));
+                acc[r][1] = vmlal_s16(acc[r][1], vget_low_s16(w), vget_low_s16(in2));
+                acc[r][1] = vmlal_s16(acc[r][1], vget_high_s16(w), vget_high_s16(in2));
+            }
+        }
+        /* lane sums wrap mod 2^32 like the __SMLAD accumulation */
+        for (r = 0; r < rows; r++)
+        {
+            int32x2_t s = vpadd_s32(vget_low_s32(acc[r][0]), vget_high_s32(acc[r][0]));
+            int32x2_t s2 = vpadd_s32(vget_low_s32(acc[r][1]), vget_high_s32(acc[r][1]));
+            s = vpadd_s32(s, s2);
+            sum[r][0] = (q31_t)((uint32_t)sum[r][0] + (uint32_t)vget_lane_s32(s, 0));
+            sum[r][1] = (q31_t)((uint32_t)sum[r][1] + (uint32_t)vget_lane_s32(s, 1));
+        }
+    }
+#elif defined(ARM_NN_X86)
+    arm_nn_x86_dot_q15(wt, wt_stride, col, col2, len, rows, sum);
+    k = len;
+#elif defined(ARM_MATH_DSP) && !defined(ARM_MATH_MVEI)
+    for (; k + 2 <= len; k += 2)
+    {
+        const q31_t in1 = arm_nn_read_q15x2(col + k);
+        const q31_t in2 = col2 ? arm_nn_read_q15x2(col2 + k) : in1;
+        for (r = 0; r < rows; r++)
+        {
+            const q31_t w = arm_nn_read_q15x2(wt + r * wt_stride + k);
+            sum[r][0] = __SMLAD(w, in1, sum[r][0]);
+            sum[r][1] = __SMLAD(w, in2, sum[r][1]);
+        }
+    }
+#endif
+
+    /* left-over of the window */
+    for (; k < len; k++)
+    {
+        for (r = 0; r < rows; r++)
+        {
+            sum[r][0] = (q31_t)((uint32_t)sum[r][0] + (uint32_t)(wt[r * wt_stride + k] * col[k]));
+            if (col2)
+            {
+                sum[r][1] = (q31_t)((uint32_t)sum[r][1] + (uint32_t)(wt[r * wt_stride + k] * col2[k]));
+            }
+        }
+    }
+
+    for (r = 0; r < rows; r++)
+    {
+        pOut[r] = arm_nn_sat_q15(sum[r][0] >> out_shift, relu);
+        if (col2)
+        {
+            pOut2[r] = arm_nn_sat_q15(sum[r][1] >> out_shift, relu);
+        }
+    }
+}
+
+static void arm_nn_conv_1_x_n_q15_pixels(const q15_t *wt,
+                                         const int32_t wt_stride,
+                                         const q15_t *col,
+                                         const q15_t *col2,
+                                         const int32_t len,
+                                         const uint16_t ch_im_out,
+                                         const q15_t *bias,
+                                         const uint16_t bias_shift,
+                                         const uint16_t out_shift,
+                                         q15_t *pOut,
+                                         q15_t *pOut2,
+                                         const int32_t relu)
+{
+    int32_t i = 0;
+
+    for (; i + 4 <= ch_im_out; i += 4)
+    {
+        arm_nn_conv_1_x_n_q15_block(wt + i * wt_stride, wt_stride, col, col2, len, 4, bias + i, bias_shift, out_shift,
+                                    pOut + i, pOut2 + i, relu);
+    }
+    for (; i < ch_im_out; i++)
+    {
+        arm_nn_conv_1_x_n_q15_block(wt + i * wt_stride, wt_stride, col, col2, len, 1, bias + i, bias_shift, out_shift,
+                                    pOut + i, pOut2 + i, relu);
+    }
+}
+
+/* Arguments of an arm_nn_convolve_1_x_n_HWC_q15() call the output channel ranges work on */
+typedef struct
+{
+    const q15_t *Im_in;
+    int32_t dim_im_in_x;
+    int32_t ch_im_in;
+    const q15_t *wt;
+    int32_t ch_im_out;
+    int32_t dim_kernel_x;
+    int32_t padding_x;
+    int32_t stride_x;
+    const q15_t *bias;
+    uint16_t bias_shift;
+    uint16_t out_shift;
+    q15_t *Im_out;
+    int32_t dim_im_out_x;
+    int32_t relu;
+} arm_nn_conv_1_x_n_q15_args;
+
+/* Output channels [ch_begin, ch_end) of every output pixel */
+static void arm_nn_conv_1_x_n_q15_channels(const arm_nn_conv_1_x_n_q15_args *a,
+                                           const int32_t ch_begin,
+                                           const int32_t ch_end)
+{
+    const int32_t wt_stride = a->ch_im_in * a->dim_kernel_x;
+    const q15_t *wt = a->wt + ch_begin * wt_stride;
+    const int32_t ch_count = ch_end - ch_begin;
+    int32_t i_out_x = 0;
+
+    while (i_out_x < a->dim_im_out_x)
+    {
+        const int32_t base = i_out_x * a->stride_x - a->padding_x;
+        q15_t *pOut = a->Im_out + i_out_x * a->ch_im_out + ch_begin;
+
+        if (i_out_x + 1 < a->dim_im_out_x && base >= 0 && base + a->stride_x + a->dim_kernel_x <= a->dim_im_in_x)
+        {
+            /* both windows inside the input */
+            const q15_t *col = a->Im_in + base * a->ch_im_in;
+            arm_nn_conv_1_x_n_q15_pixels(wt, wt_stride, col, col + a->stride_x * a->ch_im_in, wt_stride, ch_count,
+                                         a->bias + ch_begin, a->bias_shift, a->out_shift, pOut, pOut + a->ch_im_out,
+                                         a->relu);
+            i_out_x += 2;
+        }
+        else
+        {
+            /* window clipped by the padding, the taps outside the input are zero */
+            int32_t first = base < 0 ? -base : 0;
+            int32_t last = base + a->dim_kernel_x > a->dim_im_in_x ? a->dim_im_in_x - base : a->dim_kernel_x;
+            if (last < first)
+            {
+                last = first;
+            }
+            arm_nn_conv_1_x_n_q15_pixels(wt + first * a->ch_im_in, wt_stride, a->Im_in + (base + first) * a->ch_im_in,
+                                         NULL, (last - first) * a->ch_im_in, ch_count, a->bias + ch_begin,
+                                         a->bias_shift, a->out_shift, pOut, pOut, a->relu);
+            i_out_x += 1;
+        }
+    }
+}
+
+/* Output channels [ch_begin, ch_end) in tiles whose filters fit in ARM_NN_L1_TILE_BYTES, each tile
+ * going over every output pixel before the next one: the filters of a layer rarely fit in L1
+ * while a tile of them stays there for the whole input row */
+static void arm_nn_conv_1_x_n_q15_tiles(const arm_nn_conv_1_x_n_q15_args *a,
+                                        const int32_t ch_begin,
+                                        const int32_t ch_end)
+{
+#if ARM_NN_L1_TILE_BYTES > 0
+    const int32_t tile_ch = ARM_NN_CONV_Q15_TILE_CH(a->ch_im_in * a->dim_kernel_x, ch_end - ch_begin);
+    int32_t c0;
+
+    for (c0 = ch_begin; c0 < ch_end; c0 += tile_ch)
+    {
+        arm_nn_conv_1_x_n_q15_channels(a, c0, MIN(ch_end, c0 + tile_ch));
+    }
+#else
+    arm_nn_conv_1_x_n_q15_channels(a, ch_begin, ch_end);
+#endif
+}
+
+/* Output channels in the tiles of arm_nn_conv_1_x_n_q15_tiles(), each tile going over the input row
+ * of every tensor of the batch while it stays in L1. `a` gives the layer, Im_in and Im_out the
+ * tensors. */
+static void arm_nn_conv_1_x_n_q15_batch(const arm_nn_conv_1_x_n_q15_args *a,
+                                        const q15_t *const *Im_in,
+                                        q15_t *const *Im_out,
+                                        const int32_t batch)
+{
+#if ARM_NN_L1_TILE_BYTES > 0
+    const int32_t tile_ch = ARM_NN_CONV_Q15_TILE_CH(a->ch_im_in * a->dim_kernel_x, a->ch_im_out);
+#else
+    const int32_t tile_ch = a->ch_im_out;
+#endif
+    arm_nn_conv_1_x_n_q15_args lane = *a;
+    int32_t c0, b;
+
+    for (c0 = 0; c0 < a->ch_im_out; c0 += tile_ch)
+    {
+        for (b = 0; b < batch; b++)
+        {
+            lane.Im_in = Im_in[b];
+            lane.Im_out = Im_out[b];
+            arm_nn_conv_1_x_n_q15_channels(&lane, c0, MIN(a->ch_im_out, c0 + tile_ch));
+        }
+    }
+}
+
+#if defined(ARM_NN_BATCH)
+/* The same call of every lane of a batch. The lanes run copies of one model, the filters of lane 0
+ * serve all of them. */
+static void arm_nn_conv_1_x_n_q15_batch_task(void *const *ctx, int32_t lanes)
+{
+    const q15_t *Im_in[ARM_NN_BATCH_MAX];
+    q15_t *Im_out[ARM_NN_BATCH_MAX];
+    int32_t b;
+
+    for (b = 0; b < lanes; b++)
+    {
+        Im_in[b] = ((const arm_nn_conv_1_x_n_q15_args *)ctx[b])->Im_in;
+        Im_out[b] = ((const arm_nn_conv_1_x_n_q15_args *)ctx[b])->Im_out;
+    }
+    arm_nn_conv_1_x_n_q15_batch((const arm_nn_conv_1_x_n_q15_args *)ctx[0], Im_in, Im_out, lanes);
+}
+#endif
+
+#if defined(ARM_NN_TEAM)
+/* One part of the output channels, on a thread of the team */
+static void arm_nn_conv_1_x_n_q15_team_part(void *ctx, int32_t part, int32_t parts)
+{
+    const arm_nn_conv_1_x_n_q15_args *a = (const arm_nn_conv_1_x_n_q15_args *)ctx;
+    arm_nn_conv_1_x_n_q15_tiles(a, arm_nn_team_bound(a->ch_im_out, part, parts),
+                                arm_nn_team_bound(a->ch_im_out, part + 1, parts));
+}
+#endif
+
+/* arm_convolve_1_x_n_HWC_q15() and arm_convolve_1_x_n_HWC_q15_relu(), which only differ in the
+ * output saturation */
+static arm_status arm_nn_convolve_1_x_n_HWC_q15(const q15_t *Im_in,
+                                                const uint16_t dim_im_in_x,
+                                                const uint16_t dim_im_in_y,
+                                                const uint16_t ch_im_in,
+                                                const q15_t *wt,
+                                                const uint16_t ch_im_out,
+                                                const uint16_t dim_kernel_x,
+                                                const uint16_t dim_kernel_y,
+                                                const uint16_t padding_x,
+                                                const uint16_t padding_y,
+                                                const uint16_t stride_x,
+                                                const uint16_t stride_y,
+                                                const q15_t *bias,
+                                                const uint16_t bias_shift,
+                                                const uint16_t out_shift,
+                                                q15_t *Im_out,
+                                                const uint16_t dim_im_out_x,
+                                                const uint16_t dim_im_out_y,
+                                                q15_t *bufferA,
+                                                q7_t *bufferB,
+                                                const int32_t relu)
+{
+    (void)stride_y;
+    (void)bufferA;
+    (void)bufferB;
+
+    if (dim_im_in_y != 1 || dim_kernel_y != 1 || padding_y != 0 || dim_im_out_y != 1)
+    {
+        return ARM_MATH_SIZE_MISMATCH;
+    }
+
+    const arm_nn_conv_1_x_n_q15_args args = {Im_in, dim_im_in_x, ch_im_in, wt, ch_im_out, dim_kernel_x, padding_x,
+                                             stride_x, bias, bias_shift, out_shift, Im_out, dim_im_out_x, relu};
+
+#if defined(ARM_NN_BATCH)
+    /* lanes of a batch hand the call to the batch */
+    if (arm_nn_batch && arm_nn_batch->join(arm_nn_conv_1_x_n_q15_batch_task, (void *)&args))
+    {
+        return ARM_MATH_SUCCESS;
+    }
+#endif
+
+#if defined(ARM_NN_TEAM)
+    /* filters are independent, large layers split them over the team */
+    const int32_t parts = arm_nn_team_parts((int64_t)dim_im_out_x * ch_im_out * ch_im_in * dim_kernel_x, ch_im_out);
+    if (parts > 1)
+    {
+        arm_nn_team->run(arm_nn_conv_1_x_n_q15_team_part, (void *)&args, parts);
+        return ARM_MATH_SUCCESS;
+    }
+#endif
+
+    arm_nn_conv_1_x_n_q15_tiles(&args, 0, ch_im_out);
+
+    /* Return to application */
+    return ARM_MATH_SUCCESS;
+}
+
+/**
+ * @brief Direct Q15 convolution function for 1 x n inputs and kernels
+ * @param[in]       Im_in        pointer to input tensor
+ * @param[in]       dim_im_in_x  input tensor dimension x
+ * @param[in]       dim_im_in_y  input tensor dimension y, must be 1
+ * @param[in]       ch_im_in     number of input tensor channels
+ * @param[in]       wt           pointer to kernel weights
+ * @param[in]       ch_im_out    number of filters, i.e., output tensor channels
+ * @param[in]       dim_kernel_x filter kernel size x
+ * @param[in]       dim_kernel_y filter kernel size y, must be 1
+ * @param[in]       padding_x    padding size x
+ * @param[in]       padding_y    padding size y, must be 0
+ * @param[in]       stride_x     convolution stride x
+ * @param[in]       stride_y     convolution stride y
+ * @param[in]       bias         pointer to bias
+ * @param[in]       bias_shift   amount of left-shift for bias
+ * @param[in]       out_shift    amount of right-shift for output
+ * @param[in,out]   Im_out       pointer to output tensor
+ * @param[in]       dim_im_out_x output tensor dimension x
+ * @param[in]       dim_im_out_y output tensor dimension y, must be 1
+ * @param[in,out]   bufferA      unused
+ * @param[in,out]   bufferB      unused
+ * @return     The function returns either
+ * <code>ARM_MATH_SIZE_MISMATCH</code> or <code>ARM_MATH_SUCCESS</code> based on the outcome of size checking.
+ *
+ * @details
+ *
+ * Same signature and results as arm_convolve_HWC_q15_basic_nonsquare(). With a single input
+ * row the taps of an output pixel are one contiguous slice of the input, so the filters run
+ * straight over the input without an im2col copy. Pixels go in pairs, stride_x * ch_im_in
+ * apart, each weight load serving both, and pixels whose window is clipped by the padding
+ * only visit the taps inside the input. The filters go in tiles of ARM_NN_L1_TILE_BYTES that
+ * stay in L1 over the whole row. Built with ARM_NN_TEAM, large layers split their filters
+ * over the arm_nn_team threads, with the same results. Built with ARM_NN_BATCH, the call of
+ * every lane of an arm_nn_batch goes through arm_convolve_1_x_n_HWC_q15_batch() at once.
+ *
+ * <b>Buffer size:</b>
+ *
+ * bufferA size: 0
+ *
+ * bufferB size: 0
+ *
+ */
+
+arm_status arm_convolve_1_x_n_HWC_q15(const q15_t *Im_in,
+                                      const uint16_t dim_im_in_x,
+                                      const uint16_t dim_im_in_y,
+                                      const uint16_t ch_im_in,
+                                      const q15_t *wt,
+                                      const uint16_t ch_im_out,
+                                      const uint16_t dim_kernel_x,
+                                      const uint16_t dim_kernel_y,
+                                      const uint16_t padding_x,
+                                      const uint16_t padding_y,
+                                      const uint16_t stride_x,
+                                      const uint16_t stride_y,
+                                      const q15_t *bias,
+                                      const uint16_t bias_shift,
+                                      const uint16_t out_shift,
+                                      q15_t *Im_out,
+                                      const uint16_t dim_im_out_x,
+                                      const uint16_t dim_im_out_y,
+                                      q15_t *bufferA,
+                                      q7_t *bufferB)
+{
+    return arm_nn_convolve_1_x_n_HWC_q15(Im_in, dim_im_in_x, dim_im_in_y, ch_im_in, wt, ch_im_out, dim_kernel_x,
+                                         dim_kernel_y, padding_x, padding_y, stride_x, stride_y, bias, bias_shift,
+                                         out_shift, Im_out, dim_im_out_x, dim_im_out_y, bufferA, bufferB, 0);
+}
+
+/**
+ * @brief Direct Q15 convolution function for 1 x n inputs and kernels followed by a ReLU
+ * @param[in]       Im_in        pointer to input tensor
+ * @param[in]       dim_im_in_x  input tensor dimension x
+ * @param[in]       dim_im_in_y  input tensor dimension y, must be 1
+ * @param[in]       ch_im_in     number of input tensor channels
+ * @param[in]       wt           pointer to kernel weights
+ * @param[in]       ch_im_out    number of filters, i.e., output tensor channels
+ * @param[in]       dim_kernel_x filter kernel size x
+ * @param[in]       dim_kernel_y filter kernel size y, must be 1
+ * @param[in]       padding_x    padding size x
+ * @param[in]       padding_y    padding size y, must be 0
+ * @param[in]       stride_x     convolution stride x
+ * @param[in]       stride_y     convolution stride y
+ * @param[in]       bias         pointer to bias
+ * @param[in]       bias_shift   amount of left-shift for bias
+ * @param[in]       out_shift    amount of right-shift for output
+ * @param[in,out]   Im_out       pointer to output tensor
+ * @param[in]       dim_im_out_x output tensor dimension x
+ * @param[in]       dim_im_out_y output tensor dimension y, must be 1
+ * @param[in,out]   bufferA      unused
+ * @param[in,out]   bufferB      unused
+ * @return     The function returns either
+ * <code>ARM_MATH_SIZE_MISMATCH</code> or <code>ARM_MATH_SUCCESS</code> based on the outcome of size checking.
+ *
+ * @details
+ *
+ * Same results as arm_convolve_1_x_n_HWC_q15() followed by arm_relu_q15() on Im_out, the ReLU
+ * being applied when each output is saturated instead of in a second pass over Im_out.
+ *
+ */
+
+arm_status arm_convolve_1_x_n_HWC_q15_relu(const q15_t *Im_in,
+                                           const uint16_t dim_im_in_x,
+                                           const uint16_t dim_im_in_y,
+                                           const uint16_t ch_im_in,
+                                           const q15_t *wt,
+                                           const uint16_t ch_im_out,
+                                           const uint16_t dim_kernel_x,
+                                           const uint16_t dim_kernel_y,
+                                           const uint16_t padding_x,
+                                           const uint16_t padding_y,
+                                           const uint16_t stride_x,
+                                           const uint16_t stride_y,
+                                           const q15_t *bias,
+                                           const uint16_t bias_shift,
+                                           const uint16_t out_shift,
+                                           q15_t *Im_out,
+                                           const uint16_t dim_im_out_x,
+                                           const uint16_t dim_im_out_y,
+                                           q15_t *bufferA,
+                                           q7_t *bufferB)
+{
+    return arm_nn_convolve_1_x_n_HWC_q15(Im_in, dim_im_in_x, dim_im_in_y, ch_im_in, wt, ch_im_out, dim_kernel_x,
+                                         dim_kernel_y, padding_x, padding_y, stride_x, stride_y, bias, bias_shift,
+                                         out_shift, Im_out, dim_im_out_x, dim_im_out_y, bufferA, bufferB, 1);
+}
+
+/**
+ * @brief Direct Q15 convolution function for 1 x n inputs and kernels over a batch of tensors
+ * @param[in]       Im_in        pointers to the batch input tensors
+ * @param[in]       dim_im_in_x  input tensor dimension x
+ * @param[in]       dim_im_in_y  input tensor dimension y, must be 1
+ * @param[in]       ch_im_in     number of input tensor channels
+ * @param[in]       wt           pointer to kernel weights
+ * @param[in]       ch_im_out    number of filters, i.e., output tensor channels
+ * @param[in]       dim_kernel_x filter kernel size x
+ * @param[in]       dim_kernel_y filter kernel size y, must be 1
+ * @param[in]       padding_x    padding size x
+ * @param[in]       padding_y    padding size y, must be 0
+ * @param[in]       stride_x     convolution stride x
+ * @param[in]       stride_y     convolution stride y
+ * @param[in]       bias         pointer to bias
+ * @param[in]       bias_shift   amount of left-shift for bias
+ * @param[in]       out_shift    amount of right-shift for output
+ * @param[in,out]   Im_out       pointers to the batch output tensors
+ * @param[in]       dim_im_out_x output tensor dimension x
+ * @param[in]       dim_im_out_y output tensor dimension y, must be 1
+ * @param[in]       batch        number of tensors
+ * @param[in,out]   bufferA      unused
+ * @param[in,out]   bufferB      unused
+ * @return     The function returns either
+ * <code>ARM_MATH_SIZE_MISMATCH</code> or <code>ARM_MATH_SUCCESS</code> based on the outcome of size checking.
+ *
+ * @details
+ *
+ * Same results as arm_convolve_1_x_n_HWC_q15() on each tensor. Each tile of filters goes over
+ * the input row of every tensor of the batch while it stays in L1, so the filters are streamed
+ * from memory once per batch instead of once per tensor.
+ *
+ * <b>Buffer size:</b>
+ *
+ * bufferA size: 0
+ *
+ * bufferB size: 0
+ *
+ */
+
+arm_status arm_convolve_1_x_n_HWC_q15_batch(const q15_t *const *Im_in,
+                                            const uint16_t dim_im_in_x,
+                                            const uint16_t dim_im_in_y,
+                                            const uint16_t ch_im_in,
+                                            const q15_t *wt,
+                                            const uint16_t ch_im_out,
+                                            const uint16_t dim_kernel_x,
+                                            const uint16_t dim_kernel_y,
+                                            const uint16_t padding_x,
+                                            const uint16_t padding_y,
+                                            const uint16_t stride_x,
+                                            const uint16_t stride_y,
+                                            const q15_t *bias,
+                                            const uint16_t bias_shift,
+                                            const uint16_t out_shift,
+                                            q15_t *const *Im_out,
+                                            const uint16_t dim_im_out_x,
+                                            const uint16_t dim_im_out_y,
+                                            const uint16_t batch,
+                                            q15_t *bufferA,
+                                            q7_t *bufferB)
+{
+    (void)stride_y;
+    (void)bufferA;
+    (void)bufferB;
+
+    if (dim_im_in_y != 1 || dim_kernel_y != 1 || padding_y != 0 || dim_im_out_y != 1)
+    {
+        return ARM_MATH_SIZE_MISMATCH;
+    }
+
+    /* the tensors come from Im_in and Im_out */
+    const arm_nn_conv_1_x_n_q15_args args = {NULL, dim_im_in_x, ch_im_in, wt, ch_im_out, dim_kernel_x, padding_x,
+                                             stride_x, bias, bias_shift, out_shift, NULL, dim_im_out_x, 0};
+    arm_nn_conv_1_x_n_q15_batch(&args, Im_in, Im_out, batch);
+
+    /* Return to application */
+    return ARM_MATH_SUCCESS;
+}
+
+/**
+ * @} end of NNConv group
+ */
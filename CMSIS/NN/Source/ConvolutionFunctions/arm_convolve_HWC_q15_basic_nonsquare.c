@@ -40,65 +40,91 @@
  * @{
  */
 
-/**
- * @brief Basic Q15 convolution function (non-square shape)
- * @param[in]       Im_in       pointer to input tensor
- * @param[in]       dim_im_in_x  input tensor dimention x
- * @param[in]       dim_im_in_y  input tensor dimention y
- * @param[in]       ch_im_in    number of input tensor channels
- * @param[in]       wt          pointer to kernel weights
- * @param[in]       ch_im_out   number of filters, i.e., output tensor channels
- * @param[in]       dim_kernel_x filter kernel size x
- * @param[in]       dim_kernel_y filter kernel size y
- * @param[in]       padding_x    padding size x
- * @param[in]       padding_y    padding size y
- * @param[in]       stride_x     convolution stride x
- * @param[in]       stride_y     convolution stride y
- * @param[in]       bias        pointer to bias
- * @param[in]       bias_shift  amount of left-shift for bias
- * @param[in]       out_shift   amount of right-shift for output
- * @param[in,out]   Im_out      pointer to output tensor
- * @param[in]       dim_im_out_x output tensor dimension x
- * @param[in]       dim_im_out_y output tensor dimension y
- * @param[in,out]   bufferA     pointer to buffer space for input
- * @param[in,out]   bufferB     pointer to buffer space for output
- * @return     The function returns <code>ARM_MATH_SUCCESS</code>
- *
- * @details
- *
- * <b>Buffer size:</b>
- *
- * bufferA size: ch_im_in*dim_kernel_x*dim_kernel_y
- *
- * bufferB size: 0
- *
- * This basic version is designed to work for any input tensor and weight
- * dimension.
- */
-
-arm_status arm_convolve_HWC_q15_basic_nonsquare(const q15_t *Im_in,
-                                      const uint16_t dim_im_in_x,
-                                      const uint16_t dim_im_in_y,
-                                      const uint16_t ch_im_in,
-                                      const q15_t *wt,
-                                      const uint16_t ch_im_out,
-                                      const uint16_t dim_kernel_x,
-                                      const uint16_t dim_kernel_y,
-                                      const uint16_t padding_x,
-                                      const uint16_t padding_y,
-                                      const uint16_t stride_x,
-                                      const uint16_t stride_y,
-                                      const q15_t *bias,
-                                      const uint16_t bias_shift,
-                                      const uint16_t out_shift,
-                                      q15_t *Im_out,
-                                      const uint16_t dim_im_out_x,
-                                      const uint16_t dim_im_out_y,
-                                      q15_t *bufferA,
-                                      q7_t *bufferB)
+/* arm_convolve_HWC_q15_basic_nonsquare() and arm_convolve_HWC_q15_basic_nonsquare_relu(), which
+ * only differ in the output saturation */
+static arm_status arm_nn_convolve_HWC_q15_basic_nonsquare(const q15_t *Im_in,
+                                                          const uint16_t dim_im_in_x,
+                                                          const uint16_t dim_im_in_y,
+                                                          const uint16_t ch_im_in,
+                                                          const q15_t *wt,
+                                                          const uint16_t ch_im_out,
+                                                          const uint16_t dim_kernel_x,
+                                                          const uint16_t dim_kernel_y,
+                                                          const uint16_t padding_x,
+                                                          const uint16_t padding_y,
+                                                          const uint16_t stride_x,
+                                                          const uint16_t stride_y,
+                                                          const q15_t *bias,
+                                                          const uint16_t bias_shift,
+                                                          const uint16_t out_shift,
+                                                          q15_t *Im_out,
+                                                          const uint16_t dim_im_out_x,
+                                                          const uint16_t dim_im_out_y,
+                                                          q15_t *bufferA,
+                                                          q7_t *bufferB,
+                                                          const int32_t relu)
 {
     (void)bufferB;
-#if defined(ARM_MATH_DSP) && !defined(ARM_MATH_MVEI)
+
+    if (dim_im_in_y == 1 && dim_kernel_y == 1 && padding_y == 0 && dim_im_out_y == 1)
+    {
+        /* 1-D layer: the filters run straight over the input row, no im2col */
+        return (relu ? arm_convolve_1_x_n_HWC_q15_relu : arm_convolve_1_x_n_HWC_q15)(
+            Im_in, dim_im_in_x, dim_im_in_y, ch_im_in, wt, ch_im_out, dim_kernel_x, dim_kernel_y, padding_x, padding_y,
+            stride_x, stride_y, bias, bias_shift, out_shift, Im_out, dim_im_out_x, dim_im_out_y, bufferA, bufferB);
+    }
+
+#if defined(ARM_NN_X86)
+    /* Run the following code for x86 hosts with SSE4.1 or AVX2 */
+    const int32_t col_len = ch_im_in * dim_kernel_y * dim_kernel_x;
+    int16_t i_out_y, i_out_x, i_ker_y, i_ker_x;
+    q15_t *pOut = Im_out;
+    int32_t i, r;
+
+    for (i_out_y = 0; i_out_y < dim_im_out_y; i_out_y++)
+    {
+        for (i_out_x = 0; i_out_x < dim_im_out_x; i_out_x++)
+        {
+            q15_t *pBuffer = bufferA;
+
+            for (i_ker_y = i_out_y * stride_y - padding_y; i_ker_y < i_out_y * stride_y - padding_y + dim_kernel_y; i_ker_y++)
+            {
+                for (i_ker_x = i_out_x * stride_x - padding_x; i_ker_x < i_out_x * stride_x - padding_x + dim_kernel_x; i_ker_x++)
+                {
+                    if (i_ker_y < 0 || i_ker_y >= dim_im_in_y || i_ker_x < 0 || i_ker_x >= dim_im_in_x)
+                    {
+                        memset(pBuffer, 0, sizeof(q15_t) * ch_im_in);
+                    }
+                    else
+                    {
+                        memcpy(pBuffer, Im_in + (i_ker_y * dim_im_in_x + i_ker_x) * ch_im_in, sizeof(q15_t) * ch_im_in);
+                    }
+                    pBuffer += ch_im_in;
+                }
+            }
+
+            /* four filters at a time against one load of the column */
+            for (i = 0; i < ch_im_out; i += 4)
+            {
+                const int32_t rows = ch_im_out - i < 4 ? ch_im_out - i : 4;
+                q31_t sum[4][2];
+
+                for (r = 0; r < rows; r++)
+                {
+                    sum[r][0] = ((q31_t)bias[i + r] << bias_shift) + NN_ROUND(out_shift);
+                    sum[r][1] = 0;
+                }
+                arm_nn_x86_dot_q15(wt + i * col_len, col_len, bufferA, NULL, col_len, rows, sum);
+                for (r = 0; r < rows; r++)
+                {
+                    pOut[i + r] = arm_nn_sat_q15(sum[r][0] >> out_shift, relu);
+                }
+            }
+            pOut += ch_im_out;
+        }
+    }
+
+#elif defined(ARM_MATH_DSP) && !defined(ARM_MATH_MVEI)
     /* Run the following code for Cortex-M4 and Cortex-M7 */
 
     int16_t i_out_y, i_out_x, i_ker_y, i_ker_x;
@@ -163,7 +189,7 @@ arm_status arm_convolve_HWC_q15_basic_nonsquare(const q15_t *Im_in,
                     sum += inA1 * inB1;
                     colCnt--;
                 }
-                *pOut = (q15_t)__SSAT((sum >> out_shift), 16);
+                *pOut = arm_nn_sat_q15(sum >> out_shift, relu);
                 pOut++;
             }
 
@@ -203,7 +229,7 @@ arm_status arm_convolve_HWC_q15_basic_nonsquare(const q15_t *Im_in,
                         }
                     }
                 }
-                Im_out[i + (j * dim_im_out_x + k) * ch_im_out] = (q15_t)__SSAT((conv_out >> out_shift), 16);
+                Im_out[i + (j * dim_im_out_x + k) * ch_im_out] = arm_nn_sat_q15(conv_out >> out_shift, relu);
             }
         }
     }
@@ -214,6 +240,128 @@ arm_status arm_convolve_HWC_q15_basic_nonsquare(const q15_t *Im_in,
     return ARM_MATH_SUCCESS;
 }
 
+/**
+ * @brief Basic Q15 convolution function (non-square shape)
+ * @param[in]       Im_in       pointer to input tensor
+ * @param[in]       dim_im_in_x  input tensor dimention x
+ * @param[in]       dim_im_in_y  input tensor dimention y
+ * @param[in]       ch_im_in    number of input tensor channels
+ * @param[in]       wt          pointer to kernel weights
+ * @param[in]       ch_im_out   number of filters, i.e., output tensor channels
+ * @param[in]       dim_kernel_x filter kernel size x
+ * @param[in]       dim_kernel_y filter kernel size y
+ * @param[in]       padding_x    padding size x
+ * @param[in]       padding_y    padding size y
+ * @param[in]       stride_x     convolution stride x
+ * @param[in]       stride_y     convolution stride y
+ * @param[in]       bias        pointer to bias
+ * @param[in]       bias_shift  amount of left-shift for bias
+ * @param[in]       out_shift   amount of right-shift for output
+ * @param[in,out]   Im_out      pointer to output tensor
+ * @param[in]       dim_im_out_x output tensor dimension x
+ * @param[in]       dim_im_out_y output tensor dimension y
+ * @param[in,out]   bufferA     pointer to buffer space for input
+ * @param[in,out]   bufferB     pointer to buffer space for output
+ * @return     The function returns <code>ARM_MATH_SUCCESS</code>
+ *
+ * @details
+ *
+ * <b>Buffer size:</b>
+ *
+ * bufferA size: ch_im_in*dim_kernel_x*dim_kernel_y
+ *
+ * bufferB size: 0
+ *
+ * This basic version is designed to work for any input tensor and weight
+ * dimension. 1-D layers (dim_im_in_y, dim_kernel_y and dim_im_out_y 1, no padding_y)
+ * go to arm_convolve_1_x_n_HWC_q15().
+ */
+
+arm_status arm_convolve_HWC_q15_basic_nonsquare(const q15_t *Im_in,
+                                                const uint16_t dim_im_in_x,
+                                                const uint16_t dim_im_in_y,
+                                                const uint16_t ch_im_in,
+                                                const q15_t *wt,
+                                                const uint16_t ch_im_out,
+                                                const uint16_t dim_kernel_x,
+                                                const uint16_t dim_kernel_y,
+                                                const uint16_t padding_x,
+                                                const uint16_t padding_y,
+                                                const uint16_t stride_x,
+                                                const uint16_t stride_y,
+                                                const q15_t *bias,
+                                                const uint16_t bias_shift,
+                                                const uint16_t out_shift,
+                                                q15_t *Im_out,
+                                                const uint16_t dim_im_out_x,
+                                                const uint16_t dim_im_out_y,
+                                                q15_t *bufferA,
+                                                q7_t *bufferB)
+{
+    return arm_nn_convolve_HWC_q15_basic_nonsquare(Im_in, dim_im_in_x, dim_im_in_y, ch_im_in, wt, ch_im_out,
+                                                   dim_kernel_x, dim_kernel_y, padding_x, padding_y, stride_x, stride_y,
+                                                   bias, bias_shift, out_shift, Im_out, dim_im_out_x, dim_im_out_y,
+                                                   bufferA, bufferB, 0);
+}
+
+/**
+ * @brief Basic Q15 convolution function (non-square shape) followed by a ReLU
+ * @param[in]       Im_in       pointer to input tensor
+ * @param[in]       dim_im_in_x  input tensor dimention x
+ * @param[in]       dim_im_in_y  input tensor dimention y
+ * @param[in]       ch_im_in    number of input tensor channels
+ * @param[in]       wt          pointer to kernel weights
+ * @param[in]       ch_im_out   number of filters, i.e., output tensor channels
+ * @param[in]       dim_kernel_x filter kernel size x
+ * @param[in]       dim_kernel_y filter kernel size y
+ * @param[in]       padding_x    padding size x
+ * @param[in]       padding_y    padding size y
+ * @param[in]       stride_x     convolution stride x
+ * @param[in]       stride_y     convolution stride y
+ * @param[in]       bias        pointer to bias
+ * @param[in]       bias_shift  amount of left-shift for bias
+ * @param[in]       out_shift   amount of right-shift for output
+ * @param[in,out]   Im_out      pointer to output tensor
+ * @param[in]       dim_im_out_x output tensor dimension x
+ * @param[in]       dim_im_out_y output tensor dimension y
+ * @param[in,out]   bufferA     pointer to buffer space for input
+ * @param[in,out]   bufferB     pointer to buffer space for output
+ * @return     The function returns <code>ARM_MATH_SUCCESS</code>
+ *
+ * @details
+ *
+ * Same results as arm_convolve_HWC_q15_basic_nonsquare() followed by arm_relu_q15() on Im_out,
+ * the ReLU being applied when each output is saturated instead of in a second pass over Im_out.
+ *
+ */
+
+arm_status arm_convolve_HWC_q15_basic_nonsquare_relu(const q15_t *Im_in,
+                                                     const uint16_t dim_im_in_x,
+                                                     const uint16_t dim_im_in_y,
+                                                     const uint16_t ch_im_in,
+                                                     const q15_t *wt,
+                                                     const uint16_t ch_im_out,
+                                                     const uint16_t dim_kernel_x,
+                                                     const uint16_t dim_kernel_y,
+                                                     const uint16_t padding_x,
+                                                     const uint16_t padding_y,
+                                                     const uint16_t stride_x,
+                                                     const uint16_t stride_y,
+                                                     const q15_t *bias,
+                                                     const uint16_t bias_shift,
+                                                     const uint16_t out_shift,
+                                                     q15_t *Im_out,
+                                                     const uint16_t dim_im_out_x,
+                                                     const uint16_t dim_im_out_y,
+                                                     q15_t *bufferA,
+                                                     q7_t *bufferB)
+{
+    return arm_nn_convolve_HWC_q15_basic_nonsquare(Im_in, dim_im_in_x, dim_im_in_y, ch_im_in, wt, ch_im_out,
+                                                   dim_kernel_x, dim_kernel_y, padding_x, padding_y, stride_x, stride_y,
+                                                   bias, bias_shift, out_shift, Im_out, dim_im_out_x, dim_im_out_y,
+                                                   bufferA, bufferB, 1);
+}
+
 /**
  * @} end of NNConv group
  */
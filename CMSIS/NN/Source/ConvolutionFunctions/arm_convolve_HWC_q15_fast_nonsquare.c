@@ -40,70 +40,278 @@
  * @{
  */
 
-/**
- * @brief Fast Q15 convolution function (non-sqaure shape)
- * @param[in]       Im_in        pointer to input tensor
- * @param[in]       dim_im_in_x  input tensor dimention x
- * @param[in]       dim_im_in_y  input tensor dimention y
- * @param[in]       ch_im_in     number of input tensor channels
- * @param[in]       wt           pointer to kernel weights
- * @param[in]       ch_im_out    number of filters, i.e., output tensor channels
- * @param[in]       dim_kernel_x filter kernel size x
- * @param[in]       dim_kernel_y filter kernel size y
- * @param[in]       padding_x    padding size x
- * @param[in]       padding_y    padding size y
- * @param[in]       stride_x     convolution stride x
- * @param[in]       stride_y     convolution stride y
- * @param[in]       bias         pointer to bias
- * @param[in]       bias_shift   amount of left-shift for bias
- * @param[in]       out_shift    amount of right-shift for output
- * @param[in,out]   Im_out       pointer to output tensor
- * @param[in]       dim_im_out_x output tensor dimension x
- * @param[in]       dim_im_out_y output tensor dimension y
- * @param[in,out]   bufferA      pointer to buffer space for input
- * @param[in,out]   bufferB      pointer to buffer space for output
- * @return     The function returns either
- * <code>ARM_MATH_SIZE_MISMATCH</code> or <code>ARM_MATH_SUCCESS</code> based on the outcome of size checking.
- *
- * @details
- *
- * <b>Buffer size:</b>
- *
- * bufferA size: 2*ch_im_in*dim_kernel*dim_kernel
- *
- * bufferB size: 0
- *
- * <b>Input dimension constraints:</b>
- *
- * ch_im_in is multiple of 2
- *
- * ch_im_out is multiple of 2
- *
- */
+#if defined(ARM_MATH_NEON)
 
-arm_status arm_convolve_HWC_q15_fast_nonsquare(const q15_t *Im_in,
-                                               const uint16_t dim_im_in_x,
-                                               const uint16_t dim_im_in_y,
-                                               const uint16_t ch_im_in,
-                                               const q15_t *wt,
-                                               const uint16_t ch_im_out,
-                                               const uint16_t dim_kernel_x,
-                                               const uint16_t dim_kernel_y,
-                                               const uint16_t padding_x,
-                                               const uint16_t padding_y,
-                                               const uint16_t stride_x,
-                                               const uint16_t stride_y,
-                                               const q15_t *bias,
-                                               const uint16_t bias_shift,
-                                               const uint16_t out_shift,
-                                               q15_t *Im_out,
-                                               const uint16_t dim_im_out_x,
-                                               const uint16_t dim_im_out_y,
-                                               q15_t *bufferA,
-                                               q7_t *bufferB)
+/* Sum of the four lanes, wrapping mod 2^32 like the __SMLAD accumulation */
+static inline q31_t arm_nn_conv_q15_neon_hsum(int32x4_t v)
+{
+    int32x2_t s = vpadd_s32(vget_low_s32(v), vget_high_s32(v));
+    s = vpadd_s32(s, s);
+    return vget_lane_s32(s, 0);
+}
+
+static inline void arm_nn_conv_q15_neon_copy(const q15_t *src, q15_t *dst, int32_t len)
+{
+    while (len >= 8)
+    {
+        vst1q_s16(dst, vld1q_s16(src));
+        src += 8;
+        dst += 8;
+        len -= 8;
+    }
+    while (len--)
+    {
+        *dst++ = *src++;
+    }
+}
+
+/* im2col of one output pixel. In HWC layout the taps of a kernel row that fall inside the image
+ * are one contiguous run of values, so each row is a zero fill, one copy and a zero fill. */
+static q15_t *arm_nn_conv_q15_neon_im2col(const q15_t *Im_in,
+                                          const uint16_t dim_im_in_x,
+                                          const uint16_t dim_im_in_y,
+                                          const uint16_t ch_im_in,
+                                          const uint16_t dim_kernel_x,
+                                          const uint16_t dim_kernel_y,
+                                          const int32_t x0,
+                                          const int32_t y0,
+                                          q15_t *pBuffer)
+{
+    int32_t before = x0 < 0 ? -x0 : 0;
+    int32_t after = x0 + dim_kernel_x > dim_im_in_x ? x0 + dim_kernel_x - dim_im_in_x : 0;
+    int32_t i_ker_y;
+
+    if (before > dim_kernel_x)
+    {
+        before = dim_kernel_x;
+    }
+    if (after > dim_kernel_x - before)
+    {
+        after = dim_kernel_x - before;
+    }
+
+    const int32_t inside = dim_kernel_x - before - after;
+
+    for (i_ker_y = y0; i_ker_y < y0 + dim_kernel_y; i_ker_y++)
+    {
+        if (i_ker_y < 0 || i_ker_y >= dim_im_in_y || inside == 0)
+        {
+            memset(pBuffer, 0, sizeof(q15_t) * ch_im_in * dim_kernel_x);
+            pBuffer += ch_im_in * dim_kernel_x;
+            continue;
+        }
+
+        memset(pBuffer, 0, sizeof(q15_t) * ch_im_in * before);
+        pBuffer += ch_im_in * before;
+        arm_nn_conv_q15_neon_copy(Im_in + (i_ker_y * dim_im_in_x + x0 + before) * ch_im_in, pBuffer, ch_im_in * inside);
+        pBuffer += ch_im_in * inside;
+        memset(pBuffer, 0, sizeof(q15_t) * ch_im_in * after);
+        pBuffer += ch_im_in * after;
+    }
+
+    return pBuffer;
+}
+
+/* `rows` (2 or 4) consecutive filters applied to the two im2col columns of a pixel pair, eight
+ * MACs per vmlal_s16 with the weights and columns loaded once per eight values */
+static inline void arm_nn_conv_q15_neon_block(const q15_t *wt,
+                                              const q15_t *col,
+                                              const int32_t col_len,
+                                              const int32_t rows,
+                                              const q15_t *bias,
+                                              const uint16_t bias_shift,
+                                              const uint16_t out_shift,
+                                              q15_t *pOut,
+                                              const uint16_t ch_im_out,
+                                              const int32_t relu)
+{
+    const q15_t *col2 = col + col_len;
+    int32x4_t acc[4][2];
+    q31_t sum[4][2];
+    int32_t r, k;
+
+    for (r = 0; r < rows; r++)
+    {
+        acc[r][0] = vdupq_n_s32(0);
+        acc[r][1] = vdupq_n_s32(0);
+    }
+
+    for (k = 0; k + 8 <= col_len; k += 8)
+    {
+        const int16x8_t in1 = vld1q_s16(col + k);
+        const int16x8_t in2 = vld1q_s16(col2 + k);
+        for (r = 0; r < rows; r++)
+        {
+            const int16x8_t w = vld1q_s16(wt + r * col_len + k);
+            acc[r][0] = vmlal_s16(acc[r][0], vget_low_s16(w), vget_low_s16(in1));
+            acc[r][0] = vmlal_s16(acc[r][0], vget_high_s16(w), vget_high_s16(in1));
+            acc[r][1] = vmlal_s16(acc[r][1], vget_low_s16(w), vget_low_s16(in2));
+            acc[r][1] = vmlal_s16(acc[r][1], vget_high_s16(w), vget_high_s16(in2));
+        }
+    }
+
+    for (r = 0; r < rows; r++)
+    {
+        const q31_t init = ((q31_t)bias[r] << bias_shift) + NN_ROUND(out_shift);
+        sum[r][0] = (q31_t)((uint32_t)init + (uint32_t)arm_nn_conv_q15_neon_hsum(acc[r][0]));
+        sum[r][1] = (q31_t)((uint32_t)init + (uint32_t)arm_nn_conv_q15_neon_hsum(acc[r][1]));
+    }
+
+    /* left-over of the columns */
+    for (; k < col_len; k++)
+    {
+        for (r = 0; r < rows; r++)
+        {
+            sum[r][0] = (q31_t)((uint32_t)sum[r][0] + (uint32_t)(wt[r * col_len + k] * col[k]));
+            sum[r][1] = (q31_t)((uint32_t)sum[r][1] + (uint32_t)(wt[r * col_len + k] * col2[k]));
+        }
+    }
+
+    for (r = 0; r < rows; r++)
+    {
+        pOut[r] = arm_nn_sat_q15(sum[r][0] >> out_shift, relu);
+        pOut[ch_im_out + r] = arm_nn_sat_q15(sum[r][1] >> out_shift, relu);
+    }
+}
+
+#endif /* ARM_MATH_NEON */
+
+/* arm_convolve_HWC_q15_fast_nonsquare() and arm_convolve_HWC_q15_fast_nonsquare_relu(), which
+ * only differ in the output saturation */
+static arm_status arm_nn_convolve_HWC_q15_fast_nonsquare(const q15_t *Im_in,
+                                                         const uint16_t dim_im_in_x,
+                                                         const uint16_t dim_im_in_y,
+                                                         const uint16_t ch_im_in,
+                                                         const q15_t *wt,
+                                                         const uint16_t ch_im_out,
+                                                         const uint16_t dim_kernel_x,
+                                                         const uint16_t dim_kernel_y,
+                                                         const uint16_t padding_x,
+                                                         const uint16_t padding_y,
+                                                         const uint16_t stride_x,
+                                                         const uint16_t stride_y,
+                                                         const q15_t *bias,
+                                                         const uint16_t bias_shift,
+                                                         const uint16_t out_shift,
+                                                         q15_t *Im_out,
+                                                         const uint16_t dim_im_out_x,
+                                                         const uint16_t dim_im_out_y,
+                                                         q15_t *bufferA,
+                                                         q7_t *bufferB,
+                                                         const int32_t relu)
 {
     (void)bufferB;
-#if defined(ARM_MATH_DSP) && !defined(ARM_MATH_MVEI)
+
+    if (dim_im_in_y == 1 && dim_kernel_y == 1 && padding_y == 0 && dim_im_out_y == 1)
+    {
+        /* 1-D layer: the filters run straight over the input row, no im2col and no channel constraint */
+        return (relu ? arm_convolve_1_x_n_HWC_q15_relu : arm_convolve_1_x_n_HWC_q15)(
+            Im_in, dim_im_in_x, dim_im_in_y, ch_im_in, wt, ch_im_out, dim_kernel_x, dim_kernel_y, padding_x, padding_y,
+            stride_x, stride_y, bias, bias_shift, out_shift, Im_out, dim_im_out_x, dim_im_out_y, bufferA, bufferB);
+    }
+
+#if defined(ARM_MATH_NEON)
+    /* Run the following code for Cortex-A with NEON */
+    const int32_t col_len = ch_im_in * dim_kernel_y * dim_kernel_x;
+    int16_t i_out_y, i_out_x;
+    q15_t *pOut = Im_out;
+
+    if (ch_im_in % 2 != 0 || ch_im_out % 2 != 0)
+    {
+        /* check if the input dimension meets the constraints */
+        return ARM_MATH_SIZE_MISMATCH;
+    }
+
+    for (i_out_y = 0; i_out_y < dim_im_out_y; i_out_y++)
+    {
+        /* pixel pairs as in the DSP path below, a trailing odd pixel is not computed */
+        for (i_out_x = 1; i_out_x < dim_im_out_x; i_out_x += 2)
+        {
+            const int32_t y0 = i_out_y * stride_y - padding_y;
+            q15_t *pBuffer = bufferA;
+            int i;
+
+            pBuffer = arm_nn_conv_q15_neon_im2col(Im_in, dim_im_in_x, dim_im_in_y, ch_im_in, dim_kernel_x, dim_kernel_y,
+                                                  (i_out_x - 1) * stride_x - padding_x, y0, pBuffer);
+            arm_nn_conv_q15_neon_im2col(Im_in, dim_im_in_x, dim_im_in_y, ch_im_in, dim_kernel_x, dim_kernel_y,
+                                        i_out_x * stride_x - padding_x, y0, pBuffer);
+
+            /* four filters at a time, then the last pair when ch_im_out is not a multiple of 4 */
+            for (i = 0; i + 4 <= ch_im_out; i += 4)
+            {
+                arm_nn_conv_q15_neon_block(wt + i * col_len, bufferA, col_len, 4, bias + i, bias_shift, out_shift, pOut + i, ch_im_out, relu);
+            }
+            if (i < ch_im_out)
+            {
+                arm_nn_conv_q15_neon_block(wt + i * col_len, bufferA, col_len, 2, bias + i, bias_shift, out_shift, pOut + i, ch_im_out, relu);
+            }
+
+            pOut += 2 * ch_im_out;
+        }
+    }
+
+#elif defined(ARM_NN_X86)
+    /* Run the following code for x86 hosts with SSE4.1 or AVX2 */
+    const int32_t col_len = ch_im_in * dim_kernel_y * dim_kernel_x;
+    int16_t i_out_y, i_out_x, i_ker_y, i_ker_x, i_px;
+    q15_t *pOut = Im_out;
+    int32_t i, r;
+
+    if (ch_im_in % 2 != 0 || ch_im_out % 2 != 0)
+    {
+        /* check if the input dimension meets the constraints */
+        return ARM_MATH_SIZE_MISMATCH;
+    }
+
+    for (i_out_y = 0; i_out_y < dim_im_out_y; i_out_y++)
+    {
+        /* pixel pairs as in the DSP path below, a trailing odd pixel is not computed */
+        for (i_out_x = 1; i_out_x < dim_im_out_x; i_out_x += 2)
+        {
+            q15_t *pBuffer = bufferA;
+
+            for (i_px = i_out_x - 1; i_px <= i_out_x; i_px++)
+            {
+                for (i_ker_y = i_out_y * stride_y - padding_y; i_ker_y < i_out_y * stride_y - padding_y + dim_kernel_y; i_ker_y++)
+                {
+                    for (i_ker_x = i_px * stride_x - padding_x; i_ker_x < i_px * stride_x - padding_x + dim_kernel_x; i_ker_x++)
+                    {
+                        if (i_ker_y < 0 || i_ker_y >= dim_im_in_y || i_ker_x < 0 || i_ker_x >= dim_im_in_x)
+                        {
+                            memset(pBuffer, 0, sizeof(q15_t) * ch_im_in);
+                        }
+                        else
+                        {
+                            memcpy(pBuffer, Im_in + (i_ker_y * dim_im_in_x + i_ker_x) * ch_im_in, sizeof(q15_t) * ch_im_in);
+                        }
+                        pBuffer += ch_im_in;
+                    }
+                }
+            }
+
+            /* four filters at a time on both columns */
+            for (i = 0; i < ch_im_out; i += 4)
+            {
+                const int32_t rows = ch_im_out - i < 4 ? ch_im_out - i : 4;
+                q31_t sum[4][2];
+
+                for (r = 0; r < rows; r++)
+                {
+                    sum[r][0] = ((q31_t)bias[i + r] << bias_shift) + NN_ROUND(out_shift);
+                    sum[r][1] = sum[r][0];
+                }
+                arm_nn_x86_dot_q15(wt + i * col_len, col_len, bufferA, bufferA + col_len, col_len, rows, sum);
+                for (r = 0; r < rows; r++)
+                {
+                    pOut[i + r] = arm_nn_sat_q15(sum[r][0] >> out_shift, relu);
+                    pOut[ch_im_out + i + r] = arm_nn_sat_q15(sum[r][1] >> out_shift, relu);
+                }
+            }
+            pOut += 2 * ch_im_out;
+        }
+    }
+
+#elif defined(ARM_MATH_DSP) && !defined(ARM_MATH_MVEI)
     int16_t i_out_y, i_out_x, i_ker_y, i_ker_x;
 
     q15_t *pBuffer = bufferA;
@@ -201,10 +409,10 @@ arm_status arm_convolve_HWC_q15_fast_nonsquare(const q15_t *Im_in,
                         sum4 += inA2 * inB2;
                         colCnt--;
                     } /* while over colCnt */
-                    *pOut++ = (q15_t)__SSAT(sum >> out_shift, 16);
-                    *pOut++ = (q15_t)__SSAT(sum3 >> out_shift, 16);
-                    *pOut2++ = (q15_t)__SSAT(sum2 >> out_shift, 16);
-                    *pOut2++ = (q15_t)__SSAT(sum4 >> out_shift, 16);
+                    *pOut++ = arm_nn_sat_q15(sum >> out_shift, relu);
+                    *pOut++ = arm_nn_sat_q15(sum3 >> out_shift, relu);
+                    *pOut2++ = arm_nn_sat_q15(sum2 >> out_shift, relu);
+                    *pOut2++ = arm_nn_sat_q15(sum4 >> out_shift, relu);
 
                     /* skip the row computed with A2 */
                     pA += ch_im_in * dim_kernel_y * dim_kernel_x;
@@ -254,7 +462,7 @@ arm_status arm_convolve_HWC_q15_fast_nonsquare(const q15_t *Im_in,
                         }
                     }
                 }
-                Im_out[i + (j * dim_im_out_x + k) * ch_im_out] = (q15_t)__SSAT((conv_out >> out_shift), 16);
+                Im_out[i + (j * dim_im_out_x + k) * ch_im_out] = arm_nn_sat_q15(conv_out >> out_shift, relu);
             }
         }
     }
@@ -265,6 +473,137 @@ arm_status arm_convolve_HWC_q15_fast_nonsquare(const q15_t *Im_in,
     return ARM_MATH_SUCCESS;
 }
 
+/**
+ * @brief Fast Q15 convolution function (non-sqaure shape)
+ * @param[in]       Im_in        pointer to input tensor
+ * @param[in]       dim_im_in_x  input tensor dimention x
+ * @param[in]       dim_im_in_y  input tensor dimention y
+ * @param[in]       ch_im_in     number of input tensor channels
+ * @param[in]       wt           pointer to kernel weights
+ * @param[in]       ch_im_out    number of filters, i.e., output tensor channels
+ * @param[in]       dim_kernel_x filter kernel size x
+ * @param[in]       dim_kernel_y filter kernel size y
+ * @param[in]       padding_x    padding size x
+ * @param[in]       padding_y    padding size y
+ * @param[in]       stride_x     convolution stride x
+ * @param[in]       stride_y     convolution stride y
+ * @param[in]       bias         pointer to bias
+ * @param[in]       bias_shift   amount of left-shift for bias
+ * @param[in]       out_shift    amount of right-shift for output
+ * @param[in,out]   Im_out       pointer to output tensor
+ * @param[in]       dim_im_out_x output tensor dimension x
+ * @param[in]       dim_im_out_y output tensor dimension y
+ * @param[in,out]   bufferA      pointer to buffer space for input
+ * @param[in,out]   bufferB      pointer to buffer space for output
+ * @return     The function returns either
+ * <code>ARM_MATH_SIZE_MISMATCH</code> or <code>ARM_MATH_SUCCESS</code> based on the outcome of size checking.
+ *
+ * @details
+ *
+ * <b>Buffer size:</b>
+ *
+ * bufferA size: 2*ch_im_in*dim_kernel*dim_kernel
+ *
+ * bufferB size: 0
+ *
+ * <b>Input dimension constraints:</b>
+ *
+ * ch_im_in is multiple of 2
+ *
+ * ch_im_out is multiple of 2
+ *
+ * 1-D layers (dim_im_in_y, dim_kernel_y and dim_im_out_y 1, no padding_y) go to
+ * arm_convolve_1_x_n_HWC_q15(), which takes any channel counts and also computes a trailing odd
+ * output pixel.
+ *
+ */
+
+arm_status arm_convolve_HWC_q15_fast_nonsquare(const q15_t *Im_in,
+                                               const uint16_t dim_im_in_x,
+                                               const uint16_t dim_im_in_y,
+                                               const uint16_t ch_im_in,
+                                               const q15_t *wt,
+                                               const uint16_t ch_im_out,
+                                               const uint16_t dim_kernel_x,
+                                               const uint16_t dim_kernel_y,
+                                               const uint16_t padding_x,
+                                               const uint16_t padding_y,
+                                               const uint16_t stride_x,
+                                               const uint16_t stride_y,
+                                               const q15_t *bias,
+                                               const uint16_t bias_shift,
+                                               const uint16_t out_shift,
+                                               q15_t *Im_out,
+                                               const uint16_t dim_im_out_x,
+                                               const uint16_t dim_im_out_y,
+                                               q15_t *bufferA,
+                                               q7_t *bufferB)
+{
+    return arm_nn_convolve_HWC_q15_fast_nonsquare(Im_in, dim_im_in_x, dim_im_in_y, ch_im_in, wt, ch_im_out,
+                                                  dim_kernel_x, dim_kernel_y, padding_x, padding_y, stride_x, stride_y,
+                                                  bias, bias_shift, out_shift, Im_out, dim_im_out_x, dim_im_out_y,
+                                                  bufferA, bufferB, 0);
+}
+
+/**
+ * @brief Fast Q15 convolution function (non-sqaure shape) followed by a ReLU
+ * @param[in]       Im_in        pointer to input tensor
+ * @param[in]       dim_im_in_x  input tensor dimention x
+ * @param[in]       dim_im_in_y  input tensor dimention y
+ * @param[in]       ch_im_in     number of input tensor channels
+ * @param[in]       wt           pointer to kernel weights
+ * @param[in]       ch_im_out    number of filters, i.e., output tensor channels
+ * @param[in]       dim_kernel_x filter kernel size x
+ * @param[in]       dim_kernel_y filter kernel size y
+ * @param[in]       padding_x    padding size x
+ * @param[in]       padding_y    padding size y
+ * @param[in]       stride_x     convolution stride x
+ * @param[in]       stride_y     convolution stride y
+ * @param[in]       bias         pointer to bias
+ * @param[in]       bias_shift   amount of left-shift for bias
+ * @param[in]       out_shift    amount of right-shift for output
+ * @param[in,out]   Im_out       pointer to output tensor
+ * @param[in]       dim_im_out_x output tensor dimension x
+ * @param[in]       dim_im_out_y output tensor dimension y
+ * @param[in,out]   bufferA      pointer to buffer space for input
+ * @param[in,out]   bufferB      pointer to buffer space for output
+ * @return     The function returns either
+ * <code>ARM_MATH_SIZE_MISMATCH</code> or <code>ARM_MATH_SUCCESS</code> based on the outcome of size checking.
+ *
+ * @details
+ *
+ * Same results as arm_convolve_HWC_q15_fast_nonsquare() followed by arm_relu_q15() on Im_out,
+ * the ReLU being applied when each output is saturated instead of in a second pass over Im_out.
+ *
+ */
+
+arm_status arm_convolve_HWC_q15_fast_nonsquare_relu(const q15_t *Im_in,
+                                                    const uint16_t dim_im_in_x,
+                                                    const uint16_t dim_im_in_y,
+                                                    const uint16_t ch_im_in,
+                                                    const q15_t *wt,
+                                                    const uint16_t ch_im_out,
+                                                    const uint16_t dim_kernel_x,
+                                                    const uint16_t dim_kernel_y,
+                                                    const uint16_t padding_x,
+                                                    const uint16_t padding_y,
+                                                    const uint16_t stride_x,
+                                                    const uint16_t stride_y,
+                                                    const q15_t *bias,
+                                                    const uint16_t bias_shift,
+                                                    const uint16_t out_shift,
+                                                    q15_t *Im_out,
+                                                    const uint16_t dim_im_out_x,
+                                                    const uint16_t dim_im_out_y,
+                                                    q15_t *bufferA,
+                                                    q7_t *bufferB)
+{
+    return arm_nn_convolve_HWC_q15_fast_nonsquare(Im_in, dim_im_in_x, dim_im_in_y, ch_im_in, wt, ch_im_out,
+                                                  dim_kernel_x, dim_kernel_y, padding_x, padding_y, stride_x, stride_y,
+                                                  bias, bias_shift, out_shift, Im_out, dim_im_out_x, dim_im_out_y,
+                                                  bufferA, bufferB, 1);
+}
+
 /**
  * @} end of NNConv group
  */
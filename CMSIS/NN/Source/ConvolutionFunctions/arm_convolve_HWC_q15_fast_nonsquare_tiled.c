@@ -0,0 +1,412 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS NN Library
+ * Title:        arm_convolve_HWC_q15_fast_nonsquare_tiled.c
+ * Description:  Q15 im2col convolution tiled for the L1 data cache
+ *
+ * Target Processor:  Cortex-A9 (ARMv7-A with DSP extension and NEON)
+ *
+ * -------------------------------------------------------------------- */
+
+#include "arm_nnfunctions.h"
+#include "arm_nnsupportfunctions.h"
+
+/**
+ *  @ingroup groupNN
+ */
+
+/**
+ * @addtogroup NNConv
+ * @{
+ */
+
+/*
+ * Dot products of `rows` (1 to 4) filter slices with one or two column slices of `len` values,
+ * added to sum[r][0] and sum[r][1] with 32-bit wrap-around like the __SMLAD accumulation, so the
+ * partial sums of the depth tiles add up to the same totals. sum[r][1] is meaningless when col2
+ * is NULL.
+ */
+static inline void arm_nn_conv_q15_tile_dot(const q15_t *wt,
+                                            const int32_t wt_stride,
+                                            const q15_t *col,
+                                            const q15_t *col2,
+                                            const int32_t len,
+                                            const int32_t rows,
+                                            q31_t sum[4][2])
+{
+    int32_t r, k = 0;
+
+#if defined(ARM_MATH_NEON)
+    {
+        int32x4_t acc[4][2];
+        for (r = 0; r < rows; r++)
+        {
+            acc[r][0] = vdupq_n_s32(0);
+            acc[r][1] = vdupq_n_s32(0);
+        }
+        for (; k + 8 <= len; k += 8)
+        {
+            const int16x8_t in1 = vld1q_s16(col + k);
+            const int16x8_t in2 = col2 ? vld1q_s16(col2 + k) : in1;
+            for (r = 0; r < rows; r++)
+            {
+                const int16x8_t w = vld1q_s16(wt + r * wt_stride + k);
+                acc[r][0] = vmlal_s16(acc[r][0], vget_low_s16(w), vget_low_s16(in1));
+                acc[r][0] = vmlal_s16(acc[r][0], vget_high_s16(w), vget_high_s16(in1));
+                acc[r][1] = vmlal_s16(acc[r][1], vget_low_s16(w), vget_low_s16(in2));
+                acc[r][1] = vmlal_s16(acc[r][1], vget_high_s16(w), vget_high_s16(in2));
+            }
+        }
+        for (r = 0; r < rows; r++)
+        {
+            int32x2_t s = vpadd_s32(vget_low_s32(acc[r][0]), vget_high_s32(acc[r][0]));
+            int32x2_t s2 = vpadd_s32(vget_low_s32(acc[r][1]), vget_high_s32(acc[r][1]));
+            s = vpadd_s32(s, s2);
+            sum[r][0] = (q31_t)((uint32_t)sum[r][0] + (uint32_t)vget_lane_s32(s, 0));
+            sum[r][1] = (q31_t)((uint32_t)sum[r][1] + (uint32_t)vget_lane_s32(s, 1));
+        }
+    }
+#elif defined(ARM_NN_X86)
+    arm_nn_x86_dot_q15(wt, wt_stride, col, col2, len, rows, sum);
+    k = len;
+#elif defined(ARM_MATH_DSP) && !defined(ARM_MATH_MVEI)
+    for (; k + 2 <= len; k += 2)
+    {
+        const q31_t in1 = arm_nn_read_q15x2(col + k);
+        const q31_t in2 = col2 ? arm_nn_read_q15x2(col2 + k) : in1;
+        for (r = 0; r < rows; r++)
+        {
+            const q31_t w = arm_nn_read_q15x2(wt + r * wt_stride + k);
+            sum[r][0] = __SMLAD(w, in1, sum[r][0]);
+            sum[r][1] = __SMLAD(w, in2, sum[r][1]);
+        }
+    }
+#endif
+
+    /* left-over of the slices */
+    for (; k < len; k++)
+    {
+        for (r = 0; r < rows; r++)
+        {
+            sum[r][0] = (q31_t)((uint32_t)sum[r][0] + (uint32_t)(wt[r * wt_stride + k] * col[k]));
+            if (col2)
+            {
+                sum[r][1] = (q31_t)((uint32_t)sum[r][1] + (uint32_t)(wt[r * wt_stride + k] * col2[k]));
+            }
+        }
+    }
+}
+
+/* im2col column of the output pixel whose window starts at (x0, y0), the taps outside the input
+ * being zero. In HWC layout the taps of a kernel row inside the input are one contiguous run. */
+static void arm_nn_conv_q15_tile_im2col(const q15_t *Im_in,
+                                        const int32_t dim_im_in_x,
+                                        const int32_t dim_im_in_y,
+                                        const int32_t ch_im_in,
+                                        const int32_t dim_kernel_x,
+                                        const int32_t dim_kernel_y,
+                                        const int32_t x0,
+                                        const int32_t y0,
+                                        q15_t *col)
+{
+    const int32_t row_len = ch_im_in * dim_kernel_x;
+    int32_t first = x0 < 0 ? -x0 : 0;
+    int32_t last = x0 + dim_kernel_x > dim_im_in_x ? dim_im_in_x - x0 : dim_kernel_x;
+    int32_t i_ker_y;
+
+    if (first > dim_kernel_x)
+    {
+        first = dim_kernel_x;
+    }
+    if (last < first)
+    {
+        last = first;
+    }
+
+    for (i_ker_y = y0; i_ker_y < y0 + dim_kernel_y; i_ker_y++, col += row_len)
+    {
+        if (i_ker_y < 0 || i_ker_y >= dim_im_in_y || last == first)
+        {
+            memset(col, 0, sizeof(q15_t) * row_len);
+            continue;
+        }
+        memset(col, 0, sizeof(q15_t) * ch_im_in * first);
+        memcpy(col + ch_im_in * first, Im_in + (i_ker_y * dim_im_in_x + x0 + first) * ch_im_in,
+               sizeof(q15_t) * ch_im_in * (last - first));
+        memset(col + ch_im_in * last, 0, sizeof(q15_t) * ch_im_in * (dim_kernel_x - last));
+    }
+}
+
+/* arm_convolve_HWC_q15_fast_nonsquare_tiled() and arm_convolve_HWC_q15_fast_nonsquare_tiled_relu(),
+ * which only differ in the output saturation */
+static arm_status arm_nn_convolve_HWC_q15_fast_nonsquare_tiled(const q15_t *Im_in,
+                                                               const uint16_t dim_im_in_x,
+                                                               const uint16_t dim_im_in_y,
+                                                               const uint16_t ch_im_in,
+                                                               const q15_t *wt,
+                                                               const uint16_t ch_im_out,
+                                                               const uint16_t dim_kernel_x,
+                                                               const uint16_t dim_kernel_y,
+                                                               const uint16_t padding_x,
+                                                               const uint16_t padding_y,
+                                                               const uint16_t stride_x,
+                                                               const uint16_t stride_y,
+                                                               const q15_t *bias,
+                                                               const uint16_t bias_shift,
+                                                               const uint16_t out_shift,
+                                                               q15_t *Im_out,
+                                                               const uint16_t dim_im_out_x,
+                                                               const uint16_t dim_im_out_y,
+                                                               q15_t *bufferA,
+                                                               q7_t *bufferB,
+                                                               const int32_t relu)
+{
+    if (dim_im_in_y == 1 && dim_kernel_y == 1 && padding_y == 0 && dim_im_out_y == 1)
+    {
+        /* 1-D layer: the filters run straight over the input row, no im2col */
+        return (relu ? arm_convolve_1_x_n_HWC_q15_relu : arm_convolve_1_x_n_HWC_q15)(
+            Im_in, dim_im_in_x, dim_im_in_y, ch_im_in, wt, ch_im_out, dim_kernel_x, dim_kernel_y, padding_x, padding_y,
+            stride_x, stride_y, bias, bias_shift, out_shift, Im_out, dim_im_out_x, dim_im_out_y, bufferA, bufferB);
+    }
+
+    (void)bufferB;
+
+    const int32_t col_len = ch_im_in * dim_kernel_x * dim_kernel_y;
+    const int32_t tile_depth = ARM_NN_CONV_Q15_TILE_DEPTH(col_len);
+    const int32_t tile_ch = ARM_NN_CONV_Q15_TILE_CH(col_len, ch_im_out);
+    const int32_t tile_pixels = ARM_NN_CONV_Q15_TILE_PIXELS(col_len);
+    const int32_t pixels = dim_im_out_x * dim_im_out_y;
+    /* partial sums of the pixel group for one tile of filters, behind the columns */
+    q31_t *partial = (q31_t *)(bufferA + tile_pixels * col_len);
+    int32_t p0;
+
+    for (p0 = 0; p0 < pixels; p0 += tile_pixels)
+    {
+        const int32_t count = MIN(tile_pixels, pixels - p0);
+        int32_t p, c0;
+
+        /* columns of the whole group, built once for all the tiles */
+        for (p = 0; p < count; p++)
+        {
+            const int32_t i_out_y = (p0 + p) / dim_im_out_x;
+            const int32_t i_out_x = (p0 + p) % dim_im_out_x;
+            arm_nn_conv_q15_tile_im2col(Im_in, dim_im_in_x, dim_im_in_y, ch_im_in, dim_kernel_x, dim_kernel_y,
+                                        i_out_x * stride_x - padding_x, i_out_y * stride_y - padding_y,
+                                        bufferA + p * col_len);
+        }
+
+        for (c0 = 0; c0 < ch_im_out; c0 += tile_ch)
+        {
+            const int32_t c1 = MIN(ch_im_out, c0 + tile_ch);
+            int32_t k0;
+
+            /* the tile of filters stays in L1 while every column pair of the group goes by */
+            for (k0 = 0; k0 < col_len; k0 += tile_depth)
+            {
+                const int32_t len = MIN(tile_depth, col_len - k0);
+                const int32_t first = k0 == 0;
+                const int32_t last = k0 + len == col_len;
+
+                for (p = 0; p < count; p += 2)
+                {
+                    const q15_t *col = bufferA + p * col_len + k0;
+                    const q15_t *col2 = p + 1 < count ? col + col_len : NULL;
+                    q31_t *part = partial + p * tile_ch;
+                    q15_t *pOut = Im_out + (p0 + p) * ch_im_out;
+                    int32_t c, r;
+
+                    for (c = c0; c < c1; c += 4)
+                    {
+                        const int32_t rows = MIN(4, c1 - c);
+                        q31_t sum[4][2];
+
+                        for (r = 0; r < rows; r++)
+                        {
+                            if (first)
+                            {
+                                sum[r][0] = ((q31_t)bias[c + r] << bias_shift) + NN_ROUND(out_shift);
+                                sum[r][1] = sum[r][0];
+                            }
+                            else
+                            {
+                                sum[r][0] = part[c - c0 + r];
+                                sum[r][1] = part[tile_ch + c - c0 + r];
+                            }
+                        }
+
+                        arm_nn_conv_q15_tile_dot(wt + c * col_len + k0, col_len, col, col2, len, rows, sum);
+
+                        for (r = 0; r < rows; r++)
+                        {
+                            if (last)
+                            {
+                                pOut[c + r] = arm_nn_sat_q15(sum[r][0] >> out_shift, relu);
+                                if (col2)
+                                {
+                                    pOut[ch_im_out + c + r] = arm_nn_sat_q15(sum[r][1] >> out_shift, relu);
+                                }
+                            }
+                            else
+                            {
+                                part[c - c0 + r] = sum[r][0];
+                                part[tile_ch + c - c0 + r] = sum[r][1];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    /* Return to application */
+    return ARM_MATH_SUCCESS;
+}
+
+/**
+ * @brief Fast Q15 convolution function (non-square shape) tiled for the L1 data cache
+ * @param[in]       Im_in        pointer to input tensor
+ * @param[in]       dim_im_in_x  input tensor dimension x
+ * @param[in]       dim_im_in_y  input tensor dimension y
+ * @param[in]       ch_im_in     number of input tensor channels
+ * @param[in]       wt           pointer to kernel weights
+ * @param[in]       ch_im_out    number of filters, i.e., output tensor channels
+ * @param[in]       dim_kernel_x filter kernel size x
+ * @param[in]       dim_kernel_y filter kernel size y
+ * @param[in]       padding_x    padding size x
+ * @param[in]       padding_y    padding size y
+ * @param[in]       stride_x     convolution stride x
+ * @param[in]       stride_y     convolution stride y
+ * @param[in]       bias         pointer to bias
+ * @param[in]       bias_shift   amount of left-shift for bias
+ * @param[in]       out_shift    amount of right-shift for output
+ * @param[in,out]   Im_out       pointer to output tensor
+ * @param[in]       dim_im_out_x output tensor dimension x
+ * @param[in]       dim_im_out_y output tensor dimension y
+ * @param[in,out]   bufferA      pointer to buffer space for input, 4-byte aligned
+ * @param[in,out]   bufferB      unused
+ * @return     The function returns <code>ARM_MATH_SUCCESS</code>
+ *
+ * @details
+ *
+ * Same results as arm_convolve_HWC_q15_basic_nonsquare(), computed the way of
+ * arm_convolve_HWC_q15_fast_nonsquare() but blocked for the L1 data cache. The im2col columns
+ * of a group of output pixels are built once, then each tile of filters, cut in depth slices
+ * when the columns are long, goes over the whole group while it stays in L1, the partial sums
+ * of the slices being kept in bufferA. Tile sizes are the ARM_NN_CONV_Q15_TILE_* of the layer
+ * shape for ARM_NN_L1_TILE_BYTES. Layers one row high go to arm_convolve_1_x_n_HWC_q15().
+ *
+ * <b>Buffer size:</b>
+ *
+ * bufferA size: ARM_NN_CONV_Q15_TILED_BUFFER_SIZE(ch_im_in, dim_kernel_x, dim_kernel_y, ch_im_out)
+ *
+ * bufferB size: 0
+ *
+ * <b>Input dimension constraints:</b>
+ *
+ * none, unlike arm_convolve_HWC_q15_fast_nonsquare() every output pixel is computed
+ *
+ */
+
+arm_status arm_convolve_HWC_q15_fast_nonsquare_tiled(const q15_t *Im_in,
+                                                     const uint16_t dim_im_in_x,
+                                                     const uint16_t dim_im_in_y,
+                                                     const uint16_t ch_im_in,
+                                                     const q15_t *wt,
+                                                     const uint16_t ch_im_out,
+                                                     const uint16_t dim_kernel_x,
+                                                     const uint16_t dim_kernel_y,
+                                                     const uint16_t padding_x,
+                                                     const uint16_t padding_y,
+                                                     const uint16_t stride_x,
+                                                     const uint16_t stride_y,
+                                                     const q15_t *bias,
+                                                     const uint16_t bias_shift,
+                                                     const uint16_t out_shift,
+                                                     q15_t *Im_out,
+                                                     const uint16_t dim_im_out_x,
+                                                     const uint16_t dim_im_out_y,
+                                                     q15_t *bufferA,
+                                                     q7_t *bufferB)
+{
+    return arm_nn_convolve_HWC_q15_fast_nonsquare_tiled(Im_in, dim_im_in_x, dim_im_in_y, ch_im_in, wt, ch_im_out,
+                                                        dim_kernel_x, dim_kernel_y, padding_x, padding_y, stride_x,
+                                                        stride_y, bias, bias_shift, out_shift, Im_out, dim_im_out_x,
+                                                        dim_im_out_y, bufferA, bufferB, 0);
+}
+
+/**
+ * @brief Fast Q15 convolution function (non-square shape) tiled for the L1 data cache followed by a ReLU
+ * @param[in]       Im_in        pointer to input tensor
+ * @param[in]       dim_im_in_x  input tensor dimension x
+ * @param[in]       dim_im_in_y  input tensor dimension y
+ * @param[in]       ch_im_in     number of input tensor channels
+ * @param[in]       wt           pointer to kernel weights
+ * @param[in]       ch_im_out    number of filters, i.e., output tensor channels
+ * @param[in]       dim_kernel_x filter kernel size x
+ * @param[in]       dim_kernel_y filter kernel size y
+ * @param[in]       padding_x    padding size x
+ * @param[in]       padding_y    padding size y
+ * @param[in]       stride_x     convolution stride x
+ * @param[in]       stride_y     convolution stride y
+ * @param[in]       bias         pointer to bias
+ * @param[in]       bias_shift   amount of left-shift for bias
+ * @param[in]       out_shift    amount of right-shift for output
+ * @param[in,out]   Im_out       pointer to output tensor
+ * @param[in]       dim_im_out_x output tensor dimension x
+ * @param[in]       dim_im_out_y output tensor dimension y
+ * @param[in,out]   bufferA      pointer to buffer space for input, 4-byte aligned
+ * @param[in,out]   bufferB      unused
+ * @return     The function returns <code>ARM_MATH_SUCCESS</code>
+ *
+ * @details
+ *
+ * Same results as arm_convolve_HWC_q15_fast_nonsquare_tiled() followed by arm_relu_q15() on
+ * Im_out, the ReLU being applied when each output is saturated.
+ *
+ */
+
+arm_status arm_convolve_HWC_q15_fast_nonsquare_tiled_relu(const q15_t *Im_in,
+                                                          const uint16_t dim_im_in_x,
+                                                          const uint16_t dim_im_in_y,
+                                                          const uint16_t ch_im_in,
+                                                          const q15_t *wt,
+                                                          const uint16_t ch_im_out,
+                                                          const uint16_t dim_kernel_x,
+                                                          const uint16_t dim_kernel_y,
+                                                          const uint16_t padding_x,
+                                                          const uint16_t padding_y,
+                                                          const uint16_t stride_x,
+                                                          const uint16_t stride_y,
+                                                          const q15_t *bias,
+                                                          const uint16_t bias_shift,
+                                                          const uint16_t out_shift,
+                                                          q15_t *Im_out,
+                                                          const uint16_t dim_im_out_x,
+                                                          const uint16_t dim_im_out_y,
+                                                          q15_t *bufferA,
+                                                          q7_t *bufferB)
+{
+    return arm_nn_convolve_HWC_q15_fast_nonsquare_tiled(Im_in, dim_im_in_x, dim_im_in_y, ch_im_in, wt, ch_im_out,
+                                                        dim_kernel_x, dim_kernel_y, padding_x, padding_y, stride_x,
+                                                        stride_y, bias, bias_shift, out_shift, Im_out, dim_im_out_x,
+                                                        dim_im_out_y, bufferA, bufferB, 1);
+}
+
+/**
+ * @} end of NNConv group
+ */
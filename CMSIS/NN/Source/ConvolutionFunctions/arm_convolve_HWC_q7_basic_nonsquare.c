@@ -0,0 +1,229 @@
+/*
+ * Copyright (C) 2010-2021 Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS NN Library
+ * Title:        arm_convolve_HWC_q7_basic_nonsquare.c
+ * Description:  Q7 version of convolution (non-square shape)
+ *
+ * Target Processor:  Cortex-A9 (ARMv7-A with DSP extension and NEON)
+ *
+ * -------------------------------------------------------------------- */
+
+#include "arm_nnfunctions.h"
+#include "arm_nnsupportfunctions.h"
+
+/**
+ *  @ingroup groupNN
+ */
+
+/**
+ * @addtogroup NNConv
+ * @{
+ */
+
+/* arm_convolve_HWC_q7_basic_nonsquare() and arm_convolve_HWC_q7_basic_nonsquare_relu(), which
+ * only differ in the output saturation */
+static arm_status arm_nn_convolve_HWC_q7_basic_nonsquare(const q7_t *Im_in,
+                                                         const uint16_t dim_im_in_x,
+                                                         const uint16_t dim_im_in_y,
+                                                         const uint16_t ch_im_in,
+                                                         const q7_t *wt,
+                                                         const uint16_t ch_im_out,
+                                                         const uint16_t dim_kernel_x,
+                                                         const uint16_t dim_kernel_y,
+                                                         const uint16_t padding_x,
+                                                         const uint16_t padding_y,
+                                                         const uint16_t stride_x,
+                                                         const uint16_t stride_y,
+                                                         const q7_t *bias,
+                                                         const uint16_t bias_shift,
+                                                         const uint16_t out_shift,
+                                                         q7_t *Im_out,
+                                                         const uint16_t dim_im_out_x,
+                                                         const uint16_t dim_im_out_y,
+                                                         q15_t *bufferA,
+                                                         q7_t *bufferB,
+                                                         const int32_t relu)
+{
+    (void)bufferB;
+
+    const int32_t col_len = ch_im_in * dim_kernel_x * dim_kernel_y;
+    q7_t *scratch = (q7_t *)bufferA;
+    int32_t i_out_y, i_out_x;
+
+    for (i_out_y = 0; i_out_y < dim_im_out_y; i_out_y++)
+    {
+        for (i_out_x = 0; i_out_x < dim_im_out_x; i_out_x++)
+        {
+            const q7_t *col = arm_nn_conv_q7_column(Im_in, dim_im_in_x, dim_im_in_y, ch_im_in, dim_kernel_x,
+                                                    dim_kernel_y, padding_x, padding_y, stride_x, stride_y, i_out_x,
+                                                    i_out_y, scratch);
+            q7_t *pOut = Im_out + (i_out_y * dim_im_out_x + i_out_x) * ch_im_out;
+            int32_t i, r;
+
+            /* four filters at a time against one load of the column */
+            for (i = 0; i < ch_im_out; i += 4)
+            {
+                const int32_t rows = MIN(4, ch_im_out - i);
+                q31_t sum[4][2];
+
+                for (r = 0; r < rows; r++)
+                {
+                    sum[r][0] = ((q31_t)bias[i + r] << bias_shift) + NN_ROUND(out_shift);
+                    sum[r][1] = 0;
+                }
+                arm_nn_dot_q7(wt + i * col_len, col_len, col, NULL, col_len, rows, sum);
+                for (r = 0; r < rows; r++)
+                {
+                    pOut[i + r] = arm_nn_sat_q7(sum[r][0] >> out_shift, relu);
+                }
+            }
+        }
+    }
+
+    /* Return to application */
+    return ARM_MATH_SUCCESS;
+}
+/**
+ * @brief Basic Q7 convolution function (non-square shape)
+ * @param[in]       Im_in        pointer to input tensor
+ * @param[in]       dim_im_in_x  input tensor dimension x
+ * @param[in]       dim_im_in_y  input tensor dimension y
+ * @param[in]       ch_im_in     number of input tensor channels
+ * @param[in]       wt           pointer to kernel weights
+ * @param[in]       ch_im_out    number of filters, i.e., output tensor channels
+ * @param[in]       dim_kernel_x filter kernel size x
+ * @param[in]       dim_kernel_y filter kernel size y
+ * @param[in]       padding_x    padding size x
+ * @param[in]       padding_y    padding size y
+ * @param[in]       stride_x     convolution stride x
+ * @param[in]       stride_y     convolution stride y
+ * @param[in]       bias         pointer to bias
+ * @param[in]       bias_shift   amount of left-shift for bias
+ * @param[in]       out_shift    amount of right-shift for output
+ * @param[in,out]   Im_out       pointer to output tensor
+ * @param[in]       dim_im_out_x output tensor dimension x
+ * @param[in]       dim_im_out_y output tensor dimension y
+ * @param[in,out]   bufferA      pointer to buffer space for input
+ * @param[in,out]   bufferB      unused
+ * @return     The function returns <code>ARM_MATH_SUCCESS</code>
+ *
+ * @details
+ *
+ * <b>Buffer size:</b>
+ *
+ * bufferA size: ch_im_in*dim_kernel_x*dim_kernel_y
+ *
+ * bufferB size: 0
+ *
+ * This basic version is designed to work for any input tensor and weight dimension. Each output
+ * pixel goes through its im2col column, read in place when the filters are one row high and the
+ * window lies inside the input, and four filters at a time through arm_nn_dot_q7(): 16 multiply
+ * accumulates per vmull_s8/vpadal pair with NEON, pmaddwd on x86 hosts (ARM_NN_X86), __SMLAD with
+ * the DSP extension, all with the same results.
+ */
+
+arm_status arm_convolve_HWC_q7_basic_nonsquare(const q7_t *Im_in,
+                                               const uint16_t dim_im_in_x,
+                                               const uint16_t dim_im_in_y,
+                                               const uint16_t ch_im_in,
+                                               const q7_t *wt,
+                                               const uint16_t ch_im_out,
+                                               const uint16_t dim_kernel_x,
+                                               const uint16_t dim_kernel_y,
+                                               const uint16_t padding_x,
+                                               const uint16_t padding_y,
+                                               const uint16_t stride_x,
+                                               const uint16_t stride_y,
+                                               const q7_t *bias,
+                                               const uint16_t bias_shift,
+                                               const uint16_t out_shift,
+                                               q7_t *Im_out,
+                                               const uint16_t dim_im_out_x,
+                                               const uint16_t dim_im_out_y,
+                                               q15_t *bufferA,
+                                               q7_t *bufferB)
+{
+    return arm_nn_convolve_HWC_q7_basic_nonsquare(Im_in, dim_im_in_x, dim_im_in_y, ch_im_in, wt, ch_im_out,
+                                                  dim_kernel_x, dim_kernel_y, padding_x, padding_y, stride_x, stride_y,
+                                                  bias, bias_shift, out_shift, Im_out, dim_im_out_x, dim_im_out_y,
+                                                  bufferA, bufferB, 0);
+}
+
+/**
+ * @brief Basic Q7 convolution function (non-square shape) followed by a ReLU
+ * @param[in]       Im_in        pointer to input tensor
+ * @param[in]       dim_im_in_x  input tensor dimension x
+ * @param[in]       dim_im_in_y  input tensor dimension y
+ * @param[in]       ch_im_in     number of input tensor channels
+ * @param[in]       wt           pointer to kernel weights
+ * @param[in]       ch_im_out    number of filters, i.e., output tensor channels
+ * @param[in]       dim_kernel_x filter kernel size x
+ * @param[in]       dim_kernel_y filter kernel size y
+ * @param[in]       padding_x    padding size x
+ * @param[in]       padding_y    padding size y
+ * @param[in]       stride_x     convolution stride x
+ * @param[in]       stride_y     convolution stride y
+ * @param[in]       bias         pointer to bias
+ * @param[in]       bias_shift   amount of left-shift for bias
+ * @param[in]       out_shift    amount of right-shift for output
+ * @param[in,out]   Im_out       pointer to output tensor
+ * @param[in]       dim_im_out_x output tensor dimension x
+ * @param[in]       dim_im_out_y output tensor dimension y
+ * @param[in,out]   bufferA      pointer to buffer space for input
+ * @param[in,out]   bufferB      unused
+ * @return     The function returns <code>ARM_MATH_SUCCESS</code>
+ *
+ * @details
+ *
+ * Same results as arm_convolve_HWC_q7_basic_nonsquare() followed by arm_relu_q7() on Im_out,
+ * the ReLU being applied when each output is saturated instead of in a second pass over Im_out.
+ *
+ */
+
+arm_status arm_convolve_HWC_q7_basic_nonsquare_relu(const q7_t *Im_in,
+                                                    const uint16_t dim_im_in_x,
+                                                    const uint16_t dim_im_in_y,
+                                                    const uint16_t ch_im_in,
+                                                    const q7_t *wt,
+                                                    const uint16_t ch_im_out,
+                                                    const uint16_t dim_kernel_x,
+                                                    const uint16_t dim_kernel_y,
+                                                    const uint16_t padding_x,
+                                                    const uint16_t padding_y,
+                                                    const uint16_t stride_x,
+                                                    const uint16_t stride_y,
+                                                    const q7_t *bias,
+                                                    const uint16_t bias_shift,
+                                                    const uint16_t out_shift,
+                                                    q7_t *Im_out,
+                                                    const uint16_t dim_im_out_x,
+                                                    const uint16_t dim_im_out_y,
+                                                    q15_t *bufferA,
+                                                    q7_t *bufferB)
+{
+    return arm_nn_convolve_HWC_q7_basic_nonsquare(Im_in, dim_im_in_x, dim_im_in_y, ch_im_in, wt, ch_im_out,
+                                                  dim_kernel_x, dim_kernel_y, padding_x, padding_y, stride_x, stride_y,
+                                                  bias, bias_shift, out_shift, Im_out, dim_im_out_x, dim_im_out_y,
+                                                  bufferA, bufferB, 1);
+}
+
+/**
+ * @} end of NNConv group
+ */
@@ -0,0 +1,251 @@
+/*
+ * Copyright (C) 2010-2021 Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS NN Library
+ * Title:        arm_convolve_HWC_q7_fast_nonsquare.c
+ * Description:  Fast Q7 version of convolution (non-square shape)
+ *
+ * Target Processor:  Cortex-A9 (ARMv7-A with DSP extension and NEON)
+ *
+ * -------------------------------------------------------------------- */
+
+#include "arm_nnfunctions.h"
+#include "arm_nnsupportfunctions.h"
+
+/**
+ *  @ingroup groupNN
+ */
+
+/**
+ * @addtogroup NNConv
+ * @{
+ */
+
+/* arm_convolve_HWC_q7_fast_nonsquare() and arm_convolve_HWC_q7_fast_nonsquare_relu(), which
+ * only differ in the output saturation */
+static arm_status arm_nn_convolve_HWC_q7_fast_nonsquare(const q7_t *Im_in,
+                                                        const uint16_t dim_im_in_x,
+                                                        const uint16_t dim_im_in_y,
+                                                        const uint16_t ch_im_in,
+                                                        const q7_t *wt,
+                                                        const uint16_t ch_im_out,
+                                                        const uint16_t dim_kernel_x,
+                                                        const uint16_t dim_kernel_y,
+                                                        const uint16_t padding_x,
+                                                        const uint16_t padding_y,
+                                                        const uint16_t stride_x,
+                                                        const uint16_t stride_y,
+                                                        const q7_t *bias,
+                                                        const uint16_t bias_shift,
+                                                        const uint16_t out_shift,
+                                                        q7_t *Im_out,
+                                                        const uint16_t dim_im_out_x,
+                                                        const uint16_t dim_im_out_y,
+                                                        q15_t *bufferA,
+                                                        q7_t *bufferB,
+                                                        const int32_t relu)
+{
+    (void)bufferB;
+
+    if (ch_im_in % 4 != 0 || ch_im_out % 2 != 0)
+    {
+        /* check if the input dimension meets the constraints */
+        return ARM_MATH_SIZE_MISMATCH;
+    }
+
+    const int32_t col_len = ch_im_in * dim_kernel_x * dim_kernel_y;
+    const int32_t pixels = dim_im_out_x * dim_im_out_y;
+    q7_t *scratch = (q7_t *)bufferA;
+    int32_t p;
+
+    /* two output pixels at a time, each load of the filters serving both columns */
+    for (p = 0; p < pixels; p += 2)
+    {
+        const q7_t *col = arm_nn_conv_q7_column(Im_in, dim_im_in_x, dim_im_in_y, ch_im_in, dim_kernel_x, dim_kernel_y,
+                                                padding_x, padding_y, stride_x, stride_y, p % dim_im_out_x,
+                                                p / dim_im_out_x, scratch);
+        const q7_t *col2 = NULL;
+        q7_t *pOut = Im_out + p * ch_im_out;
+        int32_t i, r;
+
+        if (p + 1 < pixels)
+        {
+            col2 = arm_nn_conv_q7_column(Im_in, dim_im_in_x, dim_im_in_y, ch_im_in, dim_kernel_x, dim_kernel_y,
+                                         padding_x, padding_y, stride_x, stride_y, (p + 1) % dim_im_out_x,
+                                         (p + 1) / dim_im_out_x, scratch + col_len);
+        }
+
+        for (i = 0; i < ch_im_out; i += 4)
+        {
+            const int32_t rows = MIN(4, ch_im_out - i);
+            q31_t sum[4][2];
+
+            for (r = 0; r < rows; r++)
+            {
+                sum[r][0] = ((q31_t)bias[i + r] << bias_shift) + NN_ROUND(out_shift);
+                sum[r][1] = sum[r][0];
+            }
+            arm_nn_dot_q7(wt + i * col_len, col_len, col, col2, col_len, rows, sum);
+            for (r = 0; r < rows; r++)
+            {
+                pOut[i + r] = arm_nn_sat_q7(sum[r][0] >> out_shift, relu);
+                if (col2)
+                {
+                    pOut[ch_im_out + i + r] = arm_nn_sat_q7(sum[r][1] >> out_shift, relu);
+                }
+            }
+        }
+    }
+
+    /* Return to application */
+    return ARM_MATH_SUCCESS;
+}
+/**
+ * @brief Fast Q7 convolution function (non-square shape)
+ * @param[in]       Im_in        pointer to input tensor
+ * @param[in]       dim_im_in_x  input tensor dimension x
+ * @param[in]       dim_im_in_y  input tensor dimension y
+ * @param[in]       ch_im_in     number of input tensor channels
+ * @param[in]       wt           pointer to kernel weights
+ * @param[in]       ch_im_out    number of filters, i.e., output tensor channels
+ * @param[in]       dim_kernel_x filter kernel size x
+ * @param[in]       dim_kernel_y filter kernel size y
+ * @param[in]       padding_x    padding size x
+ * @param[in]       padding_y    padding size y
+ * @param[in]       stride_x     convolution stride x
+ * @param[in]       stride_y     convolution stride y
+ * @param[in]       bias         pointer to bias
+ * @param[in]       bias_shift   amount of left-shift for bias
+ * @param[in]       out_shift    amount of right-shift for output
+ * @param[in,out]   Im_out       pointer to output tensor
+ * @param[in]       dim_im_out_x output tensor dimension x
+ * @param[in]       dim_im_out_y output tensor dimension y
+ * @param[in,out]   bufferA      pointer to buffer space for input
+ * @param[in,out]   bufferB      unused
+ * @return     The function returns either
+ * <code>ARM_MATH_SIZE_MISMATCH</code> or <code>ARM_MATH_SUCCESS</code> based on the outcome of size checking.
+ *
+ * @details
+ *
+ * <b>Buffer size:</b>
+ *
+ * bufferA size: 2*ch_im_in*dim_kernel_x*dim_kernel_y
+ *
+ * bufferB size: 0
+ *
+ * <b>Input dimension constraints:</b>
+ *
+ * ch_im_in is multiple of 4
+ *
+ * ch_im_out is multiple of 2
+ *
+ * Output pixels go in pairs, the columns of both (read in place when the filters are one row high
+ * and the window lies inside the input) sharing each load of four filters in arm_nn_dot_q7().
+ * Same results as arm_convolve_HWC_q7_basic_nonsquare(), an odd last pixel included.
+ */
+
+arm_status arm_convolve_HWC_q7_fast_nonsquare(const q7_t *Im_in,
+                                              const uint16_t dim_im_in_x,
+                                              const uint16_t dim_im_in_y,
+                                              const uint16_t ch_im_in,
+                                              const q7_t *wt,
+                                              const uint16_t ch_im_out,
+                                              const uint16_t dim_kernel_x,
+                                              const uint16_t dim_kernel_y,
+                                              const uint16_t padding_x,
+                                              const uint16_t padding_y,
+                                              const uint16_t stride_x,
+                                              const uint16_t stride_y,
+                                              const q7_t *bias,
+                                              const uint16_t bias_shift,
+                                              const uint16_t out_shift,
+                                              q7_t *Im_out,
+                                              const uint16_t dim_im_out_x,
+                                              const uint16_t dim_im_out_y,
+                                              q15_t *bufferA,
+                                              q7_t *bufferB)
+{
+    return arm_nn_convolve_HWC_q7_fast_nonsquare(Im_in, dim_im_in_x, dim_im_in_y, ch_im_in, wt, ch_im_out, dim_kernel_x,
+                                                 dim_kernel_y, padding_x, padding_y, stride_x, stride_y, bias,
+                                                 bias_shift, out_shift, Im_out, dim_im_out_x, dim_im_out_y, bufferA,
+                                                 bufferB, 0);
+}
+
+/**
+ * @brief Fast Q7 convolution function (non-square shape) followed by a ReLU
+ * @param[in]       Im_in        pointer to input tensor
+ * @param[in]       dim_im_in_x  input tensor dimension x
+ * @param[in]       dim_im_in_y  input tensor dimension y
+ * @param[in]       ch_im_in     number of input tensor channels
+ * @param[in]       wt           pointer to kernel weights
+ * @param[in]       ch_im_out    number of filters, i.e., output tensor channels
+ * @param[in]       dim_kernel_x filter kernel size x
+ * @param[in]       dim_kernel_y filter kernel size y
+ * @param[in]       padding_x    padding size x
+ * @param[in]       padding_y    padding size y
+ * @param[in]       stride_x     convolution stride x
+ * @param[in]       stride_y     convolution stride y
+ * @param[in]       bias         pointer to bias
+ * @param[in]       bias_shift   amount of left-shift for bias
+ * @param[in]       out_shift    amount of right-shift for output
+ * @param[in,out]   Im_out       pointer to output tensor
+ * @param[in]       dim_im_out_x output tensor dimension x
+ * @param[in]       dim_im_out_y output tensor dimension y
+ * @param[in,out]   bufferA      pointer to buffer space for input
+ * @param[in,out]   bufferB      unused
+ * @return     The function returns either
+ * <code>ARM_MATH_SIZE_MISMATCH</code> or <code>ARM_MATH_SUCCESS</code> based on the outcome of size checking.
+ *
+ * @details
+ *
+ * Same results as arm_convolve_HWC_q7_fast_nonsquare() followed by arm_relu_q7() on Im_out,
+ * the ReLU being applied when each output is saturated instead of in a second pass over Im_out.
+ *
+ */
+
+arm_status arm_convolve_HWC_q7_fast_nonsquare_relu(const q7_t *Im_in,
+                                                   const uint16_t dim_im_in_x,
+                                                   const uint16_t dim_im_in_y,
+                                                   const uint16_t ch_im_in,
+                                                   const q7_t *wt,
+                                                   const uint16_t ch_im_out,
+                                                   const uint16_t dim_kernel_x,
+                                                   const uint16_t dim_kernel_y,
+                                                   const uint16_t padding_x,
+                                                   const uint16_t padding_y,
+                                                   const uint16_t stride_x,
+                                                   const uint16_t stride_y,
+                                                   const q7_t *bias,
+                                                   const uint16_t bias_shift,
+                                                   const uint16_t out_shift,
+                                                   q7_t *Im_out,
+                                                   const uint16_t dim_im_out_x,
+                                                   const uint16_t dim_im_out_y,
+                                                   q15_t *bufferA,
+                                                   q7_t *bufferB)
+{
+    return arm_nn_convolve_HWC_q7_fast_nonsquare(Im_in, dim_im_in_x, dim_im_in_y, ch_im_in, wt, ch_im_out, dim_kernel_x,
+                                                 dim_kernel_y, padding_x, padding_y, stride_x, stride_y, bias,
+                                                 bias_shift, out_shift, Im_out, dim_im_out_x, dim_im_out_y, bufferA,
+                                                 bufferB, 1);
+}
+
+/**
+ * @} end of NNConv group
+ */
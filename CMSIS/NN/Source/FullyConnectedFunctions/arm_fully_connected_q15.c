@@ -40,40 +40,130 @@
  * @{
  */
 
-/**
- * @brief Q15 opt fully-connected layer function
- * @param[in]       pV          pointer to input vector
- * @param[in]       pM          pointer to matrix weights
- * @param[in]       dim_vec     length of the vector
- * @param[in]       num_of_rows number of rows in weight matrix
- * @param[in]       bias_shift  amount of left-shift for bias
- * @param[in]       out_shift   amount of right-shift for output
- * @param[in]       bias        pointer to bias
- * @param[in,out]   pOut        pointer to output vector
- * @param[in,out]   vec_buffer  pointer to buffer space for input
- * @return     The function returns <code>ARM_MATH_SUCCESS</code>
- *
- *
- * @details
- *
- * <b>Buffer size:</b>
- *
- * vec_buffer size: 0
- *
- */
+#if defined(ARM_MATH_NEON)
 
-arm_status arm_fully_connected_q15(const q15_t *pV,
-                                   const q15_t *pM,
-                                   const uint16_t dim_vec,
-                                   const uint16_t num_of_rows,
-                                   const uint16_t bias_shift,
-                                   const uint16_t out_shift,
-                                   const q15_t *bias,
-                                   q15_t *pOut,
-                                   q15_t *vec_buffer)
+/* `rows` (1 to 4) consecutive weight rows against the input vector. Eight values of the vector
+ * are loaded once per step and shared by all rows, each row keeping its own vmlal_s16 chain. */
+static inline void arm_nn_fc_q15_neon_rows(const q15_t *pV,
+                                           const q15_t *pM,
+                                           const uint16_t dim_vec,
+                                           const int32_t rows,
+                                           const q15_t *bias,
+                                           const uint16_t bias_shift,
+                                           const uint16_t out_shift,
+                                           q15_t *pOut,
+                                           const int32_t relu)
+{
+    int32x4_t acc[4];
+    q31_t sum[4];
+    int32_t r, k = 0;
+
+    for (r = 0; r < rows; r++)
+    {
+        sum[r] = ((q31_t)bias[r] << bias_shift) + NN_ROUND(out_shift);
+        acc[r] = vdupq_n_s32(0);
+    }
+
+    for (; k + 8 <= dim_vec; k += 8)
+    {
+        const int16x8_t v = vld1q_s16(pV + k);
+        for (r = 0; r < rows; r++)
+        {
+            const int16x8_t w = vld1q_s16(pM + r * dim_vec + k);
+            acc[r] = vmlal_s16(acc[r], vget_low_s16(w), vget_low_s16(v));
+            acc[r] = vmlal_s16(acc[r], vget_high_s16(w), vget_high_s16(v));
+        }
+    }
+    if (k + 4 <= dim_vec)
+    {
+        const int16x4_t v = vld1_s16(pV + k);
+        for (r = 0; r < rows; r++)
+        {
+            acc[r] = vmlal_s16(acc[r], vld1_s16(pM + r * dim_vec + k), v);
+        }
+        k += 4;
+    }
+
+    /* lane sums wrap mod 2^32 like the __SMLAD accumulation */
+    for (r = 0; r < rows; r++)
+    {
+        int32x2_t s = vpadd_s32(vget_low_s32(acc[r]), vget_high_s32(acc[r]));
+        s = vpadd_s32(s, s);
+        sum[r] = (q31_t)((uint32_t)sum[r] + (uint32_t)vget_lane_s32(s, 0));
+    }
+
+    /* left-over of the vector */
+    for (; k < dim_vec; k++)
+    {
+        for (r = 0; r < rows; r++)
+        {
+            sum[r] = (q31_t)((uint32_t)sum[r] + (uint32_t)(pV[k] * pM[r * dim_vec + k]));
+        }
+    }
+
+    for (r = 0; r < rows; r++)
+    {
+        pOut[r] = arm_nn_sat_q15(sum[r] >> out_shift, relu);
+    }
+}
+
+#endif /* ARM_MATH_NEON */
+
+/* arm_fully_connected_q15() and arm_fully_connected_q15_relu(), which only differ in the output
+ * saturation */
+static arm_status arm_nn_fully_connected_q15(const q15_t *pV,
+                                             const q15_t *pM,
+                                             const uint16_t dim_vec,
+                                             const uint16_t num_of_rows,
+                                             const uint16_t bias_shift,
+                                             const uint16_t out_shift,
+                                             const q15_t *bias,
+                                             q15_t *pOut,
+                                             q15_t *vec_buffer,
+                                             const int32_t relu)
 {
     (void)vec_buffer;
-#if defined(ARM_MATH_DSP) && !defined(ARM_MATH_MVEI)
+#if defined(ARM_MATH_NEON)
+    /* Run the following code for Cortex-A with NEON */
+    int32_t i = 0;
+
+    for (; i + 4 <= num_of_rows; i += 4)
+    {
+        arm_nn_fc_q15_neon_rows(pV, pM + i * dim_vec, dim_vec, 4, bias + i, bias_shift, out_shift, pOut + i, relu);
+    }
+    if (i + 2 <= num_of_rows)
+    {
+        arm_nn_fc_q15_neon_rows(pV, pM + i * dim_vec, dim_vec, 2, bias + i, bias_shift, out_shift, pOut + i, relu);
+        i += 2;
+    }
+    if (i < num_of_rows)
+    {
+        arm_nn_fc_q15_neon_rows(pV, pM + i * dim_vec, dim_vec, 1, bias + i, bias_shift, out_shift, pOut + i, relu);
+    }
+
+#elif defined(ARM_NN_X86)
+    /* Run the following code for x86 hosts with SSE4.1 or AVX2 */
+    int32_t i, r;
+
+    /* four rows at a time against one load of the vector */
+    for (i = 0; i < num_of_rows; i += 4)
+    {
+        const int32_t rows = num_of_rows - i < 4 ? num_of_rows - i : 4;
+        q31_t sum[4][2];
+
+        for (r = 0; r < rows; r++)
+        {
+            sum[r][0] = ((q31_t)bias[i + r] << bias_shift) + NN_ROUND(out_shift);
+            sum[r][1] = 0;
+        }
+        arm_nn_x86_dot_q15(pM + i * dim_vec, dim_vec, pV, NULL, dim_vec, rows, sum);
+        for (r = 0; r < rows; r++)
+        {
+            pOut[i + r] = arm_nn_sat_q15(sum[r][0] >> out_shift, relu);
+        }
+    }
+
+#elif defined(ARM_MATH_DSP) && !defined(ARM_MATH_MVEI)
     /* Run the following code for Cortex-M4 and Cortex-M7 */
 
     const q15_t *pB = pM;
@@ -122,8 +212,8 @@ arm_status arm_fully_connected_q15(const q15_t *pV,
             sum2 += inV * inM2;
             colCnt--;
         } /* while over colCnt */
-        *pO++ = (q15_t)(__SSAT((sum >> out_shift), 16));
-        *pO++ = (q15_t)(__SSAT((sum2 >> out_shift), 16));
+        *pO++ = arm_nn_sat_q15(sum >> out_shift, relu);
+        *pO++ = arm_nn_sat_q15(sum2 >> out_shift, relu);
 
         /* adjust the pointers and counters */
         pB = pB + dim_vec;
@@ -166,7 +256,7 @@ arm_status arm_fully_connected_q15(const q15_t *pV,
             colCnt--;
         }
 
-        *pO++ = (q15_t)(__SSAT((sum >> out_shift), 16));
+        *pO++ = arm_nn_sat_q15(sum >> out_shift, relu);
 
         rowCnt--;
     }
@@ -181,7 +271,7 @@ arm_status arm_fully_connected_q15(const q15_t *pV,
         {
             ip_out += pV[j] * pM[i * dim_vec + j];
         }
-        pOut[i] = (q15_t)__SSAT((ip_out >> out_shift), 16);
+        pOut[i] = arm_nn_sat_q15(ip_out >> out_shift, relu);
     }
 
 #endif /* ARM_MATH_DSP */
@@ -190,6 +280,237 @@ arm_status arm_fully_connected_q15(const q15_t *pV,
     return (ARM_MATH_SUCCESS);
 }
 
+/* The rows of arm_fully_connected_q15_batch() go in tiles of ARM_NN_FC_Q15_TILE_ROWS, each tile
+ * over every vector of the batch while it stays in L1. Rows are computed the same whatever the
+ * rows around them, so each vector gets the results of arm_fully_connected_q15(). */
+static void arm_nn_fully_connected_q15_batch(const q15_t *const *pV,
+                                             const q15_t *pM,
+                                             const uint16_t dim_vec,
+                                             const uint16_t num_of_rows,
+                                             const uint16_t bias_shift,
+                                             const uint16_t out_shift,
+                                             const q15_t *bias,
+                                             q15_t *const *pOut,
+                                             const int32_t batch,
+                                             const int32_t relu)
+{
+    const int32_t tile_rows = ARM_NN_FC_Q15_TILE_ROWS(dim_vec, num_of_rows);
+    int32_t r0, b;
+
+    for (r0 = 0; r0 < num_of_rows; r0 += tile_rows)
+    {
+        const uint16_t rows = MIN(num_of_rows - r0, tile_rows);
+        for (b = 0; b < batch; b++)
+        {
+            arm_nn_fully_connected_q15(pV[b], pM + r0 * dim_vec, dim_vec, rows, bias_shift, out_shift, bias + r0,
+                                       pOut[b] + r0, NULL, relu);
+        }
+    }
+}
+
+#if defined(ARM_NN_TEAM) || defined(ARM_NN_BATCH)
+
+/* Arguments of an arm_nn_fully_connected_q15() call, for the team parts and the batch */
+typedef struct
+{
+    const q15_t *pV;
+    const q15_t *pM;
+    uint16_t dim_vec;
+    uint16_t num_of_rows;
+    uint16_t bias_shift;
+    uint16_t out_shift;
+    const q15_t *bias;
+    q15_t *pOut;
+    int32_t relu;
+} arm_nn_fc_q15_args;
+
+#if defined(ARM_NN_TEAM)
+/* One part of the rows, on a thread of the team */
+static void arm_nn_fc_q15_team_part(void *ctx, int32_t part, int32_t parts)
+{
+    const arm_nn_fc_q15_args *a = (const arm_nn_fc_q15_args *)ctx;
+    const int32_t begin = arm_nn_team_bound(a->num_of_rows, part, parts);
+    const int32_t end = arm_nn_team_bound(a->num_of_rows, part + 1, parts);
+    arm_nn_fully_connected_q15(a->pV, a->pM + begin * a->dim_vec, a->dim_vec, end - begin, a->bias_shift, a->out_shift,
+                               a->bias + begin, a->pOut + begin, NULL, a->relu);
+}
+#endif
+
+#if defined(ARM_NN_BATCH)
+/* The same call of every lane of a batch. The lanes run copies of one model, the weights of lane 0
+ * serve all of them. */
+static void arm_nn_fc_q15_batch_task(void *const *ctx, int32_t lanes)
+{
+    const arm_nn_fc_q15_args *a = (const arm_nn_fc_q15_args *)ctx[0];
+    const q15_t *pV[ARM_NN_BATCH_MAX];
+    q15_t *pOut[ARM_NN_BATCH_MAX];
+    int32_t b;
+
+    for (b = 0; b < lanes; b++)
+    {
+        pV[b] = ((const arm_nn_fc_q15_args *)ctx[b])->pV;
+        pOut[b] = ((const arm_nn_fc_q15_args *)ctx[b])->pOut;
+    }
+    arm_nn_fully_connected_q15_batch(pV, a->pM, a->dim_vec, a->num_of_rows, a->bias_shift, a->out_shift, a->bias, pOut,
+                                     lanes, a->relu);
+}
+#endif
+
+#endif /* ARM_NN_TEAM || ARM_NN_BATCH */
+
+/* Rows are independent, large layers split them over the team. Lanes of a batch hand the call to
+ * the batch instead. */
+static arm_status arm_nn_fully_connected_q15_team(const q15_t *pV,
+                                                  const q15_t *pM,
+                                                  const uint16_t dim_vec,
+                                                  const uint16_t num_of_rows,
+                                                  const uint16_t bias_shift,
+                                                  const uint16_t out_shift,
+                                                  const q15_t *bias,
+                                                  q15_t *pOut,
+                                                  q15_t *vec_buffer,
+                                                  const int32_t relu)
+{
+#if defined(ARM_NN_BATCH)
+    if (arm_nn_batch)
+    {
+        arm_nn_fc_q15_args args = {pV, pM, dim_vec, num_of_rows, bias_shift, out_shift, bias, pOut, relu};
+        if (arm_nn_batch->join(arm_nn_fc_q15_batch_task, &args))
+        {
+            return ARM_MATH_SUCCESS;
+        }
+    }
+#endif
+#if defined(ARM_NN_TEAM)
+    const int32_t parts = arm_nn_team_parts((int64_t)dim_vec * num_of_rows, num_of_rows);
+    if (parts > 1)
+    {
+        arm_nn_fc_q15_args args = {pV, pM, dim_vec, num_of_rows, bias_shift, out_shift, bias, pOut, relu};
+        arm_nn_team->run(arm_nn_fc_q15_team_part, &args, parts);
+        return ARM_MATH_SUCCESS;
+    }
+#endif
+    return arm_nn_fully_connected_q15(pV, pM, dim_vec, num_of_rows, bias_shift, out_shift, bias, pOut, vec_buffer, relu);
+}
+
+/**
+ * @brief Q15 opt fully-connected layer function
+ * @param[in]       pV          pointer to input vector
+ * @param[in]       pM          pointer to matrix weights
+ * @param[in]       dim_vec     length of the vector
+ * @param[in]       num_of_rows number of rows in weight matrix
+ * @param[in]       bias_shift  amount of left-shift for bias
+ * @param[in]       out_shift   amount of right-shift for output
+ * @param[in]       bias        pointer to bias
+ * @param[in,out]   pOut        pointer to output vector
+ * @param[in,out]   vec_buffer  pointer to buffer space for input
+ * @return     The function returns <code>ARM_MATH_SUCCESS</code>
+ *
+ *
+ * @details
+ *
+ * <b>Buffer size:</b>
+ *
+ * vec_buffer size: 0
+ *
+ * With ARM_MATH_NEON the rows go four at a time, then one pair and one single row for the
+ * remainder, with the same results as the __SMLAD path. x86 hosts with SSE4.1 or AVX2
+ * (ARM_NN_X86) also go four rows at a time, again with the same results. Built with ARM_NN_TEAM,
+ * large layers split their rows over the arm_nn_team threads. Built with ARM_NN_BATCH, the call
+ * of every lane of an arm_nn_batch goes through arm_fully_connected_q15_batch() at once.
+ *
+ */
+
+arm_status arm_fully_connected_q15(const q15_t *pV,
+                                   const q15_t *pM,
+                                   const uint16_t dim_vec,
+                                   const uint16_t num_of_rows,
+                                   const uint16_t bias_shift,
+                                   const uint16_t out_shift,
+                                   const q15_t *bias,
+                                   q15_t *pOut,
+                                   q15_t *vec_buffer)
+{
+    return arm_nn_fully_connected_q15_team(pV, pM, dim_vec, num_of_rows, bias_shift, out_shift, bias, pOut, vec_buffer, 0);
+}
+
+/**
+ * @brief Q15 opt fully-connected layer function followed by a ReLU
+ * @param[in]       pV          pointer to input vector
+ * @param[in]       pM          pointer to matrix weights
+ * @param[in]       dim_vec     length of the vector
+ * @param[in]       num_of_rows number of rows in weight matrix
+ * @param[in]       bias_shift  amount of left-shift for bias
+ * @param[in]       out_shift   amount of right-shift for output
+ * @param[in]       bias        pointer to bias
+ * @param[in,out]   pOut        pointer to output vector
+ * @param[in,out]   vec_buffer  pointer to buffer space for input
+ * @return     The function returns <code>ARM_MATH_SUCCESS</code>
+ *
+ * @details
+ *
+ * Same results as arm_fully_connected_q15() followed by arm_relu_q15() on pOut, the ReLU
+ * being applied when each output is saturated instead of in a second pass over pOut.
+ *
+ */
+
+arm_status arm_fully_connected_q15_relu(const q15_t *pV,
+                                        const q15_t *pM,
+                                        const uint16_t dim_vec,
+                                        const uint16_t num_of_rows,
+                                        const uint16_t bias_shift,
+                                        const uint16_t out_shift,
+                                        const q15_t *bias,
+                                        q15_t *pOut,
+                                        q15_t *vec_buffer)
+{
+    return arm_nn_fully_connected_q15_team(pV, pM, dim_vec, num_of_rows, bias_shift, out_shift, bias, pOut, vec_buffer, 1);
+}
+
+/**
+ * @brief Q15 fully-connected layer function over a batch of vectors
+ * @param[in]       pV          pointers to the batch input vectors
+ * @param[in]       pM          pointer to matrix weights
+ * @param[in]       dim_vec     length of one vector
+ * @param[in]       num_of_rows number of rows in weight matrix
+ * @param[in]       bias_shift  amount of left-shift for bias
+ * @param[in]       out_shift   amount of right-shift for output
+ * @param[in]       bias        pointer to bias
+ * @param[in,out]   pOut        pointers to the batch output vectors
+ * @param[in]       batch       number of vectors
+ * @param[in,out]   vec_buffer  pointer to buffer space for input
+ * @return     The function returns <code>ARM_MATH_SUCCESS</code>
+ *
+ * @details
+ *
+ * Same results as arm_fully_connected_q15() on each vector. The weight rows go in tiles of
+ * ARM_NN_FC_Q15_TILE_ROWS that are applied to every vector of the batch while they stay in
+ * L1, so the matrix is streamed from memory once per batch instead of once per vector.
+ * Built with ARM_NN_BATCH, arm_fully_connected_q15() called from the lanes of an arm_nn_batch
+ * ends up here.
+ *
+ * <b>Buffer size:</b>
+ *
+ * vec_buffer size: 0
+ *
+ */
+
+arm_status arm_fully_connected_q15_batch(const q15_t *const *pV,
+                                         const q15_t *pM,
+                                         const uint16_t dim_vec,
+                                         const uint16_t num_of_rows,
+                                         const uint16_t bias_shift,
+                                         const uint16_t out_shift,
+                                         const q15_t *bias,
+                                         q15_t *const *pOut,
+                                         const uint16_t batch,
+                                         q15_t *vec_buffer)
+{
+    (void)vec_buffer;
+    arm_nn_fully_connected_q15_batch(pV, pM, dim_vec, num_of_rows, bias_shift, out_shift, bias, pOut, batch, 0);
+    return ARM_MATH_SUCCESS;
+}
+
 /**
  * @} end of FC group
  */
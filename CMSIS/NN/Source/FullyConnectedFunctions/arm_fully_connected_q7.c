@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2010-2021 Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS NN Library
+ * Title:        arm_fully_connected_q7.c
+ * Description:  Q7 basic fully-connected layer function
+ *
+ * Target Processor:  Cortex-A9 (ARMv7-A with DSP extension and NEON)
+ *
+ * -------------------------------------------------------------------- */
+
+#include "arm_nnfunctions.h"
+#include "arm_nnsupportfunctions.h"
+
+/**
+ *  @ingroup groupNN
+ */
+
+/**
+ * @addtogroup FC
+ * @{
+ */
+
+/* arm_fully_connected_q7() and arm_fully_connected_q7_relu(), which only differ in the output
+ * saturation */
+static arm_status arm_nn_fully_connected_q7(const q7_t *pV,
+                                            const q7_t *pM,
+                                            const uint16_t dim_vec,
+                                            const uint16_t num_of_rows,
+                                            const uint16_t bias_shift,
+                                            const uint16_t out_shift,
+                                            const q7_t *bias,
+                                            q7_t *pOut,
+                                            q15_t *vec_buffer,
+                                            const int32_t relu)
+{
+    (void)vec_buffer;
+
+    int32_t i, r;
+
+    /* four rows at a time against one load of the vector */
+    for (i = 0; i < num_of_rows; i += 4)
+    {
+        const int32_t rows = MIN(4, num_of_rows - i);
+        q31_t sum[4][2];
+
+        for (r = 0; r < rows; r++)
+        {
+            sum[r][0] = ((q31_t)bias[i + r] << bias_shift) + NN_ROUND(out_shift);
+            sum[r][1] = 0;
+        }
+        arm_nn_dot_q7(pM + i * dim_vec, dim_vec, pV, NULL, dim_vec, rows, sum);
+        for (r = 0; r < rows; r++)
+        {
+            pOut[i + r] = arm_nn_sat_q7(sum[r][0] >> out_shift, relu);
+        }
+    }
+
+    /* Return to application */
+    return (ARM_MATH_SUCCESS);
+}
+
+/**
+ * @brief Q7 basic fully-connected layer function
+ * @param[in]       pV          pointer to input vector
+ * @param[in]       pM          pointer to matrix weights
+ * @param[in]       dim_vec     length of the vector
+ * @param[in]       num_of_rows number of rows in weight matrix
+ * @param[in]       bias_shift  amount of left-shift for bias
+ * @param[in]       out_shift   amount of right-shift for output
+ * @param[in]       bias        pointer to bias
+ * @param[in,out]   pOut        pointer to output vector
+ * @param[in,out]   vec_buffer  pointer to buffer space for input
+ * @return     The function returns <code>ARM_MATH_SUCCESS</code>
+ *
+ * @details
+ *
+ * <b>Buffer size:</b>
+ *
+ * vec_buffer size: 0
+ *
+ * Row-major weights, four rows at a time through arm_nn_dot_q7(): vmull_s8/vpadal with NEON,
+ * pmaddwd on x86 hosts (ARM_NN_X86), __SMLAD on the reordered halves with the DSP extension, all
+ * with the same results as the plain loop.
+ *
+ */
+
+arm_status arm_fully_connected_q7(const q7_t *pV,
+                                  const q7_t *pM,
+                                  const uint16_t dim_vec,
+                                  const uint16_t num_of_rows,
+                                  const uint16_t bias_shift,
+                                  const uint16_t out_shift,
+                                  const q7_t *bias,
+                                  q7_t *pOut,
+                                  q15_t *vec_buffer)
+{
+    return arm_nn_fully_connected_q7(pV, pM, dim_vec, num_of_rows, bias_shift, out_shift, bias, pOut, vec_buffer, 0);
+}
+
+/**
+ * @brief Q7 basic fully-connected layer function followed by a ReLU
+ * @param[in]       pV          pointer to input vector
+ * @param[in]       pM          pointer to matrix weights
+ * @param[in]       dim_vec     length of the vector
+ * @param[in]       num_of_rows number of rows in weight matrix
+ * @param[in]       bias_shift  amount of left-shift for bias
+ * @param[in]       out_shift   amount of right-shift for output
+ * @param[in]       bias        pointer to bias
+ * @param[in,out]   pOut        pointer to output vector
+ * @param[in,out]   vec_buffer  pointer to buffer space for input
+ * @return     The function returns <code>ARM_MATH_SUCCESS</code>
+ *
+ * @details
+ *
+ * Same results as arm_fully_connected_q7() followed by arm_relu_q7() on pOut, the ReLU
+ * being applied when each output is saturated instead of in a second pass over pOut.
+ *
+ */
+
+arm_status arm_fully_connected_q7_relu(const q7_t *pV,
+                                       const q7_t *pM,
+                                       const uint16_t dim_vec,
+                                       const uint16_t num_of_rows,
+                                       const uint16_t bias_shift,
+                                       const uint16_t out_shift,
+                                       const q7_t *bias,
+                                       q7_t *pOut,
+                                       q15_t *vec_buffer)
+{
+    return arm_nn_fully_connected_q7(pV, pM, dim_vec, num_of_rows, bias_shift, out_shift, bias, pOut, vec_buffer, 1);
+}
+
+/**
+ * @} end of FC group
+ */
@@ -0,0 +1,329 @@
+/*
+ * Copyright (C) 2010-2021 Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS NN Library
+ * Title:        arm_fully_connected_q7_opt.c
+ * Description:  Q7 fully-connected layer function with interleaved weights
+ *
+ * Target Processor:  Cortex-A9 (ARMv7-A with DSP extension and NEON)
+ *
+ * -------------------------------------------------------------------- */
+
+#include "arm_nnfunctions.h"
+#include "arm_nnsupportfunctions.h"
+
+/**
+ *  @ingroup groupNN
+ */
+
+/**
+ * @addtogroup FC
+ * @{
+ */
+
+#if defined(ARM_MATH_NEON) || defined(ARM_NN_X86) || (defined(ARM_MATH_DSP) && !defined(ARM_MATH_MVEI))
+
+/* The input in the order of the interleaved weights: [v0 v2 v1 v3] for each block of four
+ * columns, the left-over columns as they are. Same as arm_q7_to_q15_reordered_no_shift(). */
+static void arm_nn_fc_q7_opt_reorder(const q7_t *pV, q15_t *vec_buffer, const uint16_t dim_vec)
+{
+    int32_t k = 0;
+
+    for (; k + 4 <= dim_vec; k += 4)
+    {
+        vec_buffer[k] = pV[k];
+        vec_buffer[k + 1] = pV[k + 2];
+        vec_buffer[k + 2] = pV[k + 1];
+        vec_buffer[k + 3] = pV[k + 3];
+    }
+    for (; k < dim_vec; k++)
+    {
+        vec_buffer[k] = pV[k];
+    }
+}
+
+#endif
+
+/* arm_fully_connected_q7_opt() and arm_fully_connected_q7_opt_relu(), which only differ in the output
+ * saturation */
+static arm_status arm_nn_fully_connected_q7_opt(const q7_t *pV,
+                                                const q7_t *pM,
+                                                const uint16_t dim_vec,
+                                                const uint16_t num_of_rows,
+                                                const uint16_t bias_shift,
+                                                const uint16_t out_shift,
+                                                const q7_t *bias,
+                                                q7_t *pOut,
+                                                q15_t *vec_buffer,
+                                                const int32_t relu)
+{
+    const q7_t *pB = pM;
+    const q7_t *pBias = bias;
+    q7_t *pO = pOut;
+    uint16_t rowCnt = num_of_rows >> 2;
+    int32_t k, r;
+
+#if defined(ARM_MATH_NEON) || defined(ARM_NN_X86) || (defined(ARM_MATH_DSP) && !defined(ARM_MATH_MVEI))
+    arm_nn_fc_q7_opt_reorder(pV, vec_buffer, dim_vec);
+#else
+    (void)vec_buffer;
+#endif
+
+    while (rowCnt)
+    {
+        q31_t sum[4];
+
+        for (r = 0; r < 4; r++)
+        {
+            sum[r] = ((q31_t)(*pBias++) << bias_shift) + NN_ROUND(out_shift);
+        }
+        k = 0;
+
+#if defined(ARM_MATH_NEON)
+        /* Run the following code for Cortex-A with NEON */
+        {
+            /* lanes of acc12: row 1 and row 2 products of [v0 v0 v2 v2] then [v1 v1 v3 v3],
+             * acc34 the same for rows 3 and 4 */
+            int32x4_t acc12 = vdupq_n_s32(0);
+            int32x4_t acc34 = vdupq_n_s32(0);
+
+            for (; k + 4 <= dim_vec; k += 4, pB += 16)
+            {
+                const int8x16_t w = vld1q_s8(pB);
+                const int16x8_t wl = vmovl_s8(vget_low_s8(w));
+                const int16x8_t wh = vmovl_s8(vget_high_s8(w));
+                const int16x4_t v = vld1_s16(vec_buffer + k);
+                const int16x4x2_t z = vzip_s16(v, v);
+
+                acc12 = vmlal_s16(acc12, vget_low_s16(wl), z.val[0]);
+                acc34 = vmlal_s16(acc34, vget_high_s16(wl), z.val[0]);
+                acc12 = vmlal_s16(acc12, vget_low_s16(wh), z.val[1]);
+                acc34 = vmlal_s16(acc34, vget_high_s16(wh), z.val[1]);
+            }
+
+            /* lane sums wrap mod 2^32 like the __SMLAD accumulation */
+            {
+                const int32x2_t s12 = vadd_s32(vget_low_s32(acc12), vget_high_s32(acc12));
+                const int32x2_t s34 = vadd_s32(vget_low_s32(acc34), vget_high_s32(acc34));
+                sum[0] = (q31_t)((uint32_t)sum[0] + (uint32_t)vget_lane_s32(s12, 0));
+                sum[1] = (q31_t)((uint32_t)sum[1] + (uint32_t)vget_lane_s32(s12, 1));
+                sum[2] = (q31_t)((uint32_t)sum[2] + (uint32_t)vget_lane_s32(s34, 0));
+                sum[3] = (q31_t)((uint32_t)sum[3] + (uint32_t)vget_lane_s32(s34, 1));
+            }
+        }
+
+#elif defined(ARM_NN_X86)
+        /* Run the following code for x86 hosts with SSE4.1 or AVX2 */
+        {
+            /* regroups the 16 bytes of a block by row, each row then in the [v0 v2 v1 v3] order of
+             * vec_buffer */
+            const __m128i by_row = _mm_setr_epi8(0, 2, 8, 10, 1, 3, 9, 11, 4, 6, 12, 14, 5, 7, 13, 15);
+            __m128i acc12 = _mm_setzero_si128();
+            __m128i acc34 = _mm_setzero_si128();
+
+            for (; k + 4 <= dim_vec; k += 4, pB += 16)
+            {
+                const __m128i w = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)pB), by_row);
+                const __m128i v = _mm_loadl_epi64((const __m128i *)(vec_buffer + k));
+                const __m128i vv = _mm_unpacklo_epi64(v, v);
+
+                acc12 = _mm_add_epi32(acc12, _mm_madd_epi16(_mm_cvtepi8_epi16(w), vv));
+                acc34 = _mm_add_epi32(acc34, _mm_madd_epi16(_mm_cvtepi8_epi16(_mm_srli_si128(w, 8)), vv));
+            }
+
+            /* [r1 r1 r2 r2] and [r3 r3 r4 r4] -> [r1 r2 r3 r4] */
+            const __m128i rows = _mm_hadd_epi32(acc12, acc34);
+            sum[0] = (q31_t)((uint32_t)sum[0] + (uint32_t)_mm_extract_epi32(rows, 0));
+            sum[1] = (q31_t)((uint32_t)sum[1] + (uint32_t)_mm_extract_epi32(rows, 1));
+            sum[2] = (q31_t)((uint32_t)sum[2] + (uint32_t)_mm_extract_epi32(rows, 2));
+            sum[3] = (q31_t)((uint32_t)sum[3] + (uint32_t)_mm_extract_epi32(rows, 3));
+        }
+
+#elif defined(ARM_MATH_DSP) && !defined(ARM_MATH_MVEI)
+        /* Run the following code for Cortex-M4 and Cortex-M7 */
+        {
+            const q15_t *pA = vec_buffer;
+
+            for (; k + 4 <= dim_vec; k += 4)
+            {
+                q31_t inM11, inM12, inM13, inM14;
+                q31_t inV;
+
+                inV = arm_nn_read_q15x2_ia(&pA);
+                pB = read_and_pad_reordered(pB, &inM11, &inM12);
+                sum[0] = __SMLAD(inV, inM11, sum[0]);
+                sum[1] = __SMLAD(inV, inM12, sum[1]);
+                pB = read_and_pad_reordered(pB, &inM13, &inM14);
+                sum[2] = __SMLAD(inV, inM13, sum[2]);
+                sum[3] = __SMLAD(inV, inM14, sum[3]);
+
+                inV = arm_nn_read_q15x2_ia(&pA);
+                pB = read_and_pad_reordered(pB, &inM11, &inM12);
+                sum[0] = __SMLAD(inV, inM11, sum[0]);
+                sum[1] = __SMLAD(inV, inM12, sum[1]);
+                pB = read_and_pad_reordered(pB, &inM13, &inM14);
+                sum[2] = __SMLAD(inV, inM13, sum[2]);
+                sum[3] = __SMLAD(inV, inM14, sum[3]);
+            }
+        }
+
+#else
+        /* Run the following code as reference implementation for Cortex-M0 and Cortex-M3 */
+        for (; k + 4 <= dim_vec; k += 4, pB += 16)
+        {
+            const q7_t inA1 = pV[k];
+            const q7_t inA3 = pV[k + 1];
+            const q7_t inA2 = pV[k + 2];
+            const q7_t inA4 = pV[k + 3];
+
+            sum[0] += inA1 * pB[0] + inA2 * pB[2];
+            sum[1] += inA1 * pB[1] + inA2 * pB[3];
+            sum[2] += inA1 * pB[4] + inA2 * pB[6];
+            sum[3] += inA1 * pB[5] + inA2 * pB[7];
+
+            sum[0] += inA3 * pB[8] + inA4 * pB[10];
+            sum[1] += inA3 * pB[9] + inA4 * pB[11];
+            sum[2] += inA3 * pB[12] + inA4 * pB[14];
+            sum[3] += inA3 * pB[13] + inA4 * pB[15];
+        }
+
+#endif /* ARM_MATH_NEON */
+
+        /* left-over of the vector, one weight per row for each column */
+        for (; k < dim_vec; k++, pB += 4)
+        {
+            for (r = 0; r < 4; r++)
+            {
+                sum[r] += pV[k] * pB[r];
+            }
+        }
+
+        for (r = 0; r < 4; r++)
+        {
+            *pO++ = arm_nn_sat_q7(sum[r] >> out_shift, relu);
+        }
+        rowCnt--;
+    }
+
+    /* left-over rows keep the plain row-major layout */
+    rowCnt = num_of_rows & 0x3;
+    if (rowCnt)
+    {
+        q31_t sum[4][2];
+
+        for (r = 0; r < rowCnt; r++)
+        {
+            sum[r][0] = ((q31_t)(*pBias++) << bias_shift) + NN_ROUND(out_shift);
+            sum[r][1] = 0;
+        }
+        arm_nn_dot_q7(pB, dim_vec, pV, NULL, dim_vec, rowCnt, sum);
+        for (r = 0; r < rowCnt; r++)
+        {
+            *pO++ = arm_nn_sat_q7(sum[r][0] >> out_shift, relu);
+        }
+    }
+
+    /* Return to application */
+    return (ARM_MATH_SUCCESS);
+}
+
+/**
+ * @brief Q7 opt fully-connected layer function
+ * @param[in]       pV          pointer to input vector
+ * @param[in]       pM          pointer to matrix weights
+ * @param[in]       dim_vec     length of the vector
+ * @param[in]       num_of_rows number of rows in weight matrix
+ * @param[in]       bias_shift  amount of left-shift for bias
+ * @param[in]       out_shift   amount of right-shift for output
+ * @param[in]       bias        pointer to bias
+ * @param[in,out]   pOut        pointer to output vector
+ * @param[in,out]   vec_buffer  pointer to buffer space for input
+ * @return     The function returns <code>ARM_MATH_SUCCESS</code>
+ *
+ * @details
+ *
+ * <b>Buffer size:</b>
+ *
+ * vec_buffer size: dim_vec
+ *
+ * The weights are interleaved as for the upstream CMSIS-NN function: groups of four rows, each
+ * block of four columns k..k+3 of a group stored as the 16 values
+ *
+ * | r1k | r2k | r1k+2 | r2k+2 | r3k | r4k | r3k+2 | r4k+2 |
+ * | r1k+1 | r2k+1 | r1k+3 | r2k+3 | r3k+1 | r4k+1 | r3k+3 | r4k+3 |
+ *
+ * then the left-over columns of the group as | r1c | r2c | r3c | r4c |, and the left-over rows
+ * row-major. vec_buffer receives the input in the matching [v0 v2 v1 v3] order, which NEON zips
+ * into the [v0 v0 v2 v2] and [v1 v1 v3 v3] lanes of its vmlal_s16 pairs, x86 hosts (ARM_NN_X86)
+ * regroup each block by row with one pshufb for pmaddwd, and the DSP extension reads as __SMLAD
+ * operands. Same results on every path.
+ *
+ */
+
+arm_status arm_fully_connected_q7_opt(const q7_t *pV,
+                                      const q7_t *pM,
+                                      const uint16_t dim_vec,
+                                      const uint16_t num_of_rows,
+                                      const uint16_t bias_shift,
+                                      const uint16_t out_shift,
+                                      const q7_t *bias,
+                                      q7_t *pOut,
+                                      q15_t *vec_buffer)
+{
+    return arm_nn_fully_connected_q7_opt(pV, pM, dim_vec, num_of_rows, bias_shift, out_shift, bias, pOut, vec_buffer,
+                                         0);
+}
+
+/**
+ * @brief Q7 opt fully-connected layer function followed by a ReLU
+ * @param[in]       pV          pointer to input vector
+ * @param[in]       pM          pointer to matrix weights
+ * @param[in]       dim_vec     length of the vector
+ * @param[in]       num_of_rows number of rows in weight matrix
+ * @param[in]       bias_shift  amount of left-shift for bias
+ * @param[in]       out_shift   amount of right-shift for output
+ * @param[in]       bias        pointer to bias
+ * @param[in,out]   pOut        pointer to output vector
+ * @param[in,out]   vec_buffer  pointer to buffer space for input
+ * @return     The function returns <code>ARM_MATH_SUCCESS</code>
+ *
+ * @details
+ *
+ * Same results as arm_fully_connected_q7_opt() followed by arm_relu_q7() on pOut, the ReLU
+ * being applied when each output is saturated instead of in a second pass over pOut.
+ *
+ */
+
+arm_status arm_fully_connected_q7_opt_relu(const q7_t *pV,
+                                           const q7_t *pM,
+                                           const uint16_t dim_vec,
+                                           const uint16_t num_of_rows,
+                                           const uint16_t bias_shift,
+                                           const uint16_t out_shift,
+                                           const q7_t *bias,
+                                           q7_t *pOut,
+                                           q15_t *vec_buffer)
+{
+    return arm_nn_fully_connected_q7_opt(pV, pM, dim_vec, num_of_rows, bias_shift, out_shift, bias, pOut, vec_buffer,
+                                         1);
+}
+
+/**
+ * @} end of FC group
+ */
@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2010-2021 Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS NN Library
+ * Title:        arm_maxpool_q7_HWC.c
+ * Description:  Q7 max pooling function
+ *
+ * Target Processor:  Cortex-A9 (ARMv7-A with DSP extension and NEON)
+ *
+ * -------------------------------------------------------------------- */
+
+#include "arm_nnfunctions.h"
+#include "arm_nnsupportfunctions.h"
+
+/**
+ *  @ingroup groupNN
+ */
+
+/**
+ * @addtogroup Pooling
+ * @{
+ */
+
+/* pOut[c] = max(pOut[c], pIn[c]) over `size` channels */
+static void arm_nn_maxpool_q7_max(q7_t *pOut, const q7_t *pIn, const int32_t size)
+{
+    int32_t c = 0;
+
+#if defined(ARM_MATH_NEON)
+    /* Run the following code for Cortex-A with NEON */
+    for (; c + 16 <= size; c += 16)
+    {
+        vst1q_s8(pOut + c, vmaxq_s8(vld1q_s8(pOut + c), vld1q_s8(pIn + c)));
+    }
+#elif defined(ARM_NN_X86)
+    /* Run the following code for x86 hosts with SSE4.1 or AVX2 */
+    for (; c + 16 <= size; c += 16)
+    {
+        const __m128i out = _mm_loadu_si128((const __m128i *)(pOut + c));
+        _mm_storeu_si128((__m128i *)(pOut + c), _mm_max_epi8(out, _mm_loadu_si128((const __m128i *)(pIn + c))));
+    }
+#endif
+    for (; c < size; c++)
+    {
+        if (pIn[c] > pOut[c])
+        {
+            pOut[c] = pIn[c];
+        }
+    }
+}
+
+/**
+ * @brief Q7 max pooling function
+ * @param[in]       Im_in       pointer to input tensor
+ * @param[in]       dim_im_in   input tensor dimension
+ * @param[in]       ch_im_in    number of input tensor channels
+ * @param[in]       dim_kernel  filter kernel size
+ * @param[in]       padding     padding sizes
+ * @param[in]       stride      convolution stride
+ * @param[in]       dim_im_out  output tensor dimension
+ * @param[in,out]   bufferA     unused
+ * @param[in,out]   Im_out      pointer to output tensor
+ *
+ * @details
+ *
+ * <b>Buffer size:</b>
+ *
+ * bufferA size: 0
+ *
+ * Each output pixel starts from its first input pixel and takes the channel-wise max of the
+ * others of its window, clipped to the input, 16 channels at a time with vmaxq_s8 (pmaxsb on x86
+ * hosts), -128 for a window entirely in the padding. Unlike the upstream DSP path, which pools
+ * the rows in place first, Im_in is left untouched.
+ *
+ */
+
+void arm_maxpool_q7_HWC(q7_t *Im_in,
+                        const uint16_t dim_im_in,
+                        const uint16_t ch_im_in,
+                        const uint16_t dim_kernel,
+                        const uint16_t padding,
+                        const uint16_t stride,
+                        const uint16_t dim_im_out,
+                        q7_t *bufferA,
+                        q7_t *Im_out)
+{
+    (void)bufferA;
+
+    int32_t i_y, i_x;
+
+    for (i_y = 0; i_y < dim_im_out; i_y++)
+    {
+        const int32_t y0 = MAX(0, i_y * stride - padding);
+        const int32_t y1 = MIN(dim_im_in, i_y * stride - padding + dim_kernel);
+
+        for (i_x = 0; i_x < dim_im_out; i_x++)
+        {
+            const int32_t x0 = MAX(0, i_x * stride - padding);
+            const int32_t x1 = MIN(dim_im_in, i_x * stride - padding + dim_kernel);
+            q7_t *pOut = Im_out + (i_y * dim_im_out + i_x) * ch_im_in;
+            int32_t k_y, k_x;
+
+            if (y0 >= y1 || x0 >= x1)
+            {
+                /* window entirely in the padding */
+                memset(pOut, -128, ch_im_in);
+                continue;
+            }
+
+            memcpy(pOut, Im_in + (y0 * dim_im_in + x0) * ch_im_in, ch_im_in);
+            for (k_y = y0; k_y < y1; k_y++)
+            {
+                for (k_x = (k_y == y0 ? x0 + 1 : x0); k_x < x1; k_x++)
+                {
+                    arm_nn_maxpool_q7_max(pOut, Im_in + (k_y * dim_im_in + k_x) * ch_im_in, ch_im_in);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @} end of Pooling group
+ */
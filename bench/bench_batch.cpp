@@ -0,0 +1,177 @@
+/* bench_batch.cpp */
+
+// Throughput vs latency of batched inference for an FC heavy layer stack: a 1-D conv over the
+// window followed by two fully connected layers, the first one too large for L1. Batch size 1
+// runs the stock CMSIS kernels, larger batches the *_batch kernels the lanes of a BATCH build
+// end up in, whose outputs are checked against the stock ones.
+//
+//   bench_batch [windows/s] [max wait us]
+//
+// Latency counts the time the first window of a batch waits for the batch to fill (bounded by
+// the max wait) plus the batch compute time.
+
+#include "arm_nnfunctions.h"
+#include "arm_nnsupportfunctions.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using bench_clock = std::chrono::steady_clock;
+
+// Window of 128 samples on 2 input channels
+constexpr uint16_t IN_X = 128;
+constexpr uint16_t IN_CH = 2;
+constexpr uint16_t CONV_CH = 16;
+constexpr uint16_t CONV_K = 5;
+constexpr uint16_t CONV_PAD = 2;
+constexpr uint16_t FC1_IN = IN_X * CONV_CH;
+constexpr uint16_t FC1_OUT = 64;
+constexpr uint16_t FC2_OUT = 16;
+constexpr uint16_t MAX_BATCH = ARM_NN_BATCH_MAX;
+
+struct layers_t
+{
+    std::vector<q15_t> conv_wt, conv_bias, fc1_wt, fc1_bias, fc2_wt, fc2_bias;
+};
+
+struct buffers_t
+{
+    std::vector<q15_t> input, conv_out, fc1_out, output, col;
+};
+
+static void fill(std::vector<q15_t> &v, size_t n, std::mt19937 &rng, int range)
+{
+    std::uniform_int_distribution<int> dist(-range, range);
+    v.resize(n);
+    for (q15_t &x : v)
+        x = static_cast<q15_t>(dist(rng));
+}
+
+static void run_stock(const layers_t &l, buffers_t &b, uint16_t batch)
+{
+    for (uint16_t i = 0; i < batch; ++i)
+    {
+        arm_convolve_HWC_q15_fast_nonsquare(&b.input[i * IN_X * IN_CH], IN_X, 1, IN_CH, l.conv_wt.data(), CONV_CH, CONV_K, 1,
+                                            CONV_PAD, 0, 1, 1, l.conv_bias.data(), 0, 9, &b.conv_out[i * FC1_IN], IN_X, 1,
+                                            b.col.data(), nullptr);
+        arm_fully_connected_q15(&b.conv_out[i * FC1_IN], l.fc1_wt.data(), FC1_IN, FC1_OUT, 0, 12, l.fc1_bias.data(),
+                                &b.fc1_out[i * FC1_OUT], nullptr);
+        arm_fully_connected_q15(&b.fc1_out[i * FC1_OUT], l.fc2_wt.data(), FC1_OUT, FC2_OUT, 0, 9, l.fc2_bias.data(),
+                                &b.output[i * FC2_OUT], nullptr);
+    }
+}
+
+// Tensor i of every layer, as the lanes hand them to the batch
+struct lanes_t
+{
+    const q15_t *input[MAX_BATCH], *conv_in[MAX_BATCH], *fc1_in[MAX_BATCH];
+    q15_t *conv_out[MAX_BATCH], *fc1_out[MAX_BATCH], *output[MAX_BATCH];
+};
+
+static lanes_t lanes_of(buffers_t &b)
+{
+    lanes_t lanes;
+    for (uint16_t i = 0; i < MAX_BATCH; ++i)
+    {
+        lanes.input[i] = &b.input[i * IN_X * IN_CH];
+        lanes.conv_out[i] = &b.conv_out[i * FC1_IN];
+        lanes.conv_in[i] = lanes.conv_out[i];
+        lanes.fc1_out[i] = &b.fc1_out[i * FC1_OUT];
+        lanes.fc1_in[i] = lanes.fc1_out[i];
+        lanes.output[i] = &b.output[i * FC2_OUT];
+    }
+    return lanes;
+}
+
+static void run_batched(const layers_t &l, const lanes_t &b, uint16_t batch)
+{
+    arm_convolve_1_x_n_HWC_q15_batch(b.input, IN_X, 1, IN_CH, l.conv_wt.data(), CONV_CH, CONV_K, 1, CONV_PAD, 0, 1, 1,
+                                     l.conv_bias.data(), 0, 9, b.conv_out, IN_X, 1, batch, nullptr, nullptr);
+    arm_fully_connected_q15_batch(b.conv_in, l.fc1_wt.data(), FC1_IN, FC1_OUT, 0, 12, l.fc1_bias.data(), b.fc1_out, batch,
+                                  nullptr);
+    arm_fully_connected_q15_batch(b.fc1_in, l.fc2_wt.data(), FC1_OUT, FC2_OUT, 0, 9, l.fc2_bias.data(), b.output, batch,
+                                  nullptr);
+}
+
+static void allocate(buffers_t &b)
+{
+    b.conv_out.assign(MAX_BATCH * FC1_IN, 0);
+    b.fc1_out.assign(MAX_BATCH * FC1_OUT, 0);
+    b.output.assign(MAX_BATCH * FC2_OUT, 0);
+    b.col.assign(2 * IN_CH * CONV_K, 0);
+}
+
+int main(int argc, char **argv)
+{
+    const double rate = argc > 1 ? strtod(argv[1], nullptr) : 1000.0;
+    const double max_wait_us = argc > 2 ? strtod(argv[2], nullptr) : 2000.0;
+    const double period_us = 1e6 / rate;
+
+    std::mt19937 rng(42);
+    layers_t l;
+    fill(l.conv_wt, CONV_CH * CONV_K * IN_CH, rng, 2000);
+    fill(l.conv_bias, CONV_CH, rng, 200);
+    fill(l.fc1_wt, FC1_OUT * FC1_IN, rng, 2000);
+    fill(l.fc1_bias, FC1_OUT, rng, 200);
+    fill(l.fc2_wt, FC2_OUT * FC1_OUT, rng, 2000);
+    fill(l.fc2_bias, FC2_OUT, rng, 200);
+
+    buffers_t stock, batched;
+    fill(stock.input, MAX_BATCH * IN_X * IN_CH, rng, 8000);
+    batched.input = stock.input;
+    allocate(stock);
+    allocate(batched);
+    const lanes_t lanes = lanes_of(batched);
+
+    printf("FC weights %u KiB, %.0f windows/s, max wait %.0f us\n",
+           static_cast<unsigned>((l.fc1_wt.size() + l.fc2_wt.size()) * sizeof(q15_t) / 1024), rate, max_wait_us);
+    printf("%5s %12s %14s %14s %14s %12s\n", "batch", "us/window", "windows/s", "mean lat us", "worst lat us", "speedup");
+
+    double base_us = 0;
+    for (uint16_t batch : {1, 2, 4, 8})
+    {
+        run_stock(l, stock, batch);
+        run_batched(l, lanes, batch);
+        if (std::memcmp(stock.output.data(), batched.output.data(), batch * FC2_OUT * sizeof(q15_t)) != 0)
+        {
+            fprintf(stderr, "batch %u: batched kernels differ from the stock ones\n", batch);
+            return 1;
+        }
+
+        // Run for about 0.2 s per batch size
+        uint64_t calls = 0;
+        auto start = bench_clock::now();
+        auto elapsed = bench_clock::duration::zero();
+        while (elapsed < std::chrono::milliseconds(200))
+        {
+            if (batch == 1)
+                run_stock(l, stock, batch);
+            else
+                run_batched(l, lanes, batch);
+            ++calls;
+            elapsed = bench_clock::now() - start;
+        }
+
+        const double batch_us = std::chrono::duration<double, std::micro>(elapsed).count() / calls;
+        const double window_us = batch_us / batch;
+        if (batch == 1)
+            base_us = window_us;
+
+        // At this rate a batch may close on the max wait before it is full
+        const double fill_us = std::min((batch - 1) * period_us, max_wait_us);
+        const unsigned filled = std::min<unsigned>(batch, 1 + static_cast<unsigned>(max_wait_us / period_us));
+        printf("%5u %12.2f %14.0f %14.1f %14.1f %11.2fx", batch, window_us, 1e6 / window_us, fill_us / 2 + batch_us,
+               fill_us + batch_us, base_us / window_us);
+        if (filled < batch)
+            printf("  (only %u windows per batch at this rate)", filled);
+        if (window_us > period_us)
+            printf("  (cannot keep up)");
+        printf("\n");
+    }
+
+    return 0;
+}
@@ -0,0 +1,169 @@
+/* bench_convert.cpp */
+
+// Throughput of the raw ADC code conversion (ConvertRaw.hpp) on the path the build selects (NEON
+// with NEON=1 on the board, SSE4.1 or AVX2 for bench_convert_host) against the one sample at a
+// time loop, for the float, int8 and int16 model inputs, without and with an ADC calibration.
+// Then the min-max normalization (SampleNorm.hpp) of a window against sample_norm_scalar(), and
+// the fused conversion and normalization against the conversion followed by sample_norm_scalar().
+//
+//   bench_convert [runs]
+//
+// Each conversion goes over a ring-sized block (DATA_SIZE samples) `runs` times (2000 by default),
+// the median block gives the samples/s. The block holds random 14-bit codes; both outputs are
+// compared bit for bit on it and on every int16 code, so the rounding and saturation edges are
+// covered too. The normalization runs over WINDOW-sample windows, compared on NORM_CHECKS random
+// windows of every span from flat to full scale. The exit code is 1 on a mismatch.
+
+#include "ConvertRaw.hpp"
+#include "SampleNorm.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using bench_clock = std::chrono::steady_clock;
+
+constexpr size_t BLOCK = 16384;
+constexpr size_t WINDOW = 1024;
+constexpr int NORM_CHECKS = 2000;
+
+static double median(std::vector<double> &v)
+{
+    std::sort(v.begin(), v.end());
+    return v[v.size() / 2];
+}
+
+template <typename F>
+static double time_block(int runs, F &&convert)
+{
+    for (int i = 0; i < 10; ++i)
+        convert();
+    std::vector<double> s;
+    for (int i = 0; i < runs; ++i)
+    {
+        auto start = bench_clock::now();
+        convert();
+        auto end = bench_clock::now();
+        s.push_back(std::chrono::duration<double>(end - start).count());
+    }
+    return median(s);
+}
+
+// Every int16 code through both loops, in blocks of odd sizes so the vector tails get used too
+template <typename T>
+static bool same_on_all_codes(const adc_calib_t &calib)
+{
+    std::vector<int16_t> codes(65536);
+    for (size_t i = 0; i < codes.size(); ++i)
+        codes[i] = static_cast<int16_t>(static_cast<int32_t>(i) - 32768);
+    std::vector<T> simd(codes.size()), scalar(codes.size());
+
+    for (size_t i = 0, len = 1; i < codes.size(); i += len, len = len % 61 + 1)
+    {
+        const size_t n = std::min(len, codes.size() - i);
+        convert_raw_samples(codes.data() + i, simd.data() + i, n, calib);
+        convert_raw_scalar(codes.data() + i, scalar.data() + i, n, calib);
+    }
+    return std::memcmp(simd.data(), scalar.data(), codes.size() * sizeof(T)) == 0;
+}
+
+template <typename T>
+static bool bench_type(const char *type, const char *calib_name, const adc_calib_t &calib,
+                       const std::vector<int16_t> &raw, int runs)
+{
+    // Both loops time into the same buffer: where the output sits against the input (4K aliasing of
+    // the loads behind the stores) moved the float conversion by 15%, more than the loops differ
+    std::vector<T> simd(raw.size()), scalar(raw.size());
+    const double simd_s = time_block(runs, [&] { convert_raw_samples(raw.data(), simd.data(), raw.size(), calib); });
+    const double scalar_s = time_block(runs, [&] { convert_raw_scalar(raw.data(), simd.data(), raw.size(), calib); });
+    convert_raw_samples(raw.data(), simd.data(), raw.size(), calib);
+    convert_raw_scalar(raw.data(), scalar.data(), raw.size(), calib);
+
+    const bool same = std::memcmp(simd.data(), scalar.data(), raw.size() * sizeof(T)) == 0 && same_on_all_codes<T>(calib);
+    printf("%-6s %-12s %14.1f %14.1f %8.2fx%s\n", type, calib_name, raw.size() / simd_s / 1e6, raw.size() / scalar_s / 1e6,
+           scalar_s / simd_s, same ? "" : "  MISMATCH");
+    return same;
+}
+
+// Raw window whose codes span `span` from a random base, split where a ring would wrap it
+static void random_window(std::vector<int16_t> &raw, std::mt19937 &rng)
+{
+    const int span = std::uniform_int_distribution<int>(0, 65535)(rng);
+    const int base = std::uniform_int_distribution<int>(-32768, 32767 - span)(rng);
+    std::uniform_int_distribution<int> dist(base, base + span);
+    for (int16_t &x : raw)
+        x = static_cast<int16_t>(dist(rng));
+}
+
+template <typename T>
+static bool bench_norm(const char *type, const adc_calib_t &calib, int runs, std::mt19937 &rng)
+{
+    std::vector<int16_t> raw(WINDOW);
+    static T scalar[WINDOW][1], simd[WINDOW][1], fused[WINDOW][1];
+    const size_t split = WINDOW / 3;
+
+    bool same = true;
+    for (int c = 0; c < NORM_CHECKS && same; ++c)
+    {
+        random_window(raw, rng);
+        convert_raw_samples(raw.data(), &scalar[0][0], WINDOW, calib);
+        std::memcpy(simd, scalar, sizeof(simd));
+        sample_norm_scalar(scalar);
+        sample_norm(simd);
+        convert_raw_norm(raw.data(), split, raw.data() + split, WINDOW - split, &fused[0][0], calib);
+        same = std::memcmp(simd, scalar, sizeof(simd)) == 0 && std::memcmp(fused, scalar, sizeof(fused)) == 0;
+    }
+
+    random_window(raw, rng);
+    convert_raw_samples(raw.data(), &scalar[0][0], WINDOW, calib);
+    const double scalar_s = time_block(runs, [&] { sample_norm_scalar(scalar); });
+    const double simd_s = time_block(runs, [&] { sample_norm(simd); });
+    const double two_pass_s = time_block(runs, [&] {
+        convert_raw_samples(raw.data(), &scalar[0][0], WINDOW, calib);
+        sample_norm_scalar(scalar);
+    });
+    const double fused_s = time_block(runs, [&] { convert_raw_norm(raw.data(), WINDOW, nullptr, 0, &fused[0][0], calib); });
+
+    printf("%-6s %14.1f %14.1f %8.2fx %14.1f %14.1f %8.2fx%s\n", type, WINDOW / simd_s / 1e6, WINDOW / scalar_s / 1e6,
+           scalar_s / simd_s, WINDOW / fused_s / 1e6, WINDOW / two_pass_s / 1e6, two_pass_s / fused_s,
+           same ? "" : "  MISMATCH");
+    return same;
+}
+
+int main(int argc, char **argv)
+{
+    const int runs = argc > 1 ? atoi(argv[1]) : 2000;
+
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<int> dist(-8192, 8191);
+    std::vector<int16_t> raw(BLOCK);
+    for (int16_t &x : raw)
+        x = static_cast<int16_t>(dist(rng));
+
+    const adc_calib_t none;
+    const adc_calib_t calib = make_adc_calib(-37, 1.0213);
+
+    printf("%s path, %zu-sample blocks, median of %d runs\n", convert_raw_path(), raw.size(), runs);
+    printf("%-6s %-12s %14s %14s %9s\n", "type", "calibration", "vector MS/s", "scalar MS/s", "speedup");
+
+    int failures = 0;
+    for (int c = 0; c < 2; ++c)
+    {
+        const adc_calib_t &cal = c ? calib : none;
+        const char *name = c ? "offset+gain" : "none";
+        failures += !bench_type<float>("float", name, cal, raw, runs);
+        failures += !bench_type<int8_t>("int8", name, cal, raw, runs);
+        failures += !bench_type<int16_t>("int16", name, cal, raw, runs);
+    }
+
+    printf("\nnormalization of %zu-sample windows, with the calibration above\n", WINDOW);
+    printf("%-6s %14s %14s %9s %14s %14s %9s\n", "type", "norm MS/s", "scalar MS/s", "speedup", "fused MS/s",
+           "2-pass MS/s", "speedup");
+    failures += !bench_norm<float>("float", calib, runs, rng);
+    failures += !bench_norm<int8_t>("int8", calib, runs, rng);
+    failures += !bench_norm<int16_t>("int16", calib, runs, rng);
+    return failures ? 1 : 0;
+}
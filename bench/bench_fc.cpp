@@ -0,0 +1,146 @@
+/* bench_fc.cpp */
+
+// Throughput of arm_fully_connected_q15 against the plain reference loop over the dense layer
+// shapes of the generated models: a flattened 1-D conv output into a first dense layer, then the
+// narrower layers down to the model outputs. Built with NEON=1 this times the NEON kernel, with
+// NEON=0 the __SMLAD one.
+//
+//   bench_fc [random shapes to check]
+//
+// Before timing, the kernel is checked bit for bit against the reference on random shapes, odd
+// lengths and saturating values included.
+
+#include "arm_nnfunctions.h"
+#include "arm_nnsupportfunctions.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using bench_clock = std::chrono::steady_clock;
+
+struct fc_shape_t
+{
+    uint16_t dim_vec;
+    uint16_t num_of_rows;
+};
+
+// From the flattened conv outputs (window x filters) down to the output layers
+constexpr fc_shape_t SHAPES[] = {
+    {4096, 64}, {2048, 64}, {2048, 32}, {1024, 128}, {1024, 32}, {512, 64},
+    {256, 64}, {256, 16}, {128, 32}, {64, 16}, {64, 10}, {32, 2}, {16, 1}, {130, 3},
+};
+
+// Same arithmetic as the reference path of the kernel, the accumulation wraps like __SMLAD
+static void reference_fc(const q15_t *pV, const q15_t *pM, uint16_t dim_vec, uint16_t num_of_rows, uint16_t bias_shift,
+                         uint16_t out_shift, const q15_t *bias, q15_t *pOut)
+{
+    for (uint16_t i = 0; i < num_of_rows; ++i)
+    {
+        uint32_t acc = static_cast<uint32_t>((static_cast<q31_t>(bias[i]) << bias_shift) + NN_ROUND(out_shift));
+        for (uint16_t j = 0; j < dim_vec; ++j)
+            acc += static_cast<uint32_t>(pV[j] * pM[i * dim_vec + j]);
+        pOut[i] = static_cast<q15_t>(__SSAT(static_cast<q31_t>(acc) >> out_shift, 16));
+    }
+}
+
+static void fill(std::vector<q15_t> &v, size_t n, std::mt19937 &rng, int shift)
+{
+    std::uniform_int_distribution<int> dist(-32768, 32767);
+    v.resize(n);
+    for (q15_t &x : v)
+        x = static_cast<q15_t>(dist(rng) >> shift);
+}
+
+static bool check(std::mt19937 &rng, unsigned count)
+{
+    std::vector<q15_t> vec, weights, bias, out, ref;
+    for (unsigned n = 0; n < count; ++n)
+    {
+        const uint16_t dim_vec = 1 + rng() % 300;
+        const uint16_t rows = 1 + rng() % 23;
+        const uint16_t bias_shift = rng() % 4;
+        const uint16_t out_shift = rng() % 16;
+        // Full scale values half of the time, to exercise the wrap-around and the saturation
+        const int shift = rng() % 2 ? 0 : rng() % 10;
+
+        fill(vec, dim_vec, rng, shift);
+        fill(weights, dim_vec * rows, rng, shift);
+        fill(bias, rows, rng, 4);
+        out.assign(rows, 0);
+        ref.assign(rows, 0);
+
+        arm_fully_connected_q15(vec.data(), weights.data(), dim_vec, rows, bias_shift, out_shift, bias.data(), out.data(), nullptr);
+        reference_fc(vec.data(), weights.data(), dim_vec, rows, bias_shift, out_shift, bias.data(), ref.data());
+        if (std::memcmp(out.data(), ref.data(), rows * sizeof(q15_t)) != 0)
+        {
+            fprintf(stderr, "dim_vec %u, %u rows: kernel differs from the reference\n", dim_vec, rows);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Calls `run` for about 0.2 s and returns the time per call in ns
+template <typename F>
+static double time_calls(F run)
+{
+    uint64_t calls = 0;
+    auto start = bench_clock::now();
+    auto elapsed = bench_clock::duration::zero();
+    while (elapsed < std::chrono::milliseconds(200))
+    {
+        run();
+        ++calls;
+        elapsed = bench_clock::now() - start;
+    }
+    return std::chrono::duration<double, std::nano>(elapsed).count() / calls;
+}
+
+int main(int argc, char **argv)
+{
+    const unsigned checks = argc > 1 ? strtoul(argv[1], nullptr, 10) : 2000;
+
+    std::mt19937 rng(42);
+    if (!check(rng, checks))
+        return 1;
+    printf("%u random shapes bit-exact with the reference\n", checks);
+
+#if defined(ARM_MATH_NEON)
+    const char *path = "NEON";
+#elif defined(ARM_MATH_DSP)
+    const char *path = "__SMLAD";
+#else
+    const char *path = "reference";
+#endif
+    printf("arm_fully_connected_q15, %s path\n", path);
+    printf("%8s %6s %10s %12s %12s %12s %9s\n", "dim_vec", "rows", "KiB", "ref ns", "kernel ns", "kernel MMAC/s", "speedup");
+
+    std::vector<q15_t> vec, weights, bias, out, ref;
+    for (const fc_shape_t &s : SHAPES)
+    {
+        fill(vec, s.dim_vec, rng, 4);
+        fill(weights, s.dim_vec * s.num_of_rows, rng, 4);
+        fill(bias, s.num_of_rows, rng, 4);
+        out.assign(s.num_of_rows, 0);
+        ref.assign(s.num_of_rows, 0);
+
+        const double ref_ns = time_calls([&]
+                                         { reference_fc(vec.data(), weights.data(), s.dim_vec, s.num_of_rows, 0, 12, bias.data(), ref.data()); });
+        const double kernel_ns = time_calls([&]
+                                            { arm_fully_connected_q15(vec.data(), weights.data(), s.dim_vec, s.num_of_rows, 0, 12, bias.data(), out.data(), nullptr); });
+        if (std::memcmp(out.data(), ref.data(), s.num_of_rows * sizeof(q15_t)) != 0)
+        {
+            fprintf(stderr, "dim_vec %u, %u rows: kernel differs from the reference\n", s.dim_vec, s.num_of_rows);
+            return 1;
+        }
+
+        const double macs = static_cast<double>(s.dim_vec) * s.num_of_rows;
+        printf("%8u %6u %10.1f %12.0f %12.0f %12.1f %8.2fx\n", s.dim_vec, s.num_of_rows,
+               weights.size() * sizeof(q15_t) / 1024.0, ref_ns, kernel_ns, macs / kernel_ns * 1e3, ref_ns / kernel_ns);
+    }
+
+    return 0;
+}
@@ -0,0 +1,344 @@
+/* bench_kernels.cpp */
+
+// Timing of the CMSIS kernels the generated models call: arm_convolve_HWC_q15_basic_nonsquare,
+// arm_convolve_HWC_q15_fast_nonsquare, arm_fully_connected_q15 and arm_relu_q15, over a fixed grid
+// of shapes plus the layer shapes of the model in model/ (model/kernel_shapes.inc, listed at build
+// time by tools/model_shapes.py).
+//
+//   bench_kernels [--json results.json] [--samples N] [--model-only]
+//
+// Each shape is warmed up, then timed over N samples (200 by default) of enough back to back calls
+// to last SAMPLE_MIN_NS. The table gives ns/call (median and p99 over the samples), MAC/s and the
+// bytes a call reads and writes (input, weights, bias and output once each, im2col copies not
+// counted). --json writes the same figures, with the kernel path and compiler, for tracking
+// regressions across kernel changes.
+
+#include "arm_nnfunctions.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+using bench_clock = std::chrono::steady_clock;
+
+enum kernel_id_t
+{
+    KERNEL_CONV_BASIC,
+    KERNEL_CONV_FAST,
+    KERNEL_FC,
+    KERNEL_RELU
+};
+
+constexpr const char *KERNEL_NAMES[] = {
+    "arm_convolve_HWC_q15_basic_nonsquare",
+    "arm_convolve_HWC_q15_fast_nonsquare",
+    "arm_fully_connected_q15",
+    "arm_relu_q15",
+};
+
+// Convolutions use in_x .. out_y, the fully connected layer dim_vec and rows, the ReLU size
+struct kernel_shape_t
+{
+    kernel_id_t kernel = KERNEL_RELU;
+    const char *source = nullptr;
+    uint16_t in_x = 0, in_y = 0, ch_in = 0, ch_out = 0, k_x = 0, k_y = 0, pad_x = 0, pad_y = 0, stride_x = 0, stride_y = 0,
+             out_x = 0, out_y = 0;
+    uint16_t dim_vec = 0, rows = 0;
+    uint16_t size = 0;
+};
+
+// 1-D layers over the window as the models use them, a few 2-D ones for the im2col paths
+constexpr kernel_shape_t GRID[] = {
+    {.kernel = KERNEL_CONV_BASIC, .source = "grid", .in_x = 128, .in_y = 1, .ch_in = 1, .ch_out = 8, .k_x = 5, .k_y = 1, .pad_x = 2, .pad_y = 0, .stride_x = 1, .stride_y = 1, .out_x = 128, .out_y = 1},
+    {.kernel = KERNEL_CONV_BASIC, .source = "grid", .in_x = 16, .in_y = 16, .ch_in = 3, .ch_out = 16, .k_x = 3, .k_y = 3, .pad_x = 1, .pad_y = 1, .stride_x = 1, .stride_y = 1, .out_x = 16, .out_y = 16},
+    {.kernel = KERNEL_CONV_FAST, .source = "grid", .in_x = 128, .in_y = 1, .ch_in = 2, .ch_out = 16, .k_x = 5, .k_y = 1, .pad_x = 2, .pad_y = 0, .stride_x = 1, .stride_y = 1, .out_x = 128, .out_y = 1},
+    {.kernel = KERNEL_CONV_FAST, .source = "grid", .in_x = 128, .in_y = 1, .ch_in = 16, .ch_out = 32, .k_x = 3, .k_y = 1, .pad_x = 1, .pad_y = 0, .stride_x = 1, .stride_y = 1, .out_x = 128, .out_y = 1},
+    {.kernel = KERNEL_CONV_FAST, .source = "grid", .in_x = 256, .in_y = 1, .ch_in = 8, .ch_out = 8, .k_x = 7, .k_y = 1, .pad_x = 0, .pad_y = 0, .stride_x = 2, .stride_y = 1, .out_x = 125, .out_y = 1},
+    {.kernel = KERNEL_CONV_FAST, .source = "grid", .in_x = 16, .in_y = 16, .ch_in = 8, .ch_out = 16, .k_x = 3, .k_y = 3, .pad_x = 1, .pad_y = 1, .stride_x = 1, .stride_y = 1, .out_x = 16, .out_y = 16},
+    {.kernel = KERNEL_CONV_FAST, .source = "grid", .in_x = 32, .in_y = 8, .ch_in = 16, .ch_out = 32, .k_x = 5, .k_y = 3, .pad_x = 2, .pad_y = 1, .stride_x = 1, .stride_y = 1, .out_x = 32, .out_y = 8},
+    {.kernel = KERNEL_FC, .source = "grid", .dim_vec = 4096, .rows = 64},
+    {.kernel = KERNEL_FC, .source = "grid", .dim_vec = 2048, .rows = 32},
+    {.kernel = KERNEL_FC, .source = "grid", .dim_vec = 512, .rows = 64},
+    {.kernel = KERNEL_FC, .source = "grid", .dim_vec = 128, .rows = 32},
+    {.kernel = KERNEL_FC, .source = "grid", .dim_vec = 64, .rows = 10},
+    {.kernel = KERNEL_FC, .source = "grid", .dim_vec = 130, .rows = 3},
+    {.kernel = KERNEL_RELU, .source = "grid", .size = 256},
+    {.kernel = KERNEL_RELU, .source = "grid", .size = 2048},
+    {.kernel = KERNEL_RELU, .source = "grid", .size = 16384},
+};
+
+constexpr kernel_shape_t MODEL_SHAPES[] = {
+#include "../model/kernel_shapes.inc"
+    // Keeps the array non empty when the model has no call to list
+    {},
+};
+
+constexpr uint64_t SAMPLE_MIN_NS = 200000;
+constexpr auto WARMUP_TIME = std::chrono::milliseconds(20);
+
+struct kernel_data_t
+{
+    std::vector<q15_t> input, weights, bias, output, col;
+};
+
+struct kernel_result_t
+{
+    const kernel_shape_t *shape;
+    double median_ns, p99_ns, min_ns, mean_ns;
+    uint64_t macs, bytes;
+    uint64_t calls_per_sample;
+};
+
+static void fill(std::vector<q15_t> &v, size_t n, std::mt19937 &rng, int range)
+{
+    std::uniform_int_distribution<int> dist(-range, range);
+    v.resize(n);
+    for (q15_t &x : v)
+        x = static_cast<q15_t>(dist(rng));
+}
+
+static uint32_t col_len(const kernel_shape_t &s)
+{
+    return static_cast<uint32_t>(s.ch_in) * s.k_x * s.k_y;
+}
+
+static uint64_t shape_macs(const kernel_shape_t &s)
+{
+    switch (s.kernel)
+    {
+    case KERNEL_CONV_BASIC:
+    case KERNEL_CONV_FAST:
+        return static_cast<uint64_t>(s.out_x) * s.out_y * s.ch_out * col_len(s);
+    case KERNEL_FC:
+        return static_cast<uint64_t>(s.dim_vec) * s.rows;
+    case KERNEL_RELU:
+        return 0;
+    }
+    return 0;
+}
+
+static uint64_t shape_bytes(const kernel_shape_t &s)
+{
+    switch (s.kernel)
+    {
+    case KERNEL_CONV_BASIC:
+    case KERNEL_CONV_FAST:
+        return sizeof(q15_t) * (static_cast<uint64_t>(s.in_x) * s.in_y * s.ch_in + static_cast<uint64_t>(s.ch_out) * col_len(s) +
+                                s.ch_out + static_cast<uint64_t>(s.out_x) * s.out_y * s.ch_out);
+    case KERNEL_FC:
+        return sizeof(q15_t) * (s.dim_vec + static_cast<uint64_t>(s.dim_vec) * s.rows + 2 * s.rows);
+    case KERNEL_RELU:
+        return sizeof(q15_t) * 2 * static_cast<uint64_t>(s.size);
+    }
+    return 0;
+}
+
+static void prepare(const kernel_shape_t &s, kernel_data_t &d, std::mt19937 &rng)
+{
+    switch (s.kernel)
+    {
+    case KERNEL_CONV_BASIC:
+    case KERNEL_CONV_FAST:
+        fill(d.input, static_cast<size_t>(s.in_x) * s.in_y * s.ch_in, rng, 4000);
+        fill(d.weights, static_cast<size_t>(s.ch_out) * col_len(s), rng, 2000);
+        fill(d.bias, s.ch_out, rng, 200);
+        d.output.assign(static_cast<size_t>(s.out_x) * s.out_y * s.ch_out, 0);
+        d.col.assign(2 * col_len(s), 0);
+        break;
+    case KERNEL_FC:
+        fill(d.input, s.dim_vec, rng, 4000);
+        fill(d.weights, static_cast<size_t>(s.dim_vec) * s.rows, rng, 2000);
+        fill(d.bias, s.rows, rng, 200);
+        d.output.assign(s.rows, 0);
+        break;
+    case KERNEL_RELU:
+        fill(d.input, s.size, rng, 4000);
+        d.output = d.input;
+        break;
+    }
+}
+
+static arm_status run(const kernel_shape_t &s, kernel_data_t &d)
+{
+    switch (s.kernel)
+    {
+    case KERNEL_CONV_BASIC:
+        return arm_convolve_HWC_q15_basic_nonsquare(d.input.data(), s.in_x, s.in_y, s.ch_in, d.weights.data(), s.ch_out, s.k_x,
+                                                    s.k_y, s.pad_x, s.pad_y, s.stride_x, s.stride_y, d.bias.data(), 0, 9,
+                                                    d.output.data(), s.out_x, s.out_y, d.col.data(), nullptr);
+    case KERNEL_CONV_FAST:
+        return arm_convolve_HWC_q15_fast_nonsquare(d.input.data(), s.in_x, s.in_y, s.ch_in, d.weights.data(), s.ch_out, s.k_x,
+                                                   s.k_y, s.pad_x, s.pad_y, s.stride_x, s.stride_y, d.bias.data(), 0, 9,
+                                                   d.output.data(), s.out_x, s.out_y, d.col.data(), nullptr);
+    case KERNEL_FC:
+        return arm_fully_connected_q15(d.input.data(), d.weights.data(), s.dim_vec, s.rows, 0, 12, d.bias.data(),
+                                       d.output.data(), nullptr);
+    case KERNEL_RELU:
+        // The input turns non negative after the first call, which does not change the work done
+        arm_relu_q15(d.output.data(), s.size);
+        return ARM_MATH_SUCCESS;
+    }
+    return ARM_MATH_ARGUMENT_ERROR;
+}
+
+static uint64_t time_ns(const kernel_shape_t &s, kernel_data_t &d, uint64_t calls)
+{
+    auto start = bench_clock::now();
+    for (uint64_t n = 0; n < calls; ++n)
+        run(s, d);
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(bench_clock::now() - start).count();
+}
+
+static bool measure(const kernel_shape_t &s, unsigned samples, std::mt19937 &rng, kernel_result_t &result)
+{
+    kernel_data_t d;
+    prepare(s, d, rng);
+    if (run(s, d) != ARM_MATH_SUCCESS)
+        return false;
+
+    // Warm up the caches and the clock, and size a sample to SAMPLE_MIN_NS
+    uint64_t calls = 1;
+    auto start = bench_clock::now();
+    while (bench_clock::now() - start < WARMUP_TIME)
+    {
+        if (time_ns(s, d, calls) < SAMPLE_MIN_NS)
+            calls *= 2;
+    }
+
+    std::vector<double> per_call(samples);
+    for (double &ns : per_call)
+        ns = static_cast<double>(time_ns(s, d, calls)) / calls;
+    std::sort(per_call.begin(), per_call.end());
+
+    double total = 0;
+    for (double ns : per_call)
+        total += ns;
+
+    result.shape = &s;
+    result.median_ns = per_call[samples / 2];
+    result.p99_ns = per_call[std::min<size_t>(samples - 1, (samples * 99) / 100)];
+    result.min_ns = per_call.front();
+    result.mean_ns = total / samples;
+    result.macs = shape_macs(s);
+    result.bytes = shape_bytes(s);
+    result.calls_per_sample = calls;
+    return true;
+}
+
+static std::string describe(const kernel_shape_t &s)
+{
+    char text[96];
+    switch (s.kernel)
+    {
+    case KERNEL_CONV_BASIC:
+    case KERNEL_CONV_FAST:
+        snprintf(text, sizeof(text), "%ux%ux%u k%ux%u s%u,%u -> %ux%ux%u", s.in_x, s.in_y, s.ch_in, s.k_x, s.k_y, s.stride_x,
+                 s.stride_y, s.out_x, s.out_y, s.ch_out);
+        break;
+    case KERNEL_FC:
+        snprintf(text, sizeof(text), "%u -> %u", s.dim_vec, s.rows);
+        break;
+    case KERNEL_RELU:
+        snprintf(text, sizeof(text), "%u", s.size);
+        break;
+    }
+    return text;
+}
+
+static const char *kernel_path()
+{
+#if defined(ARM_MATH_NEON)
+    return "NEON";
+#elif defined(ARM_NN_X86) && defined(__AVX2__)
+    return "AVX2";
+#elif defined(ARM_NN_X86)
+    return "SSE4.1";
+#elif defined(ARM_MATH_DSP)
+    return "__SMLAD";
+#else
+    return "reference";
+#endif
+}
+
+static bool write_json(const char *path, const std::vector<kernel_result_t> &results, unsigned samples)
+{
+    FILE *out = fopen(path, "w");
+    if (!out)
+        return false;
+
+    fprintf(out, "{\n  \"path\": \"%s\",\n  \"compiler\": \"%s\",\n  \"samples\": %u,\n  \"results\": [\n", kernel_path(),
+            __VERSION__, samples);
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const kernel_result_t &r = results[i];
+        const kernel_shape_t &s = *r.shape;
+        fprintf(out, "    {\"kernel\": \"%s\", \"source\": \"%s\", \"shape\": \"%s\", ", KERNEL_NAMES[s.kernel], s.source,
+                describe(s).c_str());
+        fprintf(out, "\"ns_per_call\": {\"median\": %.1f, \"p99\": %.1f, \"min\": %.1f, \"mean\": %.1f}, ", r.median_ns, r.p99_ns,
+                r.min_ns, r.mean_ns);
+        fprintf(out, "\"macs\": %llu, \"mac_per_s\": %.0f, \"bytes\": %llu, \"bytes_per_s\": %.0f, \"calls_per_sample\": %llu}%s\n",
+                static_cast<unsigned long long>(r.macs), r.macs / r.median_ns * 1e9, static_cast<unsigned long long>(r.bytes),
+                r.bytes / r.median_ns * 1e9, static_cast<unsigned long long>(r.calls_per_sample), i + 1 < results.size() ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+    return fclose(out) == 0;
+}
+
+int main(int argc, char **argv)
+{
+    const char *json_path = nullptr;
+    unsigned samples = 200;
+    bool model_only = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+            json_path = argv[++i];
+        else if (std::strcmp(argv[i], "--samples") == 0 && i + 1 < argc)
+            samples = std::max(1ul, strtoul(argv[++i], nullptr, 10));
+        else if (std::strcmp(argv[i], "--model-only") == 0)
+            model_only = true;
+        else
+        {
+            fprintf(stderr, "Usage: %s [--json results.json] [--samples N] [--model-only]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    std::vector<const kernel_shape_t *> shapes;
+    for (const kernel_shape_t &s : MODEL_SHAPES)
+        if (s.source)
+            shapes.push_back(&s);
+    if (!model_only)
+        for (const kernel_shape_t &s : GRID)
+            shapes.push_back(&s);
+
+    printf("CMSIS kernels, %s path, %u samples per shape\n", kernel_path(), samples);
+    printf("%-38s %-20s %-30s %11s %11s %10s %10s %10s\n", "kernel", "source", "shape", "median ns", "p99 ns", "MMAC/s", "KiB",
+           "MB/s");
+
+    std::mt19937 rng(42);
+    std::vector<kernel_result_t> results;
+    for (const kernel_shape_t *s : shapes)
+    {
+        kernel_result_t r;
+        if (!measure(*s, samples, rng, r))
+        {
+            fprintf(stderr, "%s %s: shape rejected by the kernel, skipped\n", KERNEL_NAMES[s->kernel], describe(*s).c_str());
+            continue;
+        }
+        results.push_back(r);
+        printf("%-38s %-20s %-30s %11.0f %11.0f %10.1f %10.1f %10.0f\n", KERNEL_NAMES[s->kernel], s->source, describe(*s).c_str(),
+               r.median_ns, r.p99_ns, r.macs / r.median_ns * 1e3, r.bytes / 1024.0, r.bytes / r.median_ns * 1e3);
+    }
+
+    if (json_path && !write_json(json_path, results, samples))
+    {
+        fprintf(stderr, "Error writing %s\n", json_path);
+        return 1;
+    }
+    return 0;
+}
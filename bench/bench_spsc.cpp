@@ -0,0 +1,158 @@
+/* bench_spsc.cpp */
+
+// Compares the futex backed spsc_ring_t against the std::queue + mutex + condition_variable
+// hand-off that Channel used before. Each item stands in for one acquired window handle.
+//
+//   bench_spsc [items]
+//
+// Unpaced runs give the raw throughput, paced runs push at a fixed window rate and report the
+// producer -> consumer hand-off latency, which is what matters for the acquisition thread.
+
+#include "SpscRing.hpp"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+using bench_clock = std::chrono::steady_clock;
+
+static uint64_t now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(bench_clock::now().time_since_epoch()).count();
+}
+
+struct bench_result_t
+{
+    double items_per_s;
+    double p50_ns;
+    double p99_ns;
+};
+
+// Item payload is the push timestamp, so the consumer can measure the hand-off latency
+struct condvar_queue_t
+{
+    std::queue<uint64_t> queue;
+    std::mutex mtx;
+    std::condition_variable cond;
+    bool done = false;
+};
+
+static void pace(uint64_t start_ns, uint64_t period_ns, uint64_t i)
+{
+    if (period_ns == 0)
+        return;
+    uint64_t due = start_ns + i * period_ns;
+    while (now_ns() < due)
+    {
+    }
+}
+
+static bench_result_t summarize(std::vector<uint64_t> &latencies, uint64_t elapsed_ns)
+{
+    std::sort(latencies.begin(), latencies.end());
+    bench_result_t result;
+    result.items_per_s = latencies.size() * 1e9 / elapsed_ns;
+    result.p50_ns = latencies[latencies.size() / 2];
+    result.p99_ns = latencies[latencies.size() * 99 / 100];
+    return result;
+}
+
+static bench_result_t run_condvar(uint64_t items, uint64_t period_ns)
+{
+    condvar_queue_t q;
+    std::vector<uint64_t> latencies;
+    latencies.reserve(items);
+
+    std::thread consumer([&]
+                         {
+        while (true)
+        {
+            uint64_t stamp;
+            {
+                std::unique_lock<std::mutex> lock(q.mtx);
+                q.cond.wait(lock, [&] { return !q.queue.empty() || q.done; });
+                if (q.queue.empty() && q.done)
+                    break;
+                stamp = q.queue.front();
+                q.queue.pop();
+            }
+            latencies.push_back(now_ns() - stamp);
+        } });
+
+    uint64_t start = now_ns();
+    for (uint64_t i = 0; i < items; ++i)
+    {
+        pace(start, period_ns, i);
+        std::lock_guard<std::mutex> lock(q.mtx);
+        q.queue.push(now_ns());
+        q.cond.notify_all();
+    }
+    {
+        std::lock_guard<std::mutex> lock(q.mtx);
+        q.done = true;
+    }
+    q.cond.notify_all();
+    consumer.join();
+
+    return summarize(latencies, now_ns() - start);
+}
+
+static bench_result_t run_spsc(uint64_t items, uint64_t period_ns)
+{
+    static spsc_ring_t<uint64_t, 4096> ring;
+    std::atomic<bool> done{false};
+    std::vector<uint64_t> latencies;
+    latencies.reserve(items);
+
+    std::thread consumer([&]
+                         {
+        uint64_t stamp;
+        while (ring.pop_wait(stamp, [&] { return done.load(); }))
+            latencies.push_back(now_ns() - stamp); });
+
+    uint64_t start = now_ns();
+    for (uint64_t i = 0; i < items; ++i)
+    {
+        pace(start, period_ns, i);
+        while (!ring.try_push(now_ns()))
+            std::this_thread::yield();
+    }
+    done.store(true);
+    ring.wake();
+    consumer.join();
+
+    return summarize(latencies, now_ns() - start);
+}
+
+static void report(const char *name, uint64_t rate, const bench_result_t &r)
+{
+    if (rate)
+        printf("%-10s %10llu win/s paced  %12.0f items/s  p50 %8.0f ns  p99 %8.0f ns\n", name,
+               static_cast<unsigned long long>(rate), r.items_per_s, r.p50_ns, r.p99_ns);
+    else
+        printf("%-10s %16s  %12.0f items/s  p50 %8.0f ns  p99 %8.0f ns\n", name, "unpaced",
+               r.items_per_s, r.p50_ns, r.p99_ns);
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t items = argc > 1 ? strtoull(argv[1], nullptr, 10) : 2000000;
+
+    report("condvar", 0, run_condvar(items, 0));
+    report("spsc", 0, run_spsc(items, 0));
+
+    // The ADC hands over about 1000 windows/s today, go well past that
+    for (uint64_t rate : {10000ULL, 100000ULL, 1000000ULL})
+    {
+        uint64_t paced_items = std::min<uint64_t>(items, rate);
+        report("condvar", rate, run_condvar(paced_items, 1000000000ULL / rate));
+        report("spsc", rate, run_spsc(paced_items, 1000000000ULL / rate));
+    }
+
+    return 0;
+}
@@ -0,0 +1,175 @@
+/* bench_team.cpp */
+
+// Fork/join cost of the inference team (InferenceTeam.hpp) and what it buys on layers of the size
+// of the generated models. Build with TEAM > 1, the kernels only split their layers with
+// ARM_NN_TEAM.
+//
+//   bench_team [helpers]
+//
+// fork/join: an empty layer through arm_nn_team->run(), back to back (helpers still spinning) and
+// INFERENCE_TEAM_SPIN_US + 1 ms apart (helpers parked on the futex).
+// layers: 1-D convolutions and fully connected layers on the calling thread alone, then over the
+// team, both outputs compared bit for bit.
+
+#include "InferenceTeam.hpp"
+#include "arm_nnfunctions.h"
+#include "arm_nnsupportfunctions.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using bench_clock = std::chrono::steady_clock;
+
+struct team_layer_t
+{
+    bool conv;
+    uint16_t in_x, ch_in, ch_out, k_x;
+    uint16_t dim_vec, rows;
+};
+
+// 1-D convolutions from the raw window to the last feature maps, then the dense layers after them
+constexpr team_layer_t LAYERS[] = {
+    {true, 1024, 1, 32, 16, 0, 0}, {true, 512, 32, 32, 8, 0, 0}, {true, 256, 32, 64, 5, 0, 0},
+    {true, 128, 64, 64, 3, 0, 0},  {true, 64, 64, 16, 3, 0, 0},  {false, 0, 0, 0, 0, 4096, 64},
+    {false, 0, 0, 0, 0, 2048, 64}, {false, 0, 0, 0, 0, 1024, 128}, {false, 0, 0, 0, 0, 256, 16},
+};
+
+constexpr int LAYER_RUNS = 50;
+
+static void empty_part(void *, int32_t, int32_t)
+{
+}
+
+static double median(std::vector<double> &v)
+{
+    std::sort(v.begin(), v.end());
+    return v[v.size() / 2];
+}
+
+static void time_fork_join(const char *label, std::chrono::microseconds gap, int runs, int32_t parts)
+{
+    std::vector<double> ns;
+    for (int i = 0; i < runs; ++i)
+    {
+        if (gap.count())
+            std::this_thread::sleep_for(gap);
+        auto start = bench_clock::now();
+        arm_nn_team->run(empty_part, nullptr, parts);
+        auto end = bench_clock::now();
+        ns.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+    }
+    const double med = median(ns);
+    printf("fork/join %-8s %5d runs  median %8.0f ns  p99 %8.0f ns  max %8.0f ns\n", label, runs, med,
+           ns[ns.size() * 99 / 100], ns.back());
+}
+
+template <typename F>
+static double time_layer(F &&layer)
+{
+    for (int i = 0; i < 5; ++i)
+        layer();
+    std::vector<double> us;
+    for (int i = 0; i < LAYER_RUNS; ++i)
+    {
+        auto start = bench_clock::now();
+        layer();
+        auto end = bench_clock::now();
+        us.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+    }
+    return median(us);
+}
+
+static std::vector<q15_t> random_values(size_t n, std::mt19937 &rng)
+{
+    std::uniform_int_distribution<int> dist(-2048, 2047);
+    std::vector<q15_t> v(n);
+    for (q15_t &x : v)
+        x = static_cast<q15_t>(dist(rng));
+    return v;
+}
+
+int main(int argc, char **argv)
+{
+    const int helpers = argc > 1 ? atoi(argv[1]) : INFERENCE_TEAM - 1;
+
+    // Pinned like a single channel process, the helpers go to the cores after this one
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(0, &cpuset);
+    sched_setaffinity(0, sizeof(cpuset), &cpuset);
+
+    if (!start_inference_team(helpers, 0, 1))
+        return 1;
+    const int32_t parts = helpers + 1;
+#if !defined(ARM_NN_TEAM)
+    printf("Built without ARM_NN_TEAM (TEAM=1), the layers below run on one thread either way\n");
+#endif
+
+    time_fork_join("spinning", std::chrono::microseconds(0), 20000, parts);
+    time_fork_join("parked", std::chrono::microseconds(INFERENCE_TEAM_SPIN_US + 1000), 200, parts);
+
+    std::mt19937 rng(1);
+    int failures = 0;
+    printf("\n%-28s %10s %7s %10s %10s %8s\n", "layer", "MACs", "parts", "alone us", "team us", "speedup");
+    for (const team_layer_t &l : LAYERS)
+    {
+        char name[64];
+        int64_t macs;
+        std::vector<q15_t> in, wt, bias, out_alone, out_team;
+        auto run = [&](q15_t *out)
+        {
+            if (l.conv)
+            {
+                const uint16_t out_x = l.in_x - l.k_x + 1;
+                arm_convolve_1_x_n_HWC_q15(in.data(), l.in_x, 1, l.ch_in, wt.data(), l.ch_out, l.k_x, 1, 0, 0, 1, 1,
+                                           bias.data(), 0, 9, out, out_x, 1, nullptr, nullptr);
+            }
+            else
+                arm_fully_connected_q15(in.data(), wt.data(), l.dim_vec, l.rows, 0, 9, bias.data(), out, nullptr);
+        };
+
+        size_t out_size;
+        int32_t count;
+        if (l.conv)
+        {
+            const int out_x = l.in_x - l.k_x + 1;
+            snprintf(name, sizeof(name), "conv %ux%u k%u -> %u", l.in_x, l.ch_in, l.k_x, l.ch_out);
+            macs = static_cast<int64_t>(out_x) * l.ch_out * l.ch_in * l.k_x;
+            in = random_values(static_cast<size_t>(l.in_x) * l.ch_in, rng);
+            wt = random_values(static_cast<size_t>(l.ch_out) * l.ch_in * l.k_x, rng);
+            bias = random_values(l.ch_out, rng);
+            out_size = static_cast<size_t>(out_x) * l.ch_out;
+            count = l.ch_out;
+        }
+        else
+        {
+            snprintf(name, sizeof(name), "fc %u -> %u", l.dim_vec, l.rows);
+            macs = static_cast<int64_t>(l.dim_vec) * l.rows;
+            in = random_values(l.dim_vec, rng);
+            wt = random_values(static_cast<size_t>(l.dim_vec) * l.rows, rng);
+            bias = random_values(l.rows, rng);
+            out_size = l.rows;
+            count = l.rows;
+        }
+        out_alone.assign(out_size, 0);
+        out_team.assign(out_size, 0);
+
+        const arm_nn_team_t *team = arm_nn_team;
+        arm_nn_team = nullptr;
+        const double alone_us = time_layer([&] { run(out_alone.data()); });
+        arm_nn_team = team;
+        const double team_us = time_layer([&] { run(out_team.data()); });
+
+        const bool same = std::memcmp(out_alone.data(), out_team.data(), out_size * sizeof(q15_t)) == 0;
+        failures += !same;
+        printf("%-28s %10lld %7d %10.1f %10.1f %7.2fx%s\n", name, static_cast<long long>(macs), arm_nn_team_parts(macs, count),
+               alone_us, team_us, alone_us / team_us, same ? "" : "  MISMATCH");
+    }
+
+    stop_inference_team();
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,217 @@
+/* bench_tiling.cpp */
+
+// L1 data cache behaviour of the tiled q15 convolutions (ARM_NN_L1_TILE_BYTES): 2-D layers through
+// arm_convolve_HWC_q15_fast_nonsquare and its _tiled variant, 1-D layers of the size of the models
+// through arm_convolve_1_x_n_HWC_q15 built without (ARM_NN_L1_TILE_BYTES=0) and with the filter
+// tiling. Both builds come from tools/kernel_path.c, as kernel_path_tile_off and kernel_path_tile_on.
+//
+//   bench_tiling [runs]
+//
+// Each layer is warmed up, then run `runs` times (20 by default) with the perf counters of this
+// thread on: cycles, instructions, L1D read accesses and L1D read misses, given per call. A
+// counter the kernel or the CPU does not offer (or perf_event_paranoid forbids) shows as "-".
+// Outputs of the two variants are compared bit for bit, the exit code is 1 on a mismatch.
+
+#include "kernel_path.h"
+#include "arm_nnsupportfunctions.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <random>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <vector>
+
+extern "C" const kernel_path_t kernel_path_tile_on;
+extern "C" const kernel_path_t kernel_path_tile_off;
+
+using bench_clock = std::chrono::steady_clock;
+
+struct tiling_layer_t
+{
+    uint16_t in_x, in_y, ch_in, ch_out, k_x, k_y, pad_x, pad_y;
+};
+
+// 2-D layers with even output rows for the stock fast kernel, then 1-D layers like bench_team's
+constexpr tiling_layer_t LAYERS_2D[] = {
+    {16, 16, 32, 64, 3, 3, 1, 1}, {8, 8, 128, 128, 3, 3, 1, 1}, {32, 8, 16, 32, 5, 3, 2, 1}, {16, 16, 8, 16, 3, 3, 1, 1},
+};
+
+constexpr tiling_layer_t LAYERS_1D[] = {
+    {1024, 1, 1, 32, 16, 1, 0, 0}, {512, 1, 32, 32, 8, 1, 0, 0}, {256, 1, 32, 64, 5, 1, 0, 0},
+    {128, 1, 64, 64, 3, 1, 0, 0},  {64, 1, 64, 16, 3, 1, 0, 0},
+};
+
+enum counter_id_t
+{
+    COUNTER_CYCLES,
+    COUNTER_INSTRUCTIONS,
+    COUNTER_L1D_ACCESS,
+    COUNTER_L1D_MISS,
+    COUNTERS
+};
+
+constexpr uint64_t L1D_READ = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8);
+
+// One fd per counter rather than a group, so the ones that open still count when another is missing
+static int counter_fds[COUNTERS];
+
+static int open_counter(uint32_t type, uint64_t config)
+{
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+static void open_counters()
+{
+    counter_fds[COUNTER_CYCLES] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    counter_fds[COUNTER_INSTRUCTIONS] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    counter_fds[COUNTER_L1D_ACCESS] =
+        open_counter(PERF_TYPE_HW_CACHE, L1D_READ | (PERF_COUNT_HW_CACHE_RESULT_ACCESS << 16));
+    counter_fds[COUNTER_L1D_MISS] = open_counter(PERF_TYPE_HW_CACHE, L1D_READ | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+    if (counter_fds[COUNTER_L1D_MISS] < 0)
+        fprintf(stderr, "No L1D miss counter (perf_event_open: %s), only the times are meaningful\n", strerror(errno));
+}
+
+struct layer_counts_t
+{
+    double us;
+    double counts[COUNTERS];
+};
+
+template <typename F>
+static layer_counts_t count_layer(int runs, F &&layer)
+{
+    for (int i = 0; i < 3; ++i)
+        layer();
+
+    for (int fd : counter_fds)
+        if (fd >= 0)
+        {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    auto start = bench_clock::now();
+    for (int i = 0; i < runs; ++i)
+        layer();
+    auto end = bench_clock::now();
+    for (int fd : counter_fds)
+        if (fd >= 0)
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+
+    layer_counts_t c;
+    c.us = std::chrono::duration<double, std::micro>(end - start).count() / runs;
+    for (int i = 0; i < COUNTERS; ++i)
+    {
+        uint64_t value = 0;
+        c.counts[i] = counter_fds[i] >= 0 && read(counter_fds[i], &value, sizeof(value)) == sizeof(value)
+                          ? static_cast<double>(value) / runs
+                          : -1;
+    }
+    return c;
+}
+
+static void print_counts(const char *name, const char *variant, const layer_counts_t &c)
+{
+    printf("%-30s %-8s %9.1f", name, variant, c.us);
+    for (double v : c.counts)
+    {
+        if (v < 0)
+            printf(" %11s", "-");
+        else
+            printf(" %11.0f", v);
+    }
+    if (c.counts[COUNTER_L1D_ACCESS] > 0 && c.counts[COUNTER_L1D_MISS] >= 0)
+        printf(" %7.2f%%", 100.0 * c.counts[COUNTER_L1D_MISS] / c.counts[COUNTER_L1D_ACCESS]);
+    printf("\n");
+}
+
+static std::vector<q15_t> random_values(size_t n, std::mt19937 &rng)
+{
+    std::uniform_int_distribution<int> dist(-2048, 2047);
+    std::vector<q15_t> v(n);
+    for (q15_t &x : v)
+        x = static_cast<q15_t>(dist(rng));
+    return v;
+}
+
+// Runs `before` and `after` on the same layer, returns false when their outputs differ
+static bool compare_layer(const tiling_layer_t &l, int runs, std::mt19937 &rng, const char *before_name, conv_q15_fn before,
+                          size_t before_buffer, const char *after_name, conv_q15_fn after, size_t after_buffer)
+{
+    const uint16_t out_x = l.in_x + 2 * l.pad_x - l.k_x + 1;
+    const uint16_t out_y = l.in_y + 2 * l.pad_y - l.k_y + 1;
+    const std::vector<q15_t> in = random_values(static_cast<size_t>(l.in_x) * l.in_y * l.ch_in, rng);
+    const std::vector<q15_t> wt = random_values(static_cast<size_t>(l.ch_out) * l.ch_in * l.k_x * l.k_y, rng);
+    const std::vector<q15_t> bias = random_values(l.ch_out, rng);
+    const size_t out_size = static_cast<size_t>(out_x) * out_y * l.ch_out;
+    std::vector<q15_t> out_before(out_size), out_after(out_size);
+    std::vector<q15_t> buffer(std::max(before_buffer, after_buffer));
+
+    char name[64];
+    snprintf(name, sizeof(name), "%ux%ux%u k%ux%u -> %u", l.in_x, l.in_y, l.ch_in, l.k_x, l.k_y, l.ch_out);
+
+    auto run = [&](conv_q15_fn conv, q15_t *out)
+    {
+        conv(in.data(), l.in_x, l.in_y, l.ch_in, wt.data(), l.ch_out, l.k_x, l.k_y, l.pad_x, l.pad_y, 1, 1, bias.data(), 0, 9,
+             out, out_x, out_y, buffer.data(), nullptr);
+    };
+    const layer_counts_t c_before = count_layer(runs, [&] { run(before, out_before.data()); });
+    const layer_counts_t c_after = count_layer(runs, [&] { run(after, out_after.data()); });
+    print_counts(name, before_name, c_before);
+    print_counts("", after_name, c_after);
+
+    if (std::memcmp(out_before.data(), out_after.data(), out_size * sizeof(q15_t)) != 0)
+    {
+        printf("%-30s MISMATCH between %s and %s\n", name, before_name, after_name);
+        return false;
+    }
+    return true;
+}
+
+static void print_header(const char *title)
+{
+    printf("\n%s\n%-30s %-8s %9s %11s %11s %11s %11s %8s\n", title, "layer", "variant", "us/call", "cycles", "instr",
+           "L1D read", "L1D miss", "miss");
+}
+
+int main(int argc, char **argv)
+{
+    const int runs = argc > 1 ? atoi(argv[1]) : 20;
+    std::mt19937 rng(1);
+    int failures = 0;
+
+    open_counters();
+    printf("ARM_NN_L1_TILE_BYTES %d, per call figures over %d runs\n", ARM_NN_L1_TILE_BYTES, runs);
+
+    print_header("im2col convolutions: arm_convolve_HWC_q15_fast_nonsquare (fast) and its _tiled variant (tiled)");
+    for (const tiling_layer_t &l : LAYERS_2D)
+    {
+        const size_t col_len = static_cast<size_t>(l.ch_in) * l.k_x * l.k_y;
+        failures += !compare_layer(l, runs, rng, "fast", kernel_path_tile_on.conv_fast, 2 * col_len, "tiled",
+                                   kernel_path_tile_on.conv_fast_tiled,
+                                   kernel_path_tile_on.conv_fast_tiled_buffer_size(l.ch_in, l.k_x, l.k_y, l.ch_out));
+    }
+
+    print_header("1-D convolutions: arm_convolve_1_x_n_HWC_q15 without (untiled) and with filter tiles (tiled)");
+    for (const tiling_layer_t &l : LAYERS_1D)
+        failures += !compare_layer(l, runs, rng, "untiled", kernel_path_tile_off.conv_1_x_n, 0, "tiled",
+                                   kernel_path_tile_on.conv_1_x_n, 0);
+
+    for (int fd : counter_fds)
+        if (fd >= 0)
+            close(fd);
+    return failures ? 1 : 0;
+}
@@ -1,6 +1,8 @@
 /*ADC.hpp*/
 
 #include "Common.hpp"
+#include "AcqMemory.hpp"
 
 void initialize_acq();
+bool map_acq_ring(acq_memory_source_t &source);
 void cleanup();
\ No newline at end of file
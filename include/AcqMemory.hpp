@@ -0,0 +1,40 @@
+/*AcqMemory.hpp*/
+
+#pragma once
+
+#include "Common.hpp"
+#include <vector>
+
+// Backing store of the ADC AXI ring. The board maps the reserved DMA region
+// through /dev/mem, a plain Linux host plugs in a heap buffer it fills itself.
+struct acq_memory_source_t
+{
+    virtual ~acq_memory_source_t() = default;
+    virtual const int16_t *map(uint32_t phys_addr, uint32_t size) = 0;
+    virtual void unmap() = 0;
+};
+
+struct devmem_source_t : acq_memory_source_t
+{
+    const int16_t *map(uint32_t phys_addr, uint32_t size) override;
+    void unmap() override;
+
+private:
+    void *mapping = nullptr;
+    size_t mapping_size = 0;
+    int fd = -1;
+};
+
+struct host_memory_source_t : acq_memory_source_t
+{
+    const int16_t *map(uint32_t phys_addr, uint32_t size) override;
+    void unmap() override;
+
+    int16_t *data() { return buffer.data(); }
+    size_t samples() const { return buffer.size(); }
+
+private:
+    std::vector<int16_t> buffer;
+};
+
+raw_view_t make_raw_view(const int16_t *ring, uint32_t pos, uint32_t count);
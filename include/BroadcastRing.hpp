@@ -0,0 +1,318 @@
+/*BroadcastRing.hpp*/
+
+#pragma once
+
+#include "SpscRing.hpp"
+
+// Single-producer/multi-consumer broadcast ring. The producer publishes each item once under an
+// increasing sequence number and every consumer reads it in place through its own cursor.
+//
+// Each consumer may lag at most `limit` items behind, when it would go past that its overflow
+// policy decides: the producer waits (BLOCK), the new item is skipped for that consumer only
+// (DROP_NEWEST), the consumer loses its oldest pending item (DROP_OLDEST) or everything but the
+// new one (KEEP_LATEST). A slot is only reused once no consumer still needs it, the slot a
+// consumer is reading is never reused under its feet.
+//
+// The slots are allocated with the ring and items are built in place, so the ring is also the
+// fixed pool of its items: no allocation and no reference count per item.
+template <typename T, uint32_t Capacity, uint32_t MaxConsumers>
+class broadcast_ring_t
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "broadcast_ring_t capacity must be a power of two");
+
+public:
+    // Consumers have to be attached before the producer starts
+    void attach(uint32_t consumer, overflow_policy_t policy, uint32_t limit)
+    {
+        cursor_t &cursor = cursors[consumer];
+        cursor.next.store(published.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        cursor.policy = policy;
+        cursor.limit = limit < 1 ? 1 : (limit > Capacity / 2 ? Capacity / 2 : limit);
+        cursor.attached = true;
+    }
+
+    bool attached(uint32_t consumer) const
+    {
+        return cursors[consumer].attached;
+    }
+
+    // Producer side: applies the overflow policies and returns the slot for the next sequence.
+    // nullptr when a consumer is still reading the slot to reuse, or a BLOCK consumer is full and stop() holds.
+    template <typename Pred>
+    T *claim(Pred &&stop)
+    {
+        uint64_t seq = published.load(std::memory_order_relaxed);
+        uint32_t skip = 0;
+        bool full = false;
+
+        for (uint32_t i = 0; i < MaxConsumers; ++i)
+        {
+            cursor_t &cursor = cursors[i];
+            if (!cursor.attached)
+                continue;
+
+            uint64_t lag = seq - cursor.next.load(std::memory_order_acquire);
+            full |= lag >= cursor.limit;
+            switch (cursor.policy)
+            {
+            case OVERFLOW_BLOCK:
+            {
+                uint32_t spins = 0;
+                while (seq - cursor.next.load(std::memory_order_acquire) >= cursor.limit)
+                {
+                    if (stop())
+                        return nullptr;
+                    block_backoff(spins);
+                }
+                break;
+            }
+            case OVERFLOW_DROP_NEWEST:
+                if (lag >= cursor.limit)
+                {
+                    skip |= 1u << i;
+                    cursor.drops.fetch_add(1, std::memory_order_relaxed);
+                }
+                break;
+            case OVERFLOW_DROP_OLDEST:
+                if (lag >= cursor.limit)
+                    drop_until(cursor, seq - cursor.limit + 1);
+                break;
+            case OVERFLOW_KEEP_LATEST:
+                if (lag >= 1)
+                    drop_until(cursor, seq);
+                break;
+            }
+        }
+        if (full)
+            full_claims.fetch_add(1, std::memory_order_relaxed);
+
+        slot_t &slot = slots[seq & (Capacity - 1)];
+        uint64_t old = slot.seq.load(std::memory_order_acquire);
+        if (old != EMPTY)
+        {
+            for (uint32_t i = 0; i < MaxConsumers; ++i)
+            {
+                cursor_t &cursor = cursors[i];
+                uint32_t spins = 0;
+                while (cursor.attached && still_needed(cursor, 1u << i, slot, old))
+                {
+                    if (cursor.holding.load(std::memory_order_seq_cst) == old)
+                    {
+                        held_claims.fetch_add(1, std::memory_order_relaxed);
+                        return nullptr;
+                    }
+                    if (cursor.policy != OVERFLOW_BLOCK)
+                    {
+                        drop_until(cursor, old + 1);
+                        continue;
+                    }
+                    if (stop())
+                        return nullptr;
+                    block_backoff(spins);
+                }
+            }
+        }
+
+        // Sequence first, skip mask second: a reader checks them in the opposite order
+        slot.seq.store(seq, std::memory_order_release);
+        slot.skip.store(skip, std::memory_order_release);
+        return &slot.value;
+    }
+
+    // Producer side: makes the claimed slot visible to every consumer
+    uint64_t publish()
+    {
+        uint64_t seq = published.load(std::memory_order_relaxed);
+        uint32_t skip = slots[seq & (Capacity - 1)].skip.load(std::memory_order_relaxed);
+        published.store(seq + 1, std::memory_order_seq_cst);
+
+        // Items skipped for a consumer never count towards its backlog
+        for (uint32_t i = 0; i < MaxConsumers; ++i)
+        {
+            cursor_t &cursor = cursors[i];
+            if (!cursor.attached || (skip & (1u << i)))
+                continue;
+            uint64_t lag = seq + 1 - cursor.next.load(std::memory_order_relaxed);
+            if (lag > cursor.lag_max.load(std::memory_order_relaxed))
+                cursor.lag_max.store(lag, std::memory_order_relaxed);
+        }
+
+        if (sleepers.load(std::memory_order_seq_cst))
+            wake();
+        return seq;
+    }
+
+    // Consumer side: blocks until the next item for this consumer is published. Returns nullptr once
+    // it has read everything and stop() holds, whoever flips stop() has to call wake() afterwards.
+    // idle() runs before each park, see park_untimed_t.
+    template <typename Pred, typename Idle = park_untimed_t>
+    const T *wait_next(uint32_t consumer, Pred &&stop, uint64_t *sequence = nullptr, Idle &&idle = Idle{})
+    {
+        cursor_t &cursor = cursors[consumer];
+        uint32_t spins = 0;
+
+        while (true)
+        {
+            uint64_t seq = cursor.next.load(std::memory_order_acquire);
+
+            if (seq >= published.load(std::memory_order_acquire))
+            {
+                if (stop())
+                {
+                    if (seq < published.load(std::memory_order_acquire))
+                        continue;
+                    return nullptr;
+                }
+
+                if (spins < park_spin_limit())
+                {
+                    ++spins;
+                    cpu_relax();
+                    continue;
+                }
+                spins = 0;
+
+                uint32_t timeout_ms = idle();
+                sleepers.fetch_add(1, std::memory_order_seq_cst);
+                uint32_t seen = signal.load(std::memory_order_seq_cst);
+                if (seq >= published.load(std::memory_order_seq_cst) && !stop())
+                    futex_wait(signal, seen, timeout_ms);
+                sleepers.fetch_sub(1, std::memory_order_relaxed);
+                continue;
+            }
+
+            // Announce the read, then make sure the producer did not move the cursor meanwhile
+            cursor.holding.store(seq, std::memory_order_seq_cst);
+            if (cursor.next.load(std::memory_order_seq_cst) != seq)
+            {
+                cursor.holding.store(EMPTY, std::memory_order_relaxed);
+                continue;
+            }
+
+            slot_t &slot = slots[seq & (Capacity - 1)];
+            uint32_t skip = slot.skip.load(std::memory_order_acquire);
+            if (slot.seq.load(std::memory_order_acquire) != seq || (skip & (1u << consumer)))
+            {
+                // Dropped for this consumer by its overflow policy
+                cursor.holding.store(EMPTY, std::memory_order_relaxed);
+                advance(cursor, seq);
+                continue;
+            }
+
+            if (sequence)
+                *sequence = seq;
+            return &slot.value;
+        }
+    }
+
+    // Consumer side: done with the item returned by wait_next()
+    void release(uint32_t consumer)
+    {
+        cursor_t &cursor = cursors[consumer];
+        advance(cursor, cursor.holding.load(std::memory_order_relaxed));
+        cursor.holding.store(EMPTY, std::memory_order_release);
+    }
+
+    void wake()
+    {
+        signal.fetch_add(1, std::memory_order_seq_cst);
+        futex_wake(signal);
+    }
+
+    // Items published but not yet released by this consumer
+    uint64_t lag(uint32_t consumer) const
+    {
+        return published.load(std::memory_order_acquire) - cursors[consumer].next.load(std::memory_order_acquire);
+    }
+
+    uint64_t lag_max(uint32_t consumer) const
+    {
+        return cursors[consumer].lag_max.load(std::memory_order_relaxed);
+    }
+
+    uint64_t drops(uint32_t consumer) const
+    {
+        return cursors[consumer].drops.load(std::memory_order_relaxed);
+    }
+
+    // Claims that found a consumer `limit` items behind, whatever its policy did about it
+    uint64_t full_count() const
+    {
+        return full_claims.load(std::memory_order_relaxed);
+    }
+
+    // Claims refused because a consumer was still reading the slot to reuse: every slot of the
+    // ring, which is also the pool of its items, was taken
+    uint64_t held_count() const
+    {
+        return held_claims.load(std::memory_order_relaxed);
+    }
+
+    uint64_t published_count() const
+    {
+        return published.load(std::memory_order_acquire);
+    }
+
+    static constexpr uint32_t capacity() { return Capacity; }
+
+private:
+    static constexpr uint64_t EMPTY = ~0ULL;
+
+    struct alignas(CACHE_LINE_SIZE) cursor_t
+    {
+        std::atomic<uint64_t> next{0};
+        std::atomic<uint64_t> holding{EMPTY};
+        std::atomic<uint64_t> lag_max{0};
+        std::atomic<uint64_t> drops{0};
+        overflow_policy_t policy = OVERFLOW_BLOCK;
+        uint32_t limit = Capacity / 2;
+        bool attached = false;
+    };
+
+    struct slot_t
+    {
+        std::atomic<uint64_t> seq{EMPTY};
+        std::atomic<uint32_t> skip{0};
+        T value;
+    };
+
+    static void advance(cursor_t &cursor, uint64_t seq)
+    {
+        uint64_t expected = seq;
+        cursor.next.compare_exchange_strong(expected, seq + 1, std::memory_order_acq_rel);
+    }
+
+    // Producer moves a consumer forward, everything it jumps over is lost for that consumer
+    static void drop_until(cursor_t &cursor, uint64_t target)
+    {
+        uint64_t next = cursor.next.load(std::memory_order_acquire);
+        while (next < target)
+        {
+            if (cursor.next.compare_exchange_weak(next, target, std::memory_order_acq_rel))
+            {
+                cursor.drops.fetch_add(target - next, std::memory_order_relaxed);
+                break;
+            }
+        }
+    }
+
+    static bool still_needed(const cursor_t &cursor, uint32_t bit, const slot_t &slot, uint64_t old)
+    {
+        if (slot.skip.load(std::memory_order_acquire) & bit)
+            return false;
+        uint64_t next = cursor.next.load(std::memory_order_seq_cst);
+        uint64_t holding = cursor.holding.load(std::memory_order_seq_cst);
+        return old >= next || old == holding;
+    }
+
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> published{0};
+    std::atomic<uint64_t> full_claims{0};
+    std::atomic<uint64_t> held_claims{0};
+
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> sleepers{0};
+    std::atomic<uint32_t> signal{0};
+
+    cursor_t cursors[MaxConsumers];
+
+    alignas(CACHE_LINE_SIZE) slot_t slots[Capacity];
+};
@@ -8,21 +8,30 @@
 
 #include <thread>
 #include <mutex>
-#include <condition_variable>
-#include <queue>
-#include <deque>
 #include <chrono>
 #include <atomic>
 #include <memory>
 #include <string>
+#include <vector>
+#include <algorithm>
 #include <sys/stat.h>
 #include <dirent.h>
 
 #include "rp.h"
 #include "../model/include/model.h"
+#include "SpscRing.hpp"
+#include "BroadcastRing.hpp"
+#include "SampleNorm.hpp"
 
 #define DATA_SIZE 16384
-#define QUEUE_MAX_SIZE 1000000
+// Windows (or results) a consumer may fall behind, half a second at 1000 windows/s. The rings are
+// allocated in place at twice that, so each step of the bound costs two data_part_t per channel.
+#define QUEUE_MAX_SIZE 512
+#define WINDOW_RING_CAPACITY (2 * QUEUE_MAX_SIZE)
+#define RING_CAPACITY (2 * QUEUE_MAX_SIZE)
+#define BIN_BLOCK_SIZE (256 * 1024)
+#define CSV_BUFFER_SIZE (1024 * 1024)
+#define ADC_SAMPLE_RATE 125000000.0
 #define DECIMATION (125000 / MODEL_INPUT_DIM_0)
 #define DISK_SPACE_THRESHOLD 0.2 * 1024 * 1024 * 1024
 #define acq_priority 1
@@ -33,20 +42,186 @@
 #define log_dac_priority 1
 #define SHM_COUNTERS "/channel_counters"
 
+#ifndef ACQ_ZERO_COPY
+#define ACQ_ZERO_COPY 0
+#endif
+
+// What the acquisition does once the DMA laps the read position: 1 jumps to ACQ_RESYNC_MARGIN
+// samples behind the write pointer, logs the gap (Channel::gaps, shared_counters_t) and flags the
+// next window as discontinuous, 0 stops the acquisition. The first ACQ_GAP_LOG_SIZE gaps are kept.
+#ifndef ACQ_OVERRUN_RESYNC
+#define ACQ_OVERRUN_RESYNC 1
+#endif
+#ifndef ACQ_RESYNC_MARGIN
+#define ACQ_RESYNC_MARGIN (DATA_SIZE / 4)
+#endif
+#define ACQ_GAP_LOG_SIZE 256
+static_assert(ACQ_RESYNC_MARGIN >= MODEL_INPUT_DIM_0 && ACQ_RESYNC_MARGIN < DATA_SIZE,
+              "ACQ_RESYNC_MARGIN has to hold a window and leave room in the ring");
+
+// Inference threads per channel, every worker past the first links its own copy of the model
+// (see the Makefile) so the static buffers of the generated cnn() are private to it
+#ifndef INFERENCE_WORKERS
+#define INFERENCE_WORKERS 1
+#endif
+#define INFERENCE_JOB_RING 64
+
+// main forks one process per channel, pinned to cores 0 and 1. 1 only runs CH1, which leaves
+// core 1 to the team helpers and inference workers of that channel
+#ifndef CHANNEL_PROCESSES
+#define CHANNEL_PROCESSES 2
+#endif
+static_assert(CHANNEL_PROCESSES == 1 || CHANNEL_PROCESSES == 2, "CHANNEL_PROCESSES must be 1 or 2");
+
+// Cores the channel process on home_core may put extra inference threads on. Cores 0 to
+// channels - 1 run the channel processes, the ones past them are dealt out between the channels.
+inline std::vector<int> spare_cores(int home_core, int channels)
+{
+    const int cores = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<int> spare;
+    for (int core = channels; core < cores; ++core)
+        if ((core - channels) % channels == home_core % channels)
+            spare.push_back(core);
+    return spare;
+}
+
+// Threads the model thread splits the output channels of large convolution and fully connected
+// layers over (see InferenceTeam.hpp), 1 runs every layer on it. Layers under
+// INFERENCE_TEAM_MIN_MACS multiply-accumulates are not worth a fork/join, and idle helpers spin
+// INFERENCE_TEAM_SPIN_US for the next layer before parking.
+#ifndef INFERENCE_TEAM
+#define INFERENCE_TEAM 1
+#endif
+#ifndef INFERENCE_TEAM_MIN_MACS
+#define INFERENCE_TEAM_MIN_MACS 65536
+#endif
+#ifndef INFERENCE_TEAM_SPIN_US
+#define INFERENCE_TEAM_SPIN_US 200
+#endif
+
+// Windows per model call (see InferenceBatch.hpp), each run on a lane with its own copy of the
+// model while the layers of all lanes go through the CMSIS *_batch kernels at once. A batch waits
+// at most INFERENCE_BATCH_WAIT_US after its first window for the others.
+#ifndef INFERENCE_BATCH
+#define INFERENCE_BATCH 1
+#endif
+#ifndef INFERENCE_BATCH_WAIT_US
+#define INFERENCE_BATCH_WAIT_US 2000
+#endif
+
+// ADC calibration of each channel, applied while the raw codes are converted for the model
+// (see ConvertRaw.hpp): code = (raw - offset) * gain, with 0 <= gain < 2
+#ifndef ADC_OFFSET_CH1
+#define ADC_OFFSET_CH1 0
+#endif
+#ifndef ADC_GAIN_CH1
+#define ADC_GAIN_CH1 1.0
+#endif
+#ifndef ADC_OFFSET_CH2
+#define ADC_OFFSET_CH2 0
+#endif
+#ifndef ADC_GAIN_CH2
+#define ADC_GAIN_CH2 1.0
+#endif
+static_assert(ADC_GAIN_CH1 >= 0 && ADC_GAIN_CH1 < 2 && ADC_GAIN_CH2 >= 0 && ADC_GAIN_CH2 < 2,
+              "ADC gains are Q2.14, from 0 to under 2");
+
+#ifndef DAC_ARB_PLAYBACK
+#define DAC_ARB_PLAYBACK 0
+#endif
+
+// CSV flush policy, see csv_flush_policy_t. 0 disables a criterion, data then only goes out
+// when the buffer fills up and on shutdown.
+#ifndef CSV_FLUSH_BYTES
+#define CSV_FLUSH_BYTES (64 * 1024)
+#endif
+#ifndef CSV_FLUSH_INTERVAL_MS
+#define CSV_FLUSH_INTERVAL_MS 1000
+#endif
+
+// Overflow policy of each consumer queue once it holds QUEUE_MAX_SIZE items.
+// A stalled disk must not hold the model back, so the file writer skips the windows it cannot take:
+// the gaps show up in the recording from raw_index (blank line in the CSV, gap table in the .bin).
+// The model keeps its oldest windows out of the way so inference stays on the live signal,
+// the DAC writers only care about the latest item.
+#ifndef POLICY_WRITE_CSV
+#define POLICY_WRITE_CSV OVERFLOW_DROP_NEWEST
+#endif
+#ifndef POLICY_WRITE_DAC
+#define POLICY_WRITE_DAC OVERFLOW_KEEP_LATEST
+#endif
+#ifndef POLICY_MODEL
+#define POLICY_MODEL OVERFLOW_DROP_OLDEST
+#endif
+#ifndef POLICY_LOG_CSV
+#define POLICY_LOG_CSV OVERFLOW_DROP_OLDEST
+#endif
+#ifndef POLICY_LOG_DAC
+#define POLICY_LOG_DAC OVERFLOW_KEEP_LATEST
+#endif
+
 extern bool save_data_csv;
+extern bool save_data_bin;
 extern bool save_data_dac;
 extern bool save_output_csv;
 extern bool save_output_dac;
 
+// Min-max normalization of the model input (SampleNorm.hpp), chosen at startup. NORM_MODEL
+// normalizes a private copy of each window on the model thread (model_inference_mod), NORM_FUSED
+// converts and normalizes in one pass on the acquisition thread, so the writers get the
+// normalized window too.
+enum input_norm_t
+{
+    NORM_OFF = 0,
+    NORM_MODEL,
+    NORM_FUSED
+};
+
+extern input_norm_t input_norm;
+
+// Read-only view of a window inside the ADC AXI ring, split in two when it wraps at DATA_SIZE.
+// It stays valid until the DMA laps it, see raw_view_valid().
+struct raw_view_t
+{
+    const int16_t *first = nullptr;
+    uint32_t first_len = 0;
+    const int16_t *second = nullptr;
+    uint32_t second_len = 0;
+
+    uint32_t size() const { return first_len + second_len; }
+    int16_t operator[](uint32_t i) const { return i < first_len ? first[i] : second[i - first_len]; }
+};
+
 struct data_part_t
 {
     input_t data;
+    raw_view_t raw;
+    uint64_t raw_index = 0;
+    bool discontinuity = false; // Samples were lost right before this window, see Channel::gaps
+};
+
+// Readers of the acquired windows, each one owns a cursor in Channel::windows
+enum window_consumer_t : uint32_t
+{
+    CONSUMER_FILE = 0, // CSV writer or binary recorder
+    CONSUMER_DAC,
+    CONSUMER_MODEL,
+    WINDOW_CONSUMERS
 };
 
 struct model_result_t
 {
     output_t output;
     double computation_time;
+    uint64_t sequence = 0; // Window the result belongs to, see broadcast_ring_t::wait_next()
+    bool discontinuity = false; // Copied from the window
+};
+
+// Accounting of one bounded consumer queue, updated by its producer
+struct queue_stats_t
+{
+    std::atomic<int> drops;
+    std::atomic<int> high_watermark;
 };
 
 struct shared_counters_t
@@ -57,33 +232,53 @@ struct shared_counters_t
     std::atomic<int> write_count_dac;
     std::atomic<int> log_count_csv;
     std::atomic<int> log_count_dac;
+    std::atomic<int> ring_full_count;      // Windows that found a consumer of the window ring QUEUE_MAX_SIZE behind
+    std::atomic<int> pool_exhausted_count; // Windows dropped because every slot of the window ring was still being read
+    std::atomic<int> overrun_count;
+    std::atomic<uint64_t> samples_lost;
+    std::atomic<int> torn_count; // Zero-copy windows the DMA overwrote during their conversion
+    std::atomic<int> batch_count;    // Batched model calls, see InferenceBatch.hpp
+    std::atomic<int> batch_timeouts; // Batches INFERENCE_BATCH_WAIT_US closed before they were full
+    std::atomic<uint64_t> batch_wait_us;  // Time the batches waited for their windows
+    std::atomic<uint64_t> batch_run_us;   // Time the batches spent in the model
+    std::atomic<uint64_t> batch_latency_max_us; // Worst time from the first window of a batch to its results
+    queue_stats_t queue_csv;
+    queue_stats_t queue_dac;
+    queue_stats_t queue_model;
+    queue_stats_t queue_log_csv;
+    queue_stats_t queue_log_dac;
     std::atomic<uint64_t> trigger_time_ns;
     std::atomic<uint64_t> end_time_ns;
     std::atomic<int> ready_barrier;
 };
 
-struct Channel
+// One overrun the acquisition resynchronized after
+struct acq_gap_t
 {
-    std::queue<std::shared_ptr<data_part_t>> data_queue_csv;
-    std::queue<std::shared_ptr<data_part_t>> data_queue_dac;
-    std::queue<std::shared_ptr<data_part_t>> model_queue;
-    std::deque<model_result_t> result_buffer_csv;
-    std::deque<model_result_t> result_buffer_dac;
+    uint64_t time_ns;      // Steady clock, as the channel counters
+    uint64_t raw_index;    // First sample lost, counted from the trigger
+    uint64_t samples_lost;
+    int window;            // Windows acquired before the gap
+};
 
-    std::mutex mtx;
-    std::condition_variable cond_write_csv;
-    std::condition_variable cond_write_dac;
-    std::condition_variable cond_model;
-    std::condition_variable cond_log_csv;
-    std::condition_variable cond_log_dac;
+static_assert(QUEUE_MAX_SIZE <= WINDOW_RING_CAPACITY / 2, "QUEUE_MAX_SIZE does not fit the window ring");
+static_assert(QUEUE_MAX_SIZE <= RING_CAPACITY, "QUEUE_MAX_SIZE does not fit the result rings");
+
+struct Channel
+{
+    // Acquired windows are published once and read in place by every consumer,
+    // model results go through one SPSC ring per writer
+    broadcast_ring_t<data_part_t, WINDOW_RING_CAPACITY, WINDOW_CONSUMERS> windows;
+    spsc_ring_t<model_result_t, RING_CAPACITY> result_buffer_csv;
+    spsc_ring_t<model_result_t, RING_CAPACITY> result_buffer_dac;
 
     rp_acq_trig_state_t state;
 
     std::chrono::steady_clock::time_point trigger_time_point;
     std::chrono::steady_clock::time_point end_time_point;
 
-    bool acquisition_done = false;
-    bool processing_done = false;
+    std::atomic<bool> acquisition_done{false};
+    std::atomic<bool> processing_done{false};
     bool channel_triggered = false;
 
     shared_counters_t *counters = nullptr;
@@ -91,6 +286,14 @@ struct Channel
     std::atomic<uint64_t> end_time_ns{0};
 
     rp_channel_t channel_id;
+    adc_calib_t calib;
+
+    const int16_t *axi_ring = nullptr;
+    std::atomic<uint64_t> raw_head{0};
+
+    // Written by the acquisition thread only, saved to DataOutput/gaps_chN.csv when it exits
+    acq_gap_t gaps[ACQ_GAP_LOG_SIZE];
+    uint32_t gap_count = 0;
 };
 
 extern std::atomic<bool> stop_acquisition;
@@ -102,25 +305,39 @@ extern pid_t pid1;
 extern pid_t pid2;
 
 template <typename T>
-inline void convert_raw_data(const int16_t *src, T dst[MODEL_INPUT_DIM_0][1], size_t count)
-{
-    for (size_t i = 0; i < count; ++i)
-    {
-        if constexpr (std::is_same<T, float>::value)
-        {
-            dst[i][0] = static_cast<float>(src[i]) / 8192.0f;
-        }
-        else if constexpr (std::is_same<T, int8_t>::value)
-        {
-            dst[i][0] = static_cast<int8_t>(std::round(src[i] / 64.0f));
-        }
-        else if constexpr (std::is_same<T, int16_t>::value)
-        {
-            dst[i][0] = src[i];
-        }
-        else
-        {
-            static_assert(!sizeof(T *), "Unsupported data type in convert_raw_data.");
-        }
-    }
+inline void convert_raw_data(const int16_t *src, T dst[MODEL_INPUT_DIM_0][1], size_t count, const adc_calib_t &calib = {})
+{
+    convert_raw_samples(src, &dst[0][0], count, calib);
+}
+
+template <typename T>
+inline void convert_raw_view(const raw_view_t &view, T dst[MODEL_INPUT_DIM_0][1], const adc_calib_t &calib = {})
+{
+    convert_raw_data(view.first, dst, view.first_len, calib);
+    if (view.second_len)
+        convert_raw_data(view.second, dst + view.first_len, view.second_len, calib);
+}
+
+template <typename T>
+inline void convert_raw_data_norm(const int16_t *src, T dst[MODEL_INPUT_DIM_0][1], size_t count, const adc_calib_t &calib = {})
+{
+    convert_raw_norm(src, count, nullptr, 0, &dst[0][0], calib);
+}
+
+template <typename T>
+inline void convert_raw_view_norm(const raw_view_t &view, T dst[MODEL_INPUT_DIM_0][1], const adc_calib_t &calib = {})
+{
+    convert_raw_norm(view.first, view.first_len, view.second, view.second_len, &dst[0][0], calib);
+}
+
+inline void store_queue_stats(queue_stats_t &stats, uint64_t drops, uint64_t high_watermark)
+{
+    stats.drops.store(static_cast<int>(drops), std::memory_order_relaxed);
+    stats.high_watermark.store(static_cast<int>(high_watermark), std::memory_order_relaxed);
+}
+
+// raw_head is the DMA position at the acquisition's last poll, `slack` covers what it wrote since
+inline bool raw_view_valid(const Channel &channel, const data_part_t &part, uint64_t slack = 0)
+{
+    return part.raw.first && channel.raw_head.load(std::memory_order_acquire) - part.raw_index + slack <= DATA_SIZE;
 }
@@ -0,0 +1,287 @@
+/*ConvertRaw.hpp*/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(ARM_MATH_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
+// Conversion of the raw ADC codes into the model input type, 8 to 32 samples per step with NEON
+// (ARM_MATH_NEON, NEON=1 on the board) or SSE4.1/AVX2 on a host, one at a time otherwise. Every
+// path gives the same values as convert_raw_scalar(): floats are code / 8192, int8 is code / 64
+// rounded half away from zero (std::lround) and saturated, int16 is the code itself. Only depends
+// on the standard library and the intrinsics so the benchmarks build it on its own.
+
+// Gains are Q2.14 so the calibration stays in 16x16 -> 32-bit integer multiplies, bit-exact on every path
+#define ADC_CALIB_GAIN_SHIFT 14
+#define ADC_CALIB_GAIN_ONE (1 << ADC_CALIB_GAIN_SHIFT)
+
+// Per-channel ADC calibration applied in the same pass: code = sat16(((raw - offset) * gain) >> 14),
+// the shift rounding half up. The default one leaves the codes untouched and is skipped.
+struct adc_calib_t
+{
+    int16_t offset = 0;
+    int16_t gain = ADC_CALIB_GAIN_ONE;
+
+    bool identity() const { return offset == 0 && gain == ADC_CALIB_GAIN_ONE; }
+};
+
+// Calibration from a gain factor, which has to stay under 2.0
+constexpr adc_calib_t make_adc_calib(int offset, double gain)
+{
+    return adc_calib_t{static_cast<int16_t>(offset),
+                       static_cast<int16_t>(gain * ADC_CALIB_GAIN_ONE + (gain < 0 ? -0.5 : 0.5))};
+}
+
+inline int16_t adc_calib_apply(int16_t raw, const adc_calib_t &calib)
+{
+    const int32_t v = ((raw - calib.offset) * calib.gain + (1 << (ADC_CALIB_GAIN_SHIFT - 1))) >> ADC_CALIB_GAIN_SHIFT;
+    return static_cast<int16_t>(std::clamp(v, -32768, 32767));
+}
+
+// One sample at a time, what the vector paths are held to and what they finish a block with
+template <typename T>
+inline void convert_raw_scalar(const int16_t *src, T *dst, size_t count, const adc_calib_t &calib)
+{
+    const bool calibrate = !calib.identity();
+    for (size_t i = 0; i < count; ++i)
+    {
+        const int16_t code = calibrate ? adc_calib_apply(src[i], calib) : src[i];
+        if constexpr (std::is_same<T, float>::value)
+        {
+            dst[i] = static_cast<float>(code) / 8192.0f;
+        }
+        else if constexpr (std::is_same<T, int8_t>::value)
+        {
+            // 14-bit samples over 8 bits, the top codes would round to 128
+            dst[i] = static_cast<int8_t>(std::clamp(std::lround(code / 64.0f), -128L, 127L));
+        }
+        else if constexpr (std::is_same<T, int16_t>::value)
+        {
+            dst[i] = code;
+        }
+        else
+        {
+            static_assert(!sizeof(T *), "Unsupported data type in convert_raw_scalar.");
+        }
+    }
+}
+
+#if defined(ARM_MATH_NEON)
+
+inline int16x8_t convert_raw_calib_neon(int16x8_t raw, const adc_calib_t &calib)
+{
+    const int16x4_t offset = vdup_n_s16(calib.offset);
+    int32x4_t lo = vmulq_n_s32(vsubl_s16(vget_low_s16(raw), offset), calib.gain);
+    int32x4_t hi = vmulq_n_s32(vsubl_s16(vget_high_s16(raw), offset), calib.gain);
+    lo = vrshrq_n_s32(lo, ADC_CALIB_GAIN_SHIFT);
+    hi = vrshrq_n_s32(hi, ADC_CALIB_GAIN_SHIFT);
+    return vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi));
+}
+
+#elif defined(__SSE4_1__)
+
+inline __m128i convert_raw_calib_x86(__m128i raw, const adc_calib_t &calib)
+{
+    const __m128i offset = _mm_set1_epi32(calib.offset);
+    const __m128i gain = _mm_set1_epi32(calib.gain);
+    const __m128i round = _mm_set1_epi32(1 << (ADC_CALIB_GAIN_SHIFT - 1));
+    __m128i lo = _mm_mullo_epi32(_mm_sub_epi32(_mm_cvtepi16_epi32(raw), offset), gain);
+    __m128i hi = _mm_mullo_epi32(_mm_sub_epi32(_mm_cvtepi16_epi32(_mm_srli_si128(raw, 8)), offset), gain);
+    lo = _mm_srai_epi32(_mm_add_epi32(lo, round), ADC_CALIB_GAIN_SHIFT);
+    hi = _mm_srai_epi32(_mm_add_epi32(hi, round), ADC_CALIB_GAIN_SHIFT);
+    return _mm_packs_epi32(lo, hi);
+}
+
+#if defined(__AVX2__)
+inline __m256i convert_raw_calib_avx2(__m256i raw, const adc_calib_t &calib)
+{
+    const __m256i offset = _mm256_set1_epi32(calib.offset);
+    const __m256i gain = _mm256_set1_epi32(calib.gain);
+    const __m256i round = _mm256_set1_epi32(1 << (ADC_CALIB_GAIN_SHIFT - 1));
+    __m256i lo = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(raw));
+    __m256i hi = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(raw, 1));
+    lo = _mm256_srai_epi32(_mm256_add_epi32(_mm256_mullo_epi32(_mm256_sub_epi32(lo, offset), gain), round),
+                           ADC_CALIB_GAIN_SHIFT);
+    hi = _mm256_srai_epi32(_mm256_add_epi32(_mm256_mullo_epi32(_mm256_sub_epi32(hi, offset), gain), round),
+                           ADC_CALIB_GAIN_SHIFT);
+    // The packs work per 128-bit lane, the permute puts the four quarters back in order
+    return _mm256_permute4x64_epi64(_mm256_packs_epi32(lo, hi), _MM_SHUFFLE(3, 1, 2, 0));
+}
+
+inline __m256i convert_raw_q7_round_avx2(__m256i code)
+{
+    const __m256i half = _mm256_set1_epi16(32);
+    return _mm256_srai_epi16(_mm256_adds_epi16(_mm256_adds_epi16(code, _mm256_srai_epi16(code, 15)), half), 6);
+}
+#endif
+
+// code / 64 rounded half away from zero: the sign takes one off the negative codes before the +32,
+// the saturation only moves codes that end up at 127 anyway
+inline __m128i convert_raw_q7_round_x86(__m128i code)
+{
+    const __m128i half = _mm_set1_epi16(32);
+    return _mm_srai_epi16(_mm_adds_epi16(_mm_adds_epi16(code, _mm_srai_epi16(code, 15)), half), 6);
+}
+
+#endif
+
+inline void convert_raw_float(const int16_t *src, float *dst, size_t count, const adc_calib_t &calib)
+{
+    size_t i = 0;
+
+#if defined(ARM_MATH_NEON)
+    const bool calibrate = !calib.identity();
+    for (; i + 8 <= count; i += 8)
+    {
+        int16x8_t code = vld1q_s16(src + i);
+        if (calibrate)
+            code = convert_raw_calib_neon(code, calib);
+        vst1q_f32(dst + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(code))), 1.0f / 8192.0f));
+        vst1q_f32(dst + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(code))), 1.0f / 8192.0f));
+    }
+#elif defined(__SSE4_1__)
+    // Without a calibration the compiler vectorizes the scalar loop as well as the intrinsics did, it
+    // only takes the calibrated codes. Scaling by a power of two, the multiply by 1 / 8192 is exact
+    // like the divide.
+    if (!calib.identity())
+    {
+#if defined(__AVX2__)
+        const __m256 scale8 = _mm256_set1_ps(1.0f / 8192.0f);
+        for (; i + 16 <= count; i += 16)
+        {
+            const __m256i code = convert_raw_calib_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i)), calib);
+            const __m256i lo = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(code));
+            const __m256i hi = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(code, 1));
+            _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(lo), scale8));
+            _mm256_storeu_ps(dst + i + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(hi), scale8));
+        }
+#endif
+        const __m128 scale = _mm_set1_ps(1.0f / 8192.0f);
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m128i code = convert_raw_calib_x86(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i)), calib);
+            _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepi16_epi32(code)), scale));
+            _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepi16_epi32(_mm_srli_si128(code, 8))), scale));
+        }
+    }
+#endif
+    convert_raw_scalar(src + i, dst + i, count - i, calib);
+}
+
+inline void convert_raw_q7(const int16_t *src, int8_t *dst, size_t count, const adc_calib_t &calib)
+{
+    size_t i = 0;
+
+#if defined(ARM_MATH_NEON)
+    // vrshr rounds half up without overflowing, the saturating sign add makes it half away from zero
+    const bool calibrate = !calib.identity();
+    for (; i + 16 <= count; i += 16)
+    {
+        int16x8_t lo = vld1q_s16(src + i);
+        int16x8_t hi = vld1q_s16(src + i + 8);
+        if (calibrate)
+        {
+            lo = convert_raw_calib_neon(lo, calib);
+            hi = convert_raw_calib_neon(hi, calib);
+        }
+        lo = vrshrq_n_s16(vqaddq_s16(lo, vshrq_n_s16(lo, 15)), 6);
+        hi = vrshrq_n_s16(vqaddq_s16(hi, vshrq_n_s16(hi, 15)), 6);
+        vst1q_s8(dst + i, vcombine_s8(vqmovn_s16(lo), vqmovn_s16(hi)));
+    }
+#elif defined(__SSE4_1__)
+    const bool calibrate = !calib.identity();
+#if defined(__AVX2__)
+    for (; i + 32 <= count; i += 32)
+    {
+        __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+        __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i + 16));
+        if (calibrate)
+        {
+            lo = convert_raw_calib_avx2(lo, calib);
+            hi = convert_raw_calib_avx2(hi, calib);
+        }
+        const __m256i q7 = _mm256_packs_epi16(convert_raw_q7_round_avx2(lo), convert_raw_q7_round_avx2(hi));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), _mm256_permute4x64_epi64(q7, _MM_SHUFFLE(3, 1, 2, 0)));
+    }
+#endif
+    for (; i + 16 <= count; i += 16)
+    {
+        __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i + 8));
+        if (calibrate)
+        {
+            lo = convert_raw_calib_x86(lo, calib);
+            hi = convert_raw_calib_x86(hi, calib);
+        }
+        const __m128i q7 = _mm_packs_epi16(convert_raw_q7_round_x86(lo), convert_raw_q7_round_x86(hi));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), q7);
+    }
+#endif
+    convert_raw_scalar(src + i, dst + i, count - i, calib);
+}
+
+inline void convert_raw_q15(const int16_t *src, int16_t *dst, size_t count, const adc_calib_t &calib)
+{
+    size_t i = 0;
+
+    if (calib.identity())
+    {
+        std::memcpy(dst, src, count * sizeof(int16_t));
+        return;
+    }
+
+#if defined(ARM_MATH_NEON)
+    for (; i + 8 <= count; i += 8)
+        vst1q_s16(dst + i, convert_raw_calib_neon(vld1q_s16(src + i), calib));
+#elif defined(__SSE4_1__)
+#if defined(__AVX2__)
+    for (; i + 16 <= count; i += 16)
+    {
+        const __m256i raw = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), convert_raw_calib_avx2(raw, calib));
+    }
+#endif
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), convert_raw_calib_x86(raw, calib));
+    }
+#endif
+    convert_raw_scalar(src + i, dst + i, count - i, calib);
+}
+
+template <typename T>
+inline void convert_raw_samples(const int16_t *src, T *dst, size_t count, const adc_calib_t &calib)
+{
+    if constexpr (std::is_same<T, float>::value)
+        convert_raw_float(src, dst, count, calib);
+    else if constexpr (std::is_same<T, int8_t>::value)
+        convert_raw_q7(src, dst, count, calib);
+    else if constexpr (std::is_same<T, int16_t>::value)
+        convert_raw_q15(src, dst, count, calib);
+    else
+        static_assert(!sizeof(T *), "Unsupported data type in convert_raw_samples.");
+}
+
+inline const char *convert_raw_path()
+{
+#if defined(ARM_MATH_NEON)
+    return "NEON";
+#elif defined(__AVX2__)
+    return "AVX2";
+#elif defined(__SSE4_1__)
+    return "SSE4.1";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,90 @@
+/*CsvWriter.hpp*/
+
+#pragma once
+
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+// When a csv_writer_t hands its buffer to the kernel. Checked at the end of every drained batch and
+// while the writer waits for more (idle()): it writes once `bytes` are pending or `interval_ms` went by since the last write, whichever
+// comes first. 0 disables a criterion, with both at 0 data only goes out when the buffer is full
+// and on close().
+struct csv_flush_policy_t
+{
+    size_t bytes = 64 * 1024;
+    uint32_t interval_ms = 1000;
+};
+
+// CSV sink formatting straight into one large reusable buffer with std::to_chars,
+// a whole batch of lines then goes out in a single write(2).
+class csv_writer_t
+{
+public:
+    // Upper bound of a formatted value, a float in fixed notation with its separator
+    static constexpr size_t MAX_VALUE_CHARS = 48;
+
+    csv_writer_t(size_t capacity, csv_flush_policy_t policy);
+    ~csv_writer_t();
+
+    bool open(const std::string &filename);
+    void close();
+    bool is_open() const { return fd >= 0; }
+
+    // Makes sure `bytes` more fit, writing the pending data out when they would not.
+    // Call it before formatting a line of at most that size.
+    void reserve(size_t bytes)
+    {
+        if (buffer.size() - used < bytes)
+        {
+            write_pending();
+            if (buffer.size() < bytes)
+                buffer.resize(bytes);
+        }
+    }
+
+    template <typename T>
+    void value(T val)
+    {
+        char *out = buffer.data() + used;
+        char *end = buffer.data() + buffer.size();
+        std::to_chars_result result;
+        if constexpr (std::is_floating_point_v<T>)
+            result = std::to_chars(out, end, val, std::chars_format::fixed, 6);
+        else
+            result = std::to_chars(out, end, static_cast<int>(val));
+
+        // A value past the reserved room (a huge double) is left out rather than overrunning the buffer
+        if (result.ec == std::errc())
+            used = result.ptr - buffer.data();
+    }
+
+    void put(char c)
+    {
+        if (used < buffer.size())
+            buffer[used++] = c;
+    }
+
+    // Called once the pending batch is drained, applies the flush policy
+    void end_batch();
+
+    // Idle hook for the queue waits (park_untimed_t): applies the flush policy, then returns the
+    // time left until the pending data is due, so an idle writer still flushes on time
+    uint32_t idle();
+
+    bool failed() const { return write_failed; }
+
+private:
+    void write_pending();
+
+    std::vector<char> buffer;
+    size_t used = 0;
+    csv_flush_policy_t policy;
+    std::chrono::steady_clock::time_point last_write;
+    int fd = -1;
+    bool write_failed = false;
+};
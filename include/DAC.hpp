@@ -3,9 +3,36 @@
 #pragma once
 
 #include "Common.hpp"
+#include <algorithm>
+#include <memory>
 #include <type_traits>
 
+// Arbitrary waveform playback: the generator buffer holds two windows played back to back, one
+// full buffer period lasts two acquisition windows at ADC_SAMPLE_RATE / DECIMATION
+#define DAC_PLAYBACK_SAMPLES (2 * MODEL_INPUT_DIM_0)
+#define DAC_PLAYBACK_FREQ (ADC_SAMPLE_RATE / (static_cast<double>(DECIMATION) * DAC_PLAYBACK_SAMPLES))
+// Writes keep clear of the last 1/DAC_PLAYBACK_GUARD of a window before their half starts
+#define DAC_PLAYBACK_GUARD 8
+
 void initialize_DAC();
+bool initialize_DAC_playback(rp_channel_t rp_channel, const float *waveform);
+
+// Buffer of one output in arbitrary waveform playback, read and written while it plays. librp only
+// uploads whole waveforms, so the board goes to the ASG registers through /dev/mem, the host
+// simulation plays the buffer off its own clock (sim/rp_gen_sim.hpp).
+struct dac_arb_port_t
+{
+    virtual ~dac_arb_port_t() = default;
+    // Sample the generator is reading, in [0, DAC_PLAYBACK_SAMPLES)
+    virtual uint32_t read_pointer() = 0;
+    // Overwrites `count` samples from `offset`, the rest of the buffer keeps playing
+    virtual bool write(uint32_t offset, const float *samples, uint32_t count) = 0;
+    // Returns once about `samples` generator samples went by
+    virtual void wait(uint32_t samples) = 0;
+};
+
+// Port of an output set up by initialize_DAC_playback(), nullptr when it cannot be opened
+std::unique_ptr<dac_arb_port_t> open_dac_arb_port(rp_channel_t rp_channel);
 
 template <typename T>
 float OutputToVoltage(T value)
@@ -27,3 +54,30 @@ float OutputToVoltage(T value)
         return static_cast<float>(value);
     }
 }
+
+// Converts a whole window to clamped DAC voltages in one pass
+template <typename T>
+void window_to_voltage(const T (&window)[MODEL_INPUT_DIM_0][MODEL_INPUT_DIM_1], float *dst)
+{
+    for (size_t k = 0; k < MODEL_INPUT_DIM_0; k++)
+    {
+        dst[k] = std::clamp(OutputToVoltage(window[k][0]), -1.0f, 1.0f);
+    }
+}
+
+// Voltages of a window taken from its raw view in the ADC ring (ACQ_ZERO_COPY), with the channel's
+// calibration but at the full 14 bits, which an int8 model input drops. False when the window has no
+// view, was normalized on conversion (NORM_FUSED) or the DMA may have reached it, one window of slack
+// covering what it wrote since the acquisition's last poll: window_to_voltage() then plays part.data.
+inline bool raw_view_to_voltage(const Channel &channel, const data_part_t &part, float *dst)
+{
+    if (input_norm == NORM_FUSED || !raw_view_valid(channel, part, MODEL_INPUT_DIM_0))
+        return false;
+
+    for (uint32_t k = 0; k < part.raw.first_len; k++)
+        dst[k] = std::clamp(adc_calib_apply(part.raw.first[k], channel.calib) / 8192.0f, -1.0f, 1.0f);
+    for (uint32_t k = 0; k < part.raw.second_len; k++)
+        dst[part.raw.first_len + k] = std::clamp(adc_calib_apply(part.raw.second[k], channel.calib) / 8192.0f, -1.0f, 1.0f);
+
+    return raw_view_valid(channel, part, MODEL_INPUT_DIM_0);
+}
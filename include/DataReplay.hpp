@@ -0,0 +1,24 @@
+/*DataReplay.hpp*/
+
+#pragma once
+
+#include "Common.hpp"
+
+// Replay source, started instead of acquire_data with `can --replay <ch1 file> [<ch2 file>] [--loops N]`.
+// The capture is loaded into memory first, then published into Channel::windows as fast as the
+// consumers take it: every queue blocks instead of dropping, so each window reaches every stage.
+// A capture is a binary recording (DataWriterBin, windows as the model receives them), a CSV
+// from write_data_csv (one window per line) or any other file as little endian int16 ADC codes,
+// which go through the channel's conversion and normalization like acquired windows. The gaps of
+// a recording (its gap table, blank lines in a CSV) come out flagged with data_part_t::discontinuity.
+// Once the last window is through, the windows/s of the source, the model and every writer are printed.
+struct replay_options_t
+{
+    const char *path[2] = {nullptr, nullptr}; // CH2 replays the CH1 capture without its own
+    int loops = 1;
+};
+
+// false on a malformed command line, path[0] stays nullptr without --replay
+bool parse_replay_args(int argc, char **argv, replay_options_t &options);
+
+void replay_data(Channel &channel, const char *path, int loops);
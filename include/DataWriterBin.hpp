@@ -0,0 +1,8 @@
+/*DataWriterBin.hpp*/
+
+#pragma once
+
+#include "Common.hpp"
+#include "RawRecord.hpp"
+
+void write_data_bin(Channel &channel, const std::string &filename);
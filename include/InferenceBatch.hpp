@@ -0,0 +1,15 @@
+/*InferenceBatch.hpp*/
+
+#pragma once
+
+#include "Common.hpp"
+
+// Runs the channel inference on batches of up to INFERENCE_BATCH windows. A batch starts with the
+// first window that comes in and runs once it is full or INFERENCE_BATCH_WAIT_US later, whichever
+// comes first. Each window of the batch runs on a lane thread of its own with its own copy of the
+// model (cnn, then cnn_wN), all of them on the model thread's core. The lanes are installed as the
+// arm_nn_batch of the kernels built with ARM_NN_BATCH: the fully connected and 1-D convolution
+// layers wait for the same call of every lane and run it once through the *_batch kernels, which
+// load each weight once for the whole batch. `prepare` runs on each window before the model,
+// nullptr feeds the window as acquired.
+void run_inference_batched(Channel &channel, void (*prepare)(input_t &input));
@@ -0,0 +1,17 @@
+/*InferencePool.hpp*/
+
+#pragma once
+
+#include "Common.hpp"
+
+// Windows handed to an inference worker, tagged with their sequence in Channel::windows
+struct inference_job_t
+{
+    input_t input;
+    uint64_t sequence;
+    bool discontinuity;
+};
+
+// Runs the channel inference on INFERENCE_WORKERS threads. `prepare` runs on the worker
+// right before cnn(), nullptr feeds the window as acquired.
+void run_inference_pool(Channel &channel, void (*prepare)(input_t &input));
@@ -0,0 +1,17 @@
+/*InferenceTeam.hpp*/
+
+#pragma once
+
+#include "Common.hpp"
+
+// Starts up to `helpers` threads and installs them as the arm_nn_team of the kernels built with
+// ARM_NN_TEAM: from then on the large convolution and fully connected layers of cnn() called on this
+// thread split their output channels over it and the helpers. The helpers only go on the cores past
+// the first `channels` ones, which the channel processes are pinned to, each channel taking every
+// `channels`-th of them from its own home_core. Helpers spin INFERENCE_TEAM_SPIN_US between layers,
+// then park on a futex until the next one. Returns false, with every layer left on the calling
+// thread, when no helper could be started.
+bool start_inference_team(int helpers, int home_core, int channels);
+
+// Uninstalls the team and joins its helpers, called from the thread that started it
+void stop_inference_team();
@@ -8,5 +8,7 @@
 #define ARM_MATH_DSP 1
 #define ARM_NN_TRUNCATE 
 
+void deliver_result(Channel &channel, const model_result_t &result);
+void finish_processing(Channel &channel);
 void model_inference(Channel &channel);
 void model_inference_mod(Channel &channel);
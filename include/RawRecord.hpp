@@ -0,0 +1,114 @@
+/*RawRecord.hpp*/
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Layout of the binary raw-sample recordings (DataOutput/data_chN.bin).
+//
+// The file starts with a RAW_RECORD_HEADER_SIZE byte block holding raw_record_header_t (little endian,
+// zero padded), then the acquired windows back to back, each one dim0 * dim1 samples of sample_type,
+// exactly as the model receives them in input_t. Data always starts on a block boundary so the writer
+// can issue large aligned writes and readers can memory map it at a fixed offset.
+//
+// Windows lost before a recorded one (ADC overrun, file queue dropping) are listed from version 2 on:
+// gap_count counts them and the header block holds the first RAW_RECORD_MAX_GAPS as raw_record_gap_t
+// at RAW_RECORD_GAP_OFFSET, in window order. Version 1 files have no table and read as gap free.
+//
+// This header only depends on the standard library so offline tools can include it off board.
+
+#define RAW_RECORD_MAGIC "RPRAWWIN"
+#define RAW_RECORD_VERSION 2
+#define RAW_RECORD_HEADER_SIZE 4096
+#define RAW_RECORD_GAP_OFFSET 128
+
+enum raw_sample_type_t : uint32_t
+{
+    RAW_SAMPLE_INT8 = 1,
+    RAW_SAMPLE_INT16 = 2,
+    RAW_SAMPLE_FLOAT32 = 3
+};
+
+struct raw_record_header_t
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;     // Offset of the first window
+    uint32_t dim0;            // Samples per window (MODEL_INPUT_DIM_0)
+    uint32_t dim1;            // Values per sample (MODEL_INPUT_DIM_1)
+    uint32_t sample_type;     // raw_sample_type_t
+    uint32_t sample_size;     // Bytes per value
+    uint32_t decimation;      // ADC decimation, 125 MS/s / decimation gives the sample rate
+    uint32_t channel;         // 1 or 2
+    uint64_t start_time_ns;   // Trigger time, CLOCK_REALTIME
+    uint64_t trigger_time_ns; // Trigger time, steady clock as in the channel counters
+    uint64_t window_count;    // Written on close, 0 when the recording was cut short
+    uint64_t gap_count;       // Written on close, version 2
+};
+
+struct raw_record_gap_t
+{
+    uint64_t window;       // First window after the gap
+    uint64_t samples_lost; // Samples missing before it at the recorded rate, 0 when unknown
+};
+
+#define RAW_RECORD_MAX_GAPS ((RAW_RECORD_HEADER_SIZE - RAW_RECORD_GAP_OFFSET) / sizeof(raw_record_gap_t))
+
+static_assert(sizeof(raw_record_header_t) == 72, "raw_record_header_t layout changed");
+static_assert(sizeof(raw_record_header_t) <= RAW_RECORD_GAP_OFFSET, "raw_record_header_t runs into the gap table");
+
+inline bool raw_record_header_valid(const raw_record_header_t &header)
+{
+    return std::memcmp(header.magic, RAW_RECORD_MAGIC, sizeof(header.magic)) == 0 &&
+           header.version >= 1 && header.version <= RAW_RECORD_VERSION &&
+           header.header_size >= sizeof(raw_record_header_t) &&
+           header.dim0 > 0 && header.dim1 > 0 &&
+           header.sample_type >= RAW_SAMPLE_INT8 && header.sample_type <= RAW_SAMPLE_FLOAT32;
+}
+
+// Gap table entries stored in the header block, at most RAW_RECORD_MAX_GAPS
+inline uint64_t raw_record_gap_entries(const raw_record_header_t &header)
+{
+    if (header.version < 2 || header.header_size < RAW_RECORD_HEADER_SIZE)
+        return 0;
+    return header.gap_count < RAW_RECORD_MAX_GAPS ? header.gap_count : RAW_RECORD_MAX_GAPS;
+}
+
+// Entry i of the table of the recording whose header block starts at `file`
+inline raw_record_gap_t raw_record_gap(const void *file, uint64_t i)
+{
+    raw_record_gap_t gap;
+    std::memcpy(&gap, static_cast<const char *>(file) + RAW_RECORD_GAP_OFFSET + i * sizeof(gap), sizeof(gap));
+    return gap;
+}
+
+inline uint32_t raw_record_sample_size(uint32_t sample_type)
+{
+    switch (sample_type)
+    {
+    case RAW_SAMPLE_INT8:
+        return 1;
+    case RAW_SAMPLE_INT16:
+        return 2;
+    case RAW_SAMPLE_FLOAT32:
+        return 4;
+    default:
+        return 0;
+    }
+}
+
+// Sample type of a model input element
+template <typename T>
+constexpr raw_sample_type_t raw_sample_type()
+{
+    if constexpr (std::is_same_v<T, float>)
+        return RAW_SAMPLE_FLOAT32;
+    else if constexpr (std::is_same_v<T, int8_t>)
+        return RAW_SAMPLE_INT8;
+    else if constexpr (std::is_same_v<T, int16_t>)
+        return RAW_SAMPLE_INT16;
+    else
+        static_assert(!sizeof(T *), "Unsupported data type in raw_sample_type.");
+}
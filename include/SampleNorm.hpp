@@ -0,0 +1,421 @@
+/*SampleNorm.hpp*/
+
+#pragma once
+
+#include "ConvertRaw.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+// Min-max normalization of the first value of every sample of a window: floats to [0, 1],
+// integers to [0, 512], or [0, 127] for int8 models whose type cannot hold 512. Only depends on
+// the standard library and ConvertRaw.hpp so the host tools run the same preprocessing as the board.
+//
+// The min/max pass is a vector reduction with NEON (ARM_MATH_NEON) or SSE4.1 on a host. The integer
+// rescale (x - min) * scale / range becomes ((x - min) * mul) >> shift with mul and shift worked out
+// once per window, which gives the same quotient for every x of the window (see make_sample_norm())
+// and leaves the Cortex-A9, which has no integer divide, without a division call per sample.
+// Floats keep the divide, a reciprocal would not round the same; NEON has none, so their rescale
+// stays a scalar loop there.
+
+template <typename T>
+constexpr int sample_norm_scale()
+{
+    return std::numeric_limits<T>::max() < 512 ? std::numeric_limits<T>::max() : 512;
+}
+
+// Reference: one pass for min/max, one with a divide per sample. Strided windows (M > 1) use it.
+template <typename T, size_t N, size_t M>
+void sample_norm_scalar(T (&data)[N][M])
+{
+    using base_t = typename std::remove_cv<typename std::remove_reference<decltype(data[0][0])>::type>::type;
+
+    base_t min_val = data[0][0];
+    base_t max_val = data[0][0];
+
+    for (size_t i = 1; i < N; ++i)
+    {
+        if (data[i][0] < min_val)
+            min_val = data[i][0];
+        if (data[i][0] > max_val)
+            max_val = data[i][0];
+    }
+
+    // int for the integer types, a full-scale int8 window spans 255
+    auto range = max_val - min_val;
+    if (range == 0)
+        range = 1;
+
+    for (size_t i = 0; i < N; ++i)
+    {
+        if constexpr (std::is_floating_point<base_t>::value)
+        {
+            data[i][0] = static_cast<base_t>((data[i][0] - min_val) / static_cast<float>(range));
+        }
+        else
+        {
+            constexpr int scale = sample_norm_scale<base_t>();
+            data[i][0] = static_cast<base_t>(((data[i][0] - min_val) * scale) / range);
+        }
+    }
+}
+
+// Rescale of one window, from its min and max
+template <typename T>
+struct sample_norm_t
+{
+    T min;
+    std::conditional_t<std::is_floating_point<T>::value, T, int32_t> range;
+    uint32_t mul = 0;
+    int shift = 0;
+};
+
+// With 2^shift > range^2 and mul = ceil(scale * 2^shift / range), mul * range overshoots
+// scale * 2^shift by e < range, which moves t * scale / range up by t * e / (range * 2^shift),
+// under 1 / range for every t <= range, so never past the next integer: the floor is unchanged.
+// mul stays under 2 * scale * range + 1, below 2^26 for int16 and 2^16 for int8.
+template <typename T>
+inline sample_norm_t<T> make_sample_norm(T min_val, T max_val)
+{
+    sample_norm_t<T> norm;
+    norm.min = min_val;
+    auto range = max_val - min_val;
+    if (range == 0)
+        range = 1;
+    norm.range = range;
+    if constexpr (!std::is_floating_point<T>::value)
+    {
+        const uint64_t d = static_cast<uint64_t>(range);
+        while ((uint64_t{1} << norm.shift) <= d * d)
+            ++norm.shift;
+        const uint64_t scaled = static_cast<uint64_t>(sample_norm_scale<T>()) << norm.shift;
+        norm.mul = static_cast<uint32_t>((scaled + d - 1) / d);
+    }
+    return norm;
+}
+
+template <typename T>
+inline T sample_norm_value(T x, const sample_norm_t<T> &norm)
+{
+    if constexpr (std::is_floating_point<T>::value)
+        return static_cast<T>((x - norm.min) / norm.range);
+    else
+        return static_cast<T>((static_cast<uint64_t>(x - norm.min) * norm.mul) >> norm.shift);
+}
+
+template <typename T>
+inline void sample_norm_minmax_scalar(const T *data, size_t count, T &min_val, T &max_val)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (data[i] < min_val)
+            min_val = data[i];
+        if (data[i] > max_val)
+            max_val = data[i];
+    }
+}
+
+// Folds the lanes of the min and max vectors, stored in lo and hi, into min_val and max_val
+template <typename T, size_t L>
+inline void sample_norm_fold(const T (&lo)[L], const T (&hi)[L], T &min_val, T &max_val)
+{
+    sample_norm_minmax_scalar(lo, L, min_val, max_val);
+    sample_norm_minmax_scalar(hi, L, min_val, max_val);
+}
+
+// min_val and max_val come in as the extremes seen so far, a first sample for a new window
+inline void sample_norm_minmax(const int16_t *data, size_t count, int16_t &min_val, int16_t &max_val)
+{
+    size_t i = 0;
+
+#if defined(ARM_MATH_NEON)
+    if (count >= 8)
+    {
+        int16x8_t lo = vdupq_n_s16(min_val);
+        int16x8_t hi = vdupq_n_s16(max_val);
+        for (; i + 8 <= count; i += 8)
+        {
+            const int16x8_t x = vld1q_s16(data + i);
+            lo = vminq_s16(lo, x);
+            hi = vmaxq_s16(hi, x);
+        }
+        int16_t lanes_lo[8], lanes_hi[8];
+        vst1q_s16(lanes_lo, lo);
+        vst1q_s16(lanes_hi, hi);
+        sample_norm_fold(lanes_lo, lanes_hi, min_val, max_val);
+    }
+#elif defined(__SSE4_1__)
+    if (count >= 8)
+    {
+        __m128i lo = _mm_set1_epi16(min_val);
+        __m128i hi = _mm_set1_epi16(max_val);
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+            lo = _mm_min_epi16(lo, x);
+            hi = _mm_max_epi16(hi, x);
+        }
+        int16_t lanes_lo[8], lanes_hi[8];
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes_lo), lo);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes_hi), hi);
+        sample_norm_fold(lanes_lo, lanes_hi, min_val, max_val);
+    }
+#endif
+    sample_norm_minmax_scalar(data + i, count - i, min_val, max_val);
+}
+
+inline void sample_norm_minmax(const int8_t *data, size_t count, int8_t &min_val, int8_t &max_val)
+{
+    size_t i = 0;
+
+#if defined(ARM_MATH_NEON)
+    if (count >= 16)
+    {
+        int8x16_t lo = vdupq_n_s8(min_val);
+        int8x16_t hi = vdupq_n_s8(max_val);
+        for (; i + 16 <= count; i += 16)
+        {
+            const int8x16_t x = vld1q_s8(data + i);
+            lo = vminq_s8(lo, x);
+            hi = vmaxq_s8(hi, x);
+        }
+        int8_t lanes_lo[16], lanes_hi[16];
+        vst1q_s8(lanes_lo, lo);
+        vst1q_s8(lanes_hi, hi);
+        sample_norm_fold(lanes_lo, lanes_hi, min_val, max_val);
+    }
+#elif defined(__SSE4_1__)
+    if (count >= 16)
+    {
+        __m128i lo = _mm_set1_epi8(min_val);
+        __m128i hi = _mm_set1_epi8(max_val);
+        for (; i + 16 <= count; i += 16)
+        {
+            const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+            lo = _mm_min_epi8(lo, x);
+            hi = _mm_max_epi8(hi, x);
+        }
+        int8_t lanes_lo[16], lanes_hi[16];
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes_lo), lo);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes_hi), hi);
+        sample_norm_fold(lanes_lo, lanes_hi, min_val, max_val);
+    }
+#endif
+    sample_norm_minmax_scalar(data + i, count - i, min_val, max_val);
+}
+
+inline void sample_norm_minmax(const float *data, size_t count, float &min_val, float &max_val)
+{
+    size_t i = 0;
+
+#if defined(ARM_MATH_NEON)
+    if (count >= 4)
+    {
+        float32x4_t lo = vdupq_n_f32(min_val);
+        float32x4_t hi = vdupq_n_f32(max_val);
+        for (; i + 4 <= count; i += 4)
+        {
+            const float32x4_t x = vld1q_f32(data + i);
+            lo = vminq_f32(lo, x);
+            hi = vmaxq_f32(hi, x);
+        }
+        float lanes_lo[4], lanes_hi[4];
+        vst1q_f32(lanes_lo, lo);
+        vst1q_f32(lanes_hi, hi);
+        sample_norm_fold(lanes_lo, lanes_hi, min_val, max_val);
+    }
+#elif defined(__SSE4_1__)
+    if (count >= 4)
+    {
+        __m128 lo = _mm_set1_ps(min_val);
+        __m128 hi = _mm_set1_ps(max_val);
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128 x = _mm_loadu_ps(data + i);
+            lo = _mm_min_ps(lo, x);
+            hi = _mm_max_ps(hi, x);
+        }
+        float lanes_lo[4], lanes_hi[4];
+        _mm_storeu_ps(lanes_lo, lo);
+        _mm_storeu_ps(lanes_hi, hi);
+        sample_norm_fold(lanes_lo, lanes_hi, min_val, max_val);
+    }
+#endif
+    sample_norm_minmax_scalar(data + i, count - i, min_val, max_val);
+}
+
+template <typename T>
+inline void sample_norm_apply_scalar(const T *src, T *dst, size_t count, const sample_norm_t<T> &norm)
+{
+    for (size_t i = 0; i < count; ++i)
+        dst[i] = sample_norm_value(src[i], norm);
+}
+
+#if defined(ARM_MATH_NEON)
+
+// Four (x - min) of an int16 window to their quotients, products up to 2^42 in 64-bit lanes
+inline uint16x4_t sample_norm_q15_neon(uint32x4_t t, uint32x2_t mul, int64x2_t shift)
+{
+    const uint32x2_t lo = vmovn_u64(vshlq_u64(vmull_u32(vget_low_u32(t), mul), shift));
+    const uint32x2_t hi = vmovn_u64(vshlq_u64(vmull_u32(vget_high_u32(t), mul), shift));
+    return vmovn_u32(vcombine_u32(lo, hi));
+}
+
+// Eight (x - min) of an int8 window, products under 2^24
+inline uint8x8_t sample_norm_q7_neon(uint16x8_t t, uint16x4_t mul, int32x4_t shift)
+{
+    const uint16x4_t lo = vmovn_u32(vshlq_u32(vmull_u16(vget_low_u16(t), mul), shift));
+    const uint16x4_t hi = vmovn_u32(vshlq_u32(vmull_u16(vget_high_u16(t), mul), shift));
+    return vmovn_u16(vcombine_u16(lo, hi));
+}
+
+#elif defined(__SSE4_1__)
+
+// Four (x - min) in 32-bit lanes to their quotients, the even and odd lanes through _mm_mul_epu32
+inline __m128i sample_norm_q15_x86(__m128i t, __m128i mul, __m128i shift)
+{
+    const __m128i even = _mm_srl_epi64(_mm_mul_epu32(t, mul), shift);
+    const __m128i odd = _mm_srl_epi64(_mm_mul_epu32(_mm_srli_epi64(t, 32), mul), shift);
+    return _mm_blend_epi16(even, _mm_slli_epi64(odd, 32), 0xCC);
+}
+
+inline __m128i sample_norm_q7_x86(__m128i x, __m128i min, __m128i mul, __m128i shift)
+{
+    return _mm_srl_epi32(_mm_mullo_epi32(_mm_sub_epi32(_mm_cvtepi8_epi32(x), min), mul), shift);
+}
+
+#endif
+
+// src and dst may be the same window
+inline void sample_norm_apply(const int16_t *src, int16_t *dst, size_t count, const sample_norm_t<int16_t> &norm)
+{
+    size_t i = 0;
+
+#if defined(ARM_MATH_NEON)
+    const int16x8_t min = vdupq_n_s16(norm.min);
+    const uint32x2_t mul = vdup_n_u32(norm.mul);
+    const int64x2_t shift = vdupq_n_s64(-norm.shift);
+    for (; i + 8 <= count; i += 8)
+    {
+        const uint16x8_t t = vreinterpretq_u16_s16(vsubq_s16(vld1q_s16(src + i), min));
+        const uint16x4_t lo = sample_norm_q15_neon(vmovl_u16(vget_low_u16(t)), mul, shift);
+        const uint16x4_t hi = sample_norm_q15_neon(vmovl_u16(vget_high_u16(t)), mul, shift);
+        vst1q_s16(dst + i, vreinterpretq_s16_u16(vcombine_u16(lo, hi)));
+    }
+#elif defined(__SSE4_1__)
+    const __m128i min = _mm_set1_epi16(norm.min);
+    const __m128i mul = _mm_set1_epi32(static_cast<int32_t>(norm.mul));
+    const __m128i shift = _mm_cvtsi32_si128(norm.shift);
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m128i t = _mm_sub_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i)), min);
+        const __m128i lo = sample_norm_q15_x86(_mm_cvtepu16_epi32(t), mul, shift);
+        const __m128i hi = sample_norm_q15_x86(_mm_cvtepu16_epi32(_mm_srli_si128(t, 8)), mul, shift);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_packs_epi32(lo, hi));
+    }
+#endif
+    sample_norm_apply_scalar(src + i, dst + i, count - i, norm);
+}
+
+inline void sample_norm_apply(const int8_t *src, int8_t *dst, size_t count, const sample_norm_t<int8_t> &norm)
+{
+    size_t i = 0;
+
+#if defined(ARM_MATH_NEON)
+    const int8x8_t min = vdup_n_s8(norm.min);
+    const uint16x4_t mul = vdup_n_u16(static_cast<uint16_t>(norm.mul));
+    const int32x4_t shift = vdupq_n_s32(-norm.shift);
+    for (; i + 16 <= count; i += 16)
+    {
+        const int8x16_t x = vld1q_s8(src + i);
+        const uint8x8_t lo = sample_norm_q7_neon(vreinterpretq_u16_s16(vsubl_s8(vget_low_s8(x), min)), mul, shift);
+        const uint8x8_t hi = sample_norm_q7_neon(vreinterpretq_u16_s16(vsubl_s8(vget_high_s8(x), min)), mul, shift);
+        vst1q_s8(dst + i, vreinterpretq_s8_u8(vcombine_u8(lo, hi)));
+    }
+#elif defined(__SSE4_1__)
+    const __m128i min = _mm_set1_epi32(norm.min);
+    const __m128i mul = _mm_set1_epi32(static_cast<int32_t>(norm.mul));
+    const __m128i shift = _mm_cvtsi32_si128(norm.shift);
+    for (; i + 16 <= count; i += 16)
+    {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        const __m128i q0 = sample_norm_q7_x86(x, min, mul, shift);
+        const __m128i q1 = sample_norm_q7_x86(_mm_srli_si128(x, 4), min, mul, shift);
+        const __m128i q2 = sample_norm_q7_x86(_mm_srli_si128(x, 8), min, mul, shift);
+        const __m128i q3 = sample_norm_q7_x86(_mm_srli_si128(x, 12), min, mul, shift);
+        const __m128i q = _mm_packs_epi16(_mm_packs_epi32(q0, q1), _mm_packs_epi32(q2, q3));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), q);
+    }
+#endif
+    sample_norm_apply_scalar(src + i, dst + i, count - i, norm);
+}
+
+inline void sample_norm_apply(const float *src, float *dst, size_t count, const sample_norm_t<float> &norm)
+{
+    size_t i = 0;
+
+#if defined(__SSE4_1__) && !defined(ARM_MATH_NEON)
+    const __m128 min = _mm_set1_ps(norm.min);
+    const __m128 range = _mm_set1_ps(norm.range);
+    for (; i + 4 <= count; i += 4)
+        _mm_storeu_ps(dst + i, _mm_div_ps(_mm_sub_ps(_mm_loadu_ps(src + i), min), range));
+#endif
+    sample_norm_apply_scalar(src + i, dst + i, count - i, norm);
+}
+
+// Same values as sample_norm_scalar()
+template <typename T, size_t N, size_t M>
+void sample_norm(T (&data)[N][M])
+{
+    if constexpr (M == 1)
+    {
+        T *values = &data[0][0];
+        T min_val = values[0];
+        T max_val = values[0];
+        sample_norm_minmax(values, N, min_val, max_val);
+        sample_norm_apply(values, values, N, make_sample_norm(min_val, max_val));
+    }
+    else
+    {
+        sample_norm_scalar(data);
+    }
+}
+
+// Conversion of raw codes (ConvertRaw.hpp) and normalization in one pass over dst, the codes coming
+// in up to two pieces as in a wrapped ring. The conversion never decreases with the code (the
+// calibration gain is not negative), so the min and max of the converted window are the converted
+// min and max codes: those come from a reduction over the codes, then every block is converted into
+// a small buffer and rescaled from there into dst. Same values as convert_raw_samples() followed by
+// sample_norm_scalar().
+template <typename T>
+inline void convert_raw_norm(const int16_t *first, size_t first_len, const int16_t *second, size_t second_len, T *dst,
+                             const adc_calib_t &calib)
+{
+    constexpr size_t BLOCK = 64;
+
+    int16_t code_min = first_len ? first[0] : second[0];
+    int16_t code_max = code_min;
+    sample_norm_minmax(first, first_len, code_min, code_max);
+    sample_norm_minmax(second, second_len, code_min, code_max);
+
+    T min_val, max_val;
+    convert_raw_scalar(&code_min, &min_val, 1, calib);
+    convert_raw_scalar(&code_max, &max_val, 1, calib);
+    const sample_norm_t<T> norm = make_sample_norm(min_val, max_val);
+
+    const int16_t *pieces[2] = {first, second};
+    const size_t lens[2] = {first_len, second_len};
+    for (int p = 0; p < 2; ++p)
+    {
+        for (size_t i = 0; i < lens[p]; i += BLOCK)
+        {
+            T block[BLOCK];
+            const size_t n = std::min(BLOCK, lens[p] - i);
+            convert_raw_samples(pieces[p] + i, block, n, calib);
+            sample_norm_apply(block, dst, n, norm);
+            dst += n;
+        }
+    }
+}
@@ -0,0 +1,281 @@
+/*SpscRing.hpp*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <climits>
+#include <ctime>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <sched.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#ifndef CACHE_LINE_SIZE
+#define CACHE_LINE_SIZE 64
+#endif
+
+inline void cpu_relax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__arm__) || defined(__aarch64__)
+    __asm__ volatile("yield");
+#endif
+}
+
+// Spinning before parking only pays off when the other side can run on another core meanwhile.
+// A channel process pinned to a single core parks right away, so the busy polling acquisition
+// thread gets preempted as soon as it publishes.
+inline uint32_t park_spin_limit()
+{
+    thread_local int limit = -1;
+    if (limit < 0)
+    {
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        bool multi_core = sched_getaffinity(0, sizeof(cpuset), &cpuset) == 0 && CPU_COUNT(&cpuset) > 1;
+        limit = multi_core ? 256 : 0;
+    }
+    return static_cast<uint32_t>(limit);
+}
+
+// Producer side wait on a full ring. yield() alone never lets a lower priority consumer run when the
+// producer is SCHED_FIFO, so past the spin budget it sleeps for a fraction of a window period.
+inline void block_backoff(uint32_t &spins)
+{
+    if (spins < park_spin_limit())
+    {
+        ++spins;
+        cpu_relax();
+    }
+    else
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+}
+
+// Sleeps while `word` holds `expected`, at most timeout_ms when it is not 0
+inline void futex_wait(std::atomic<uint32_t> &word, uint32_t expected, uint32_t timeout_ms = 0)
+{
+    timespec timeout{static_cast<time_t>(timeout_ms / 1000), static_cast<long>(timeout_ms % 1000) * 1000000L};
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAIT_PRIVATE, expected, timeout_ms ? &timeout : nullptr, nullptr, 0);
+}
+
+// Idle hook of the consumer waits, called each time the consumer is about to park on an empty ring.
+// It returns how long to park at most in ms, 0 parks until the producer wakes the consumer.
+struct park_untimed_t
+{
+    uint32_t operator()() const { return 0; }
+};
+
+inline void futex_wake(std::atomic<uint32_t> &word)
+{
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+}
+
+// Policy applied by a producer when a bounded ring is at its limit for one consumer
+enum overflow_policy_t : uint32_t
+{
+    OVERFLOW_BLOCK = 0,
+    OVERFLOW_DROP_NEWEST,
+    OVERFLOW_DROP_OLDEST,
+    OVERFLOW_KEEP_LATEST
+};
+
+// Bounded single-producer/single-consumer ring. Producer and consumer indices sit on their own
+// cache lines, the consumer only enters the kernel (futex) when the ring is empty.
+// push() holds the ring to `limit` items through its overflow policy. Dropping old items means the
+// producer moves the head as well, so the consumer claims each item with a CAS after copying it out.
+template <typename T, uint32_t Capacity>
+class spsc_ring_t
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "spsc_ring_t capacity must be a power of two");
+    static_assert(std::is_trivially_copyable_v<T>, "spsc_ring_t items are copied out before being claimed");
+
+public:
+    void set_policy(overflow_policy_t new_policy, uint32_t new_limit)
+    {
+        policy = new_policy;
+        limit = new_limit < 1 ? 1 : (new_limit > Capacity ? Capacity : new_limit);
+    }
+
+    bool try_push(const T &item)
+    {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t - head_cache >= Capacity)
+        {
+            head_cache = head.load(std::memory_order_acquire);
+            if (t - head_cache >= Capacity)
+                return false;
+        }
+
+        publish(t, item);
+        return true;
+    }
+
+    // Producer side push honoring the overflow policy. Returns false when the item was dropped,
+    // or when a BLOCK ring is still full once stop() holds.
+    template <typename Pred>
+    bool push(const T &item, Pred &&stop)
+    {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        uint32_t pending = t - head.load(std::memory_order_acquire);
+
+        if (policy == OVERFLOW_KEEP_LATEST)
+        {
+            if (pending > 0)
+                discard_until(t);
+        }
+        else if (pending >= limit)
+        {
+            switch (policy)
+            {
+            case OVERFLOW_BLOCK:
+            {
+                uint32_t spins = 0;
+                while (t - head.load(std::memory_order_acquire) >= limit)
+                {
+                    if (stop())
+                        return false;
+                    block_backoff(spins);
+                }
+                break;
+            }
+            case OVERFLOW_DROP_NEWEST:
+                drops.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            default:
+                discard_until(t - limit + 1);
+                break;
+            }
+        }
+
+        publish(t, item);
+        return true;
+    }
+
+    bool try_pop(T &out)
+    {
+        uint32_t h = head.load(std::memory_order_acquire);
+        while (true)
+        {
+            if (static_cast<int32_t>(tail_cache - h) <= 0)
+            {
+                tail_cache = tail.load(std::memory_order_acquire);
+                if (static_cast<int32_t>(tail_cache - h) <= 0)
+                    return false;
+            }
+
+            T value = slots[h & (Capacity - 1)];
+            if (head.compare_exchange_weak(h, h + 1, std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                out = value;
+                return true;
+            }
+        }
+    }
+
+    // Blocks until an item is available. Returns false once the ring is empty and stop() holds,
+    // whoever flips the condition behind stop() has to call wake() afterwards.
+    template <typename Pred, typename Idle = park_untimed_t>
+    bool pop_wait(T &out, Pred &&stop, Idle &&idle = Idle{})
+    {
+        uint32_t spins = 0;
+        while (!try_pop(out))
+        {
+            if (stop())
+                return try_pop(out);
+
+            if (spins < park_spin_limit())
+            {
+                ++spins;
+                cpu_relax();
+                continue;
+            }
+            spins = 0;
+
+            uint32_t timeout_ms = idle();
+            sleeping.store(1, std::memory_order_seq_cst);
+            uint32_t seen = signal.load(std::memory_order_seq_cst);
+            if (empty() && !stop())
+                futex_wait(signal, seen, timeout_ms);
+            sleeping.store(0, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    void wake()
+    {
+        signal.fetch_add(1, std::memory_order_seq_cst);
+        futex_wake(signal);
+    }
+
+    bool empty() const
+    {
+        return head.load(std::memory_order_seq_cst) == tail.load(std::memory_order_seq_cst);
+    }
+
+    uint32_t size() const
+    {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+
+    uint32_t lag_max() const
+    {
+        return high_watermark.load(std::memory_order_relaxed);
+    }
+
+    uint32_t drop_count() const
+    {
+        return drops.load(std::memory_order_relaxed);
+    }
+
+    static constexpr uint32_t capacity() { return Capacity; }
+
+private:
+    void publish(uint32_t t, const T &item)
+    {
+        slots[t & (Capacity - 1)] = item;
+        tail.store(t + 1, std::memory_order_seq_cst);
+        if (sleeping.load(std::memory_order_seq_cst))
+            wake();
+
+        uint32_t pending = t + 1 - head.load(std::memory_order_relaxed);
+        if (pending > high_watermark.load(std::memory_order_relaxed))
+            high_watermark.store(pending, std::memory_order_relaxed);
+    }
+
+    // Producer drops every item before `target` that the consumer has not claimed yet
+    void discard_until(uint32_t target)
+    {
+        uint32_t h = head.load(std::memory_order_acquire);
+        while (static_cast<int32_t>(target - h) > 0)
+        {
+            if (head.compare_exchange_weak(h, target, std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                drops.fetch_add(target - h, std::memory_order_relaxed);
+                break;
+            }
+        }
+    }
+
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> head{0};
+    uint32_t tail_cache = 0;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> tail{0};
+    uint32_t head_cache = 0;
+    overflow_policy_t policy = OVERFLOW_BLOCK;
+    uint32_t limit = Capacity;
+    std::atomic<uint32_t> high_watermark{0};
+    std::atomic<uint32_t> drops{0};
+
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> sleeping{0};
+    std::atomic<uint32_t> signal{0};
+
+    alignas(CACHE_LINE_SIZE) T slots[Capacity];
+};
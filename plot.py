@@ -6,16 +6,55 @@ from scipy import integrate
 
 # Define file paths
 buffer_file_paths = ['DataOutput/data_ch1.csv', 'DataOutput/data_ch2.csv']
+buffer_bin_paths = ['DataOutput/data_ch1.bin', 'DataOutput/data_ch2.bin']
 output_file_paths = ['ModelOutput/output_ch1.csv', 'ModelOutput/output_ch2.csv']
 
+# Binary raw recordings, see include/RawRecord.hpp
+RAW_RECORD_MAGIC = b'RPRAWWIN'
+raw_record_header = np.dtype([
+    ('magic', 'S8'), ('version', '<u4'), ('header_size', '<u4'),
+    ('dim0', '<u4'), ('dim1', '<u4'), ('sample_type', '<u4'), ('sample_size', '<u4'),
+    ('decimation', '<u4'), ('channel', '<u4'),
+    ('start_time_ns', '<u8'), ('trigger_time_ns', '<u8'), ('window_count', '<u8'), ('gap_count', '<u8'),
+])
+raw_record_gap = np.dtype([('window', '<u8'), ('samples_lost', '<u8')])
+RAW_RECORD_GAP_OFFSET = 128
+raw_sample_dtypes = {1: np.dtype('i1'), 2: np.dtype('<i2'), 3: np.dtype('<f4')}
+
+def read_raw_recording(file_path):
+    """ Maps a binary recording without loading it, returns an array of shape (windows, dim0 * dim1)
+    and the windows recorded after a gap """
+    header = np.fromfile(file_path, dtype=raw_record_header, count=1)[0]
+    if header['magic'] != RAW_RECORD_MAGIC:
+        raise ValueError(f"{file_path} is not a raw recording")
+
+    sample_dtype = raw_sample_dtypes[int(header['sample_type'])]
+    values_per_window = int(header['dim0']) * int(header['dim1'])
+    windows = (os.path.getsize(file_path) - int(header['header_size'])) // (values_per_window * sample_dtype.itemsize)
+    if header['window_count']:
+        windows = min(windows, int(header['window_count']))
+
+    gaps = np.array([], dtype=np.uint64)
+    if header['version'] >= 2:
+        entries = min(int(header['gap_count']), (int(header['header_size']) - RAW_RECORD_GAP_OFFSET) // raw_record_gap.itemsize)
+        gaps = np.fromfile(file_path, dtype=raw_record_gap, count=entries, offset=RAW_RECORD_GAP_OFFSET)['window']
+
+    return np.memmap(file_path, dtype=sample_dtype, mode='r', offset=int(header['header_size']),
+                     shape=(windows, values_per_window)), gaps
+
 # Track available plots
 available_plots = []
 
-# Load buffer data
+# Load buffer data, a binary recording takes precedence over a CSV one
 buffer_data = {}
+buffer_gaps = {}
 for i, file_path in enumerate(buffer_file_paths):
-    if os.path.exists(file_path) and os.path.getsize(file_path) > 0:
-        buffer_data[i] = pd.read_csv(file_path, header=None)
+    bin_path = buffer_bin_paths[i]
+    if os.path.exists(bin_path) and os.path.getsize(bin_path) > raw_record_header.itemsize:
+        buffer_data[i], buffer_gaps[i] = read_raw_recording(bin_path)
+        available_plots.append(f"Buffer CH{i+1}")
+    elif os.path.exists(file_path) and os.path.getsize(file_path) > 0:
+        buffer_data[i] = pd.read_csv(file_path, header=None).values
         available_plots.append(f"Buffer CH{i+1}")
 
 # Load output data
@@ -44,10 +83,12 @@ output_axes = []
 
 # Plot buffer data
 for i, data in buffer_data.items():
-    flattened_data = data.values.flatten()
+    flattened_data = data.reshape(-1)
     indices = np.arange(len(flattened_data))
 
     axs[plot_index].plot(indices, flattened_data, marker='o', linestyle='-', markersize=2, label=f'Amplitudes CH{i+1}')
+    for gap in buffer_gaps.get(i, []):
+        axs[plot_index].axvline(int(gap) * data.shape[1], color='red', linewidth=0.8)
     axs[plot_index].set_title(f'Visualization of Acquired Samples CH{i+1}', fontsize=12)
     axs[plot_index].set_xlabel('Sample Index', fontsize=8)
     axs[plot_index].set_ylabel('Amplitude', fontsize=8)
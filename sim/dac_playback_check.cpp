@@ -0,0 +1,196 @@
+/* dac_playback_check.cpp */
+
+// Runs the arbitrary waveform DAC playback (write_data_dac built with DAC_ARB_PLAYBACK=1) against
+// the rp_Gen* stand-in on its manual clock, so every run makes the same calls at the same times,
+// and replays the generator from the recorded calls:
+//  - the generator is set up once for arbitrary, continuous playback at DAC_PLAYBACK_FREQ, and the
+//    waveform is never uploaded whole again once it plays,
+//  - each write covers one half of the buffer and never the half playing at that moment,
+//  - every window comes out once, in order, in its own window period.
+//
+//   dac_playback_check [windows] [burst]
+//
+// Windows are published at the acquisition rate, `burst` of them at once every `burst` periods
+// to exercise the double buffering when the writer gets ahead. Exits non-zero on a failed check.
+
+#include "DataWriterDAC.hpp"
+#include "rp_gen_sim.hpp"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+std::atomic<bool> stop_acquisition{false};
+std::atomic<bool> stop_program{false};
+input_norm_t input_norm = NORM_OFF;
+
+static float sample_voltage(uint64_t window, size_t k)
+{
+    int16_t raw = static_cast<int16_t>(((window * MODEL_INPUT_DIM_0 + k) % 8000) - 4000);
+    return std::clamp(OutputToVoltage(static_cast<number_t>(raw)), -1.0f, 1.0f);
+}
+
+int main(int argc, char **argv)
+{
+    const uint64_t windows = argc > 1 ? strtoull(argv[1], nullptr, 10) : 2000;
+    const uint64_t burst = std::max<uint64_t>(argc > 2 ? strtoull(argv[2], nullptr, 10) : 1, 1);
+    const uint64_t period_ns = static_cast<uint64_t>(std::llround(MODEL_INPUT_DIM_0 * static_cast<double>(DECIMATION) / ADC_SAMPLE_RATE * 1e9));
+    // Time moves on in steps finer than the write guard
+    const uint64_t step_ns = period_ns / (2 * DAC_PLAYBACK_GUARD);
+
+    static Channel channel;
+    static shared_counters_t counters{};
+    channel.counters = &counters;
+    channel.channel_id = RP_CH_1;
+    channel.windows.attach(CONSUMER_DAC, OVERFLOW_BLOCK, QUEUE_MAX_SIZE);
+
+    rp_gen_sim_manual_clock(true);
+    std::thread writer(write_data_dac, std::ref(channel), RP_CH_1);
+
+    // Playback starts at time 0
+    auto triggered = []
+    {
+        for (const rp_gen_call_t &call : rp_gen_sim_calls())
+            if (call.name == "rp_GenTriggerOnly")
+                return true;
+        return false;
+    };
+    while (!triggered())
+        std::this_thread::yield();
+
+    uint64_t published = 0;
+    auto settled = [&]
+    { return counters.write_count_dac.load() == static_cast<int>(published); };
+    for (uint64_t tick = 0; published < windows; ++tick)
+    {
+        if (tick % burst == 0)
+        {
+            for (uint64_t b = 0; b < burst && published < windows; ++b, ++published)
+            {
+                data_part_t *part = channel.windows.claim([] { return false; });
+                for (size_t k = 0; k < MODEL_INPUT_DIM_0; k++)
+                    part->data[k][0] = static_cast<number_t>(static_cast<int16_t>(((published * MODEL_INPUT_DIM_0 + k) % 8000) - 4000));
+                channel.windows.publish();
+            }
+        }
+        for (uint64_t t = 0; t < period_ns; t += step_ns)
+            rp_gen_sim_advance(step_ns, settled);
+    }
+    while (!settled())
+        rp_gen_sim_advance(step_ns, settled);
+
+    channel.acquisition_done.store(true);
+    stop_program.store(true);
+    channel.windows.wake();
+    writer.join();
+
+    const std::vector<rp_gen_call_t> calls = rp_gen_sim_calls();
+    bool ok = true;
+
+    // Setup
+    bool started = false, arbitrary = false, continuous = false, freq_ok = false;
+    std::vector<const rp_gen_call_t *> writes;
+    for (const rp_gen_call_t &call : calls)
+    {
+        if (call.name == "rp_GenWaveform")
+            arbitrary = call.value == static_cast<float>(RP_WAVEFORM_ARBITRARY);
+        else if (call.name == "rp_GenMode")
+            continuous = call.value == static_cast<float>(RP_GEN_MODE_CONTINUOUS);
+        else if (call.name == "rp_GenFreq")
+            freq_ok = std::fabs(call.value - DAC_PLAYBACK_FREQ) < 1e-3 * DAC_PLAYBACK_FREQ;
+        else if (call.name == "rp_GenTriggerOnly")
+            started = true;
+        else if (call.name == "rp_GenArbWaveform")
+        {
+            if (call.samples.size() != DAC_PLAYBACK_SAMPLES)
+            {
+                printf("FAIL: upload of %zu samples, expected %d\n", call.samples.size(), DAC_PLAYBACK_SAMPLES);
+                ok = false;
+            }
+            if (started)
+            {
+                printf("FAIL: whole waveform uploaded during playback\n");
+                ok = false;
+            }
+        }
+        else if (call.name == "arb_write")
+        {
+            if (call.samples.size() != MODEL_INPUT_DIM_0 || static_cast<uint32_t>(call.value) % MODEL_INPUT_DIM_0 != 0)
+            {
+                printf("FAIL: write of %zu samples at %g, expected one half\n", call.samples.size(), call.value);
+                ok = false;
+            }
+            else
+                writes.push_back(&call);
+        }
+        else if (call.name == "rp_GenAmp" && call.value != 1.0f)
+        {
+            printf("FAIL: rp_GenAmp(%f) in playback mode\n", call.value);
+            ok = false;
+        }
+    }
+    if (!arbitrary || !continuous || !freq_ok || !started)
+    {
+        printf("FAIL: generator setup (arbitrary %d, continuous %d, frequency %d, triggered %d)\n", arbitrary, continuous, freq_ok, started);
+        return 1;
+    }
+
+    // Replay the generator: half n % 2 plays during half period n, a write lands in the half that
+    // plays next and goes out in the following half period
+    uint64_t matched = 0, glitches = 0, stale = 0;
+    uint64_t min_margin = UINT64_MAX;
+    int64_t last_period = 0;
+    bool in_order = true;
+    for (const rp_gen_call_t *write : writes)
+    {
+        const uint64_t position = rp_gen_sim_position(RP_CH_1, write->time_ns);
+        const uint64_t playing = position / MODEL_INPUT_DIM_0;
+        const uint64_t half = static_cast<uint64_t>(write->value) / MODEL_INPUT_DIM_0;
+        if (half == playing % 2)
+        {
+            ++glitches;
+            in_order = false;
+            continue;
+        }
+
+        const int64_t period = static_cast<int64_t>(playing) + 1;
+        min_margin = std::min<uint64_t>(min_margin, period * MODEL_INPUT_DIM_0 - position);
+        if (period <= last_period)
+            in_order = false; // overwrote a window before it played
+        else if (matched > 0)
+            stale += period - last_period - 1;
+        last_period = period;
+
+        for (size_t k = 0; k < MODEL_INPUT_DIM_0; k++)
+            in_order &= write->samples[k] == sample_voltage(matched, k);
+        if (!in_order)
+            break;
+        ++matched;
+    }
+
+    printf("windows %llu  writes %zu  rp_Gen* calls %zu (per-sample rp_GenAmp would need %llu)\n",
+           static_cast<unsigned long long>(windows), writes.size(), calls.size() - writes.size(),
+           static_cast<unsigned long long>(windows * MODEL_INPUT_DIM_0));
+    printf("played in order %llu  stale periods %llu  glitches %llu  min write margin %llu samples\n",
+           static_cast<unsigned long long>(matched), static_cast<unsigned long long>(stale),
+           static_cast<unsigned long long>(glitches), static_cast<unsigned long long>(min_margin == UINT64_MAX ? 0 : min_margin));
+
+    if (glitches)
+    {
+        printf("FAIL: %llu writes changed the half being played\n", static_cast<unsigned long long>(glitches));
+        ok = false;
+    }
+    if (matched != windows)
+    {
+        printf("FAIL: window %llu did not come out in order\n", static_cast<unsigned long long>(matched));
+        ok = false;
+    }
+    if (min_margin != UINT64_MAX && min_margin <= MODEL_INPUT_DIM_0 / DAC_PLAYBACK_GUARD)
+    {
+        printf("FAIL: a write came within the guard of its half\n");
+        ok = false;
+    }
+
+    printf(ok ? "OK\n" : "FAILED\n");
+    return ok ? 0 : 1;
+}
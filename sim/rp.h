@@ -0,0 +1,121 @@
+/*rp.h*/
+
+// Host stand-in for the subset of the Red Pitaya librp API this application uses. Declarations
+// and enum values follow librp, so the sources build unchanged against either header. The
+// simulated implementations live next to it (rp_gen_sim.cpp for the generator).
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <math.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define RP_SIM 1 /* Not in librp, marks the host build */
+
+#define RP_OK 0
+#define RP_EOOR 7 /* Parameter out of range */
+#define RP_EOMD 22 /* Not supported by the simulation */
+
+#define ADC_BUFFER_SIZE (16 * 1024)
+#define DAC_BUFFER_SIZE (16 * 1024)
+
+typedef enum
+{
+    RP_CH_1 = 0,
+    RP_CH_2 = 1,
+    RP_CH_3 = 2,
+    RP_CH_4 = 3
+} rp_channel_t;
+
+typedef enum
+{
+    RP_T_CH_1 = 0,
+    RP_T_CH_2 = 1,
+    RP_T_CH_3 = 2,
+    RP_T_CH_4 = 3,
+    RP_T_CH_EXT = 4
+} rp_channel_trigger_t;
+
+typedef enum
+{
+    RP_TRIG_STATE_TRIGGERED,
+    RP_TRIG_STATE_WAITING
+} rp_acq_trig_state_t;
+
+typedef enum
+{
+    RP_TRIG_SRC_DISABLED = 0,
+    RP_TRIG_SRC_NOW = 1,
+    RP_TRIG_SRC_CHA_PE = 2,
+    RP_TRIG_SRC_CHA_NE = 3,
+    RP_TRIG_SRC_CHB_PE = 4,
+    RP_TRIG_SRC_CHB_NE = 5,
+    RP_TRIG_SRC_EXT_PE = 6,
+    RP_TRIG_SRC_EXT_NE = 7,
+    RP_TRIG_SRC_AWG_PE = 8,
+    RP_TRIG_SRC_AWG_NE = 9
+} rp_acq_trig_src_t;
+
+typedef enum
+{
+    RP_WAVEFORM_SINE,
+    RP_WAVEFORM_SQUARE,
+    RP_WAVEFORM_TRIANGLE,
+    RP_WAVEFORM_RAMP_UP,
+    RP_WAVEFORM_RAMP_DOWN,
+    RP_WAVEFORM_DC,
+    RP_WAVEFORM_PWM,
+    RP_WAVEFORM_ARBITRARY,
+    RP_WAVEFORM_DC_NEG,
+    RP_WAVEFORM_SWEEP
+} rp_waveform_t;
+
+typedef enum
+{
+    RP_GEN_MODE_CONTINUOUS,
+    RP_GEN_MODE_BURST,
+    RP_GEN_MODE_STREAM
+} rp_gen_mode_t;
+
+int rp_Init(void);
+int rp_Release(void);
+
+int rp_AcqReset(void);
+int rp_AcqSetSplitTrigger(bool enable);
+int rp_AcqSetSplitTriggerPass(bool enable);
+int rp_AcqGetSamplingRateHz(float *sampling_rate);
+int rp_AcqSetTriggerLevel(rp_channel_trigger_t channel, float voltage);
+int rp_AcqSetTriggerSrcCh(rp_channel_t channel, rp_acq_trig_src_t source);
+int rp_AcqGetTriggerStateCh(rp_channel_t channel, rp_acq_trig_state_t *state);
+int rp_AcqStartCh(rp_channel_t channel);
+int rp_AcqStopCh(rp_channel_t channel);
+int rp_AcqAxiGetMemoryRegion(uint32_t *start, uint32_t *size);
+int rp_AcqAxiSetDecimationFactorCh(rp_channel_t channel, uint32_t decimation);
+int rp_AcqAxiSetTriggerDelay(rp_channel_t channel, int32_t decimated_data_num);
+int rp_AcqAxiSetBufferSamples(rp_channel_t channel, uint32_t address, uint32_t samples);
+int rp_AcqAxiEnable(rp_channel_t channel, bool enable);
+int rp_AcqAxiGetWritePointer(rp_channel_t channel, uint32_t *pos);
+int rp_AcqAxiGetWritePointerAtTrig(rp_channel_t channel, uint32_t *pos);
+int rp_AcqAxiGetDataRaw(rp_channel_t channel, uint32_t pos, uint32_t *size, int16_t *buffer);
+
+int rp_GenReset(void);
+int rp_GenOutEnable(rp_channel_t channel);
+int rp_GenOutDisable(rp_channel_t channel);
+int rp_GenAmp(rp_channel_t channel, float amplitude);
+int rp_GenOffset(rp_channel_t channel, float offset);
+int rp_GenFreq(rp_channel_t channel, float frequency);
+int rp_GenWaveform(rp_channel_t channel, rp_waveform_t type);
+int rp_GenArbWaveform(rp_channel_t channel, float *waveform, uint32_t length);
+int rp_GenMode(rp_channel_t channel, rp_gen_mode_t mode);
+int rp_GenBurstCount(rp_channel_t channel, int num);
+int rp_GenTriggerOnly(rp_channel_t channel);
+int rp_GenResetTrigger(rp_channel_t channel);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,416 @@
+/*rp_acq_sim.cpp*/
+
+#include "rp_acq_sim.hpp"
+#include "rp_gen_sim.hpp"
+#include "RawRecord.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr double ADC_RATE = 125e6;
+    constexpr uint32_t SIM_AXI_START = 0x1000000;
+
+    enum sim_source_kind_t
+    {
+        SOURCE_SINE,
+        SOURCE_SQUARE,
+        SOURCE_TRIANGLE,
+        SOURCE_NOISE,
+        SOURCE_FILE
+    };
+
+    struct sim_channel_t
+    {
+        sim_source_kind_t kind = SOURCE_SINE;
+        double freq = 1000.0;
+        double amplitude = 4096.0;
+        std::vector<int16_t> samples; // SOURCE_FILE
+
+        uint32_t decimation = 1;
+        uint32_t buffer_samples = ADC_BUFFER_SIZE;
+        rp_acq_trig_src_t trigger_src = RP_TRIG_SRC_DISABLED;
+        bool enabled = false;
+        bool started = false;
+        uint64_t start_ns = 0;
+        uint64_t stop_ns = 0; // 0 while running
+        uint64_t stored = 0;  // Samples already in the mapped ring
+    };
+
+    sim_channel_t channels[2];
+    int16_t *axi_memory = nullptr;
+    double trigger_delay_s = 0.001;
+    double rate_factor = 1.0;
+
+    uint64_t now_ns()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    sim_channel_t *find(rp_channel_t channel)
+    {
+        return channel == RP_CH_1 || channel == RP_CH_2 ? &channels[channel] : nullptr;
+    }
+
+    double sample_rate(const sim_channel_t &c)
+    {
+        return ADC_RATE / c.decimation * rate_factor;
+    }
+
+    uint64_t samples_at(const sim_channel_t &c, uint64_t t_ns)
+    {
+        if (!c.started || t_ns < c.start_ns)
+            return 0;
+        return static_cast<uint64_t>((t_ns - c.start_ns) * 1e-9 * sample_rate(c));
+    }
+
+    uint64_t trigger_sample(const sim_channel_t &c)
+    {
+        return c.trigger_src == RP_TRIG_SRC_NOW ? 0 : static_cast<uint64_t>(trigger_delay_s * sample_rate(c));
+    }
+
+    // splitmix64, so the noise of sample n is the same whenever it is read
+    uint64_t mix(uint64_t x)
+    {
+        x += 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    int16_t clamp_code(double v)
+    {
+        return static_cast<int16_t>(std::lround(std::fmin(std::fmax(v, -8192.0), 8191.0)));
+    }
+
+    // Windows of a binary recording back to ADC codes, only the first value of every sample
+    bool load_recording(const std::vector<uint8_t> &bytes, std::vector<int16_t> &samples)
+    {
+        raw_record_header_t header;
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        if (!raw_record_header_valid(header) || raw_record_sample_size(header.sample_type) != header.sample_size ||
+            bytes.size() < header.header_size)
+            return false;
+
+        const size_t stride = static_cast<size_t>(header.dim1) * header.sample_size;
+        const size_t count = (bytes.size() - header.header_size) / stride;
+        samples.resize(count);
+        const uint8_t *data = bytes.data() + header.header_size;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const uint8_t *v = data + i * stride;
+            if (header.sample_type == RAW_SAMPLE_INT8)
+                samples[i] = clamp_code(static_cast<int8_t>(*v) * 64.0);
+            else if (header.sample_type == RAW_SAMPLE_INT16)
+                std::memcpy(&samples[i], v, sizeof(int16_t));
+            else
+            {
+                float f;
+                std::memcpy(&f, v, sizeof(f));
+                samples[i] = clamp_code(f * 8192.0);
+            }
+        }
+        return true;
+    }
+
+    bool load_file(const char *path, std::vector<int16_t> &samples)
+    {
+        FILE *f = fopen(path, "rb");
+        if (!f)
+            return false;
+        std::vector<uint8_t> bytes;
+        uint8_t chunk[65536];
+        size_t n;
+        while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0)
+            bytes.insert(bytes.end(), chunk, chunk + n);
+        fclose(f);
+
+        if (bytes.size() >= sizeof(raw_record_header_t) && std::memcmp(bytes.data(), RAW_RECORD_MAGIC, 8) == 0)
+        {
+            if (!load_recording(bytes, samples))
+                return false;
+        }
+        else
+        {
+            samples.resize(bytes.size() / sizeof(int16_t));
+            std::memcpy(samples.data(), bytes.data(), samples.size() * sizeof(int16_t));
+        }
+        return !samples.empty();
+    }
+
+    // The samples written since the last poll, at most one lap of them
+    void store_written(rp_channel_t channel, sim_channel_t &c, uint64_t written)
+    {
+        int16_t *ring = axi_memory + channel * ADC_BUFFER_SIZE;
+        uint64_t n = written > c.buffer_samples && c.stored < written - c.buffer_samples ? written - c.buffer_samples : c.stored;
+        for (; n < written; ++n)
+            ring[n % c.buffer_samples] = rp_acq_sim_sample(channel, n);
+        c.stored = written;
+    }
+
+    void configure_from_env(rp_channel_t channel, const char *name)
+    {
+        const char *spec = getenv(name);
+        if (spec && !rp_acq_sim_configure(channel, spec))
+            fprintf(stderr, "rp sim: ignoring %s=%s\n", name, spec);
+    }
+}
+
+bool rp_acq_sim_configure(rp_channel_t channel, const char *spec)
+{
+    sim_channel_t *c = find(channel);
+    if (!c || !spec)
+        return false;
+
+    const std::string s(spec);
+    const std::string kind = s.substr(0, s.find(':'));
+    const char *args = s.find(':') == std::string::npos ? "" : spec + s.find(':') + 1;
+
+    if (kind == "file")
+    {
+        std::vector<int16_t> samples;
+        if (!load_file(args, samples))
+            return false;
+        c->kind = SOURCE_FILE;
+        c->samples.swap(samples);
+        return true;
+    }
+
+    double first = 0, second = 0;
+    const int parsed = sscanf(args, "%lf:%lf", &first, &second);
+    if (kind == "noise")
+    {
+        c->kind = SOURCE_NOISE;
+        c->amplitude = parsed >= 1 ? first : 4096.0;
+        return true;
+    }
+    if (parsed < 1 || first <= 0)
+        return false;
+    if (kind == "sine")
+        c->kind = SOURCE_SINE;
+    else if (kind == "square")
+        c->kind = SOURCE_SQUARE;
+    else if (kind == "triangle")
+        c->kind = SOURCE_TRIANGLE;
+    else
+        return false;
+    c->freq = first;
+    c->amplitude = parsed == 2 ? second : 4096.0;
+    return true;
+}
+
+int16_t rp_acq_sim_sample(rp_channel_t channel, uint64_t n)
+{
+    const sim_channel_t *c = find(channel);
+    if (!c)
+        return 0;
+
+    const double phase = std::fmod(n / sample_rate(*c) * c->freq, 1.0);
+    switch (c->kind)
+    {
+    case SOURCE_SINE:
+        return clamp_code(c->amplitude * std::sin(2.0 * M_PI * phase));
+    case SOURCE_SQUARE:
+        return clamp_code(phase < 0.5 ? c->amplitude : -c->amplitude);
+    case SOURCE_TRIANGLE:
+        return clamp_code(c->amplitude * (phase < 0.5 ? 4.0 * phase - 1.0 : 3.0 - 4.0 * phase));
+    case SOURCE_NOISE:
+        return clamp_code(c->amplitude * ((mix(n + channel * 0x100000000ULL) >> 11) * 0x1.0p-53 * 2.0 - 1.0));
+    case SOURCE_FILE:
+        return c->samples[n % c->samples.size()];
+    }
+    return 0;
+}
+
+void rp_acq_sim_map_axi(int16_t *memory)
+{
+    axi_memory = memory;
+}
+
+uint64_t rp_acq_sim_written(rp_channel_t channel)
+{
+    const sim_channel_t *c = find(channel);
+    if (!c)
+        return 0;
+    return samples_at(*c, c->stop_ns ? c->stop_ns : now_ns());
+}
+
+extern "C"
+{
+    int rp_Init(void)
+    {
+        configure_from_env(RP_CH_1, "RP_SIM_ADC");
+        configure_from_env(RP_CH_2, "RP_SIM_ADC");
+        configure_from_env(RP_CH_1, "RP_SIM_ADC_CH1");
+        configure_from_env(RP_CH_2, "RP_SIM_ADC_CH2");
+        if (const char *ms = getenv("RP_SIM_TRIGGER_MS"))
+            trigger_delay_s = atof(ms) / 1000.0;
+        if (const char *rate = getenv("RP_SIM_RATE"))
+            rate_factor = atof(rate) > 0 ? atof(rate) : 1.0;
+
+        // The application sends one call per DAC sample, only the log keeps them
+        rp_gen_sim_keep(false);
+        if (const char *log = getenv("RP_SIM_DAC_LOG"))
+        {
+            if (!rp_gen_sim_log(log))
+                fprintf(stderr, "rp sim: cannot open the DAC log %s\n", log);
+        }
+        return RP_OK;
+    }
+
+    int rp_Release(void)
+    {
+        rp_gen_sim_log(nullptr);
+        return RP_OK;
+    }
+
+    int rp_AcqReset(void)
+    {
+        for (sim_channel_t &c : channels)
+        {
+            c.decimation = 1;
+            c.buffer_samples = ADC_BUFFER_SIZE;
+            c.trigger_src = RP_TRIG_SRC_DISABLED;
+            c.enabled = false;
+            c.started = false;
+            c.stop_ns = 0;
+        }
+        return RP_OK;
+    }
+
+    int rp_AcqSetSplitTrigger(bool) { return RP_OK; }
+    int rp_AcqSetSplitTriggerPass(bool) { return RP_OK; }
+    int rp_AcqSetTriggerLevel(rp_channel_trigger_t channel, float) { return channel <= RP_T_CH_2 ? RP_OK : RP_EOOR; }
+
+    int rp_AcqGetSamplingRateHz(float *sampling_rate)
+    {
+        *sampling_rate = static_cast<float>(ADC_RATE / channels[0].decimation);
+        return RP_OK;
+    }
+
+    int rp_AcqSetTriggerSrcCh(rp_channel_t channel, rp_acq_trig_src_t source)
+    {
+        sim_channel_t *c = find(channel);
+        if (!c)
+            return RP_EOOR;
+        c->trigger_src = source;
+        return RP_OK;
+    }
+
+    int rp_AcqGetTriggerStateCh(rp_channel_t channel, rp_acq_trig_state_t *state)
+    {
+        const sim_channel_t *c = find(channel);
+        if (!c)
+            return RP_EOOR;
+        const bool triggered = c->started && c->trigger_src != RP_TRIG_SRC_DISABLED &&
+                               rp_acq_sim_written(channel) > trigger_sample(*c);
+        *state = triggered ? RP_TRIG_STATE_TRIGGERED : RP_TRIG_STATE_WAITING;
+        return RP_OK;
+    }
+
+    int rp_AcqStartCh(rp_channel_t channel)
+    {
+        sim_channel_t *c = find(channel);
+        if (!c)
+            return RP_EOOR;
+        c->started = true;
+        c->start_ns = now_ns();
+        c->stop_ns = 0;
+        c->stored = 0;
+        return RP_OK;
+    }
+
+    int rp_AcqStopCh(rp_channel_t channel)
+    {
+        sim_channel_t *c = find(channel);
+        if (!c)
+            return RP_EOOR;
+        if (c->started && !c->stop_ns)
+            c->stop_ns = now_ns();
+        return RP_OK;
+    }
+
+    int rp_AcqAxiGetMemoryRegion(uint32_t *start, uint32_t *size)
+    {
+        *start = SIM_AXI_START;
+        *size = 2 * ADC_BUFFER_SIZE * sizeof(int16_t);
+        return RP_OK;
+    }
+
+    int rp_AcqAxiSetDecimationFactorCh(rp_channel_t channel, uint32_t decimation)
+    {
+        sim_channel_t *c = find(channel);
+        if (!c || decimation == 0 || decimation > 65536)
+            return RP_EOOR;
+        c->decimation = decimation;
+        return RP_OK;
+    }
+
+    int rp_AcqAxiSetTriggerDelay(rp_channel_t channel, int32_t)
+    {
+        return find(channel) ? RP_OK : RP_EOOR;
+    }
+
+    int rp_AcqAxiSetBufferSamples(rp_channel_t channel, uint32_t, uint32_t samples)
+    {
+        sim_channel_t *c = find(channel);
+        if (!c || samples == 0 || samples > ADC_BUFFER_SIZE)
+            return RP_EOOR;
+        c->buffer_samples = samples;
+        return RP_OK;
+    }
+
+    int rp_AcqAxiEnable(rp_channel_t channel, bool enable)
+    {
+        sim_channel_t *c = find(channel);
+        if (!c)
+            return RP_EOOR;
+        c->enabled = enable;
+        return RP_OK;
+    }
+
+    int rp_AcqAxiGetWritePointer(rp_channel_t channel, uint32_t *pos)
+    {
+        sim_channel_t *c = find(channel);
+        if (!c || !c->enabled)
+            return RP_EOOR;
+        const uint64_t written = rp_acq_sim_written(channel);
+        if (axi_memory)
+            store_written(channel, *c, written);
+        *pos = static_cast<uint32_t>(written % c->buffer_samples);
+        return RP_OK;
+    }
+
+    int rp_AcqAxiGetWritePointerAtTrig(rp_channel_t channel, uint32_t *pos)
+    {
+        const sim_channel_t *c = find(channel);
+        if (!c || !c->enabled)
+            return RP_EOOR;
+        *pos = static_cast<uint32_t>(trigger_sample(*c) % c->buffer_samples);
+        return RP_OK;
+    }
+
+    // Each ring position holds the latest sample written to it, 0 where nothing was written yet
+    int rp_AcqAxiGetDataRaw(rp_channel_t channel, uint32_t pos, uint32_t *size, int16_t *buffer)
+    {
+        const sim_channel_t *c = find(channel);
+        if (!c || !c->enabled || pos >= c->buffer_samples || *size > c->buffer_samples)
+            return RP_EOOR;
+
+        const uint64_t written = rp_acq_sim_written(channel);
+        const uint32_t last = written ? static_cast<uint32_t>((written - 1) % c->buffer_samples) : 0;
+        for (uint32_t i = 0; i < *size; ++i)
+        {
+            const uint32_t p = (pos + i) % c->buffer_samples;
+            const uint64_t back = (last + c->buffer_samples - p) % c->buffer_samples;
+            buffer[i] = written > back ? rp_acq_sim_sample(channel, written - 1 - back) : 0;
+        }
+        return RP_OK;
+    }
+}
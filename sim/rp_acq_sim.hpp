@@ -0,0 +1,35 @@
+/*rp_acq_sim.hpp*/
+
+#pragma once
+
+#include "rp.h"
+#include <cstdint>
+
+// Simulated ADC behind the rp_Acq* calls of sim/rp.h. Each channel's AXI ring fills in real time at
+// 125 MS/s / decimation from the moment rp_AcqStartCh() is called: the write pointer is computed from
+// the steady clock, so it keeps moving in the forked channel processes without a thread behind it.
+// Sample n of a channel is a pure function of n, so any ring position always reads the latest sample
+// written there, as the DMA would leave it.
+//
+// rp_Init() configures it from the environment:
+//   RP_SIM_ADC, RP_SIM_ADC_CH1, RP_SIM_ADC_CH2  source of both channels or of one, see rp_acq_sim_configure()
+//   RP_SIM_TRIGGER_MS                           trigger this long after rp_AcqStartCh() (default 1)
+//   RP_SIM_RATE                                 sample rate factor, 2 fills the ring twice as fast (default 1);
+//                                               the acquisition counts the laps of a stall at the nominal rate
+//   RP_SIM_DAC_LOG                              file every rp_Gen* call is appended to, see rp_gen_sim.hpp
+
+// Source of one channel:
+//   sine:<Hz>[:<amplitude>]  square:<Hz>[:<amplitude>]  triangle:<Hz>[:<amplitude>]  noise[:<amplitude>]
+//   file:<path>  a binary recording (RawRecord.hpp, its windows scaled back to ADC codes) or any
+//                other file as little endian int16 codes, played in a loop
+// Amplitudes are in ADC codes (default 4096, full scale 8192). Returns false on a bad spec or file.
+bool rp_acq_sim_configure(rp_channel_t channel, const char *spec);
+
+// Host memory standing in for the AXI reserved memory (a host_memory_source_t mapped by map_acq_ring),
+// channel 2 half way in like on the board. Each rp_AcqAxiGetWritePointer() then stores the samples
+// written since the last call into the ring as the DMA would, so ACQ_ZERO_COPY reads them in place.
+void rp_acq_sim_map_axi(int16_t *memory);
+
+// Sample n of a channel since its start, and how many it has written so far
+int16_t rp_acq_sim_sample(rp_channel_t channel, uint64_t n);
+uint64_t rp_acq_sim_written(rp_channel_t channel);
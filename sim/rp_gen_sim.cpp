@@ -0,0 +1,245 @@
+/*rp_gen_sim.cpp*/
+
+#include "rp_gen_sim.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <fcntl.h>
+#include <mutex>
+#include <thread>
+#include <unistd.h>
+
+namespace
+{
+    std::mutex calls_mutex;
+    std::vector<rp_gen_call_t> calls;
+    bool keep_calls = true;
+    int log_fd = -1;
+
+    // Generator state of each output, under calls_mutex
+    struct generator_t
+    {
+        bool triggered = false;
+        uint64_t trigger_ns = 0;
+        float frequency = 0.0f;
+        uint32_t length = 0;
+    };
+    generator_t generators[2];
+
+    // Manual clock, under calls_mutex
+    std::condition_variable clock_moved;
+    bool manual_clock = false;
+    uint64_t manual_ns = 0;
+    bool waiting = false;
+    uint64_t waiting_until = 0;
+
+    uint64_t now_ns()
+    {
+        if (manual_clock)
+            return manual_ns;
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    double sample_ns(const generator_t &gen)
+    {
+        return 1e9 / (static_cast<double>(gen.frequency) * gen.length);
+    }
+
+    uint64_t position(const generator_t &gen, uint64_t time_ns)
+    {
+        if (!gen.triggered || gen.length == 0 || gen.frequency <= 0.0f || time_ns < gen.trigger_ns)
+            return 0;
+        return static_cast<uint64_t>((time_ns - gen.trigger_ns) / sample_ns(gen));
+    }
+
+    void log_call(const rp_gen_call_t &call)
+    {
+        std::string line = std::to_string(call.time_ns) + "," + std::to_string(call.channel + 1) + "," + call.name;
+        char value[32];
+        snprintf(value, sizeof(value), ",%g", call.value);
+        line += value;
+        for (float sample : call.samples)
+        {
+            snprintf(value, sizeof(value), ",%g", sample);
+            line += value;
+        }
+        line += '\n';
+        if (write(log_fd, line.data(), line.size()) != static_cast<ssize_t>(line.size()))
+            perror("rp_gen_sim_log");
+    }
+
+    int record(const char *name, rp_channel_t channel, float value, const float *samples = nullptr, uint32_t length = 0)
+    {
+        if (channel != RP_CH_1 && channel != RP_CH_2)
+            return RP_EOOR;
+
+        rp_gen_call_t call;
+        call.name = name;
+        call.channel = channel;
+        call.value = value;
+        if (samples)
+            call.samples.assign(samples, samples + length);
+
+        std::lock_guard<std::mutex> lock(calls_mutex);
+        call.time_ns = now_ns();
+        generator_t &gen = generators[channel];
+        if (call.name == "rp_GenTriggerOnly")
+        {
+            gen.triggered = true;
+            gen.trigger_ns = call.time_ns;
+        }
+        else if (call.name == "rp_GenFreq")
+            gen.frequency = value;
+        else if (call.name == "rp_GenArbWaveform")
+            gen.length = length;
+        else if (call.name == "rp_GenReset")
+            generators[RP_CH_1] = generators[RP_CH_2] = generator_t{};
+
+        if (log_fd >= 0)
+            log_call(call);
+        if (keep_calls)
+            calls.push_back(std::move(call));
+        return RP_OK;
+    }
+}
+
+std::vector<rp_gen_call_t> rp_gen_sim_calls()
+{
+    std::lock_guard<std::mutex> lock(calls_mutex);
+    return calls;
+}
+
+void rp_gen_sim_clear()
+{
+    std::lock_guard<std::mutex> lock(calls_mutex);
+    calls.clear();
+}
+
+void rp_gen_sim_keep(bool keep)
+{
+    std::lock_guard<std::mutex> lock(calls_mutex);
+    keep_calls = keep;
+}
+
+uint32_t rp_gen_sim_read_pointer(rp_channel_t channel)
+{
+    std::lock_guard<std::mutex> lock(calls_mutex);
+    const generator_t &gen = generators[channel];
+    return gen.length ? position(gen, now_ns()) % gen.length : 0;
+}
+
+int rp_gen_sim_write(rp_channel_t channel, uint32_t offset, const float *samples, uint32_t count)
+{
+    if (!samples || count == 0 || offset + count > DAC_BUFFER_SIZE)
+        return RP_EOOR;
+    return record("arb_write", channel, static_cast<float>(offset), samples, count);
+}
+
+uint64_t rp_gen_sim_position(rp_channel_t channel, uint64_t time_ns)
+{
+    std::lock_guard<std::mutex> lock(calls_mutex);
+    return position(generators[channel], time_ns);
+}
+
+void rp_gen_sim_wait(rp_channel_t channel, uint32_t samples)
+{
+    std::unique_lock<std::mutex> lock(calls_mutex);
+    const generator_t &gen = generators[channel];
+    const uint64_t ns = gen.length && gen.frequency > 0.0f ? static_cast<uint64_t>(samples * sample_ns(gen)) + 1 : 0;
+    if (!manual_clock)
+    {
+        lock.unlock();
+        std::this_thread::sleep_for(std::chrono::nanoseconds(ns));
+        return;
+    }
+
+    waiting_until = manual_ns + ns;
+    waiting = true;
+    clock_moved.wait(lock, [&] { return manual_ns >= waiting_until; });
+    waiting = false;
+}
+
+void rp_gen_sim_manual_clock(bool manual)
+{
+    std::lock_guard<std::mutex> lock(calls_mutex);
+    manual_clock = manual;
+    manual_ns = 0;
+}
+
+void rp_gen_sim_advance(uint64_t ns, const std::function<bool()> &settled)
+{
+    std::unique_lock<std::mutex> lock(calls_mutex);
+    while (!waiting && !settled())
+    {
+        lock.unlock();
+        std::this_thread::yield();
+        lock.lock();
+    }
+
+    manual_ns += ns;
+    // A writer woken here counts as busy until it is back in rp_gen_sim_wait() or settled
+    if (waiting && manual_ns >= waiting_until)
+        waiting = false;
+    clock_moved.notify_all();
+}
+
+bool rp_gen_sim_log(const char *path)
+{
+    std::lock_guard<std::mutex> lock(calls_mutex);
+    if (log_fd >= 0)
+        close(log_fd);
+    log_fd = path ? open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644) : -1;
+    return !path || log_fd >= 0;
+}
+
+extern "C"
+{
+    int rp_GenReset(void) { return record("rp_GenReset", RP_CH_1, 0.0f); }
+    int rp_GenOutEnable(rp_channel_t channel) { return record("rp_GenOutEnable", channel, 0.0f); }
+    int rp_GenOutDisable(rp_channel_t channel) { return record("rp_GenOutDisable", channel, 0.0f); }
+    int rp_GenTriggerOnly(rp_channel_t channel) { return record("rp_GenTriggerOnly", channel, 0.0f); }
+    int rp_GenResetTrigger(rp_channel_t channel) { return record("rp_GenResetTrigger", channel, 0.0f); }
+
+    int rp_GenAmp(rp_channel_t channel, float amplitude)
+    {
+        if (amplitude < -1.0f || amplitude > 1.0f)
+            return RP_EOOR;
+        return record("rp_GenAmp", channel, amplitude);
+    }
+
+    int rp_GenOffset(rp_channel_t channel, float offset)
+    {
+        if (offset < -1.0f || offset > 1.0f)
+            return RP_EOOR;
+        return record("rp_GenOffset", channel, offset);
+    }
+
+    int rp_GenFreq(rp_channel_t channel, float frequency)
+    {
+        if (frequency <= 0.0f || frequency > 62.5e6f)
+            return RP_EOOR;
+        return record("rp_GenFreq", channel, frequency);
+    }
+
+    int rp_GenWaveform(rp_channel_t channel, rp_waveform_t type)
+    {
+        return record("rp_GenWaveform", channel, static_cast<float>(type));
+    }
+
+    int rp_GenArbWaveform(rp_channel_t channel, float *waveform, uint32_t length)
+    {
+        if (!waveform || length == 0 || length > DAC_BUFFER_SIZE)
+            return RP_EOOR;
+        return record("rp_GenArbWaveform", channel, static_cast<float>(length), waveform, length);
+    }
+
+    int rp_GenMode(rp_channel_t channel, rp_gen_mode_t mode)
+    {
+        return record("rp_GenMode", channel, static_cast<float>(mode));
+    }
+
+    int rp_GenBurstCount(rp_channel_t channel, int num)
+    {
+        return record("rp_GenBurstCount", channel, static_cast<float>(num));
+    }
+}
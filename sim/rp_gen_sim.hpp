@@ -0,0 +1,47 @@
+/*rp_gen_sim.hpp*/
+
+#pragma once
+
+#include "rp.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Every rp_Gen* call made against the simulation, in call order
+struct rp_gen_call_t
+{
+    std::string name;
+    rp_channel_t channel;
+    float value;                // Amplitude, offset, frequency, waveform type, mode or burst count
+    std::vector<float> samples; // rp_GenArbWaveform only
+    uint64_t time_ns;           // steady clock, or the manual one
+};
+
+// Snapshot of the calls recorded so far
+std::vector<rp_gen_call_t> rp_gen_sim_calls();
+void rp_gen_sim_clear();
+
+// Whether calls are kept for rp_gen_sim_calls() (default true)
+void rp_gen_sim_keep(bool keep);
+
+// The generator plays its arbitrary waveform buffer from rp_GenTriggerOnly() on, at the last
+// rp_GenFreq() over the length of the last rp_GenArbWaveform(). The ASG registers the board reads
+// and writes through /dev/mem are simulated below: the read pointer at the current time, and
+// writes of part of the buffer, recorded as "arb_write" calls with the offset as value.
+uint32_t rp_gen_sim_read_pointer(rp_channel_t channel);
+int rp_gen_sim_write(rp_channel_t channel, uint32_t offset, const float *samples, uint32_t count);
+// Samples the generator played from the trigger to time_ns
+uint64_t rp_gen_sim_position(rp_channel_t channel, uint64_t time_ns);
+// Returns once about `samples` generator samples went by
+void rp_gen_sim_wait(rp_channel_t channel, uint32_t samples);
+
+// With the manual clock, time stands still from 0 until rp_gen_sim_advance() moves it on. The
+// advance first waits for the writer to settle: blocked in rp_gen_sim_wait(), or `settled`
+// returning true, meaning it has nothing left to do at the current time.
+void rp_gen_sim_manual_clock(bool manual);
+void rp_gen_sim_advance(uint64_t ns, const std::function<bool()> &settled);
+
+// Also append every call to `path` as a CSV line "time_ns,channel,call,value[,samples...]", with one
+// O_APPEND write per call so the forked channel processes can share the file. nullptr closes it.
+bool rp_gen_sim_log(const char *path);
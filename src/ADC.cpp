@@ -3,6 +3,10 @@
 #include "ADC.hpp"
 #include <iostream>
 
+static uint32_t g_adc_axi_start = 0;
+static uint32_t g_adc_axi_size = 0;
+static acq_memory_source_t *acq_memory = nullptr;
+
 void initialize_acq()
 {
     rp_AcqReset();
@@ -15,7 +19,6 @@ void initialize_acq()
         std::cerr << "rp_AcqSetSplitTriggerPass failed!" << std::endl;
     }
 
-    uint32_t g_adc_axi_start, g_adc_axi_size;
     if (rp_AcqAxiGetMemoryRegion(&g_adc_axi_start, &g_adc_axi_size) != RP_OK)
     {
         std::cerr << "rp_AcqAxiGetMemoryRegion failed!" << std::endl;
@@ -111,6 +114,21 @@ void initialize_acq()
     }
 }
 
+bool map_acq_ring(acq_memory_source_t &source)
+{
+    const int16_t *base = source.map(g_adc_axi_start, g_adc_axi_size);
+    if (!base)
+    {
+        std::cerr << "Mapping the AXI reserved memory failed, falling back to rp_AcqAxiGetDataRaw." << std::endl;
+        return false;
+    }
+
+    channel1.axi_ring = base;
+    channel2.axi_ring = base + (g_adc_axi_size / 2) / sizeof(int16_t);
+    acq_memory = &source;
+    return true;
+}
+
 void cleanup()
 {
     std::cout << "\nReleasing resources\n";
@@ -118,6 +136,13 @@ void cleanup()
     rp_AcqStopCh(RP_CH_2);
     rp_AcqAxiEnable(RP_CH_1, false);
     rp_AcqAxiEnable(RP_CH_2, false);
+    if (acq_memory)
+    {
+        channel1.axi_ring = nullptr;
+        channel2.axi_ring = nullptr;
+        acq_memory->unmap();
+        acq_memory = nullptr;
+    }
     rp_Release();
     std::cout << "Cleanup done." << std::endl;
 }
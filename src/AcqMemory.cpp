@@ -0,0 +1,79 @@
+/*AcqMemory.cpp*/
+
+#include "AcqMemory.hpp"
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+const int16_t *devmem_source_t::map(uint32_t phys_addr, uint32_t size)
+{
+    fd = open("/dev/mem", O_RDONLY | O_SYNC);
+    if (fd < 0)
+    {
+        std::cerr << "Error opening /dev/mem for the AXI reserved memory." << std::endl;
+        return nullptr;
+    }
+
+    // mmap needs a page aligned offset, the reserved region usually is but keep the remainder just in case
+    const uint32_t page_mask = static_cast<uint32_t>(sysconf(_SC_PAGESIZE)) - 1;
+    const uint32_t page_offset = phys_addr & page_mask;
+
+    mapping_size = size + page_offset;
+    mapping = mmap(nullptr, mapping_size, PROT_READ, MAP_SHARED, fd, phys_addr - page_offset);
+    if (mapping == MAP_FAILED)
+    {
+        std::cerr << "mmap of the AXI reserved memory failed." << std::endl;
+        mapping = nullptr;
+        close(fd);
+        fd = -1;
+        return nullptr;
+    }
+
+    return reinterpret_cast<const int16_t *>(static_cast<const uint8_t *>(mapping) + page_offset);
+}
+
+void devmem_source_t::unmap()
+{
+    if (mapping)
+    {
+        munmap(mapping, mapping_size);
+        mapping = nullptr;
+    }
+    if (fd >= 0)
+    {
+        close(fd);
+        fd = -1;
+    }
+}
+
+const int16_t *host_memory_source_t::map(uint32_t, uint32_t size)
+{
+    buffer.assign(size / sizeof(int16_t), 0);
+    return buffer.data();
+}
+
+void host_memory_source_t::unmap()
+{
+    buffer.clear();
+    buffer.shrink_to_fit();
+}
+
+raw_view_t make_raw_view(const int16_t *ring, uint32_t pos, uint32_t count)
+{
+    raw_view_t view;
+    view.first = ring + pos;
+
+    if (pos + count <= DATA_SIZE)
+    {
+        view.first_len = count;
+    }
+    else
+    {
+        view.first_len = DATA_SIZE - pos;
+        view.second = ring;
+        view.second_len = count - view.first_len;
+    }
+
+    return view;
+}
@@ -0,0 +1,89 @@
+/*CsvWriter.cpp*/
+
+#include "CsvWriter.hpp"
+#include <iostream>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+csv_writer_t::csv_writer_t(size_t capacity, csv_flush_policy_t policy)
+    : buffer(capacity), policy(policy)
+{
+}
+
+csv_writer_t::~csv_writer_t()
+{
+    close();
+}
+
+bool csv_writer_t::open(const std::string &filename)
+{
+    fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    used = 0;
+    write_failed = false;
+    last_write = std::chrono::steady_clock::now();
+    return fd >= 0;
+}
+
+void csv_writer_t::close()
+{
+    if (fd < 0)
+        return;
+    write_pending();
+    ::close(fd);
+    fd = -1;
+}
+
+void csv_writer_t::end_batch()
+{
+    if (used == 0)
+        return;
+
+    if (policy.bytes && used >= policy.bytes)
+    {
+        write_pending();
+        return;
+    }
+
+    if (policy.interval_ms &&
+        std::chrono::steady_clock::now() - last_write >= std::chrono::milliseconds(policy.interval_ms))
+    {
+        write_pending();
+    }
+}
+
+uint32_t csv_writer_t::idle()
+{
+    end_batch();
+    if (used == 0 || policy.interval_ms == 0)
+        return 0;
+
+    auto left = std::chrono::milliseconds(policy.interval_ms) - (std::chrono::steady_clock::now() - last_write);
+    auto left_ms = std::chrono::ceil<std::chrono::milliseconds>(left).count();
+    return left_ms > 0 ? static_cast<uint32_t>(left_ms) : 1;
+}
+
+void csv_writer_t::write_pending()
+{
+    const char *data = buffer.data();
+    size_t size = used;
+    used = 0;
+    last_write = std::chrono::steady_clock::now();
+
+    // Keep draining the queue after a failure, the data is lost either way
+    while (size > 0 && !write_failed)
+    {
+        ssize_t written = ::write(fd, data, size);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            std::cerr << "Error writing CSV output: " << strerror(errno) << std::endl;
+            write_failed = true;
+            break;
+        }
+        data += written;
+        size -= written;
+    }
+}
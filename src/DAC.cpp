@@ -1,6 +1,15 @@
 /*DAC.cpp*/
 
 #include "DAC.hpp"
+#include <iostream>
+#include <cmath>
+#ifdef RP_SIM
+#include "rp_gen_sim.hpp"
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
 
 void initialize_DAC()
 {
@@ -12,3 +21,126 @@ void initialize_DAC()
     rp_GenTriggerOnly(RP_CH_1);
     rp_GenTriggerOnly(RP_CH_2);
 }
+
+// Switches one output to arbitrary waveform playback, continuous so the buffer keeps looping.
+// Playback starts with the next rp_GenTriggerOnly().
+bool initialize_DAC_playback(rp_channel_t rp_channel, const float *waveform)
+{
+    if (rp_GenWaveform(rp_channel, RP_WAVEFORM_ARBITRARY) != RP_OK ||
+        rp_GenArbWaveform(rp_channel, const_cast<float *>(waveform), DAC_PLAYBACK_SAMPLES) != RP_OK ||
+        rp_GenMode(rp_channel, RP_GEN_MODE_CONTINUOUS) != RP_OK ||
+        rp_GenAmp(rp_channel, 1.0f) != RP_OK ||
+        rp_GenOffset(rp_channel, 0.0f) != RP_OK ||
+        rp_GenFreq(rp_channel, static_cast<float>(DAC_PLAYBACK_FREQ)) != RP_OK)
+    {
+        std::cerr << "Arbitrary waveform setup failed on DAC channel " << rp_channel + 1 << std::endl;
+        return false;
+    }
+
+    return rp_GenOutEnable(rp_channel) == RP_OK;
+}
+
+#ifdef RP_SIM
+struct sim_dac_port_t : dac_arb_port_t
+{
+    explicit sim_dac_port_t(rp_channel_t rp_channel) : rp_channel(rp_channel) {}
+
+    uint32_t read_pointer() override { return rp_gen_sim_read_pointer(rp_channel); }
+
+    bool write(uint32_t offset, const float *samples, uint32_t count) override
+    {
+        return rp_gen_sim_write(rp_channel, offset, samples, count) == RP_OK;
+    }
+
+    void wait(uint32_t samples) override { rp_gen_sim_wait(rp_channel, samples); }
+
+private:
+    rp_channel_t rp_channel;
+};
+
+std::unique_ptr<dac_arb_port_t> open_dac_arb_port(rp_channel_t rp_channel)
+{
+    return std::make_unique<sim_dac_port_t>(rp_channel);
+}
+#else
+// Arbitrary signal generator of the FPGA (red_pitaya_asg): the read pointer of each output as a
+// byte offset into its buffer, and the buffers with one 14-bit two's complement sample per word
+#define ASG_BASE 0x40200000
+#define ASG_MAP_SIZE 0x30000
+#define ASG_READ_POINTER_CH1 0x14
+#define ASG_READ_POINTER_CH2 0x34
+#define ASG_BUFFER_CH1 0x10000
+#define ASG_BUFFER_CH2 0x20000
+
+struct devmem_dac_port_t : dac_arb_port_t
+{
+    explicit devmem_dac_port_t(rp_channel_t rp_channel) : rp_channel(rp_channel) {}
+
+    ~devmem_dac_port_t() override
+    {
+        if (mapping)
+            munmap(mapping, ASG_MAP_SIZE);
+        if (fd >= 0)
+            close(fd);
+    }
+
+    bool open()
+    {
+        fd = ::open("/dev/mem", O_RDWR | O_SYNC);
+        if (fd < 0)
+        {
+            std::cerr << "Error opening /dev/mem for the generator registers." << std::endl;
+            return false;
+        }
+        mapping = mmap(nullptr, ASG_MAP_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, ASG_BASE);
+        if (mapping == MAP_FAILED)
+        {
+            std::cerr << "mmap of the generator registers failed." << std::endl;
+            mapping = nullptr;
+            return false;
+        }
+        return true;
+    }
+
+    uint32_t read_pointer() override
+    {
+        const uint32_t pointer = reg(rp_channel == RP_CH_1 ? ASG_READ_POINTER_CH1 : ASG_READ_POINTER_CH2);
+        return (pointer >> 2) % DAC_PLAYBACK_SAMPLES;
+    }
+
+    bool write(uint32_t offset, const float *samples, uint32_t count) override
+    {
+        volatile uint32_t *buffer = &reg(rp_channel == RP_CH_1 ? ASG_BUFFER_CH1 : ASG_BUFFER_CH2);
+        for (uint32_t k = 0; k < count; k++)
+        {
+            // Same counts as rp_GenArbWaveform() at amplitude 1
+            const long code = std::clamp(std::lround(samples[k] * 8192.0f), -8192L, 8191L);
+            buffer[offset + k] = static_cast<uint32_t>(code) & 0x3FFF;
+        }
+        return true;
+    }
+
+    void wait(uint32_t samples) override
+    {
+        std::this_thread::sleep_for(std::chrono::duration<double>(samples / (DAC_PLAYBACK_FREQ * DAC_PLAYBACK_SAMPLES)));
+    }
+
+private:
+    volatile uint32_t &reg(uint32_t offset)
+    {
+        return *reinterpret_cast<volatile uint32_t *>(static_cast<uint8_t *>(mapping) + offset);
+    }
+
+    rp_channel_t rp_channel;
+    void *mapping = nullptr;
+    int fd = -1;
+};
+
+std::unique_ptr<dac_arb_port_t> open_dac_arb_port(rp_channel_t rp_channel)
+{
+    auto port = std::make_unique<devmem_dac_port_t>(rp_channel);
+    if (!port->open())
+        return nullptr;
+    return port;
+}
+#endif
@@ -2,8 +2,45 @@
 
 #include "DataAcquisition.hpp"
 #include "SystemUtils.hpp"
+#include <cmath>
+#include <fstream>
 #include <iostream>
 
+#if ACQ_OVERRUN_RESYNC
+// Appends one overrun to the channel's gap log and counters
+static void record_gap(Channel &channel, uint64_t raw_index, uint64_t samples_lost)
+{
+    const uint64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                std::chrono::steady_clock::now().time_since_epoch())
+                                .count();
+    if (channel.gap_count < ACQ_GAP_LOG_SIZE)
+        channel.gaps[channel.gap_count] = {now_ns, raw_index, samples_lost, channel.counters->acquire_count.load()};
+    ++channel.gap_count;
+    channel.counters->overrun_count.fetch_add(1, std::memory_order_relaxed);
+    channel.counters->samples_lost.fetch_add(samples_lost, std::memory_order_relaxed);
+}
+#endif
+
+static void save_gap_log(const Channel &channel)
+{
+    const int ch = static_cast<int>(channel.channel_id) + 1;
+    const std::string filename = "DataOutput/gaps_ch" + std::to_string(ch) + ".csv";
+    std::ofstream out(filename);
+    if (!out)
+    {
+        std::cerr << "Error opening gap log " << filename << std::endl;
+        return;
+    }
+    out << "time_ns,raw_index,samples_lost,window\n";
+    const uint32_t logged = channel.gap_count < ACQ_GAP_LOG_SIZE ? channel.gap_count : ACQ_GAP_LOG_SIZE;
+    for (uint32_t i = 0; i < logged; ++i)
+    {
+        const acq_gap_t &gap = channel.gaps[i];
+        out << gap.time_ns << ',' << gap.raw_index << ',' << gap.samples_lost << ',' << gap.window << '\n';
+    }
+    std::cout << channel.gap_count << " overrun(s) on channel " << ch << ", gap log in " << filename << std::endl;
+}
+
 void acquire_data(Channel &channel, rp_channel_t rp_channel)
 {
     try
@@ -50,6 +87,45 @@ void acquire_data(Channel &channel, rp_channel_t rp_channel)
         }
 
         uint32_t pos = pw;
+        uint64_t raw_index = 0;
+
+        constexpr double samples_per_ns = ADC_SAMPLE_RATE / DECIMATION * 1e-9;
+        uint64_t written = 0;
+        uint32_t last_pwrite = pw;
+        auto last_poll = channel.trigger_time_point;
+        bool discontinuity = false;
+
+        // The write pointer only gives the position in the ring, the time since the last poll
+        // tells how many times the DMA went around it meanwhile
+        auto poll_write_pointer = [&](uint32_t &pwrite)
+        {
+            if (rp_AcqAxiGetWritePointer(rp_channel, &pwrite) != RP_OK)
+                return false;
+            auto now = std::chrono::steady_clock::now();
+            uint32_t moved = (pwrite + DATA_SIZE - last_pwrite) % DATA_SIZE;
+            double expected = std::chrono::duration<double, std::nano>(now - last_poll).count() * samples_per_ns;
+            int64_t laps = std::llround((expected - moved) / DATA_SIZE);
+            written += moved + (laps > 0 ? laps : 0) * static_cast<uint64_t>(DATA_SIZE);
+            last_pwrite = pwrite;
+            last_poll = now;
+            channel.raw_head.store(written, std::memory_order_release);
+            return true;
+        };
+
+        // Checked while a BLOCK consumer holds a claim back, the write pointer keeps being polled
+        // meanwhile so raw_head stays current for the readers of the raw views
+        auto claim_stopped = [&]
+        {
+            uint32_t pwrite;
+            if (channel.axi_ring)
+                poll_write_pointer(pwrite);
+            return stop_acquisition.load();
+        };
+
+        if (channel.axi_ring)
+        {
+            std::cout << "Zero-copy acquisition from the AXI ring on channel " << rp_channel + 1 << std::endl;
+        }
 
         while (!stop_acquisition.load())
         {
@@ -61,9 +137,9 @@ void acquire_data(Channel &channel, rp_channel_t rp_channel)
             }
 
             uint32_t pwrite = 0;
-            if (rp_AcqAxiGetWritePointer(rp_channel, &pwrite) == RP_OK)
+            if (poll_write_pointer(pwrite))
             {
-                int64_t distance = (pwrite >= pos) ? (pwrite - pos) : (DATA_SIZE - pos + pwrite);
+                int64_t distance = static_cast<int64_t>(written - raw_index);
 
                 if (distance < 0)
                 {
@@ -73,49 +149,94 @@ void acquire_data(Channel &channel, rp_channel_t rp_channel)
 
                 if (distance >= DATA_SIZE)
                 {
+#if ACQ_OVERRUN_RESYNC
+                    // Start over ACQ_RESYNC_MARGIN samples behind the DMA, everything before is gone
+                    const uint64_t resume = written - ACQ_RESYNC_MARGIN;
+                    record_gap(channel, raw_index, resume - raw_index);
+                    std::cerr << "WARN: Overrun on channel " << rp_channel + 1 << " at: " << channel.counters->acquire_count.load()
+                              << ", resynchronized, " << resume - raw_index << " samples lost" << std::endl;
+
+                    raw_index = resume;
+                    pos = (pwrite + DATA_SIZE - ACQ_RESYNC_MARGIN) % DATA_SIZE;
+                    discontinuity = true;
+                    continue;
+#else
                     std::cerr << "ERR: Overrun detected on channel " << rp_channel + 1 << " at: " << channel.counters->acquire_count.load() << std::endl;
 
-                    {
-                        std::lock_guard<std::mutex> lock(channel.mtx);
-                        stop_acquisition.store(true);
-                    }
-                    channel.cond_write_csv.notify_all();
-                    channel.cond_model.notify_all();
-                    return;
+                    stop_acquisition.store(true);
+                    break;
+#endif
                 }
 
                 if (distance >= samples_per_chunk)
                 {
+                    // The copying path reads the window before claiming its slot, a failed read then
+                    // leaves the ring and its consumer counters untouched and is simply retried
                     int16_t buffer_raw[samples_per_chunk];
-                    if (rp_AcqAxiGetDataRaw(rp_channel, pos, &chunk_size, buffer_raw) != RP_OK)
+                    if (!channel.axi_ring && rp_AcqAxiGetDataRaw(rp_channel, pos, &chunk_size, buffer_raw) != RP_OK)
                     {
                         std::cerr << "rp_AcqAxiGetDataRaw failed on channel " << rp_channel + 1 << std::endl;
                         continue;
                     }
 
-                    auto part = std::make_shared<data_part_t>();
-                    convert_raw_data(buffer_raw, part->data, samples_per_chunk);
+                    // Overflow policies are applied here, only a BLOCK consumer can hold the producer back
+                    data_part_t *part = channel.windows.claim(claim_stopped);
+                    channel.counters->ring_full_count.store(static_cast<int>(channel.windows.full_count()), std::memory_order_relaxed);
+                    if (!part)
+                    {
+                        if (stop_acquisition.load())
+                            break;
 
-                    pos += samples_per_chunk;
-                    if (pos >= DATA_SIZE)
-                        pos -= DATA_SIZE;
+                        // A consumer is still reading the slot to reuse, drop this window rather than wait
+                        channel.counters->pool_exhausted_count.fetch_add(1, std::memory_order_relaxed);
+                        discontinuity = true;
+                        raw_index += samples_per_chunk;
+                        pos += samples_per_chunk;
+                        if (pos >= DATA_SIZE)
+                            pos -= DATA_SIZE;
+                        continue;
+                    }
 
+                    part->discontinuity = discontinuity;
+                    part->raw_index = raw_index;
+                    if (channel.axi_ring)
                     {
-                        std::lock_guard<std::mutex> lock(channel.mtx);
-                        if (save_data_csv)
-                        {
-                            channel.data_queue_csv.push(part);
-                            channel.cond_write_csv.notify_all();
-                        }
+                        part->raw = make_raw_view(channel.axi_ring, pos, samples_per_chunk);
+                        if (input_norm == NORM_FUSED)
+                            convert_raw_view_norm(part->raw, part->data, channel.calib);
+                        else
+                            convert_raw_view(part->raw, part->data, channel.calib);
 
-                        if (save_data_dac)
+                        // The DMA kept writing during the conversion, a window it caught up with is torn
+                        uint32_t pcheck;
+                        if (poll_write_pointer(pcheck) && !raw_view_valid(channel, *part))
                         {
-                            channel.data_queue_dac.push(part);
-                            channel.cond_write_dac.notify_all();
+                            channel.counters->torn_count.fetch_add(1, std::memory_order_relaxed);
+                            part->discontinuity = true;
+                            part->raw = raw_view_t{};
                         }
-                        channel.model_queue.push(part);
-                        channel.cond_model.notify_all();
                     }
+                    else
+                    {
+                        if (input_norm == NORM_FUSED)
+                            convert_raw_data_norm(buffer_raw, part->data, samples_per_chunk, channel.calib);
+                        else
+                            convert_raw_data(buffer_raw, part->data, samples_per_chunk, channel.calib);
+                    }
+
+                    raw_index += samples_per_chunk;
+                    pos += samples_per_chunk;
+                    if (pos >= DATA_SIZE)
+                        pos -= DATA_SIZE;
+
+                    channel.windows.publish();
+                    discontinuity = false;
+
+                    if (save_data_csv)
+                        store_queue_stats(channel.counters->queue_csv, channel.windows.drops(CONSUMER_FILE), channel.windows.lag_max(CONSUMER_FILE));
+                    if (save_data_dac)
+                        store_queue_stats(channel.counters->queue_dac, channel.windows.drops(CONSUMER_DAC), channel.windows.lag_max(CONSUMER_DAC));
+                    store_queue_stats(channel.counters->queue_model, channel.windows.drops(CONSUMER_MODEL), channel.windows.lag_max(CONSUMER_MODEL));
 
                     channel.counters->acquire_count.fetch_add(1, std::memory_order_relaxed);
                 }
@@ -128,19 +249,11 @@ void acquire_data(Channel &channel, rp_channel_t rp_channel)
                 channel.end_time_point.time_since_epoch())
                 .count());
 
-        {
-            std::lock_guard<std::mutex> lock(channel.mtx);
-            channel.acquisition_done = true;
-            if (save_data_csv)
-            {
-                channel.cond_write_csv.notify_all();
-            }
+        channel.acquisition_done.store(true);
+        channel.windows.wake();
 
-            if (save_data_dac)
-            {
-                channel.cond_write_dac.notify_all();
-            }
-        }
+        if (channel.gap_count)
+            save_gap_log(channel);
 
         std::cout << "Acquisition thread on channel " << static_cast<int>(channel.channel_id) + 1 << " exiting..." << std::endl;
     }
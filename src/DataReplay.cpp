@@ -0,0 +1,285 @@
+/*DataReplay.cpp*/
+
+#include "DataReplay.hpp"
+#include "RawRecord.hpp"
+#include "SystemUtils.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <vector>
+
+using base_t = std::remove_cv_t<std::remove_all_extents_t<input_t>>;
+
+// Windows ready for the model, or raw ADC codes still to convert
+struct replay_capture_t
+{
+    std::vector<base_t> windows;
+    std::vector<int16_t> codes;
+    std::vector<bool> gaps; // Windows recorded after lost samples, replayed with data_part_t::discontinuity
+    size_t count = 0;
+};
+
+static constexpr size_t window_values = MODEL_INPUT_DIM_0 * MODEL_INPUT_DIM_1;
+
+static bool load_recording(const std::vector<char> &bytes, const char *path, replay_capture_t &capture)
+{
+    raw_record_header_t header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (!raw_record_header_valid(header) || bytes.size() < header.header_size)
+    {
+        std::cerr << path << " is not a raw recording" << std::endl;
+        return false;
+    }
+    if (header.dim0 != MODEL_INPUT_DIM_0 || header.dim1 != MODEL_INPUT_DIM_1 || header.sample_type != raw_sample_type<base_t>())
+    {
+        std::cerr << path << " holds " << header.dim0 << "x" << header.dim1 << " windows of sample type " << header.sample_type
+                  << ", the model takes " << MODEL_INPUT_DIM_0 << "x" << MODEL_INPUT_DIM_1 << " of type "
+                  << raw_sample_type<base_t>() << std::endl;
+        return false;
+    }
+
+    capture.count = (bytes.size() - header.header_size) / sizeof(input_t);
+    if (header.window_count && header.window_count < capture.count)
+        capture.count = header.window_count;
+    capture.windows.resize(capture.count * window_values);
+    std::memcpy(capture.windows.data(), bytes.data() + header.header_size, capture.count * sizeof(input_t));
+
+    capture.gaps.assign(capture.count, false);
+    for (uint64_t i = 0; i < raw_record_gap_entries(header); ++i)
+    {
+        const raw_record_gap_t gap = raw_record_gap(bytes.data(), i);
+        if (gap.window < capture.count)
+            capture.gaps[gap.window] = true;
+    }
+    return true;
+}
+
+// Same layout as write_data_csv: the first value of every sample, one window per line, a blank line before a gap
+static bool load_csv(const std::vector<char> &bytes, const char *path, replay_capture_t &capture)
+{
+    std::istringstream in(std::string(bytes.begin(), bytes.end()));
+    std::string line;
+    size_t line_number = 0;
+    bool gap = false;
+    while (std::getline(in, line))
+    {
+        ++line_number;
+        if (line.empty())
+        {
+            gap = !capture.gaps.empty();
+            continue;
+        }
+        capture.gaps.push_back(gap);
+        gap = false;
+
+        capture.windows.resize(capture.windows.size() + window_values);
+        base_t *window = capture.windows.data() + capture.windows.size() - window_values;
+        const char *p = line.c_str();
+        for (size_t k = 0; k < MODEL_INPUT_DIM_0; k++)
+        {
+            char *end;
+            double value = std::strtod(p, &end);
+            if (end == p || (*end != (k < MODEL_INPUT_DIM_0 - 1 ? ',' : '\0') && *end != '\r'))
+            {
+                std::cerr << path << ":" << line_number << ": expected " << MODEL_INPUT_DIM_0 << " comma separated values" << std::endl;
+                return false;
+            }
+            window[k * MODEL_INPUT_DIM_1] = static_cast<base_t>(value);
+            p = end + 1;
+        }
+    }
+    capture.count = capture.windows.size() / window_values;
+    return true;
+}
+
+static bool load_capture(const char *path, replay_capture_t &capture)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        std::cerr << "Error opening replay capture " << path << std::endl;
+        return false;
+    }
+    std::vector<char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    bool loaded;
+    const size_t length = std::strlen(path);
+    if (bytes.size() >= sizeof(raw_record_header_t) && std::memcmp(bytes.data(), RAW_RECORD_MAGIC, 8) == 0)
+        loaded = load_recording(bytes, path, capture);
+    else if (length > 4 && std::strcmp(path + length - 4, ".csv") == 0)
+        loaded = load_csv(bytes, path, capture);
+    else
+    {
+        capture.count = bytes.size() / (MODEL_INPUT_DIM_0 * sizeof(int16_t));
+        capture.codes.resize(capture.count * MODEL_INPUT_DIM_0);
+        std::memcpy(capture.codes.data(), bytes.data(), capture.codes.size() * sizeof(int16_t));
+        loaded = true;
+    }
+
+    if (loaded && capture.count == 0)
+    {
+        std::cerr << "Replay capture " << path << " holds no complete window" << std::endl;
+        return false;
+    }
+    return loaded;
+}
+
+bool parse_replay_args(int argc, char **argv, replay_options_t &options)
+{
+    int files = 0;
+    bool replay = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--replay") == 0)
+            replay = true;
+        else if (std::strcmp(argv[i], "--loops") == 0 && i + 1 < argc)
+            options.loops = std::atoi(argv[++i]);
+        else if (replay && files < 2 && argv[i][0] != '-')
+            options.path[files++] = argv[i];
+        else
+            return false;
+    }
+    return replay ? files > 0 && options.loops > 0 : options.loops == 1;
+}
+
+// Windows each stage has taken in, and whether the stage runs
+struct replay_stage_t
+{
+    const char *name;
+    const std::atomic<int> *count;
+    bool active;
+    uint64_t done_ns;
+};
+
+static uint64_t now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Waits until every running stage has taken in `total` windows, then lets the consumers exit
+static void drain_stages(Channel &channel, replay_stage_t *stages, size_t stage_count, uint64_t total)
+{
+    size_t pending = stage_count;
+    while (pending && !stop_program.load())
+    {
+        pending = 0;
+        for (size_t i = 0; i < stage_count; ++i)
+        {
+            replay_stage_t &stage = stages[i];
+            if (!stage.active || stage.done_ns)
+                continue;
+            if (static_cast<uint64_t>(stage.count->load(std::memory_order_relaxed)) >= total)
+                stage.done_ns = now_ns();
+            else
+                ++pending;
+        }
+        if (pending)
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+
+    stop_program.store(true);
+    wake_channel(channel);
+}
+
+void replay_data(Channel &channel, const char *path, int loops)
+{
+    try
+    {
+        const int ch = static_cast<int>(channel.channel_id) + 1;
+        replay_capture_t capture;
+        if (!load_capture(path, capture))
+        {
+            stop_acquisition.store(true);
+            stop_program.store(true);
+            channel.acquisition_done.store(true);
+            wake_channel(channel);
+            return;
+        }
+
+        std::cout << "Replaying " << capture.count << " windows of " << path << " on channel " << ch
+                  << (capture.codes.empty() ? "" : " (raw ADC codes)") << ", " << loops << " time(s)" << std::endl;
+
+        const uint64_t start_ns = now_ns();
+        channel.counters->trigger_time_ns.store(start_ns);
+        uint64_t published = 0;
+
+        for (int loop = 0; loop < loops && !stop_acquisition.load(); ++loop)
+        {
+            for (size_t w = 0; w < capture.count && !stop_acquisition.load(); ++w)
+            {
+                // Every consumer blocks in replay, claim only fails once the run is stopped
+                data_part_t *part = channel.windows.claim([]
+                                                          { return stop_acquisition.load(); });
+                if (!part)
+                    break;
+
+                part->raw_index = published * MODEL_INPUT_DIM_0;
+                part->discontinuity = !capture.gaps.empty() && capture.gaps[w];
+                if (!capture.codes.empty())
+                {
+                    const int16_t *codes = capture.codes.data() + w * MODEL_INPUT_DIM_0;
+                    if (input_norm == NORM_FUSED)
+                        convert_raw_data_norm(codes, part->data, MODEL_INPUT_DIM_0, channel.calib);
+                    else
+                        convert_raw_data(codes, part->data, MODEL_INPUT_DIM_0, channel.calib);
+                }
+                else
+                    std::memcpy(part->data, capture.windows.data() + w * window_values, sizeof(input_t));
+
+                channel.windows.publish();
+                ++published;
+
+                if (save_data_csv)
+                    store_queue_stats(channel.counters->queue_csv, channel.windows.drops(CONSUMER_FILE), channel.windows.lag_max(CONSUMER_FILE));
+                if (save_data_dac)
+                    store_queue_stats(channel.counters->queue_dac, channel.windows.drops(CONSUMER_DAC), channel.windows.lag_max(CONSUMER_DAC));
+                store_queue_stats(channel.counters->queue_model, channel.windows.drops(CONSUMER_MODEL), channel.windows.lag_max(CONSUMER_MODEL));
+
+                channel.counters->acquire_count.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        const uint64_t source_ns = now_ns();
+        channel.end_time_point = std::chrono::steady_clock::now();
+        channel.counters->end_time_ns.store(source_ns);
+        channel.acquisition_done.store(true);
+        channel.windows.wake();
+
+        replay_stage_t stages[] = {
+            {"model", &channel.counters->model_count, true, 0},
+            {save_data_bin ? "binary recorder" : "data CSV writer", &channel.counters->write_count_csv, save_data_csv, 0},
+            {"data DAC writer", &channel.counters->write_count_dac, save_data_dac, 0},
+            {"result CSV writer", &channel.counters->log_count_csv, save_output_csv, 0},
+            {"result DAC writer", &channel.counters->log_count_dac, save_output_dac, 0},
+        };
+        drain_stages(channel, stages, std::size(stages), published);
+
+        // One write so the two channel processes do not interleave their lines
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(1);
+        auto rate = [&](const char *name, uint64_t end_ns)
+        {
+            const double seconds = (end_ns - start_ns) * 1e-9;
+            out << std::left << std::setw(60) << "Replay CH" + std::to_string(ch) + " " + name + ":" << published
+                << " windows in " << std::setprecision(3) << seconds << " s, " << std::setprecision(1)
+                << (seconds > 0 ? published / seconds : 0.0) << " windows/s\n";
+        };
+        rate("source", source_ns);
+        for (const replay_stage_t &stage : stages)
+        {
+            if (stage.active && stage.done_ns)
+                rate(stage.name, stage.done_ns);
+        }
+        std::cout << out.str() << std::flush;
+
+        std::cout << "Replay thread on channel " << ch << " exiting..." << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Exception in replay_data for channel " << static_cast<int>(channel.channel_id) + 1 << ": " << e.what() << std::endl;
+    }
+}
@@ -0,0 +1,168 @@
+/* DataWriterBin.cpp */
+
+#include "DataWriterBin.hpp"
+#include <iostream>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+#include <fcntl.h>
+#include <unistd.h>
+
+static bool write_all(int fd, const uint8_t *data, size_t size)
+{
+    while (size > 0)
+    {
+        ssize_t written = write(fd, data, size);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        data += written;
+        size -= written;
+    }
+    return true;
+}
+
+static raw_record_header_t make_header(const Channel &channel, uint64_t window_count, uint64_t gap_count)
+{
+    using base_t = std::remove_cv_t<std::remove_all_extents_t<input_t>>;
+
+    raw_record_header_t header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, RAW_RECORD_MAGIC, sizeof(header.magic));
+    header.version = RAW_RECORD_VERSION;
+    header.header_size = RAW_RECORD_HEADER_SIZE;
+    header.dim0 = MODEL_INPUT_DIM_0;
+    header.dim1 = MODEL_INPUT_DIM_1;
+    header.sample_type = raw_sample_type<base_t>();
+    header.sample_size = sizeof(base_t);
+    header.decimation = DECIMATION;
+    header.channel = static_cast<uint32_t>(channel.channel_id) + 1;
+    header.window_count = window_count;
+    header.gap_count = gap_count;
+
+    // The trigger is timestamped on the steady clock, move it onto the wall clock for offline use
+    header.trigger_time_ns = channel.counters->trigger_time_ns.load();
+    if (header.trigger_time_ns)
+    {
+        int64_t steady_now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                 std::chrono::steady_clock::now().time_since_epoch())
+                                 .count();
+        int64_t real_now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               std::chrono::system_clock::now().time_since_epoch())
+                               .count();
+        header.start_time_ns = real_now - (steady_now - static_cast<int64_t>(header.trigger_time_ns));
+    }
+
+    return header;
+}
+
+void write_data_bin(Channel &channel, const std::string &filename)
+{
+    try
+    {
+        int fd = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+        {
+            std::cerr << "Error opening binary output file.\n";
+            return;
+        }
+
+        // Windows are packed into one block and written out once it is full, each write(2)
+        // is BIN_BLOCK_SIZE long and lands on a BIN_BLOCK_SIZE aligned file offset
+        uint8_t *block = static_cast<uint8_t *>(std::aligned_alloc(RAW_RECORD_HEADER_SIZE, BIN_BLOCK_SIZE));
+        if (!block)
+        {
+            std::cerr << "Error allocating binary output block.\n";
+            close(fd);
+            return;
+        }
+
+        std::memset(block, 0, RAW_RECORD_HEADER_SIZE);
+        size_t used = RAW_RECORD_HEADER_SIZE;
+        uint64_t window_count = 0;
+        bool write_failed = false;
+
+        // Windows that do not follow the one before, after an overrun or dropped by the queue policy
+        raw_record_gap_t gaps[RAW_RECORD_MAX_GAPS];
+        uint64_t gap_count = 0;
+        uint64_t next_index = 0;
+
+        const data_part_t *part;
+        while ((part = channel.windows.wait_next(CONSUMER_FILE, [&]
+                                                 { return stop_program.load() && channel.acquisition_done.load(); })))
+        {
+            if (window_count == 0)
+            {
+                // The trigger time is known once the first window is out
+                raw_record_header_t header = make_header(channel, 0, 0);
+                std::memcpy(block, &header, sizeof(header));
+            }
+            else if (part->discontinuity || part->raw_index != next_index)
+            {
+                if (gap_count < RAW_RECORD_MAX_GAPS)
+                    gaps[gap_count] = {window_count, part->raw_index > next_index ? part->raw_index - next_index : 0};
+                ++gap_count;
+            }
+            next_index = part->raw_index + MODEL_INPUT_DIM_0;
+
+            input_t window;
+            std::memcpy(window, part->data, sizeof(input_t));
+            channel.windows.release(CONSUMER_FILE);
+
+            const uint8_t *src = reinterpret_cast<const uint8_t *>(window);
+            size_t remaining = sizeof(input_t);
+            while (remaining > 0)
+            {
+                size_t chunk = std::min(remaining, BIN_BLOCK_SIZE - used);
+                std::memcpy(block + used, src, chunk);
+                used += chunk;
+                src += chunk;
+                remaining -= chunk;
+
+                if (used == BIN_BLOCK_SIZE)
+                {
+                    if (!write_failed && !write_all(fd, block, used))
+                    {
+                        std::cerr << "Error writing binary output file: " << strerror(errno) << std::endl;
+                        write_failed = true;
+                    }
+                    used = 0;
+                }
+            }
+
+            ++window_count;
+            channel.counters->write_count_csv.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        if (!write_failed && used > 0 && !write_all(fd, block, used))
+        {
+            std::cerr << "Error writing binary output file: " << strerror(errno) << std::endl;
+            write_failed = true;
+        }
+
+        // Final header with the window count and the gaps, a file without them is still readable from its size
+        raw_record_header_t header = make_header(channel, write_failed ? 0 : window_count, gap_count);
+        const size_t gap_bytes = std::min<uint64_t>(gap_count, RAW_RECORD_MAX_GAPS) * sizeof(raw_record_gap_t);
+        if (pwrite(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)) ||
+            pwrite(fd, gaps, gap_bytes, RAW_RECORD_GAP_OFFSET) != static_cast<ssize_t>(gap_bytes))
+        {
+            std::cerr << "Error writing binary output header.\n";
+        }
+        if (gap_count)
+            std::cout << "Binary recording on channel " << static_cast<int>(channel.channel_id) + 1 << ": " << gap_count
+                      << " gap(s) before recorded windows" << (gap_count > RAW_RECORD_MAX_GAPS ? ", the header lists the first " + std::to_string(RAW_RECORD_MAX_GAPS) : "")
+                      << std::endl;
+
+        std::free(block);
+        close(fd);
+        std::cout << "Data writing on binary thread on channel " << static_cast<int>(channel.channel_id) + 1 << " exiting..." << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Exception in write_data_bin for channel " << static_cast<int>(channel.channel_id) + 1 << ": " << e.what() << std::endl;
+    }
+}
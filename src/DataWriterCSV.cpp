@@ -1,74 +1,53 @@
 /* DataWriterCSV.cpp */
 
 #include "DataWriterCSV.hpp"
+#include "CsvWriter.hpp"
 #include <iostream>
-#include <type_traits>
-
-template <typename T>
-void write_scalar(FILE *file, const T &val)
-{
-    if constexpr (std::is_same_v<T, float>)
-    {
-        fprintf(file, "%.6f", val);
-    }
-    else if constexpr (std::is_same_v<T, int8_t> || std::is_same_v<T, int16_t> || std::is_integral_v<T>)
-    {
-        fprintf(file, "%d", static_cast<int>(val));
-    }
-    else
-    {
-        fprintf(stderr, "Unsupported input type for writing!\n");
-        fprintf(file, "ERR");
-    }
-}
 
 void write_data_csv(Channel &channel, const std::string &filename)
 {
     try
     {
-        FILE *buffer_output_file = fopen(filename.c_str(), "w");
-        if (!buffer_output_file)
+        csv_writer_t writer(CSV_BUFFER_SIZE, {CSV_FLUSH_BYTES, CSV_FLUSH_INTERVAL_MS});
+        if (!writer.open(filename))
         {
             std::cerr << "Error opening buffer output file.\n";
             return;
         }
 
-        while (true)
+        constexpr size_t line_size = MODEL_INPUT_DIM_0 * csv_writer_t::MAX_VALUE_CHARS + 1;
+        writer.reserve(line_size);
+
+        // Each wakeup drains every pending window into the buffer, the flush policy then decides
+        // whether the batch goes to disk, and is checked again before the writer parks.
+        // Windows are formatted straight out of their slot, write(2) only ever runs once it is released.
+        const data_part_t *part;
+        uint64_t next_index = UINT64_MAX;
+        while ((part = channel.windows.wait_next(CONSUMER_FILE, [&]
+                                                 { return stop_program.load() && channel.acquisition_done.load(); },
+                                                 nullptr, [&]
+                                                 { return writer.idle(); })))
         {
-            std::shared_ptr<data_part_t> part;
-            {
-                std::unique_lock<std::mutex> lock(channel.mtx);
-                channel.cond_write_csv.wait(lock, [&]
-                                            { return !channel.data_queue_csv.empty() || channel.acquisition_done || stop_program.load(); });
-
-                if (stop_program.load() && channel.acquisition_done && channel.data_queue_csv.empty())
-                    break;
-
-                if (!channel.data_queue_csv.empty())
-                {
-                    part = channel.data_queue_csv.front();
-                    channel.data_queue_csv.pop();
-                }
-                else
-                {
-                    continue;
-                }
-            }
-
+            // A blank line marks the window after an overrun or after windows the queue policy dropped,
+            // CSV readers skip it
+            if (part->discontinuity || (next_index != UINT64_MAX && part->raw_index != next_index))
+                writer.put('\n');
+            next_index = part->raw_index + MODEL_INPUT_DIM_0;
             for (size_t k = 0; k < MODEL_INPUT_DIM_0; k++)
             {
-                write_scalar(buffer_output_file, part->data[k][0]);
-                if (k < MODEL_INPUT_DIM_0 - 1)
-                    fprintf(buffer_output_file, ",");
+                writer.value(part->data[k][0]);
+                writer.put(k < MODEL_INPUT_DIM_0 - 1 ? ',' : '\n');
             }
 
-            fprintf(buffer_output_file, "\n");
-            fflush(buffer_output_file);
-
+            channel.windows.release(CONSUMER_FILE);
             channel.counters->write_count_csv.fetch_add(1, std::memory_order_relaxed);
+
+            writer.reserve(line_size);
+            if (channel.windows.lag(CONSUMER_FILE) == 0)
+                writer.end_batch();
         }
 
-        fclose(buffer_output_file);
+        writer.close();
         std::cout << "Data writing on CSV thread on channel " << static_cast<int>(channel.channel_id) + 1 << " exiting..." << std::endl;
     }
     catch (const std::exception &e)
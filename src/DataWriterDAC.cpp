@@ -2,44 +2,105 @@
 
 #include "DataWriterDAC.hpp"
 #include <iostream>
+#include <cstring>
 
-void write_data_dac(Channel &channel, rp_channel_t rp_channel)
+#if DAC_ARB_PLAYBACK
+// Playback paced by the generator. Its buffer holds two windows and loops, so each half plays one
+// window period in turn. A window is converted as soon as it arrives and written to the half that
+// is not playing, once the half written before it started playing. Only that half is written, the
+// playing one is never touched. Where the generator is comes from its read pointer, and a half
+// starting within DAC_PLAYBACK_GUARD of the write already counts as playing. A window arriving
+// after the generator moved on to a half it was not written for leaves that half replaying stale
+// data, which is counted.
+static void play_data_dac(Channel &channel, rp_channel_t rp_channel)
 {
-    try
+    constexpr uint32_t half_samples = MODEL_INPUT_DIM_0;
+    constexpr uint32_t guard = half_samples / DAC_PLAYBACK_GUARD;
+
+    float waveform[DAC_PLAYBACK_SAMPLES] = {};
+    if (!initialize_DAC_playback(rp_channel, waveform))
+        return;
+    std::unique_ptr<dac_arb_port_t> port = open_dac_arb_port(rp_channel);
+    if (!port)
+        return;
+    rp_GenTriggerOnly(rp_channel);
+
+    // Half holding the latest window, and whether the generator got to it yet
+    int32_t latest = -1;
+    bool latest_started = true;
+    uint64_t stale_halves = 0;
+
+    const data_part_t *part;
+    while ((part = channel.windows.wait_next(CONSUMER_DAC, [&]
+                                             { return stop_program.load() && channel.acquisition_done.load(); })))
     {
+        float voltages[MODEL_INPUT_DIM_0];
+        if (!raw_view_to_voltage(channel, *part, voltages))
+            window_to_voltage(part->data, voltages);
+        channel.windows.release(CONSUMER_DAC);
+
+        int32_t target;
         while (true)
         {
-            std::shared_ptr<data_part_t> part;
+            const uint32_t pointer = port->read_pointer();
+            const int32_t playing = static_cast<int32_t>(pointer / half_samples);
+            const uint32_t left = half_samples - pointer % half_samples;
+
+            if (!latest_started && playing != latest)
             {
-                std::unique_lock<std::mutex> lock(channel.mtx);
-                channel.cond_write_dac.wait(lock, [&]
-                                            { return !channel.data_queue_dac.empty() || channel.acquisition_done || stop_program.load(); });
-
-                if (stop_program.load() && channel.acquisition_done && channel.data_queue_dac.empty())
-                    break;
-
-                if (!channel.data_queue_dac.empty())
-                {
-                    part = channel.data_queue_dac.front();
-                    channel.data_queue_dac.pop();
-                }
-                else
-                {
-                    continue;
-                }
+                port->wait(left);
+                continue;
             }
-
-            for (size_t k = 0; k < MODEL_INPUT_DIM_0; k++)
+            latest_started = true;
+            if (left <= guard)
             {
-                float voltage = OutputToVoltage(part->data[k][0]);
+                port->wait(left);
+                continue;
+            }
+            if (latest >= 0 && playing != latest)
+                ++stale_halves;
+            target = 1 - playing;
+            break;
+        }
+
+        port->write(target * half_samples, voltages, half_samples);
+        latest = target;
+        latest_started = false;
 
-                voltage = std::clamp(voltage, -1.0f, 1.0f);
+        channel.counters->write_count_dac.fetch_add(1, std::memory_order_relaxed);
+    }
 
-                rp_GenAmp(rp_channel, voltage);
+    if (stale_halves)
+    {
+        std::cerr << "DAC playback on channel " << rp_channel + 1 << ": stale data replayed " << stale_halves << " times" << std::endl;
+    }
+}
+#endif
+
+void write_data_dac(Channel &channel, rp_channel_t rp_channel)
+{
+    try
+    {
+#if DAC_ARB_PLAYBACK
+        play_data_dac(channel, rp_channel);
+#else
+        const data_part_t *part;
+        while ((part = channel.windows.wait_next(CONSUMER_DAC, [&]
+                                                 { return stop_program.load() && channel.acquisition_done.load(); })))
+        {
+            float voltages[MODEL_INPUT_DIM_0];
+            if (!raw_view_to_voltage(channel, *part, voltages))
+                window_to_voltage(part->data, voltages);
+            channel.windows.release(CONSUMER_DAC);
+
+            for (size_t k = 0; k < MODEL_INPUT_DIM_0; k++)
+            {
+                rp_GenAmp(rp_channel, voltages[k]);
             }
 
             channel.counters->write_count_dac.fetch_add(1, std::memory_order_relaxed);
         }
+#endif
         std::cout << "Data writing on DAC thread on channel " << static_cast<int>(channel.channel_id) + 1 << " exiting..." << std::endl;
     }
     catch (const std::exception &e)
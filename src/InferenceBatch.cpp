@@ -0,0 +1,272 @@
+/*InferenceBatch.cpp*/
+
+#include "InferenceBatch.hpp"
+#include "ModelProcessing.hpp"
+#include "arm_nnsupportfunctions.h"
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+static_assert(INFERENCE_BATCH >= 1 && INFERENCE_BATCH <= ARM_NN_BATCH_MAX, "INFERENCE_BATCH must be between 1 and ARM_NN_BATCH_MAX");
+static_assert(INFERENCE_BATCH == 1 || (INFERENCE_WORKERS == 1 && INFERENCE_TEAM == 1),
+              "INFERENCE_BATCH runs its lanes for the single model thread, it needs INFERENCE_WORKERS=1 and INFERENCE_TEAM=1");
+
+#if INFERENCE_BATCH > 1
+
+// Lane copies of the model, cnn_wN is linked from model_wN.o with every other symbol localized
+extern "C"
+{
+    decltype(cnn) cnn_w1;
+    decltype(cnn) cnn_w2;
+    decltype(cnn) cnn_w3;
+    decltype(cnn) cnn_w4;
+    decltype(cnn) cnn_w5;
+    decltype(cnn) cnn_w6;
+    decltype(cnn) cnn_w7;
+}
+
+static decltype(&cnn) const lane_models[INFERENCE_BATCH] = {
+    cnn,
+    cnn_w1,
+#if INFERENCE_BATCH > 2
+    cnn_w2,
+#endif
+#if INFERENCE_BATCH > 3
+    cnn_w3,
+#endif
+#if INFERENCE_BATCH > 4
+    cnn_w4,
+#endif
+#if INFERENCE_BATCH > 5
+    cnn_w5,
+#endif
+#if INFERENCE_BATCH > 6
+    cnn_w6,
+#endif
+#if INFERENCE_BATCH > 7
+    cnn_w7,
+#endif
+};
+
+struct batch_lane_t
+{
+    input_t input;
+    output_t output;
+    uint64_t sequence;
+    bool discontinuity;
+};
+
+// Batch state shared by the model thread (lane 0) and the lane threads. The model thread starts a
+// batch by bumping `start`, which packs a generation with the window count so a lane that wakes
+// late never pairs a new count with an old batch. Lanes past the count sit the batch out.
+// `finished` counts the lane threads done with the batch. At each layer call the lanes leave their
+// arguments in `ctx` and park on `layer`, the last one in runs the call for all of them and bumps it.
+struct inference_batch_t
+{
+    batch_lane_t lanes[INFERENCE_BATCH];
+    uint32_t count = 0;
+    bool stop = false;
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> start{0};
+    std::atomic<uint32_t> finished{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> layer{0};
+    std::atomic<uint32_t> arrived{0};
+    void *ctx[INFERENCE_BATCH] = {};
+    std::vector<std::thread> threads;
+};
+
+static constexpr uint32_t BATCH_COUNT_BITS = 8;
+
+static inference_batch_t batch;
+static thread_local int32_t batch_lane = -1;
+
+static int32_t batch_join(arm_nn_batch_task task, void *ctx)
+{
+    if (batch_lane < 0 || batch.count < 2)
+        return 0;
+
+    const uint32_t layer = batch.layer.load(std::memory_order_acquire);
+    batch.ctx[batch_lane] = ctx;
+    if (batch.arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == batch.count)
+    {
+        // Every other lane is parked on this layer with its arguments in ctx
+        batch.arrived.store(0, std::memory_order_relaxed);
+        task(batch.ctx, static_cast<int32_t>(batch.count));
+        batch.layer.store(layer + 1, std::memory_order_seq_cst);
+        futex_wake(batch.layer);
+        return 1;
+    }
+
+    // All lanes share one core, parking right away lets the next one reach the layer
+    while (batch.layer.load(std::memory_order_acquire) == layer)
+        futex_wait(batch.layer, layer);
+    return 1;
+}
+
+static const arm_nn_batch_t batch_hooks = {batch_join};
+
+static void batch_lane_thread(int32_t lane, uint32_t seen)
+{
+    batch_lane = lane;
+    while (true)
+    {
+        uint32_t current;
+        while ((current = batch.start.load(std::memory_order_acquire)) == seen)
+            futex_wait(batch.start, seen);
+        seen = current;
+
+        if (batch.stop)
+            return;
+        const uint32_t count = current & ((1u << BATCH_COUNT_BITS) - 1);
+        if (static_cast<uint32_t>(lane) >= count)
+            continue;
+
+        batch_lane_t &slot = batch.lanes[lane];
+        lane_models[lane](slot.input, slot.output);
+        if (batch.finished.fetch_add(1, std::memory_order_acq_rel) + 2 == count)
+            futex_wake(batch.finished);
+    }
+}
+
+static void stop_lanes()
+{
+    batch.stop = true;
+    batch.start.fetch_add(1u << BATCH_COUNT_BITS);
+    futex_wake(batch.start);
+    for (std::thread &thread : batch.threads)
+        thread.join();
+    batch.threads.clear();
+    batch.stop = false;
+}
+
+// Runs the model on the first `count` lanes, lane 0 on the calling thread
+static void run_batch(uint32_t count)
+{
+    batch.count = count;
+    if (count > 1)
+    {
+        batch.finished.store(0, std::memory_order_relaxed);
+        const uint32_t generation = (batch.start.load(std::memory_order_relaxed) >> BATCH_COUNT_BITS) + 1;
+        batch.start.store(generation << BATCH_COUNT_BITS | count, std::memory_order_seq_cst);
+        futex_wake(batch.start);
+    }
+
+    lane_models[0](batch.lanes[0].input, batch.lanes[0].output);
+
+    uint32_t finished;
+    while ((finished = batch.finished.load(std::memory_order_acquire)) + 1 < count)
+        futex_wait(batch.finished, finished);
+}
+
+// Copies the next windows into the lanes, each slot is released right away so the writers are never
+// held back by a batch waiting to fill. Returns 0 once the channel is done.
+static uint32_t collect_batch(Channel &channel, bool &timed_out, std::chrono::steady_clock::time_point &opened)
+{
+    auto stop = [&]
+    { return stop_program.load() && channel.acquisition_done.load(); };
+
+    uint32_t count = 0;
+    auto take = [&](const data_part_t *part, uint64_t sequence)
+    {
+        batch_lane_t &lane = batch.lanes[count++];
+        std::memcpy(lane.input, part->data, sizeof(input_t));
+        lane.sequence = sequence;
+        lane.discontinuity = part->discontinuity;
+        channel.windows.release(CONSUMER_MODEL);
+    };
+
+    uint64_t sequence;
+    const data_part_t *part = channel.windows.wait_next(CONSUMER_MODEL, stop, &sequence);
+    if (!part)
+        return 0;
+    opened = std::chrono::steady_clock::now();
+    take(part, sequence);
+
+    // Windows already in the ring always join, past the deadline the wait stops at an empty ring
+    const auto deadline = opened + std::chrono::microseconds(INFERENCE_BATCH_WAIT_US);
+    auto closed = [&]
+    { return stop() || std::chrono::steady_clock::now() >= deadline; };
+    auto until_deadline = [&]
+    {
+        const auto left = std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+        return static_cast<uint32_t>(std::max<int64_t>(left, 1));
+    };
+    while (count < INFERENCE_BATCH && (part = channel.windows.wait_next(CONSUMER_MODEL, closed, &sequence, until_deadline)))
+        take(part, sequence);
+
+    timed_out = count < INFERENCE_BATCH && !stop();
+    return count;
+}
+
+static uint64_t elapsed_us(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(to - from).count();
+}
+
+void run_inference_batched(Channel &channel, void (*prepare)(input_t &input))
+{
+    const uint32_t seen = batch.start.load();
+    try
+    {
+        for (int32_t lane = 1; lane < INFERENCE_BATCH; ++lane)
+        {
+            batch.threads.emplace_back(batch_lane_thread, lane, seen);
+            set_thread_priority(batch.threads.back(), model_priority);
+        }
+    }
+    catch (const std::exception &)
+    {
+        stop_lanes();
+        throw;
+    }
+    batch_lane = 0;
+    arm_nn_batch = &batch_hooks;
+
+    std::cout << "Model inference on channel " << static_cast<int>(channel.channel_id) + 1 << " in batches of up to " << INFERENCE_BATCH
+              << " windows (" << INFERENCE_BATCH_WAIT_US << " us max wait)" << std::endl;
+
+    shared_counters_t &counters = *channel.counters;
+    std::chrono::steady_clock::time_point opened;
+    uint32_t count;
+    bool timed_out;
+    while ((count = collect_batch(channel, timed_out, opened)) > 0)
+    {
+        if (prepare)
+        {
+            for (uint32_t i = 0; i < count; ++i)
+                prepare(batch.lanes[i].input);
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        run_batch(count);
+        const auto end = std::chrono::steady_clock::now();
+
+        // Each window is charged its share of the batch
+        const double per_window = std::chrono::duration<double, std::milli>(end - start).count() / count;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            model_result_t result;
+            std::memcpy(result.output, batch.lanes[i].output, sizeof(output_t));
+            result.computation_time = per_window;
+            result.sequence = batch.lanes[i].sequence;
+            result.discontinuity = batch.lanes[i].discontinuity;
+            deliver_result(channel, result);
+        }
+
+        const uint64_t latency = elapsed_us(opened, std::chrono::steady_clock::now());
+        counters.batch_count.fetch_add(1, std::memory_order_relaxed);
+        if (timed_out)
+            counters.batch_timeouts.fetch_add(1, std::memory_order_relaxed);
+        counters.batch_wait_us.fetch_add(elapsed_us(opened, start), std::memory_order_relaxed);
+        counters.batch_run_us.fetch_add(elapsed_us(start, end), std::memory_order_relaxed);
+        if (latency > counters.batch_latency_max_us.load(std::memory_order_relaxed))
+            counters.batch_latency_max_us.store(latency, std::memory_order_relaxed);
+    }
+
+    arm_nn_batch = nullptr;
+    batch_lane = -1;
+    stop_lanes();
+    finish_processing(channel);
+}
+
+#endif
@@ -0,0 +1,140 @@
+/*InferencePool.cpp*/
+
+#include "InferencePool.hpp"
+#include "ModelProcessing.hpp"
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+#include <memory>
+
+static_assert(INFERENCE_WORKERS >= 1 && INFERENCE_WORKERS <= 4, "INFERENCE_WORKERS must be between 1 and 4");
+
+// Worker copies of the model, cnn_wN is linked from model_wN.o with every other symbol localized
+extern "C"
+{
+    decltype(cnn) cnn_w1;
+    decltype(cnn) cnn_w2;
+    decltype(cnn) cnn_w3;
+}
+
+static decltype(&cnn) const worker_models[INFERENCE_WORKERS] = {
+    cnn,
+#if INFERENCE_WORKERS > 1
+    cnn_w1,
+#endif
+#if INFERENCE_WORKERS > 2
+    cnn_w2,
+#endif
+#if INFERENCE_WORKERS > 3
+    cnn_w3,
+#endif
+};
+
+struct inference_worker_t
+{
+    spsc_ring_t<inference_job_t, INFERENCE_JOB_RING> jobs;
+    // A worker runs at most one job ring ahead of the reorder stage, so pushing a result never blocks
+    spsc_ring_t<model_result_t, 2 * INFERENCE_JOB_RING> results;
+    std::atomic<bool> dispatch_done{false};
+    std::atomic<bool> done{false};
+};
+
+static void inference_worker(inference_worker_t &worker, decltype(&cnn) model, void (*prepare)(input_t &input))
+{
+    inference_job_t job;
+    while (worker.jobs.pop_wait(job, [&]
+                                { return worker.dispatch_done.load(); }))
+    {
+        if (prepare)
+            prepare(job.input);
+
+        model_result_t result;
+        result.sequence = job.sequence;
+        result.discontinuity = job.discontinuity;
+        auto start = std::chrono::high_resolution_clock::now();
+        model(job.input, result.output);
+        auto end = std::chrono::high_resolution_clock::now();
+        result.computation_time = std::chrono::duration<double, std::milli>(end - start).count();
+
+        // Never dropped, the reorder stage has to see every dispatched job
+        worker.results.push(result, [] { return false; });
+    }
+
+    worker.done.store(true);
+    worker.results.wake();
+}
+
+// Jobs go out round robin, so collecting the results in the same order puts them back in
+// acquisition order whatever the workers' individual timing
+static void reorder_results(Channel &channel, inference_worker_t *workers)
+{
+    uint64_t next = 0;
+    model_result_t result;
+    while (true)
+    {
+        inference_worker_t &worker = workers[next % INFERENCE_WORKERS];
+        if (!worker.results.pop_wait(result, [&]
+                                     { return worker.done.load(); }))
+            break;
+
+        deliver_result(channel, result);
+        ++next;
+    }
+}
+
+void run_inference_pool(Channel &channel, void (*prepare)(input_t &input))
+{
+    auto workers = std::make_unique<inference_worker_t[]>(INFERENCE_WORKERS);
+    std::thread threads[INFERENCE_WORKERS];
+
+    // The first worker stays on the core of the channel process, the others take the spare cores of
+    // the channel. A worker on the core of the other channel process would compete with its FIFO
+    // threads, so past the spare cores the workers share the home core.
+    const int home_core = static_cast<int>(channel.channel_id);
+    const std::vector<int> cores = spare_cores(home_core, CHANNEL_PROCESSES);
+    if (static_cast<int>(cores.size()) < INFERENCE_WORKERS - 1)
+        std::cerr << "Only " << cores.size() << " spare cores for the " << INFERENCE_WORKERS - 1 << " extra inference workers of channel "
+                  << home_core + 1 << ", the others share Core " << home_core << std::endl;
+    for (int i = 0; i < INFERENCE_WORKERS; ++i)
+    {
+        threads[i] = std::thread(inference_worker, std::ref(workers[i]), worker_models[i], prepare);
+        const int core = i > 0 && i - 1 < static_cast<int>(cores.size()) ? cores[i - 1] : home_core;
+        if (!set_thread_affinity(threads[i], core))
+            std::cerr << "Failed to set inference worker affinity to Core " << core << std::endl;
+        set_thread_priority(threads[i], model_priority);
+    }
+    std::thread reorder_thread(reorder_results, std::ref(channel), workers.get());
+    set_thread_priority(reorder_thread, model_priority);
+
+    std::cout << "Model inference on channel " << static_cast<int>(channel.channel_id) + 1 << " with " << INFERENCE_WORKERS << " workers" << std::endl;
+
+    // Dispatch: copy each window out of the ring and queue it on the next worker in turn.
+    // A busy worker holds the dispatcher back, the window ring policy then applies upstream.
+    const data_part_t *part;
+    uint64_t sequence;
+    uint64_t dispatched = 0;
+    while ((part = channel.windows.wait_next(CONSUMER_MODEL, [&]
+                                             { return stop_program.load() && channel.acquisition_done.load(); }, &sequence)))
+    {
+        inference_job_t job;
+        std::memcpy(job.input, part->data, sizeof(input_t));
+        job.sequence = sequence;
+        job.discontinuity = part->discontinuity;
+        channel.windows.release(CONSUMER_MODEL);
+
+        if (!workers[dispatched % INFERENCE_WORKERS].jobs.push(job, [] { return stop_program.load(); }))
+            continue;
+        ++dispatched;
+    }
+
+    for (int i = 0; i < INFERENCE_WORKERS; ++i)
+    {
+        workers[i].dispatch_done.store(true);
+        workers[i].jobs.wake();
+    }
+    for (std::thread &thread : threads)
+        thread.join();
+    reorder_thread.join();
+
+    finish_processing(channel);
+}
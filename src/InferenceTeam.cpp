@@ -0,0 +1,186 @@
+/*InferenceTeam.cpp*/
+
+#include "InferenceTeam.hpp"
+#include "arm_nnsupportfunctions.h"
+#include <iostream>
+#include <algorithm>
+#include <vector>
+#include <pthread.h>
+
+static_assert(INFERENCE_TEAM >= 1 && INFERENCE_TEAM <= 4, "INFERENCE_TEAM must be between 1 and 4");
+static_assert(INFERENCE_TEAM == 1 || INFERENCE_WORKERS == 1,
+              "INFERENCE_TEAM splits the layers of the single window model thread, it needs INFERENCE_WORKERS=1");
+
+// Fork/join state shared with the helpers. The owner fills in the layer (task, ctx) and bumps
+// `generation`, which the helpers spin on and then park on. Parts are not bound to a thread: the
+// owner and the helpers take them from `claim` (generation, parts and next part packed in one word,
+// so a helper late for a layer cannot take a part of the next one), and the owner runs whatever no
+// helper picked up. `done` counts the finished parts, on its own line so the helpers finishing do
+// not disturb the ones still polling.
+struct inference_team_t
+{
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> generation{0};
+    std::atomic<uint32_t> parked{0};
+    std::atomic<uint64_t> claim{0};
+    arm_nn_team_task task = nullptr;
+    void *ctx = nullptr;
+    bool stop = false;
+    alignas(CACHE_LINE_SIZE) std::atomic<int32_t> done{0};
+    std::vector<std::thread> helpers;
+
+    ~inference_team_t();
+};
+
+static inference_team_t team;
+static thread_local bool team_owner = false;
+
+// Runs parts of the current layer until none is left to take
+static void team_work()
+{
+    uint64_t claim = team.claim.load(std::memory_order_acquire);
+    while (static_cast<uint16_t>(claim) < static_cast<uint16_t>(claim >> 16))
+    {
+        if (!team.claim.compare_exchange_weak(claim, claim + 1, std::memory_order_acq_rel))
+            continue;
+        const int32_t part = static_cast<uint16_t>(claim);
+        team.task(team.ctx, part, static_cast<uint16_t>(claim >> 16));
+        team.done.fetch_add(1, std::memory_order_release);
+        claim = team.claim.load(std::memory_order_acquire);
+    }
+}
+
+static void team_helper(uint32_t seen)
+{
+    const auto spin = std::chrono::microseconds(INFERENCE_TEAM_SPIN_US);
+    while (true)
+    {
+        auto park_at = std::chrono::steady_clock::now() + spin;
+        uint32_t polls = 0;
+        uint32_t current;
+        while ((current = team.generation.load(std::memory_order_acquire)) == seen)
+        {
+            cpu_relax();
+            if (++polls % 64 != 0 || std::chrono::steady_clock::now() < park_at)
+                continue;
+
+            // `parked` goes up before the futex checks the generation again and the owner bumps the
+            // generation before it reads `parked`, so either the wait fails or the owner wakes it
+            team.parked.fetch_add(1);
+            futex_wait(team.generation, seen);
+            team.parked.fetch_sub(1);
+            park_at = std::chrono::steady_clock::now() + spin;
+        }
+        seen = current;
+
+        if (team.stop)
+            return;
+        team_work();
+    }
+}
+
+static int32_t team_parts(int64_t work, int32_t max_parts)
+{
+    if (!team_owner || work < INFERENCE_TEAM_MIN_MACS)
+        return 1;
+    return std::clamp(max_parts, 1, static_cast<int32_t>(team.helpers.size()) + 1);
+}
+
+static void team_run(arm_nn_team_task task, void *ctx, int32_t parts)
+{
+    const uint32_t generation = team.generation.load(std::memory_order_relaxed) + 1;
+    team.task = task;
+    team.ctx = ctx;
+    team.done.store(0, std::memory_order_relaxed);
+    team.claim.store(static_cast<uint64_t>(generation) << 32 | static_cast<uint64_t>(parts) << 16,
+                     std::memory_order_release);
+    team.generation.store(generation, std::memory_order_seq_cst);
+    if (team.parked.load())
+        futex_wake(team.generation);
+
+    team_work();
+
+    // Only parts a helper already started are left, the wait is bounded by one part. Past the spin
+    // budget it sleeps, so a helper sharing this core with the owner still gets to finish.
+    uint32_t spins = 0;
+    while (team.done.load(std::memory_order_acquire) != parts)
+        block_backoff(spins);
+}
+
+static const arm_nn_team_t team_hooks = {team_parts, team_run};
+
+static void stop_helpers()
+{
+    if (team.helpers.empty())
+        return;
+
+    team.stop = true;
+    team.generation.fetch_add(1);
+    futex_wake(team.generation);
+    for (std::thread &helper : team.helpers)
+        helper.join();
+    team.helpers.clear();
+    team.stop = false;
+}
+
+inference_team_t::~inference_team_t()
+{
+    stop_helpers();
+}
+
+// Same priority as the model thread, on a core of its own
+static void place_helper(std::thread &helper, int core_id)
+{
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(core_id, &cpuset);
+    if (pthread_setaffinity_np(helper.native_handle(), sizeof(cpu_set_t), &cpuset) != 0)
+        std::cerr << "Failed to set inference team helper affinity to Core " << core_id << std::endl;
+
+    struct sched_param param;
+    param.sched_priority = model_priority;
+    if (pthread_setschedparam(helper.native_handle(), SCHED_FIFO, &param) != 0)
+        std::cerr << "Failed to set inference team helper priority to " << model_priority << std::endl;
+}
+
+bool start_inference_team(int helpers, int home_core, int channels)
+{
+    // A helper on a core of the channel processes would compete with the FIFO threads of the other channel
+    const std::vector<int> helper_cores = spare_cores(home_core, channels);
+
+    helpers = std::min<int>(helpers, helper_cores.size());
+    if (helpers < 1)
+    {
+        std::cerr << "Inference team needs a core besides the " << channels << " of the channel processes"
+                  << (channels > 1 ? " (build with CHANNELS=1 to run one channel)" : "") << ", layers stay on the model thread"
+                  << std::endl;
+        return false;
+    }
+
+    const uint32_t seen = team.generation.load();
+    try
+    {
+        for (int i = 0; i < helpers; ++i)
+        {
+            team.helpers.emplace_back(team_helper, seen);
+            place_helper(team.helpers.back(), helper_cores[i]);
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Failed to start inference team helper: " << e.what() << std::endl;
+        stop_helpers();
+        return false;
+    }
+
+    team_owner = true;
+    arm_nn_team = &team_hooks;
+    std::cout << "Inference team of " << helpers + 1 << " threads from Core " << home_core << std::endl;
+    return true;
+}
+
+void stop_inference_team()
+{
+    arm_nn_team = nullptr;
+    team_owner = false;
+    stop_helpers();
+}
@@ -1,104 +1,89 @@
 /* modelProcessing.cpp */
 
 #include "ModelProcessing.hpp"
+#include "InferencePool.hpp"
+#include "InferenceTeam.hpp"
+#include "InferenceBatch.hpp"
+#include "SampleNorm.hpp"
 #include <iostream>
 #include <chrono>
 #include <type_traits>
+#include <cstring>
 
 #define WITH_CMSIS_NN 1
 #define ARM_MATH_DSP 1
 #define ARM_NN_TRUNCATE
 
-template <typename T>
-void sample_norm(T (&data)[MODEL_INPUT_DIM_0][MODEL_INPUT_DIM_1])
+// Hands one result to the result writers, in acquisition order
+void deliver_result(Channel &channel, const model_result_t &result)
 {
-    using base_t = typename std::remove_cv<typename std::remove_reference<decltype(data[0][0])>::type>::type;
-
-    base_t min_val = data[0][0];
-    base_t max_val = data[0][0];
-
-    for (size_t i = 1; i < MODEL_INPUT_DIM_0; ++i)
+    if (save_output_csv)
     {
-        if (data[i][0] < min_val)
-            min_val = data[i][0];
-        if (data[i][0] > max_val)
-            max_val = data[i][0];
+        channel.result_buffer_csv.push(result, [] { return stop_program.load(); });
+        store_queue_stats(channel.counters->queue_log_csv, channel.result_buffer_csv.drop_count(), channel.result_buffer_csv.lag_max());
     }
+    if (save_output_dac)
+    {
+        channel.result_buffer_dac.push(result, [] { return stop_program.load(); });
+        store_queue_stats(channel.counters->queue_log_dac, channel.result_buffer_dac.drop_count(), channel.result_buffer_dac.lag_max());
+    }
+    channel.counters->model_count.fetch_add(1, std::memory_order_relaxed);
+}
 
-    base_t range = max_val - min_val;
-    if (range == 0)
-        range = 1;
-
-    for (size_t i = 0; i < MODEL_INPUT_DIM_0; ++i)
+void finish_processing(Channel &channel)
+{
+    channel.processing_done.store(true);
+    if (save_output_csv)
     {
-        if constexpr (std::is_floating_point<base_t>::value)
-        {
-            data[i][0] = static_cast<base_t>((data[i][0] - min_val) / static_cast<float>(range));
-        }
-        else
-        {
-            data[i][0] = static_cast<base_t>(((data[i][0] - min_val) * 512) / range);
-        }
+        channel.result_buffer_csv.wake();
     }
+    if (save_output_dac)
+    {
+        channel.result_buffer_dac.wake();
+    }
+}
+
+static void normalize_input(input_t &input)
+{
+    sample_norm(input);
 }
 
 void model_inference(Channel &channel)
 {
     try
     {
-        while (true)
+#if INFERENCE_WORKERS > 1
+        run_inference_pool(channel, nullptr);
+#elif INFERENCE_BATCH > 1
+        run_inference_batched(channel, nullptr);
+#else
+#if INFERENCE_TEAM > 1
+        start_inference_team(INFERENCE_TEAM - 1, static_cast<int>(channel.channel_id), CHANNEL_PROCESSES);
+#endif
+        const data_part_t *part;
+        uint64_t sequence;
+        while ((part = channel.windows.wait_next(CONSUMER_MODEL, [&]
+                                                 { return stop_program.load() && channel.acquisition_done.load(); }, &sequence)))
         {
-            std::shared_ptr<data_part_t> part;
-            {
-                std::unique_lock<std::mutex> lock(channel.mtx);
-                channel.cond_model.wait(lock, [&]
-                                        { return !channel.model_queue.empty() || channel.acquisition_done || stop_program.load(); });
-
-                if (stop_program.load() && channel.acquisition_done && channel.model_queue.empty())
-                    break;
-
-                if (channel.model_queue.empty())
-                    continue;
-
-                part = channel.model_queue.front();
-                channel.model_queue.pop();
-            }
-
             model_result_t result;
+            result.sequence = sequence;
+            result.discontinuity = part->discontinuity;
             auto start = std::chrono::high_resolution_clock::now();
             cnn(part->data, result.output);
             auto end = std::chrono::high_resolution_clock::now();
             result.computation_time = std::chrono::duration<double, std::milli>(end - start).count();
 
-            {
-                std::lock_guard<std::mutex> lock(channel.mtx);
-                if (save_output_csv)
-                {
-                    channel.result_buffer_csv.push_back(result);
-                    channel.cond_log_csv.notify_all();
-                }
-                if (save_output_dac)
-                {
-                    channel.result_buffer_dac.push_back(result);
-                    channel.cond_log_dac.notify_all();
-                }
-                channel.counters->model_count.fetch_add(1, std::memory_order_relaxed);
-            }
-        }
+            channel.windows.release(CONSUMER_MODEL);
 
-        {
-            std::lock_guard<std::mutex> lock(channel.mtx);
-            channel.processing_done = true;
-            if (save_output_csv)
-            {
-                channel.cond_log_csv.notify_all();
-            }
-            if (save_output_dac)
-            {
-                channel.cond_log_dac.notify_all();
-            }
+            deliver_result(channel, result);
         }
 
+#if INFERENCE_TEAM > 1
+        stop_inference_team();
+#endif
+        finish_processing(channel);
+#endif
+
         std::cout << "Model inference thread on channel " << static_cast<int>(channel.channel_id) + 1 << " exiting..." << std::endl;
     }
     catch (const std::exception &e)
@@ -111,60 +96,42 @@ void model_inference_mod(Channel &channel)
 {
     try
     {
-        while (true)
+#if INFERENCE_WORKERS > 1
+        run_inference_pool(channel, normalize_input);
+#elif INFERENCE_BATCH > 1
+        run_inference_batched(channel, normalize_input);
+#else
+#if INFERENCE_TEAM > 1
+        start_inference_team(INFERENCE_TEAM - 1, static_cast<int>(channel.channel_id), CHANNEL_PROCESSES);
+#endif
+        const data_part_t *part;
+        uint64_t sequence;
+        while ((part = channel.windows.wait_next(CONSUMER_MODEL, [&]
+                                                 { return stop_program.load() && channel.acquisition_done.load(); }, &sequence)))
         {
-            std::shared_ptr<data_part_t> part;
-            {
-                std::unique_lock<std::mutex> lock(channel.mtx);
-                channel.cond_model.wait(lock, [&]
-                                        { return !channel.model_queue.empty() || channel.acquisition_done || stop_program.load(); });
-
-                if (stop_program.load() && channel.acquisition_done && channel.model_queue.empty())
-                    break;
-
-                if (channel.model_queue.empty())
-                    continue;
-
-                part = channel.model_queue.front();
-                channel.model_queue.pop();
-            }
-
-            sample_norm(part->data);
+            // The window is shared with the writers, normalize a private copy
+            input_t input;
+            std::memcpy(input, part->data, sizeof(input_t));
+            const bool discontinuity = part->discontinuity;
+            channel.windows.release(CONSUMER_MODEL);
+            normalize_input(input);
 
             model_result_t result;
+            result.sequence = sequence;
+            result.discontinuity = discontinuity;
             auto start = std::chrono::high_resolution_clock::now();
-            cnn(part->data, result.output);
+            cnn(input, result.output);
             auto end = std::chrono::high_resolution_clock::now();
             result.computation_time = std::chrono::duration<double, std::milli>(end - start).count();
 
-            {
-                std::lock_guard<std::mutex> lock(channel.mtx);
-                if (save_output_csv)
-                {
-                    channel.result_buffer_csv.push_back(result);
-                    channel.cond_log_csv.notify_all();
-                }
-                if (save_output_dac)
-                {
-                    channel.result_buffer_dac.push_back(result);
-                    channel.cond_log_dac.notify_all();
-                }
-                channel.counters->model_count.fetch_add(1, std::memory_order_relaxed);
-            }
+            deliver_result(channel, result);
         }
 
-        {
-            std::lock_guard<std::mutex> lock(channel.mtx);
-            channel.processing_done = true;
-            if (save_output_csv)
-            {
-                channel.cond_log_csv.notify_all();
-            }
-            if (save_output_dac)
-            {
-                channel.cond_log_dac.notify_all();
-            }
-        }
+#if INFERENCE_TEAM > 1
+        stop_inference_team();
+#endif
+        finish_processing(channel);
+#endif
 
         std::cout << "Model inference mod thread on channel " << static_cast<int>(channel.channel_id) + 1 << " exiting..." << std::endl;
     }
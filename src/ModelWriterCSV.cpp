@@ -2,60 +2,57 @@
 
 #include "ModelWriterCSV.hpp"
 #include "DAC.hpp"
+#include "CsvWriter.hpp"
 #include <iostream>
 #include <type_traits>
 
-// Generic output writer for model result
-template<typename T>
-void write_output(FILE *file, int index, const T &value, double time_ms) {
-    if constexpr (std::is_integral<T>::value) {
-        fprintf(file, "%d,%d,%.6f\n", index, static_cast<int>(value), time_ms);
-    } else if constexpr (std::is_floating_point<T>::value) {
-        fprintf(file, "%d,%.6f,%.6f\n", index, value, time_ms);
-    } else {
-        fprintf(file, "%d,%d,%.6f\n", index, static_cast<int>(value), time_ms); // Fallback
-    }
+// Writes one "index,value,time_ms" result line
+template <typename T>
+void write_output(csv_writer_t &writer, int index, const T &value, double time_ms)
+{
+    writer.value(index);
+    writer.put(',');
+    if constexpr (std::is_floating_point<T>::value)
+        writer.value(value);
+    else
+        writer.value(static_cast<int>(value));
+    writer.put(',');
+    writer.value(time_ms);
+    writer.put('\n');
 }
 
 void log_results_csv(Channel &channel, const std::string &filename)
 {
     try
     {
-        FILE *output_file = fopen(filename.c_str(), "w");
-        if (!output_file)
+        csv_writer_t writer(CSV_BUFFER_SIZE, {CSV_FLUSH_BYTES, CSV_FLUSH_INTERVAL_MS});
+        if (!writer.open(filename))
         {
             std::cerr << "Error opening output file: " << filename << "\n";
             return;
         }
 
         int output_index = 1;
+        constexpr size_t line_size = 3 * csv_writer_t::MAX_VALUE_CHARS + 1;
+        writer.reserve(line_size);
 
-        while (true)
+        model_result_t result;
+        while (channel.result_buffer_csv.pop_wait(result, [&] {
+            return stop_program.load() && channel.processing_done.load();
+        }, [&] { return writer.idle(); }))
         {
-            model_result_t result;
-
-            {
-                std::unique_lock<std::mutex> lock(channel.mtx);
-                channel.cond_log_csv.wait(lock, [&] {
-                    return !channel.result_buffer_csv.empty() || channel.processing_done || stop_program.load();
-                });
-
-                if (stop_program.load() && channel.processing_done && channel.result_buffer_csv.empty())
-                    break;
-
-                if (channel.result_buffer_csv.empty())
-                    continue;
-
-                result = channel.result_buffer_csv.front();
-                channel.result_buffer_csv.pop_front();
-            }
-
-            write_output(output_file, output_index++, result.output[0], result.computation_time);
-            fflush(output_file);
+            // A blank line marks the results of the windows after an overrun, CSV readers skip it
+            if (result.discontinuity)
+                writer.put('\n');
+            write_output(writer, output_index++, result.output[0], result.computation_time);
             channel.counters->log_count_csv.fetch_add(1, std::memory_order_relaxed);
+
+            writer.reserve(line_size);
+            if (channel.result_buffer_csv.empty())
+                writer.end_batch();
         }
 
-        fclose(output_file);
+        writer.close();
         std::cout << "Logging inference results on csv thread on channel " << static_cast<int>(channel.channel_id) + 1 << " exiting..." << std::endl;
     }
     catch (const std::exception &e)
@@ -7,25 +7,10 @@ void log_results_dac(Channel &channel, rp_channel_t rp_channel)
 {
     try
     {
-        while (true)
+        model_result_t result;
+        while (channel.result_buffer_dac.pop_wait(result, [&]
+                                                  { return stop_program.load(); }))
         {
-            model_result_t result;
-
-            {
-                std::unique_lock<std::mutex> lock(channel.mtx);
-                channel.cond_log_dac.wait(lock, [&]
-                                          { return !channel.result_buffer_dac.empty() || channel.processing_done || stop_program.load(); });
-
-                if (stop_program.load() && channel.result_buffer_dac.empty())
-                    break;
-
-                if (channel.result_buffer_dac.empty())
-                    continue;
-
-                result = channel.result_buffer_dac.front();
-                channel.result_buffer_dac.pop_front();
-            }
-
             float voltage = OutputToVoltage(result.output[0]);
 
             voltage = std::clamp(voltage, -1.0f, 1.0f);
@@ -6,6 +6,7 @@
 #include <csignal>
 #include <thread>
 #include <iomanip>
+#include <sstream>
 #include <filesystem>
 
 bool is_disk_space_below_threshold(const char *path, double threshold)
@@ -57,6 +58,13 @@ bool set_thread_affinity(std::thread &th, int core_id)
     return true;
 }
 
+void wake_channel(Channel &channel)
+{
+    channel.windows.wake();
+    channel.result_buffer_csv.wake();
+    channel.result_buffer_dac.wake();
+}
+
 void signal_handler(int sig)
 {
     if (sig == SIGINT)
@@ -70,14 +78,8 @@ void signal_handler(int sig)
         if (pid2 > 0)
             kill(pid2, SIGINT);
 
-        channel1.cond_write_csv.notify_all();
-        channel1.cond_model.notify_all();
-        channel1.cond_log_csv.notify_all();
-        channel1.cond_log_dac.notify_all();
-        channel2.cond_write_csv.notify_all();
-        channel2.cond_model.notify_all();
-        channel2.cond_log_csv.notify_all();
-        channel2.cond_log_dac.notify_all();
+        wake_channel(channel1);
+        wake_channel(channel2);
     }
 }
 
@@ -94,23 +96,85 @@ void print_duration(const std::string &label, uint64_t start_ns, uint64_t end_ns
               << minutes << " min " << seconds << " sec " << ms << " ms\n";
 }
 
+static void print_queue_stats(const std::string &label, const queue_stats_t &stats)
+{
+    std::cout << std::left << std::setw(60) << label << stats.drops.load() << " dropped, high-watermark "
+              << stats.high_watermark.load() << "/" << QUEUE_MAX_SIZE << '\n';
+}
+
+static void print_channel_queues(const shared_counters_t &counters, int channel)
+{
+    const std::string ch = "CH" + std::to_string(channel);
+
+    if (save_data_csv)
+        print_queue_stats("Queue " + ch + " data -> file:", counters.queue_csv);
+    if (save_data_dac)
+        print_queue_stats("Queue " + ch + " data -> DAC:", counters.queue_dac);
+    print_queue_stats("Queue " + ch + " data -> model:", counters.queue_model);
+    if (save_output_csv)
+        print_queue_stats("Queue " + ch + " results -> csv:", counters.queue_log_csv);
+    if (save_output_dac)
+        print_queue_stats("Queue " + ch + " results -> DAC:", counters.queue_log_dac);
+}
+
+// Throughput against latency of the batched inference (see InferenceBatch.hpp)
+static void print_batch_stats(const shared_counters_t &counters, int channel)
+{
+    const int batches = counters.batch_count.load();
+    if (batches == 0)
+        return;
+
+    const std::string ch = "CH" + std::to_string(channel);
+    const double windows = counters.model_count.load();
+    const double run_ms = counters.batch_run_us.load() / 1000.0;
+    std::cout << std::left << std::setw(60) << "Batches " + ch + ":" << batches << ", " << std::fixed << std::setprecision(2)
+              << windows / batches << "/" << INFERENCE_BATCH << " windows on average, " << counters.batch_timeouts.load()
+              << " closed after " << INFERENCE_BATCH_WAIT_US << " us\n";
+    std::cout << std::left << std::setw(60) << "Batch time " + ch + " (wait + model, per batch):"
+              << counters.batch_wait_us.load() / 1000.0 / batches << " + " << run_ms / batches << " ms, "
+              << (run_ms > 0 ? windows * 1000.0 / run_ms : 0.0) << " windows/s in the model, worst latency "
+              << counters.batch_latency_max_us.load() / 1000.0 << " ms\n";
+    std::cout.unsetf(std::ios::fixed);
+    std::cout << std::setprecision(6);
+}
+
 void print_channel_stats(const shared_counters_t *counters)
 {
     std::cout << "\n====================================\n\n";
 
     print_duration("Channel 1", counters[0].trigger_time_ns.load(), counters[0].end_time_ns.load());
+#if CHANNEL_PROCESSES > 1
     print_duration("Channel 2", counters[1].trigger_time_ns.load(), counters[1].end_time_ns.load());
+#endif
 
     std::cout << std::left << std::setw(60) << "Total data acquired CH1:" << counters[0].acquire_count.load() << '\n';
     if (save_data_csv)
     {
-        std::cout << std::left << std::setw(60) << "Total lines written CH1 to csv:" << counters[0].write_count_csv.load() << '\n';
+        std::cout << std::left << std::setw(60) << (save_data_bin ? "Total windows recorded CH1 to binary file:" : "Total lines written CH1 to csv:") << counters[0].write_count_csv.load() << '\n';
     }
     if (save_data_dac)
     {
         std::cout << std::left << std::setw(60) << "Total lines written CH1 to DAC_CH1:" << counters[0].write_count_dac.load() << '\n';
     }
     std::cout << std::left << std::setw(60) << "Total model calculated CH1:" << counters[0].model_count.load() << '\n';
+    print_batch_stats(counters[0], 1);
+    if (counters[0].ring_full_count.load() > 0)
+    {
+        std::cout << std::left << std::setw(60) << "Windows finding the window ring full CH1:" << counters[0].ring_full_count.load() << '\n';
+    }
+    if (counters[0].pool_exhausted_count.load() > 0)
+    {
+        std::cout << std::left << std::setw(60) << "Windows dropped CH1 (window pool exhausted):" << counters[0].pool_exhausted_count.load() << '\n';
+    }
+    if (counters[0].overrun_count.load() > 0)
+    {
+        std::cout << std::left << std::setw(60) << "Overruns CH1 (resynchronized):" << counters[0].overrun_count.load() << ", "
+                  << counters[0].samples_lost.load() << " samples lost\n";
+    }
+    if (counters[0].torn_count.load() > 0)
+    {
+        std::cout << std::left << std::setw(60) << "Torn zero-copy windows CH1 (flagged):" << counters[0].torn_count.load() << '\n';
+    }
     if (save_output_csv)
     {
         std::cout << std::left << std::setw(60) << "Total results logged CH1 to csv file:" << counters[0].log_count_csv.load() << '\n';
@@ -119,17 +183,37 @@ void print_channel_stats(const shared_counters_t *counters)
     {
         std::cout << std::left << std::setw(60) << "Total results written to DAC_CH1:" << counters[0].log_count_dac.load() << '\n';
     }
+    print_channel_queues(counters[0], 1);
 
+#if CHANNEL_PROCESSES > 1
     std::cout << std::left << std::setw(60) << "Total data acquired CH2:" << counters[1].acquire_count.load() << '\n';
     if (save_data_csv)
     {
-        std::cout << std::left << std::setw(60) << "Total lines written CH2 to csv:" << counters[1].write_count_csv.load() << '\n';
+        std::cout << std::left << std::setw(60) << (save_data_bin ? "Total windows recorded CH2 to binary file:" : "Total lines written CH2 to csv:") << counters[1].write_count_csv.load() << '\n';
     }
     if (save_data_dac)
     {
         std::cout << std::left << std::setw(60) << "Total lines written CH2 to DAC_CH1:" << counters[1].write_count_dac.load() << '\n';
     }
     std::cout << std::left << std::setw(60) << "Total model calculated CH2:" << counters[1].model_count.load() << '\n';
+    print_batch_stats(counters[1], 2);
+    if (counters[1].ring_full_count.load() > 0)
+    {
+        std::cout << std::left << std::setw(60) << "Windows finding the window ring full CH2:" << counters[1].ring_full_count.load() << '\n';
+    }
+    if (counters[1].pool_exhausted_count.load() > 0)
+    {
+        std::cout << std::left << std::setw(60) << "Windows dropped CH2 (window pool exhausted):" << counters[1].pool_exhausted_count.load() << '\n';
+    }
+    if (counters[1].overrun_count.load() > 0)
+    {
+        std::cout << std::left << std::setw(60) << "Overruns CH2 (resynchronized):" << counters[1].overrun_count.load() << ", "
+                  << counters[1].samples_lost.load() << " samples lost\n";
+    }
+    if (counters[1].torn_count.load() > 0)
+    {
+        std::cout << std::left << std::setw(60) << "Torn zero-copy windows CH2 (flagged):" << counters[1].torn_count.load() << '\n';
+    }
     if (save_output_csv)
     {
         std::cout << std::left << std::setw(60) << "Total results logged CH2 to csv file:" << counters[1].log_count_csv.load() << '\n';
@@ -138,6 +222,8 @@ void print_channel_stats(const shared_counters_t *counters)
     {
         std::cout << std::left << std::setw(60) << "Total results written to DAC_CH2:" << counters[1].log_count_dac.load() << '\n';
     }
+    print_channel_queues(counters[1], 2);
+#endif
 
     std::cout << "\n====================================\n";
 }
@@ -178,7 +264,7 @@ void folder_manager(const std::string &folder_path)
     }
 }
 
-bool ask_user_preferences(bool &save_data_csv, bool &save_data_dac, bool &save_output_csv, bool &save_output_dac)
+bool ask_user_preferences(bool &save_data_csv, bool &save_data_bin, bool &save_data_dac, bool &save_output_csv, bool &save_output_dac, input_norm_t &input_norm)
 {
     int max_attempts = 3;
 
@@ -190,18 +276,22 @@ bool ask_user_preferences(bool &save_data_csv, bool &save_data_dac, bool &save_o
                   << " 2. To DAC only\n"
                   << " 3. Both CSV and DAC\n"
                   << " 4. None\n"
-                  << "Enter your choice (1-4): ";
+                  << " 5. As binary recording only\n"
+                  << " 6. Both binary recording and DAC\n"
+                  << "Enter your choice (1-6): ";
         std::cin >> save_choice;
 
-        if (save_choice >= 1 && save_choice <= 4)
+        if (save_choice >= 1 && save_choice <= 6)
         {
-            save_data_csv = (save_choice == 1 || save_choice == 3);
-            save_data_dac = (save_choice == 2 || save_choice == 3);
+            // save_data_csv selects the file writer, save_data_bin its binary format
+            save_data_csv = (save_choice == 1 || save_choice == 3 || save_choice == 5 || save_choice == 6);
+            save_data_bin = (save_choice == 5 || save_choice == 6);
+            save_data_dac = (save_choice == 2 || save_choice == 3 || save_choice == 6);
             break;
         }
         else
         {
-            std::cerr << "Invalid input. Please enter a number between 1 and 4.\n";
+            std::cerr << "Invalid input. Please enter a number between 1 and 6.\n";
             if (attempt == max_attempts)
                 return false;
         }
@@ -222,6 +312,17 @@ bool ask_user_preferences(bool &save_data_csv, bool &save_data_dac, bool &save_o
         {
             save_output_csv = (output_option == 1 || output_option == 3);
 
+#if DAC_ARB_PLAYBACK
+            // The raw playback loops the arbitrary waveform on the same generator, rp_GenAmp from the
+            // result writer would rescale it
+            if (save_data_dac && (output_option == 2 || output_option == 3))
+            {
+                std::cerr << "Model output cannot go to the DAC while it plays the acquired data (ARB_DAC=1).\n";
+                if (attempt == max_attempts)
+                    return false;
+                continue;
+            }
+#endif
             if (save_data_dac && (output_option == 2 || output_option == 3))
             {
                 save_output_dac = false;
@@ -233,7 +334,7 @@ bool ask_user_preferences(bool &save_data_csv, bool &save_data_dac, bool &save_o
                 save_output_dac = (output_option == 2 || output_option == 3);
             }
 
-            return true;
+            break;
         }
         else
         {
@@ -243,6 +344,29 @@ bool ask_user_preferences(bool &save_data_csv, bool &save_data_dac, bool &save_o
         }
     }
 
+    for (int attempt = 1; attempt <= max_attempts; ++attempt)
+    {
+        int norm_option;
+        std::cout << "\nNormalize the model input windows?\n"
+                  << " 1. No\n"
+                  << " 2. Yes, on the model thread (saved data stays as acquired)\n"
+                  << " 3. Yes, with the conversion on the acquisition thread (saved data is normalized too)\n"
+                  << "Enter your choice (1-3): ";
+        std::cin >> norm_option;
+
+        if (norm_option >= 1 && norm_option <= 3)
+        {
+            input_norm = static_cast<input_norm_t>(norm_option - 1);
+            return true;
+        }
+        else
+        {
+            std::cerr << "Invalid input. Please enter a number between 1 and 3.\n";
+            if (attempt == max_attempts)
+                return false;
+        }
+    }
+
     return true;
 }
 
@@ -21,22 +21,42 @@
 #include "Common.hpp"
 #include "SystemUtils.hpp"
 #include "DataAcquisition.hpp"
+#include "DataReplay.hpp"
 #include "DataWriterCSV.hpp"
+#include "DataWriterBin.hpp"
 #include "DataWriterDAC.hpp"
 #include "ModelProcessing.hpp"
 #include "ModelWriterCSV.hpp"
 #include "ModelWriterDAC.hpp"
+#ifdef RP_SIM
+#include "rp_acq_sim.hpp"
+#endif
 #include "DAC.hpp"
 
 pid_t pid1 = -1;
 pid_t pid2 = -1;
 bool save_data_csv = false;
+bool save_data_bin = false;
 bool save_data_dac = false;
 bool save_output_csv = false;
 bool save_output_dac = false;
+input_norm_t input_norm = NORM_OFF;
 
-int main()
+int main(int argc, char **argv)
 {
+    replay_options_t replay_options;
+    if (!parse_replay_args(argc, argv, replay_options))
+    {
+        std::cerr << "Usage: " << argv[0] << " [--replay <ch1 capture> [<ch2 capture>] [--loops N]]" << std::endl;
+        return -1;
+    }
+    const bool replay = replay_options.path[0] != nullptr;
+    [[maybe_unused]] const char *replay_path_ch2 = replay_options.path[1] ? replay_options.path[1] : replay_options.path[0];
+
+    // A replay measures what every stage sustains, so no queue drops
+    auto policy = [replay](overflow_policy_t live)
+    { return replay ? OVERFLOW_BLOCK : live; };
+
     if (rp_Init() != RP_OK)
     {
         std::cerr << "Rp API init failed!" << std::endl;
@@ -73,29 +93,93 @@ int main()
     new (&shared_counters[0].write_count_csv) std::atomic<int>(0);
     new (&shared_counters[0].log_count_csv) std::atomic<int>(0);
     new (&shared_counters[0].log_count_dac) std::atomic<int>(0);
+    new (&shared_counters[0].ring_full_count) std::atomic<int>(0);
+    new (&shared_counters[0].pool_exhausted_count) std::atomic<int>(0);
+    new (&shared_counters[0].overrun_count) std::atomic<int>(0);
+    new (&shared_counters[0].samples_lost) std::atomic<uint64_t>(0);
+    new (&shared_counters[0].torn_count) std::atomic<int>(0);
+    new (&shared_counters[0].batch_count) std::atomic<int>(0);
+    new (&shared_counters[0].batch_timeouts) std::atomic<int>(0);
+    new (&shared_counters[0].batch_wait_us) std::atomic<uint64_t>(0);
+    new (&shared_counters[0].batch_run_us) std::atomic<uint64_t>(0);
+    new (&shared_counters[0].batch_latency_max_us) std::atomic<uint64_t>(0);
+    new (&shared_counters[0].queue_csv.drops) std::atomic<int>(0);
+    new (&shared_counters[0].queue_csv.high_watermark) std::atomic<int>(0);
+    new (&shared_counters[0].queue_dac.drops) std::atomic<int>(0);
+    new (&shared_counters[0].queue_dac.high_watermark) std::atomic<int>(0);
+    new (&shared_counters[0].queue_model.drops) std::atomic<int>(0);
+    new (&shared_counters[0].queue_model.high_watermark) std::atomic<int>(0);
+    new (&shared_counters[0].queue_log_csv.drops) std::atomic<int>(0);
+    new (&shared_counters[0].queue_log_csv.high_watermark) std::atomic<int>(0);
+    new (&shared_counters[0].queue_log_dac.drops) std::atomic<int>(0);
+    new (&shared_counters[0].queue_log_dac.high_watermark) std::atomic<int>(0);
 
     new (&shared_counters[1].acquire_count) std::atomic<int>(0);
     new (&shared_counters[1].model_count) std::atomic<int>(0);
     new (&shared_counters[1].write_count_csv) std::atomic<int>(0);
     new (&shared_counters[1].log_count_csv) std::atomic<int>(0);
     new (&shared_counters[1].log_count_dac) std::atomic<int>(0);
+    new (&shared_counters[1].ring_full_count) std::atomic<int>(0);
+    new (&shared_counters[1].pool_exhausted_count) std::atomic<int>(0);
+    new (&shared_counters[1].overrun_count) std::atomic<int>(0);
+    new (&shared_counters[1].samples_lost) std::atomic<uint64_t>(0);
+    new (&shared_counters[1].torn_count) std::atomic<int>(0);
+    new (&shared_counters[1].batch_count) std::atomic<int>(0);
+    new (&shared_counters[1].batch_timeouts) std::atomic<int>(0);
+    new (&shared_counters[1].batch_wait_us) std::atomic<uint64_t>(0);
+    new (&shared_counters[1].batch_run_us) std::atomic<uint64_t>(0);
+    new (&shared_counters[1].batch_latency_max_us) std::atomic<uint64_t>(0);
+    new (&shared_counters[1].queue_csv.drops) std::atomic<int>(0);
+    new (&shared_counters[1].queue_csv.high_watermark) std::atomic<int>(0);
+    new (&shared_counters[1].queue_dac.drops) std::atomic<int>(0);
+    new (&shared_counters[1].queue_dac.high_watermark) std::atomic<int>(0);
+    new (&shared_counters[1].queue_model.drops) std::atomic<int>(0);
+    new (&shared_counters[1].queue_model.high_watermark) std::atomic<int>(0);
+    new (&shared_counters[1].queue_log_csv.drops) std::atomic<int>(0);
+    new (&shared_counters[1].queue_log_csv.high_watermark) std::atomic<int>(0);
+    new (&shared_counters[1].queue_log_dac.drops) std::atomic<int>(0);
+    new (&shared_counters[1].queue_log_dac.high_watermark) std::atomic<int>(0);
 
     new (&shared_counters[0].ready_barrier) std::atomic<int>(0);
     new (&shared_counters[1].ready_barrier) std::atomic<int>(0);
 
     std::cout << "Starting program" << std::endl;
 
-    if (!ask_user_preferences(save_data_csv, save_data_dac, save_output_csv, save_output_dac))
+    if (!ask_user_preferences(save_data_csv, save_data_bin, save_data_dac, save_output_csv, save_output_dac, input_norm))
     {
         std::cerr << "User input failed. Exiting." << std::endl;
         return -1;
     }
     ::save_data_csv = save_data_csv;
+    ::save_data_bin = save_data_bin;
     ::save_data_dac = save_data_dac;
     ::save_output_csv = save_output_csv;
     ::save_output_dac = save_output_dac;
 
-    initialize_acq();
+#if DAC_ARB_PLAYBACK
+    // write_data_dac and log_results_dac drive the generator of their own channel
+    if (save_data_dac && save_output_dac)
+    {
+        std::cerr << "Raw DAC playback and model output on the DAC cannot share a channel. Exiting." << std::endl;
+        return -1;
+    }
+#endif
+
+    if (!replay)
+    {
+        initialize_acq();
+#if ACQ_ZERO_COPY
+#ifdef RP_SIM
+        // The simulated DMA fills a heap buffer in place of the reserved memory
+        static host_memory_source_t acq_memory_source;
+        if (map_acq_ring(acq_memory_source))
+            rp_acq_sim_map_axi(acq_memory_source.data());
+#else
+        static devmem_source_t acq_memory_source;
+        map_acq_ring(acq_memory_source);
+#endif
+#endif
+    }
     initialize_DAC();
 
     pid1 = fork();
@@ -119,15 +203,27 @@ int main()
         }
 
         channel1.counters = &shared_counters_ch1[0];
+        channel1.channel_id = RP_CH_1;
+        channel1.calib = make_adc_calib(ADC_OFFSET_CH1, ADC_GAIN_CH1);
+        if (save_data_csv)
+            channel1.windows.attach(CONSUMER_FILE, policy(POLICY_WRITE_CSV), QUEUE_MAX_SIZE);
+        if (save_data_dac)
+            channel1.windows.attach(CONSUMER_DAC, policy(POLICY_WRITE_DAC), QUEUE_MAX_SIZE);
+        channel1.windows.attach(CONSUMER_MODEL, policy(POLICY_MODEL), QUEUE_MAX_SIZE);
+        channel1.result_buffer_csv.set_policy(policy(POLICY_LOG_CSV), QUEUE_MAX_SIZE);
+        channel1.result_buffer_dac.set_policy(policy(POLICY_LOG_DAC), QUEUE_MAX_SIZE);
         set_process_affinity(0);
 
-        wait_for_barrier(shared_counters_ch1[0].ready_barrier, 2);
-        std::thread acq_thread(acquire_data, std::ref(channel1), RP_CH_1);
-        std::thread model_thread(model_inference, std::ref(channel1));
+        wait_for_barrier(shared_counters_ch1[0].ready_barrier, CHANNEL_PROCESSES);
+        std::thread acq_thread = replay ? std::thread(replay_data, std::ref(channel1), replay_options.path[0], replay_options.loops)
+                                        : std::thread(acquire_data, std::ref(channel1), RP_CH_1);
+        std::thread model_thread(input_norm == NORM_MODEL ? model_inference_mod : model_inference, std::ref(channel1));
 
         std::thread write_thread_csv, write_thread_dac, log_thread_csv, log_thread_dac;
 
-        if (save_data_csv)
+        if (save_data_csv && save_data_bin)
+            write_thread_csv = std::thread(write_data_bin, std::ref(channel1), "DataOutput/data_ch1.bin");
+        else if (save_data_csv)
             write_thread_csv = std::thread(write_data_csv, std::ref(channel1), "DataOutput/data_ch1.csv");
         if (save_data_dac)
             write_thread_dac = std::thread(write_data_dac, std::ref(channel1), RP_CH_1);
@@ -161,6 +257,7 @@ int main()
         exit(0);
     }
 
+#if CHANNEL_PROCESSES > 1
     pid2 = fork();
 
     if (pid2 < 0)
@@ -182,15 +279,27 @@ int main()
         }
 
         channel2.counters = &shared_counters_ch2[1];
+        channel2.channel_id = RP_CH_2;
+        channel2.calib = make_adc_calib(ADC_OFFSET_CH2, ADC_GAIN_CH2);
+        if (save_data_csv)
+            channel2.windows.attach(CONSUMER_FILE, policy(POLICY_WRITE_CSV), QUEUE_MAX_SIZE);
+        if (save_data_dac)
+            channel2.windows.attach(CONSUMER_DAC, policy(POLICY_WRITE_DAC), QUEUE_MAX_SIZE);
+        channel2.windows.attach(CONSUMER_MODEL, policy(POLICY_MODEL), QUEUE_MAX_SIZE);
+        channel2.result_buffer_csv.set_policy(policy(POLICY_LOG_CSV), QUEUE_MAX_SIZE);
+        channel2.result_buffer_dac.set_policy(policy(POLICY_LOG_DAC), QUEUE_MAX_SIZE);
         set_process_affinity(1);
 
-        wait_for_barrier(shared_counters_ch2[0].ready_barrier, 2);
-        std::thread acq_thread(acquire_data, std::ref(channel2), RP_CH_2);
-        std::thread model_thread(model_inference, std::ref(channel2));
+        wait_for_barrier(shared_counters_ch2[0].ready_barrier, CHANNEL_PROCESSES);
+        std::thread acq_thread = replay ? std::thread(replay_data, std::ref(channel2), replay_path_ch2, replay_options.loops)
+                                        : std::thread(acquire_data, std::ref(channel2), RP_CH_2);
+        std::thread model_thread(input_norm == NORM_MODEL ? model_inference_mod : model_inference, std::ref(channel2));
 
         std::thread write_thread_csv, write_thread_dac, log_thread_csv, log_thread_dac;
 
-        if (save_data_csv)
+        if (save_data_csv && save_data_bin)
+            write_thread_csv = std::thread(write_data_bin, std::ref(channel2), "DataOutput/data_ch2.bin");
+        else if (save_data_csv)
             write_thread_csv = std::thread(write_data_csv, std::ref(channel2), "DataOutput/data_ch2.csv");
         if (save_data_dac)
             write_thread_dac = std::thread(write_data_dac, std::ref(channel2), RP_CH_2);
@@ -223,12 +332,15 @@ int main()
         std::cout << "Child Process 2 (CH2) finished." << std::endl;
         exit(0);
     }
+#endif
 
     int status;
     waitpid(pid1, &status, 0);
+#if CHANNEL_PROCESSES > 1
     waitpid(pid2, &status, 0);
+#endif
 
-    std::cout << "Both child processes finished." << std::endl;
+    std::cout << (CHANNEL_PROCESSES > 1 ? "Both child processes finished." : "Child process finished.") << std::endl;
 
     cleanup();
     print_channel_stats(shared_counters);
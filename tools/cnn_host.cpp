@@ -0,0 +1,151 @@
+/* cnn_host.cpp */
+
+// Runs the generated model on a desktop over a binary raw-sample recording (RawRecord.hpp), with
+// the x86 paths of the CMSIS kernels (bit-exact with the ARM ones), and writes the results in the
+// "index,value,time_ms" layout of the board's model CSV so both can be diffed.
+//
+//   cnn_host [--norm] data_ch1.bin [results.csv]
+//
+// --norm applies sample_norm() to every window first, as the model_inference_mod thread does.
+// Without an output path the CSV goes to stdout. Built by `make host` (HOST_SIMD=avx2|sse4|none).
+
+#define WITH_CMSIS_NN 1
+#define ARM_MATH_DSP 1
+#define ARM_NN_TRUNCATE
+
+#include "../model/include/model.h"
+#include "RawRecord.hpp"
+#include "SampleNorm.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using base_t = std::remove_cv_t<std::remove_all_extents_t<input_t>>;
+
+static void write_output(FILE *out, uint64_t index, const output_t &output, double time_ms)
+{
+    if constexpr (std::is_floating_point_v<base_t>)
+        fprintf(out, "%llu,%f,%f\n", static_cast<unsigned long long>(index), static_cast<double>(output[0]), time_ms);
+    else
+        fprintf(out, "%llu,%d,%f\n", static_cast<unsigned long long>(index), static_cast<int>(output[0]), time_ms);
+}
+
+int main(int argc, char **argv)
+{
+    bool norm = false;
+    int arg = 1;
+    if (arg < argc && std::strcmp(argv[arg], "--norm") == 0)
+    {
+        norm = true;
+        ++arg;
+    }
+    if (argc - arg < 1 || argc - arg > 2)
+    {
+        fprintf(stderr, "Usage: %s [--norm] <recording.bin> [results.csv]\n", argv[0]);
+        return 1;
+    }
+    const char *path = argv[arg];
+
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0)
+    {
+        fprintf(stderr, "Error opening %s\n", path);
+        return 1;
+    }
+    if (static_cast<size_t>(st.st_size) < sizeof(raw_record_header_t))
+    {
+        fprintf(stderr, "%s is too short for a raw recording\n", path);
+        return 1;
+    }
+
+    void *mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED)
+    {
+        fprintf(stderr, "mmap of %s failed\n", path);
+        return 1;
+    }
+    madvise(mapping, st.st_size, MADV_SEQUENTIAL);
+
+    raw_record_header_t header;
+    std::memcpy(&header, mapping, sizeof(header));
+    if (!raw_record_header_valid(header) || raw_record_sample_size(header.sample_type) != header.sample_size ||
+        static_cast<uint64_t>(st.st_size) < header.header_size)
+    {
+        fprintf(stderr, "%s is not a raw recording\n", path);
+        return 1;
+    }
+    if (header.dim0 != MODEL_INPUT_DIM_0 || header.dim1 != MODEL_INPUT_DIM_1 || header.sample_type != raw_sample_type<base_t>())
+    {
+        fprintf(stderr, "%s holds %ux%u windows of sample type %u, the model takes %ux%u of type %u\n", path, header.dim0,
+                header.dim1, header.sample_type, MODEL_INPUT_DIM_0, MODEL_INPUT_DIM_1, raw_sample_type<base_t>());
+        return 1;
+    }
+
+    uint64_t windows = (st.st_size - header.header_size) / sizeof(input_t);
+    if (header.window_count && header.window_count < windows)
+        windows = header.window_count;
+    if (!header.window_count)
+        fprintf(stderr, "Recording was not closed cleanly, running the %llu complete windows found\n",
+                static_cast<unsigned long long>(windows));
+
+    FILE *out = argc - arg == 2 ? fopen(argv[arg + 1], "w") : stdout;
+    if (!out)
+    {
+        fprintf(stderr, "Error opening %s\n", argv[arg + 1]);
+        return 1;
+    }
+
+    const uint8_t *data = static_cast<const uint8_t *>(mapping) + header.header_size;
+    const uint64_t gap_entries = raw_record_gap_entries(header);
+    uint64_t gap = 0;
+    double total_ms = 0;
+    double max_ms = 0;
+    for (uint64_t w = 0; w < windows; ++w)
+    {
+        input_t input;
+        std::memcpy(input, data + w * sizeof(input_t), sizeof(input_t));
+        if (norm)
+            sample_norm(input);
+
+        output_t output;
+        auto start = std::chrono::high_resolution_clock::now();
+        cnn(input, output);
+        auto end = std::chrono::high_resolution_clock::now();
+        const double time_ms = std::chrono::duration<double, std::milli>(end - start).count();
+        total_ms += time_ms;
+        max_ms = std::max(max_ms, time_ms);
+
+        // Blank line before the result of a window after a gap, as the board's model CSV
+        if (gap < gap_entries && raw_record_gap(mapping, gap).window == w)
+        {
+            fputc('\n', out);
+            ++gap;
+        }
+        write_output(out, w + 1, output, time_ms);
+    }
+
+    const bool ok = !ferror(out);
+    if (out != stdout)
+        fclose(out);
+    munmap(mapping, st.st_size);
+    close(fd);
+
+    if (!ok)
+    {
+        fprintf(stderr, "Error writing CSV output\n");
+        return 1;
+    }
+    if (windows)
+        fprintf(stderr, "%llu windows, %.0f windows/s, %.2f us mean, %.2f us max per window\n",
+                static_cast<unsigned long long>(windows), windows / (total_ms / 1e3), total_ms * 1e3 / windows,
+                max_ms * 1e3);
+    return 0;
+}
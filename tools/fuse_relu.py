@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+# fuse_relu.py
+#
+# Rewrites a generated model source so that a convolution or fully connected call directly
+# followed by arm_relu_q15() (arm_relu_q7() for the q7 kernels) on its output uses the fused *_relu
+# kernel instead, and drops the separate ReLU pass. The rewritten source goes to stdout, the calls that were fused to stderr.
+#
+#   fuse_relu.py model/model.c > model/model.fused
+#
+# Anything else is copied as is. A removed call is replaced by as many empty lines as it spanned
+# and a #line directive names the original file, so compiler messages point into the generated
+# source.
+
+import re
+import sys
+
+# Kernel name -> (ReLU it absorbs, index of its output buffer argument)
+FUSABLE = {
+    "arm_convolve_HWC_q15_basic_nonsquare": ("arm_relu_q15", 15),
+    "arm_convolve_HWC_q15_fast_nonsquare": ("arm_relu_q15", 15),
+    "arm_convolve_1_x_n_HWC_q15": ("arm_relu_q15", 15),
+    "arm_fully_connected_q15": ("arm_relu_q15", 7),
+    "arm_convolve_HWC_q7_basic_nonsquare": ("arm_relu_q7", 15),
+    "arm_convolve_HWC_q7_fast_nonsquare": ("arm_relu_q7", 15),
+    "arm_fully_connected_q7": ("arm_relu_q7", 7),
+    "arm_fully_connected_q7_opt": ("arm_relu_q7", 7),
+}
+
+CALL = re.compile(r"\b(" + "|".join(FUSABLE) + r")\s*\(")
+# Whitespace and comments allowed between the kernel call and the ReLU
+GAP = re.compile(r"(?:\s+|//[^\n]*|/\*.*?\*/)*", re.S)
+
+
+def split_args(source, start):
+    """Splits the arguments of the call whose '(' is at start - 1, returns them and the index
+    just past the closing parenthesis."""
+    args, depth, current = [], 0, start
+    i = start
+    while i < len(source):
+        c = source[i]
+        if c in "([{":
+            depth += 1
+        elif c in ")]}":
+            if depth == 0:
+                args.append(source[current:i])
+                return args, i + 1
+            depth -= 1
+        elif c == "," and depth == 0:
+            args.append(source[current:i])
+            current = i + 1
+        i += 1
+    raise ValueError("unbalanced call at offset %d" % start)
+
+
+def normalize(expr):
+    return re.sub(r"\s+", "", expr)
+
+
+def fuse(source, report):
+    out, pos = [], 0
+    for call in CALL.finditer(source):
+        if call.start() < pos:
+            continue
+        name = call.group(1)
+        relu_name, out_index = FUSABLE[name]
+        args, end = split_args(source, call.end())
+        if len(args) <= out_index:
+            continue
+        # the call must end its statement, then the ReLU must be the next statement
+        semi = GAP.match(source, end).end()
+        if semi >= len(source) or source[semi] != ";":
+            continue
+        gap = GAP.match(source, semi + 1).end()
+        relu = re.compile(relu_name + r"\s*\(").match(source, gap)
+        if not relu:
+            continue
+        relu_args, relu_end = split_args(source, relu.end())
+        relu_semi = GAP.match(source, relu_end).end()
+        if len(relu_args) != 2 or relu_semi >= len(source) or source[relu_semi] != ";":
+            continue
+        if normalize(relu_args[0]) != normalize(args[out_index]):
+            continue
+
+        out.append(source[pos:call.start()])
+        out.append(name + "_relu" + source[call.start() + len(name):semi + 1])
+        out.append(re.sub(r"[ \t]+$", "", source[semi + 1:gap]))
+        out.append("\n" * source.count("\n", gap, relu_semi + 1))
+        pos = relu_semi + 1
+        report.append("%s + %s(%s) at line %d" % (name, relu_name, normalize(relu_args[0]),
+                                                  source.count("\n", 0, call.start()) + 1))
+    out.append(source[pos:])
+    return "".join(out)
+
+
+def main():
+    if len(sys.argv) != 2:
+        print("usage: %s model.c > fused.c" % sys.argv[0], file=sys.stderr)
+        return 1
+    with open(sys.argv[1]) as f:
+        source = f.read()
+    report = []
+    # Diagnostics keep pointing at the generated file
+    sys.stdout.write('#line 1 "%s"\n' % sys.argv[1])
+    sys.stdout.write(fuse(source, report))
+    for line in report:
+        print("%s: fused %s" % (sys.argv[1], line), file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
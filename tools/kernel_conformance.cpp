@@ -0,0 +1,739 @@
+/* kernel_conformance.cpp */
+
+// Bit-exactness check of every path of the CMSIS kernels this compiler can build (NEON and __SMLAD
+// on the board, SSE4.1, AVX2 and the reference loops on a desktop, see tools/kernel_path.c)
+// against a plain model of the kernel arithmetic: products summed with 32-bit wrap-around from
+// bias << bias_shift, truncating >> out_shift, then saturation to q15 or q7 (to [0, max] for the
+// *_relu variants). The q7 kernels are checked the same way, arm_fully_connected_q7_opt on
+// weights interleaved here, and arm_maxpool_q7_HWC against a max over the clipped windows.
+//
+//   kernel_conformance [cases per kernel] [seed]
+//
+// Shapes, shifts and values are random: odd channel counts, which the fast kernels must reject with
+// ARM_MATH_SIZE_MISMATCH and leave the output alone outside of their 1-D path, padding up to the kernel size, strides larger
+// than the kernel, and full scale or extreme values so the accumulators wrap and the outputs
+// saturate. Writes past the output and the documented bufferA size are caught by guard words.
+// The tiles paths are built with a 256 byte ARM_NN_L1_TILE_BYTES so that the small shapes here
+// still go through several channel, depth and pixel tiles.
+// Paths built with ARM_NN_TEAM split every layer they can over the team defined here, which runs
+// the parts one after the other. The *_batch kernels run 1 to ARM_NN_BATCH_MAX tensors through
+// one set of weights, each must match the reference on its own. Exits with 1 when any case
+// differs, the first few are listed on stderr.
+
+#include "kernel_path.h"
+#include "arm_nnsupportfunctions.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#define X(path) extern "C" const kernel_path_t kernel_path_##path;
+KERNEL_PATHS
+#undef X
+
+#define X(path) &kernel_path_##path,
+static const kernel_path_t *const PATHS[] = {KERNEL_PATHS};
+#undef X
+
+static int32_t serial_team_parts(int64_t, int32_t max_parts)
+{
+    return std::max(max_parts, 1);
+}
+
+// Last part first, so a part that writes outside its own channels leaves the wrong values behind
+static void serial_team_run(arm_nn_team_task task, void *ctx, int32_t parts)
+{
+    for (int32_t part = parts - 1; part >= 0; --part)
+        task(ctx, part, parts);
+}
+
+static const arm_nn_team_t serial_team = {serial_team_parts, serial_team_run};
+const arm_nn_team_t *arm_nn_team = &serial_team;
+
+// No batch lanes here, the *_batch kernels are called directly
+const arm_nn_batch_t *arm_nn_batch = nullptr;
+
+constexpr size_t GUARD = 16;
+constexpr q15_t GUARD_VALUE = 0x5A5A;
+constexpr unsigned MAX_REPORTS = 8;
+
+enum value_mode_t
+{
+    VALUES_SMALL,
+    VALUES_FULL,
+    VALUES_EXTREME,
+    VALUE_MODES
+};
+
+struct conv_shape_t
+{
+    uint16_t in_x, in_y, ch_in, ch_out, k_x, k_y, pad_x, pad_y, stride_x, stride_y, out_x, out_y;
+    uint16_t bias_shift, out_shift;
+};
+
+struct fc_shape_t
+{
+    uint16_t dim_vec, rows, bias_shift, out_shift;
+};
+
+struct kernel_stats_t
+{
+    std::string path, kernel;
+    unsigned cases = 0, failures = 0;
+};
+
+static std::mt19937 rng;
+static std::vector<kernel_stats_t> stats;
+static unsigned reports = 0;
+
+static unsigned rand_below(unsigned n)
+{
+    return rng() % n;
+}
+
+// q15 or q7 value, small ones within 1/32 (q15) or 1/4 (q7) of full scale
+template <typename T = q15_t>
+static T random_value(value_mode_t mode)
+{
+    constexpr int MIN = std::numeric_limits<T>::min();
+    constexpr int MAX = std::numeric_limits<T>::max();
+    constexpr int SMALL = sizeof(T) == 1 ? 32 : 1024;
+    static constexpr T EXTREMES[] = {MIN, MIN + 1, -1, 0, 1, MAX - 1, MAX};
+    switch (mode)
+    {
+    case VALUES_SMALL:
+        return static_cast<T>(static_cast<int>(rng() % (2 * SMALL + 1)) - SMALL);
+    case VALUES_FULL:
+        return static_cast<T>(rng());
+    default:
+        return EXTREMES[rand_below(sizeof(EXTREMES) / sizeof(EXTREMES[0]))];
+    }
+}
+
+template <typename T = q15_t>
+static std::vector<T> random_values(size_t n, value_mode_t mode)
+{
+    std::vector<T> v(n);
+    for (T &x : v)
+        x = random_value<T>(mode);
+    return v;
+}
+
+// Buffer of n values followed by GUARD guard words
+template <typename T = q15_t>
+static std::vector<T> guarded(size_t n)
+{
+    return std::vector<T>(n + GUARD, static_cast<T>(GUARD_VALUE));
+}
+
+template <typename T>
+static bool guard_intact(const std::vector<T> &v, size_t n)
+{
+    return std::all_of(v.begin() + n, v.end(), [](T x) { return x == static_cast<T>(GUARD_VALUE); });
+}
+
+template <typename T = q15_t>
+static T saturate(q31_t acc, uint16_t out_shift, bool relu)
+{
+    const q31_t v = acc >> out_shift;
+    return static_cast<T>(std::clamp<q31_t>(v, relu ? 0 : std::numeric_limits<T>::min(), std::numeric_limits<T>::max()));
+}
+
+static uint32_t bias_init(q31_t bias, uint16_t bias_shift, [[maybe_unused]] uint16_t out_shift)
+{
+    return static_cast<uint32_t>((static_cast<q31_t>(bias) << bias_shift) + NN_ROUND(out_shift));
+}
+
+template <typename T>
+static void reference_conv(const conv_shape_t &s, const T *in, const T *wt, const T *bias, bool relu, T *out)
+{
+    for (int oy = 0; oy < s.out_y; ++oy)
+        for (int ox = 0; ox < s.out_x; ++ox)
+            for (int co = 0; co < s.ch_out; ++co)
+            {
+                uint32_t acc = bias_init(bias[co], s.bias_shift, s.out_shift);
+                for (int ky = 0; ky < s.k_y; ++ky)
+                    for (int kx = 0; kx < s.k_x; ++kx)
+                    {
+                        const int y = oy * s.stride_y + ky - s.pad_y;
+                        const int x = ox * s.stride_x + kx - s.pad_x;
+                        if (y < 0 || y >= s.in_y || x < 0 || x >= s.in_x)
+                            continue;
+                        for (int ci = 0; ci < s.ch_in; ++ci)
+                            acc += static_cast<uint32_t>(in[(y * s.in_x + x) * s.ch_in + ci] *
+                                                         wt[((co * s.k_y + ky) * s.k_x + kx) * s.ch_in + ci]);
+                    }
+                out[(oy * s.out_x + ox) * s.ch_out + co] = saturate<T>(static_cast<q31_t>(acc), s.out_shift, relu);
+            }
+}
+
+template <typename T>
+static void reference_fc(const fc_shape_t &s, const T *vec, const T *wt, const T *bias, bool relu, T *out)
+{
+    for (int r = 0; r < s.rows; ++r)
+    {
+        uint32_t acc = bias_init(bias[r], s.bias_shift, s.out_shift);
+        for (int j = 0; j < s.dim_vec; ++j)
+            acc += static_cast<uint32_t>(vec[j] * wt[r * s.dim_vec + j]);
+        out[r] = saturate<T>(static_cast<q31_t>(acc), s.out_shift, relu);
+    }
+}
+
+static bool is_1d(const conv_shape_t &s)
+{
+    return s.in_y == 1 && s.k_y == 1 && s.pad_y == 0 && s.out_y == 1;
+}
+
+static conv_shape_t random_conv_shape(bool one_d)
+{
+    for (;;)
+    {
+        conv_shape_t s;
+        s.in_y = one_d ? 1 : 1 + rand_below(6);
+        s.k_y = one_d ? 1 : 1 + rand_below(std::min<unsigned>(s.in_y, 3));
+        s.pad_y = one_d ? 0 : rand_below(s.k_y + 1);
+        s.stride_y = one_d ? 1 : 1 + rand_below(2);
+        s.in_x = 1 + rand_below(40);
+        s.k_x = 1 + rand_below(7);
+        s.pad_x = rand_below(s.k_x + 1);
+        s.stride_x = 1 + rand_below(s.k_x + 2);
+        s.ch_in = 1 + rand_below(12);
+        s.ch_out = 1 + rand_below(rand_below(4) == 0 ? 48 : 12);
+        s.bias_shift = rand_below(16);
+        s.out_shift = rand_below(21);
+        if (s.in_x + 2 * s.pad_x < s.k_x || s.in_y + 2 * s.pad_y < s.k_y)
+            continue;
+        s.out_x = (s.in_x + 2 * s.pad_x - s.k_x) / s.stride_x + 1;
+        s.out_y = (s.in_y + 2 * s.pad_y - s.k_y) / s.stride_y + 1;
+        if (is_1d(s) != one_d)
+            continue;
+        return s;
+    }
+}
+
+static std::string describe(const conv_shape_t &s)
+{
+    char text[160];
+    snprintf(text, sizeof(text), "in %ux%ux%u, k %ux%u, pad %u,%u, stride %u,%u, out %ux%ux%u, shifts %u/%u", s.in_x, s.in_y,
+             s.ch_in, s.k_x, s.k_y, s.pad_x, s.pad_y, s.stride_x, s.stride_y, s.out_x, s.out_y, s.ch_out, s.bias_shift,
+             s.out_shift);
+    return text;
+}
+
+static std::string describe(const fc_shape_t &s)
+{
+    char text[96];
+    snprintf(text, sizeof(text), "dim_vec %u, rows %u, shifts %u/%u", s.dim_vec, s.rows, s.bias_shift, s.out_shift);
+    return text;
+}
+
+static kernel_stats_t &stats_for(const kernel_path_t &path, const char *kernel)
+{
+    for (kernel_stats_t &k : stats)
+        if (k.path == path.name && k.kernel == kernel)
+            return k;
+    stats.push_back({path.name, kernel});
+    return stats.back();
+}
+
+static void record(const kernel_path_t &path, const char *kernel, const std::string &shape, const std::string &failure)
+{
+    kernel_stats_t &k = stats_for(path, kernel);
+    ++k.cases;
+    if (failure.empty())
+        return;
+    ++k.failures;
+    if (reports++ < MAX_REPORTS)
+        fprintf(stderr, "%s %s (%s): %s\n", path.name, kernel, shape.c_str(), failure.c_str());
+}
+
+// First difference between a kernel output and the expected one, empty when they match. `skip`
+// tells which values the kernel leaves unspecified.
+template <typename T, typename Skip>
+static std::string compare(const std::vector<T> &got, const std::vector<T> &expected, size_t n, Skip skip)
+{
+    char text[96];
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (skip(i) || got[i] == expected[i])
+            continue;
+        snprintf(text, sizeof(text), "value %zu is %d, expected %d", i, got[i], expected[i]);
+        return text;
+    }
+    if (!guard_intact(got, n))
+        return "wrote past the output";
+    return {};
+}
+
+static std::string check_status(arm_status status, arm_status expected)
+{
+    if (status == expected)
+        return {};
+    return "returned " + std::to_string(status) + ", expected " + std::to_string(expected);
+}
+
+// The fast kernels compute pixel pairs, a trailing odd pixel of each output row is left alone
+// outside of the 1-D path. Rows wider than one pixel with an odd width are not supported there.
+static bool fast_skips(const conv_shape_t &s, size_t i)
+{
+    const size_t pixel = (i / s.ch_out) % (static_cast<size_t>(s.out_x) * s.out_y);
+    return !is_1d(s) && s.out_x % 2 != 0 && pixel % s.out_x == static_cast<size_t>(s.out_x) - 1;
+}
+
+static void check_conv(unsigned cases)
+{
+    enum conv_kind_t
+    {
+        CONV_BASIC,
+        CONV_FAST,
+        CONV_1_X_N,
+        CONV_FAST_TILED,
+        CONV_KINDS
+    };
+
+    for (unsigned n = 0; n < cases; ++n)
+    {
+        const conv_kind_t kind = static_cast<conv_kind_t>(n % CONV_KINDS);
+        const bool pairs = kind == CONV_FAST;
+        conv_shape_t s;
+        do
+            s = random_conv_shape(kind == CONV_1_X_N || rand_below(3) == 0);
+        while (pairs && !is_1d(s) && s.out_x % 2 != 0 && s.out_y > 1);
+        const bool relu = rand_below(2);
+        const value_mode_t mode = static_cast<value_mode_t>(rand_below(VALUE_MODES));
+
+        const size_t in_size = static_cast<size_t>(s.in_x) * s.in_y * s.ch_in;
+        const size_t out_size = static_cast<size_t>(s.out_x) * s.out_y * s.ch_out;
+        const size_t col_len = static_cast<size_t>(s.ch_in) * s.k_x * s.k_y;
+        const std::vector<q15_t> input = random_values(in_size, mode);
+        const std::vector<q15_t> weights = random_values(col_len * s.ch_out, mode);
+        const std::vector<q15_t> bias = random_values(s.ch_out, mode == VALUES_EXTREME ? VALUES_EXTREME : VALUES_SMALL);
+
+        const bool even = s.ch_in % 2 == 0 && s.ch_out % 2 == 0;
+        arm_status expected_status = ARM_MATH_SUCCESS;
+        if (pairs && !even && !is_1d(s))
+            expected_status = ARM_MATH_SIZE_MISMATCH;
+
+        std::vector<q15_t> expected = guarded(out_size);
+        if (expected_status == ARM_MATH_SUCCESS)
+            reference_conv(s, input.data(), weights.data(), bias.data(), relu, expected.data());
+
+        for (const kernel_path_t *path : PATHS)
+        {
+            // Documented bufferA sizes
+            size_t buffer_size = kind == CONV_BASIC ? col_len : 2 * col_len;
+            if (kind == CONV_FAST_TILED)
+                buffer_size = path->conv_fast_tiled_buffer_size(s.ch_in, s.k_x, s.k_y, s.ch_out);
+            std::vector<q15_t> out = guarded(out_size);
+            std::vector<q15_t> buffer = guarded(buffer_size);
+            const char *name = nullptr;
+            arm_status status;
+            switch (kind)
+            {
+            case CONV_BASIC:
+                name = relu ? "conv_basic_relu" : "conv_basic";
+                status = (relu ? path->conv_basic_relu : path->conv_basic)(
+                    input.data(), s.in_x, s.in_y, s.ch_in, weights.data(), s.ch_out, s.k_x, s.k_y, s.pad_x, s.pad_y, s.stride_x,
+                    s.stride_y, bias.data(), s.bias_shift, s.out_shift, out.data(), s.out_x, s.out_y, buffer.data(), nullptr);
+                break;
+            case CONV_FAST:
+                name = relu ? "conv_fast_relu" : "conv_fast";
+                status = (relu ? path->conv_fast_relu : path->conv_fast)(
+                    input.data(), s.in_x, s.in_y, s.ch_in, weights.data(), s.ch_out, s.k_x, s.k_y, s.pad_x, s.pad_y, s.stride_x,
+                    s.stride_y, bias.data(), s.bias_shift, s.out_shift, out.data(), s.out_x, s.out_y, buffer.data(), nullptr);
+                break;
+            case CONV_1_X_N:
+                name = relu ? "conv_1_x_n_relu" : "conv_1_x_n";
+                status = (relu ? path->conv_1_x_n_relu : path->conv_1_x_n)(
+                    input.data(), s.in_x, s.in_y, s.ch_in, weights.data(), s.ch_out, s.k_x, s.k_y, s.pad_x, s.pad_y, s.stride_x,
+                    s.stride_y, bias.data(), s.bias_shift, s.out_shift, out.data(), s.out_x, s.out_y, buffer.data(), nullptr);
+                break;
+            default:
+                name = relu ? "conv_fast_tiled_relu" : "conv_fast_tiled";
+                status = (relu ? path->conv_fast_tiled_relu : path->conv_fast_tiled)(
+                    input.data(), s.in_x, s.in_y, s.ch_in, weights.data(), s.ch_out, s.k_x, s.k_y, s.pad_x, s.pad_y, s.stride_x,
+                    s.stride_y, bias.data(), s.bias_shift, s.out_shift, out.data(), s.out_x, s.out_y, buffer.data(), nullptr);
+                break;
+            }
+
+            std::string failure = check_status(status, expected_status);
+            if (failure.empty())
+            {
+                // On a size mismatch the output must be untouched, i.e. still all guard words
+                failure = compare(out, expected, out_size, [&](size_t i)
+                                  { return expected_status == ARM_MATH_SUCCESS && pairs && fast_skips(s, i); });
+            }
+            if (failure.empty() && !guard_intact(buffer, buffer_size))
+                failure = "wrote past the documented bufferA size";
+            record(*path, name, describe(s), failure);
+        }
+    }
+}
+
+static void check_fc(unsigned cases)
+{
+    for (unsigned n = 0; n < cases; ++n)
+    {
+        fc_shape_t s;
+        s.dim_vec = 1 + rand_below(n % 8 == 0 ? 2100 : 300);
+        s.rows = 1 + rand_below(n % 8 == 0 ? 9 : 40);
+        s.bias_shift = rand_below(16);
+        s.out_shift = rand_below(21);
+        const bool relu = rand_below(2);
+        const value_mode_t mode = static_cast<value_mode_t>(rand_below(VALUE_MODES));
+
+        const std::vector<q15_t> vec = random_values(s.dim_vec, mode);
+        const std::vector<q15_t> weights = random_values(static_cast<size_t>(s.dim_vec) * s.rows, mode);
+        const std::vector<q15_t> bias = random_values(s.rows, mode == VALUES_EXTREME ? VALUES_EXTREME : VALUES_SMALL);
+        const size_t out_size = s.rows;
+
+        std::vector<q15_t> expected = guarded(out_size);
+        reference_fc(s, vec.data(), weights.data(), bias.data(), relu, expected.data());
+
+        for (const kernel_path_t *path : PATHS)
+        {
+            std::vector<q15_t> out = guarded(out_size);
+            const char *name = relu ? "fc_relu" : "fc";
+            arm_status status = (relu ? path->fc_relu : path->fc)(vec.data(), weights.data(), s.dim_vec, s.rows, s.bias_shift,
+                                                                  s.out_shift, bias.data(), out.data(), nullptr);
+
+            std::string failure = check_status(status, ARM_MATH_SUCCESS);
+            if (failure.empty())
+                failure = compare(out, expected, out_size, [](size_t) { return false; });
+            record(*path, name, describe(s), failure);
+        }
+    }
+}
+
+// Every tensor of the batch against the reference, with its own guard words
+template <typename Run>
+static std::string check_batch(const std::vector<std::vector<q15_t>> &expected, size_t out_size, Run run)
+{
+    std::vector<std::vector<q15_t>> outs(expected.size());
+    std::vector<q15_t *> out_ptrs;
+    for (std::vector<q15_t> &out : outs)
+    {
+        out = guarded(out_size);
+        out_ptrs.push_back(out.data());
+    }
+
+    std::string failure = check_status(run(out_ptrs.data()), ARM_MATH_SUCCESS);
+    for (size_t b = 0; b < outs.size() && failure.empty(); ++b)
+    {
+        failure = compare(outs[b], expected[b], out_size, [](size_t) { return false; });
+        if (!failure.empty())
+            failure = "tensor " + std::to_string(b) + ": " + failure;
+    }
+    return failure;
+}
+
+static void check_conv_batch(unsigned cases)
+{
+    for (unsigned n = 0; n < cases; ++n)
+    {
+        const conv_shape_t s = random_conv_shape(true);
+        const unsigned batch = 1 + rand_below(ARM_NN_BATCH_MAX);
+        const value_mode_t mode = static_cast<value_mode_t>(rand_below(VALUE_MODES));
+
+        const size_t in_size = static_cast<size_t>(s.in_x) * s.ch_in;
+        const size_t out_size = static_cast<size_t>(s.out_x) * s.ch_out;
+        const std::vector<q15_t> weights = random_values(static_cast<size_t>(s.ch_in) * s.k_x * s.ch_out, mode);
+        const std::vector<q15_t> bias = random_values(s.ch_out, mode == VALUES_EXTREME ? VALUES_EXTREME : VALUES_SMALL);
+        std::vector<std::vector<q15_t>> inputs, expected;
+        std::vector<const q15_t *> in_ptrs;
+        for (unsigned b = 0; b < batch; ++b)
+        {
+            inputs.push_back(random_values(in_size, mode));
+            expected.push_back(guarded(out_size));
+            reference_conv(s, inputs.back().data(), weights.data(), bias.data(), false, expected.back().data());
+        }
+        for (const std::vector<q15_t> &input : inputs)
+            in_ptrs.push_back(input.data());
+
+        for (const kernel_path_t *path : PATHS)
+        {
+            const std::string failure = check_batch(expected, out_size, [&](q15_t *const *out)
+                                                    { return path->conv_1_x_n_batch(
+                                                          in_ptrs.data(), s.in_x, s.in_y, s.ch_in, weights.data(), s.ch_out, s.k_x,
+                                                          s.k_y, s.pad_x, s.pad_y, s.stride_x, s.stride_y, bias.data(), s.bias_shift,
+                                                          s.out_shift, out, s.out_x, s.out_y, batch, nullptr, nullptr); });
+            record(*path, "conv_1_x_n_batch", describe(s) + ", batch " + std::to_string(batch), failure);
+        }
+    }
+}
+
+static void check_fc_batch(unsigned cases)
+{
+    for (unsigned n = 0; n < cases; ++n)
+    {
+        fc_shape_t s;
+        s.dim_vec = 1 + rand_below(n % 8 == 0 ? 2100 : 300);
+        s.rows = 1 + rand_below(n % 8 == 0 ? 9 : 40);
+        s.bias_shift = rand_below(16);
+        s.out_shift = rand_below(21);
+        const unsigned batch = 1 + rand_below(ARM_NN_BATCH_MAX);
+        const value_mode_t mode = static_cast<value_mode_t>(rand_below(VALUE_MODES));
+
+        const std::vector<q15_t> weights = random_values(static_cast<size_t>(s.dim_vec) * s.rows, mode);
+        const std::vector<q15_t> bias = random_values(s.rows, mode == VALUES_EXTREME ? VALUES_EXTREME : VALUES_SMALL);
+        std::vector<std::vector<q15_t>> vecs, expected;
+        std::vector<const q15_t *> vec_ptrs;
+        for (unsigned b = 0; b < batch; ++b)
+        {
+            vecs.push_back(random_values(s.dim_vec, mode));
+            expected.push_back(guarded(s.rows));
+            reference_fc(s, vecs.back().data(), weights.data(), bias.data(), false, expected.back().data());
+        }
+        for (const std::vector<q15_t> &vec : vecs)
+            vec_ptrs.push_back(vec.data());
+
+        for (const kernel_path_t *path : PATHS)
+        {
+            const std::string failure = check_batch(expected, s.rows, [&](q15_t *const *out)
+                                                    { return path->fc_batch(vec_ptrs.data(), weights.data(), s.dim_vec, s.rows,
+                                                                            s.bias_shift, s.out_shift, bias.data(), out, batch,
+                                                                            nullptr); });
+            record(*path, "fc_batch", describe(s) + ", batch " + std::to_string(batch), failure);
+        }
+    }
+}
+
+static void check_relu(unsigned cases)
+{
+    for (unsigned n = 0; n < cases; ++n)
+    {
+        const uint16_t size = rand_below(n % 4 == 0 ? 5000 : 100);
+        const std::vector<q15_t> input = random_values(size, static_cast<value_mode_t>(rand_below(VALUE_MODES)));
+
+        std::vector<q15_t> expected = guarded(size);
+        for (uint16_t i = 0; i < size; ++i)
+            expected[i] = std::max<q15_t>(input[i], 0);
+
+        for (const kernel_path_t *path : PATHS)
+        {
+            std::vector<q15_t> data = guarded(size);
+            std::copy(input.begin(), input.end(), data.begin());
+            path->relu(data.data(), size);
+            record(*path, "relu", "size " + std::to_string(size), compare(data, expected, size, [](size_t) { return false; }));
+        }
+    }
+}
+
+// q7 convolutions: the basic kernel on any shape, the fast one on shapes mostly rounded to its
+// constraints (ch_im_in multiple of 4, ch_im_out even) and rejecting the others
+static void check_conv_q7(unsigned cases)
+{
+    for (unsigned n = 0; n < cases; ++n)
+    {
+        const bool fast = n % 2;
+        conv_shape_t s = random_conv_shape(rand_below(3) == 0);
+        if (fast && rand_below(4) != 0)
+        {
+            s.ch_in = (s.ch_in + 3) / 4 * 4;
+            s.ch_out += s.ch_out % 2;
+        }
+        s.out_shift = rand_below(16);
+        const bool relu = rand_below(2);
+        const value_mode_t mode = static_cast<value_mode_t>(rand_below(VALUE_MODES));
+
+        const size_t in_size = static_cast<size_t>(s.in_x) * s.in_y * s.ch_in;
+        const size_t out_size = static_cast<size_t>(s.out_x) * s.out_y * s.ch_out;
+        const size_t col_len = static_cast<size_t>(s.ch_in) * s.k_x * s.k_y;
+        const std::vector<q7_t> input = random_values<q7_t>(in_size, mode);
+        const std::vector<q7_t> weights = random_values<q7_t>(col_len * s.ch_out, mode);
+        const std::vector<q7_t> bias = random_values<q7_t>(s.ch_out, mode == VALUES_EXTREME ? VALUES_EXTREME : VALUES_SMALL);
+
+        const arm_status expected_status =
+            fast && (s.ch_in % 4 != 0 || s.ch_out % 2 != 0) ? ARM_MATH_SIZE_MISMATCH : ARM_MATH_SUCCESS;
+        std::vector<q7_t> expected = guarded<q7_t>(out_size);
+        if (expected_status == ARM_MATH_SUCCESS)
+            reference_conv(s, input.data(), weights.data(), bias.data(), relu, expected.data());
+
+        for (const kernel_path_t *path : PATHS)
+        {
+            // Documented bufferA sizes, in q15_t
+            const size_t buffer_size = fast ? 2 * col_len : col_len;
+            std::vector<q7_t> out = guarded<q7_t>(out_size);
+            std::vector<q15_t> buffer = guarded(buffer_size);
+            const char *name =
+                fast ? (relu ? "conv_q7_fast_relu" : "conv_q7_fast") : (relu ? "conv_q7_basic_relu" : "conv_q7_basic");
+            const conv_q7_fn conv = fast ? (relu ? path->conv_q7_fast_relu : path->conv_q7_fast)
+                                         : (relu ? path->conv_q7_basic_relu : path->conv_q7_basic);
+            const arm_status status = conv(input.data(), s.in_x, s.in_y, s.ch_in, weights.data(), s.ch_out, s.k_x, s.k_y,
+                                           s.pad_x, s.pad_y, s.stride_x, s.stride_y, bias.data(), s.bias_shift, s.out_shift,
+                                           out.data(), s.out_x, s.out_y, buffer.data(), nullptr);
+
+            std::string failure = check_status(status, expected_status);
+            if (failure.empty())
+                failure = compare(out, expected, out_size, [](size_t) { return false; });
+            if (failure.empty() && !guard_intact(buffer, buffer_size))
+                failure = "wrote past the documented bufferA size";
+            record(*path, name, describe(s), failure);
+        }
+    }
+}
+
+// Row-major q7 weights in the arm_fully_connected_q7_opt() layout: per group of four rows, 16
+// values per block of four columns, then one value per row for each left-over column; the
+// left-over rows stay row-major
+static std::vector<q7_t> interleave_q7_opt(const std::vector<q7_t> &wt, int dim_vec, int rows)
+{
+    static constexpr int ROW[16] = {0, 1, 0, 1, 2, 3, 2, 3, 0, 1, 0, 1, 2, 3, 2, 3};
+    static constexpr int COL[16] = {0, 0, 2, 2, 0, 0, 2, 2, 1, 1, 3, 3, 1, 1, 3, 3};
+    std::vector<q7_t> out;
+    out.reserve(wt.size());
+    int r = 0;
+    for (; r + 4 <= rows; r += 4)
+    {
+        int k = 0;
+        for (; k + 4 <= dim_vec; k += 4)
+            for (int i = 0; i < 16; ++i)
+                out.push_back(wt[(r + ROW[i]) * dim_vec + k + COL[i]]);
+        for (; k < dim_vec; ++k)
+            for (int i = 0; i < 4; ++i)
+                out.push_back(wt[(r + i) * dim_vec + k]);
+    }
+    out.insert(out.end(), wt.begin() + r * dim_vec, wt.end());
+    return out;
+}
+
+static void check_fc_q7(unsigned cases)
+{
+    for (unsigned n = 0; n < cases; ++n)
+    {
+        fc_shape_t s;
+        s.dim_vec = 1 + rand_below(n % 8 == 0 ? 2100 : 300);
+        s.rows = 1 + rand_below(n % 8 == 0 ? 9 : 40);
+        s.bias_shift = rand_below(16);
+        s.out_shift = rand_below(16);
+        const bool opt = n % 2;
+        const bool relu = rand_below(2);
+        const value_mode_t mode = static_cast<value_mode_t>(rand_below(VALUE_MODES));
+
+        const std::vector<q7_t> vec = random_values<q7_t>(s.dim_vec, mode);
+        const std::vector<q7_t> weights = random_values<q7_t>(static_cast<size_t>(s.dim_vec) * s.rows, mode);
+        const std::vector<q7_t> bias = random_values<q7_t>(s.rows, mode == VALUES_EXTREME ? VALUES_EXTREME : VALUES_SMALL);
+        const std::vector<q7_t> interleaved = opt ? interleave_q7_opt(weights, s.dim_vec, s.rows) : weights;
+
+        std::vector<q7_t> expected = guarded<q7_t>(s.rows);
+        reference_fc(s, vec.data(), weights.data(), bias.data(), relu, expected.data());
+
+        for (const kernel_path_t *path : PATHS)
+        {
+            std::vector<q7_t> out = guarded<q7_t>(s.rows);
+            std::vector<q15_t> buffer = guarded(s.dim_vec);
+            const char *name = opt ? (relu ? "fc_q7_opt_relu" : "fc_q7_opt") : (relu ? "fc_q7_relu" : "fc_q7");
+            const fc_q7_fn fc = opt ? (relu ? path->fc_q7_opt_relu : path->fc_q7_opt) : (relu ? path->fc_q7_relu : path->fc_q7);
+            const arm_status status = fc(vec.data(), interleaved.data(), s.dim_vec, s.rows, s.bias_shift, s.out_shift,
+                                         bias.data(), out.data(), buffer.data());
+
+            std::string failure = check_status(status, ARM_MATH_SUCCESS);
+            if (failure.empty())
+                failure = compare(out, expected, s.rows, [](size_t) { return false; });
+            if (failure.empty() && !guard_intact(buffer, s.dim_vec))
+                failure = "wrote past vec_buffer";
+            record(*path, name, describe(s), failure);
+        }
+    }
+}
+
+static void check_relu_q7(unsigned cases)
+{
+    for (unsigned n = 0; n < cases; ++n)
+    {
+        const uint16_t size = rand_below(n % 4 == 0 ? 5000 : 100);
+        const std::vector<q7_t> input = random_values<q7_t>(size, static_cast<value_mode_t>(rand_below(VALUE_MODES)));
+
+        std::vector<q7_t> expected = guarded<q7_t>(size);
+        for (uint16_t i = 0; i < size; ++i)
+            expected[i] = std::max<q7_t>(input[i], 0);
+
+        for (const kernel_path_t *path : PATHS)
+        {
+            std::vector<q7_t> data = guarded<q7_t>(size);
+            std::copy(input.begin(), input.end(), data.begin());
+            path->relu_q7(data.data(), size);
+            record(*path, "relu_q7", "size " + std::to_string(size), compare(data, expected, size, [](size_t) { return false; }));
+        }
+    }
+}
+
+// Square windows clipped to the input, -128 when a window lies entirely in the padding
+static void check_maxpool_q7(unsigned cases)
+{
+    for (unsigned n = 0; n < cases; ++n)
+    {
+        const int dim_kernel = 1 + rand_below(4);
+        const int padding = rand_below(dim_kernel);
+        const int stride = 1 + rand_below(3);
+        const int dim_in = std::max<int>(dim_kernel - 2 * padding, 1 + rand_below(12));
+        const int dim_out = (dim_in + 2 * padding - dim_kernel) / stride + 1;
+        const int ch = 1 + rand_below(n % 4 == 0 ? 80 : 20);
+        const std::vector<q7_t> input =
+            random_values<q7_t>(static_cast<size_t>(dim_in) * dim_in * ch, static_cast<value_mode_t>(rand_below(VALUE_MODES)));
+        const size_t out_size = static_cast<size_t>(dim_out) * dim_out * ch;
+
+        std::vector<q7_t> expected = guarded<q7_t>(out_size);
+        for (int oy = 0; oy < dim_out; ++oy)
+            for (int ox = 0; ox < dim_out; ++ox)
+                for (int c = 0; c < ch; ++c)
+                {
+                    int max = -128;
+                    for (int y = oy * stride - padding; y < oy * stride - padding + dim_kernel; ++y)
+                        for (int x = ox * stride - padding; x < ox * stride - padding + dim_kernel; ++x)
+                            if (y >= 0 && y < dim_in && x >= 0 && x < dim_in)
+                                max = std::max<int>(max, input[(y * dim_in + x) * ch + c]);
+                    expected[(oy * dim_out + ox) * ch + c] = static_cast<q7_t>(max);
+                }
+
+        char shape[96];
+        snprintf(shape, sizeof(shape), "in %dx%dx%d, k %d, pad %d, stride %d, out %d", dim_in, dim_in, ch, dim_kernel, padding,
+                 stride, dim_out);
+        for (const kernel_path_t *path : PATHS)
+        {
+            std::vector<q7_t> in = input;
+            std::vector<q7_t> out = guarded<q7_t>(out_size);
+            path->maxpool_q7(in.data(), dim_in, ch, dim_kernel, padding, stride, dim_out, nullptr, out.data());
+            std::string failure = compare(out, expected, out_size, [](size_t) { return false; });
+            if (failure.empty() && in != input)
+                failure = "modified Im_in";
+            record(*path, "maxpool_q7", shape, failure);
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const unsigned cases = argc > 1 ? strtoul(argv[1], nullptr, 10) : 4000;
+    const unsigned seed = argc > 2 ? strtoul(argv[2], nullptr, 10) : 1;
+    rng.seed(seed);
+
+    check_conv(cases);
+    check_fc(cases);
+    check_conv_batch(cases / 4);
+    check_fc_batch(cases / 4);
+    check_relu(cases);
+    check_conv_q7(cases);
+    check_fc_q7(cases);
+    check_relu_q7(cases);
+    check_maxpool_q7(cases);
+
+    std::stable_sort(stats.begin(), stats.end(), [](const kernel_stats_t &a, const kernel_stats_t &b) { return a.kernel < b.kernel; });
+    unsigned failures = 0;
+    printf("%-12s %-20s %8s %8s\n", "path", "kernel", "cases", "failures");
+    for (const kernel_stats_t &k : stats)
+    {
+        printf("%-12s %-20s %8u %8u\n", k.path.c_str(), k.kernel.c_str(), k.cases, k.failures);
+        failures += k.failures;
+    }
+    if (failures)
+    {
+        printf("%u cases differ from the reference arithmetic (seed %u)\n", failures, seed);
+        return 1;
+    }
+    printf("All paths bit-exact with the reference arithmetic (seed %u)\n", seed);
+    return 0;
+}
@@ -0,0 +1,83 @@
+/* kernel_path.c */
+
+/* One path of the CMSIS kernels for kernel_conformance, built with -DKERNEL_PATH=<name> and the
+ * flags that select the path. The kernel sources are compiled in here like the generated model
+ * does, with the public names suffixed by the path name so several builds link side by side. */
+
+#define KERNEL_PATH_CAT2(name, path) name##_##path
+#define KERNEL_PATH_CAT(name, path) KERNEL_PATH_CAT2(name, path)
+#define KERNEL_PATH_SYM(name) KERNEL_PATH_CAT(name, KERNEL_PATH)
+#define KERNEL_PATH_STR2(path) #path
+#define KERNEL_PATH_STR(path) KERNEL_PATH_STR2(path)
+
+#define arm_convolve_HWC_q15_basic_nonsquare KERNEL_PATH_SYM(arm_convolve_HWC_q15_basic_nonsquare)
+#define arm_convolve_HWC_q15_basic_nonsquare_relu KERNEL_PATH_SYM(arm_convolve_HWC_q15_basic_nonsquare_relu)
+#define arm_convolve_HWC_q15_fast_nonsquare KERNEL_PATH_SYM(arm_convolve_HWC_q15_fast_nonsquare)
+#define arm_convolve_HWC_q15_fast_nonsquare_relu KERNEL_PATH_SYM(arm_convolve_HWC_q15_fast_nonsquare_relu)
+#define arm_convolve_1_x_n_HWC_q15 KERNEL_PATH_SYM(arm_convolve_1_x_n_HWC_q15)
+#define arm_convolve_1_x_n_HWC_q15_relu KERNEL_PATH_SYM(arm_convolve_1_x_n_HWC_q15_relu)
+#define arm_convolve_1_x_n_HWC_q15_batch KERNEL_PATH_SYM(arm_convolve_1_x_n_HWC_q15_batch)
+#define arm_convolve_HWC_q15_fast_nonsquare_tiled KERNEL_PATH_SYM(arm_convolve_HWC_q15_fast_nonsquare_tiled)
+#define arm_convolve_HWC_q15_fast_nonsquare_tiled_relu KERNEL_PATH_SYM(arm_convolve_HWC_q15_fast_nonsquare_tiled_relu)
+#define arm_fully_connected_q15 KERNEL_PATH_SYM(arm_fully_connected_q15)
+#define arm_fully_connected_q15_relu KERNEL_PATH_SYM(arm_fully_connected_q15_relu)
+#define arm_fully_connected_q15_batch KERNEL_PATH_SYM(arm_fully_connected_q15_batch)
+#define arm_relu_q15 KERNEL_PATH_SYM(arm_relu_q15)
+#define arm_convolve_HWC_q7_basic_nonsquare KERNEL_PATH_SYM(arm_convolve_HWC_q7_basic_nonsquare)
+#define arm_convolve_HWC_q7_basic_nonsquare_relu KERNEL_PATH_SYM(arm_convolve_HWC_q7_basic_nonsquare_relu)
+#define arm_convolve_HWC_q7_fast_nonsquare KERNEL_PATH_SYM(arm_convolve_HWC_q7_fast_nonsquare)
+#define arm_convolve_HWC_q7_fast_nonsquare_relu KERNEL_PATH_SYM(arm_convolve_HWC_q7_fast_nonsquare_relu)
+#define arm_fully_connected_q7 KERNEL_PATH_SYM(arm_fully_connected_q7)
+#define arm_fully_connected_q7_relu KERNEL_PATH_SYM(arm_fully_connected_q7_relu)
+#define arm_fully_connected_q7_opt KERNEL_PATH_SYM(arm_fully_connected_q7_opt)
+#define arm_fully_connected_q7_opt_relu KERNEL_PATH_SYM(arm_fully_connected_q7_opt_relu)
+#define arm_relu_q7 KERNEL_PATH_SYM(arm_relu_q7)
+#define arm_maxpool_q7_HWC KERNEL_PATH_SYM(arm_maxpool_q7_HWC)
+
+#include "kernel_path.h"
+
+#include "arm_relu_q15.c"
+#include "arm_convolve_HWC_q15_basic_nonsquare.c"
+#include "arm_convolve_HWC_q15_fast_nonsquare.c"
+#include "arm_convolve_1_x_n_HWC_q15.c"
+#include "arm_convolve_HWC_q15_fast_nonsquare_tiled.c"
+#include "arm_fully_connected_q15.c"
+#include "arm_relu_q7.c"
+#include "arm_convolve_HWC_q7_basic_nonsquare.c"
+#include "arm_convolve_HWC_q7_fast_nonsquare.c"
+#include "arm_fully_connected_q7.c"
+#include "arm_fully_connected_q7_opt.c"
+#include "arm_maxpool_q7_HWC.c"
+
+static int32_t conv_fast_tiled_buffer_size(int32_t ch_im_in, int32_t dim_kernel_x, int32_t dim_kernel_y, int32_t ch_im_out)
+{
+    return ARM_NN_CONV_Q15_TILED_BUFFER_SIZE(ch_im_in, dim_kernel_x, dim_kernel_y, ch_im_out);
+}
+
+const kernel_path_t KERNEL_PATH_SYM(kernel_path) = {
+    KERNEL_PATH_STR(KERNEL_PATH),
+    arm_convolve_HWC_q15_basic_nonsquare,
+    arm_convolve_HWC_q15_basic_nonsquare_relu,
+    arm_convolve_HWC_q15_fast_nonsquare,
+    arm_convolve_HWC_q15_fast_nonsquare_relu,
+    arm_convolve_1_x_n_HWC_q15,
+    arm_convolve_1_x_n_HWC_q15_relu,
+    arm_convolve_1_x_n_HWC_q15_batch,
+    arm_convolve_HWC_q15_fast_nonsquare_tiled,
+    arm_convolve_HWC_q15_fast_nonsquare_tiled_relu,
+    conv_fast_tiled_buffer_size,
+    arm_fully_connected_q15,
+    arm_fully_connected_q15_relu,
+    arm_fully_connected_q15_batch,
+    arm_relu_q15,
+    arm_convolve_HWC_q7_basic_nonsquare,
+    arm_convolve_HWC_q7_basic_nonsquare_relu,
+    arm_convolve_HWC_q7_fast_nonsquare,
+    arm_convolve_HWC_q7_fast_nonsquare_relu,
+    arm_fully_connected_q7,
+    arm_fully_connected_q7_relu,
+    arm_fully_connected_q7_opt,
+    arm_fully_connected_q7_opt_relu,
+    arm_relu_q7,
+    arm_maxpool_q7_HWC,
+};
@@ -0,0 +1,86 @@
+/* kernel_path.h */
+
+/* Entry points of one build of the CMSIS kernels, for kernel_conformance. tools/kernel_path.c
+ * compiles the kernel sources once per path (NEON, __SMLAD, x86, reference) with its symbols
+ * suffixed by the path name and exports them through a kernel_path_<name> table. */
+
+#pragma once
+
+#include "arm_nnfunctions.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef arm_status (*conv_q15_fn)(const q15_t *Im_in, uint16_t dim_im_in_x, uint16_t dim_im_in_y, uint16_t ch_im_in,
+                                  const q15_t *wt, uint16_t ch_im_out, uint16_t dim_kernel_x, uint16_t dim_kernel_y,
+                                  uint16_t padding_x, uint16_t padding_y, uint16_t stride_x, uint16_t stride_y,
+                                  const q15_t *bias, uint16_t bias_shift, uint16_t out_shift, q15_t *Im_out,
+                                  uint16_t dim_im_out_x, uint16_t dim_im_out_y, q15_t *bufferA, q7_t *bufferB);
+
+typedef arm_status (*fc_q15_fn)(const q15_t *pV, const q15_t *pM, uint16_t dim_vec, uint16_t num_of_rows,
+                                uint16_t bias_shift, uint16_t out_shift, const q15_t *bias, q15_t *pOut,
+                                q15_t *vec_buffer);
+
+typedef void (*relu_q15_fn)(q15_t *data, uint16_t size);
+
+typedef arm_status (*conv_q15_batch_fn)(const q15_t *const *Im_in, uint16_t dim_im_in_x, uint16_t dim_im_in_y,
+                                        uint16_t ch_im_in, const q15_t *wt, uint16_t ch_im_out, uint16_t dim_kernel_x,
+                                        uint16_t dim_kernel_y, uint16_t padding_x, uint16_t padding_y, uint16_t stride_x,
+                                        uint16_t stride_y, const q15_t *bias, uint16_t bias_shift, uint16_t out_shift,
+                                        q15_t *const *Im_out, uint16_t dim_im_out_x, uint16_t dim_im_out_y,
+                                        uint16_t batch, q15_t *bufferA, q7_t *bufferB);
+
+typedef arm_status (*fc_q15_batch_fn)(const q15_t *const *pV, const q15_t *pM, uint16_t dim_vec, uint16_t num_of_rows,
+                                      uint16_t bias_shift, uint16_t out_shift, const q15_t *bias, q15_t *const *pOut,
+                                      uint16_t batch, q15_t *vec_buffer);
+
+typedef arm_status (*conv_q7_fn)(const q7_t *Im_in, uint16_t dim_im_in_x, uint16_t dim_im_in_y, uint16_t ch_im_in,
+                                 const q7_t *wt, uint16_t ch_im_out, uint16_t dim_kernel_x, uint16_t dim_kernel_y,
+                                 uint16_t padding_x, uint16_t padding_y, uint16_t stride_x, uint16_t stride_y,
+                                 const q7_t *bias, uint16_t bias_shift, uint16_t out_shift, q7_t *Im_out,
+                                 uint16_t dim_im_out_x, uint16_t dim_im_out_y, q15_t *bufferA, q7_t *bufferB);
+
+typedef arm_status (*fc_q7_fn)(const q7_t *pV, const q7_t *pM, uint16_t dim_vec, uint16_t num_of_rows,
+                               uint16_t bias_shift, uint16_t out_shift, const q7_t *bias, q7_t *pOut,
+                               q15_t *vec_buffer);
+
+typedef void (*relu_q7_fn)(q7_t *data, uint16_t size);
+
+typedef void (*maxpool_q7_fn)(q7_t *Im_in, uint16_t dim_im_in, uint16_t ch_im_in, uint16_t dim_kernel, uint16_t padding,
+                              uint16_t stride, uint16_t dim_im_out, q7_t *bufferA, q7_t *Im_out);
+
+typedef int32_t (*conv_q15_buffer_size_fn)(int32_t ch_im_in, int32_t dim_kernel_x, int32_t dim_kernel_y, int32_t ch_im_out);
+
+typedef struct
+{
+    const char *name;
+    conv_q15_fn conv_basic;
+    conv_q15_fn conv_basic_relu;
+    conv_q15_fn conv_fast;
+    conv_q15_fn conv_fast_relu;
+    conv_q15_fn conv_1_x_n;
+    conv_q15_fn conv_1_x_n_relu;
+    conv_q15_batch_fn conv_1_x_n_batch;
+    conv_q15_fn conv_fast_tiled;
+    conv_q15_fn conv_fast_tiled_relu;
+    conv_q15_buffer_size_fn conv_fast_tiled_buffer_size; /* bufferA size for this path's ARM_NN_L1_TILE_BYTES */
+    fc_q15_fn fc;
+    fc_q15_fn fc_relu;
+    fc_q15_batch_fn fc_batch;
+    relu_q15_fn relu;
+    conv_q7_fn conv_q7_basic;
+    conv_q7_fn conv_q7_basic_relu;
+    conv_q7_fn conv_q7_fast;
+    conv_q7_fn conv_q7_fast_relu;
+    fc_q7_fn fc_q7;
+    fc_q7_fn fc_q7_relu;
+    fc_q7_fn fc_q7_opt; /* weights interleaved by four rows, see arm_fully_connected_q7_opt() */
+    fc_q7_fn fc_q7_opt_relu;
+    relu_q7_fn relu_q7;
+    maxpool_q7_fn maxpool_q7;
+} kernel_path_t;
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,91 @@
+#!/usr/bin/env python3
+# model_shapes.py
+#
+# Lists the layer shapes of a generated model for bench_kernels: reads the preprocessed model
+# sources on stdin, so the layer macros of the generated headers are already expanded, and writes
+# one kernel_shape_t initializer per distinct convolution, fully connected and ReLU call.
+#
+#   gcc -E $(CFLAGS) model/*.c | model_shapes.py > model/kernel_shapes.inc
+#
+# Calls made from the CMSIS sources the model includes are skipped, as are calls whose shape
+# arguments do not reduce to integer constants.
+
+import re
+import sys
+
+from fuse_relu import split_args
+
+# Kernel name -> (kernel_id_t, kernel_shape_t field -> argument index). The *_relu variants time
+# like the kernel they derive from.
+CONV_ARGS = {"in_x": 1, "in_y": 2, "ch_in": 3, "ch_out": 5, "k_x": 6, "k_y": 7, "pad_x": 8, "pad_y": 9,
+             "stride_x": 10, "stride_y": 11, "out_x": 16, "out_y": 17}
+KERNELS = {
+    "arm_convolve_HWC_q15_basic_nonsquare": ("KERNEL_CONV_BASIC", CONV_ARGS),
+    "arm_convolve_HWC_q15_fast_nonsquare": ("KERNEL_CONV_FAST", CONV_ARGS),
+    "arm_fully_connected_q15": ("KERNEL_FC", {"dim_vec": 2, "rows": 3}),
+    "arm_relu_q15": ("KERNEL_RELU", {"size": 1}),
+}
+FIELDS = list(CONV_ARGS) + ["dim_vec", "rows", "size"]
+
+CALL = re.compile(r"\b(" + "|".join(KERNELS) + r")(?:_relu)?\s*\(")
+LINEMARKER = re.compile(r'^#\s*(\d+)\s+"([^"]*)"', re.M)
+CAST = re.compile(r"\(\s*(?:const\s+)?(?:u?int\d+_t|q\d+_t|(?:unsigned\s+|signed\s+)?(?:int|short|long|char))\s*\)")
+SUFFIX = re.compile(r"\b(\d+)[uUlL]+\b")
+CONSTANT = re.compile(r"^[0-9\s+\-*/%()<>]+$")
+
+
+def evaluate(expr):
+    """Value of an integer constant expression, None when it is anything else."""
+    expr = SUFFIX.sub(r"\1", CAST.sub("", expr)).strip()
+    if not expr or not CONSTANT.match(expr):
+        return None
+    try:
+        value = eval(expr.replace("/", "//"), {"__builtins__": {}})
+    except (SyntaxError, ZeroDivisionError, TypeError):
+        return None
+    return value if isinstance(value, int) and 0 <= value < 65536 else None
+
+
+def locate(source, offset, markers):
+    """File and line of an offset of the preprocessed source, from the last linemarker before it."""
+    name, line, start = "<stdin>", 1, 0
+    for marker in markers:
+        if marker.start() > offset:
+            break
+        name, line, start = marker.group(2), int(marker.group(1)), source.find("\n", marker.end()) + 1
+    return name, line + source.count("\n", start, offset)
+
+
+def shapes(source):
+    markers = list(LINEMARKER.finditer(source))
+    found, seen = [], set()
+    for call in CALL.finditer(source):
+        name, line = locate(source, call.start(), markers)
+        if "CMSIS" in name or name.startswith("<"):
+            continue
+        kernel, fields = KERNELS[call.group(1)]
+        args, _ = split_args(source, call.end())
+        if len(args) <= max(fields.values()):
+            continue
+        values = {field: evaluate(args[index]) for field, index in fields.items()}
+        if None in values.values():
+            continue
+        key = (kernel,) + tuple(sorted(values.items()))
+        if key in seen:
+            continue
+        seen.add(key)
+        found.append((kernel, "%s:%d" % (name, line), values))
+    return found
+
+
+def main():
+    source = sys.stdin.read()
+    print("// Generated by tools/model_shapes.py from the preprocessed model sources, do not edit")
+    for kernel, where, values in shapes(source):
+        fields = ", ".join(".%s = %d" % (field, values[field]) for field in FIELDS if field in values)
+        print('{.kernel = %s, .source = "%s", %s},' % (kernel, where, fields))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,143 @@
+/* arm_neon.h */
+
+/* Host stand-in for the ARMv7 NEON intrinsics the CMSIS kernels use, so kernel_conformance_host can
+ * build the ARM_MATH_NEON paths with the x86 compiler (-I tools/neon_emu). Lanes are GCC vectors and
+ * every intrinsic is a plain loop with the NEON semantics: adds and multiply-accumulates wrap mod 2^32,
+ * vqmovn saturates, vrshr rounds. Only for checking, the board build uses the compiler's arm_neon.h. */
+
+#pragma once
+
+#include <stdint.h>
+typedef int8_t int8x8_t __attribute__((vector_size(8)));
+typedef int8_t int8x16_t __attribute__((vector_size(16)));
+typedef uint8_t uint8x8_t __attribute__((vector_size(8)));
+typedef uint8_t uint8x16_t __attribute__((vector_size(16)));
+typedef int16_t int16x4_t __attribute__((vector_size(8)));
+typedef int16_t int16x8_t __attribute__((vector_size(16)));
+typedef uint16_t uint16x4_t __attribute__((vector_size(8)));
+typedef uint16_t uint16x8_t __attribute__((vector_size(16)));
+typedef int32_t int32x2_t __attribute__((vector_size(8)));
+typedef int32_t int32x4_t __attribute__((vector_size(16)));
+typedef uint32_t uint32x4_t __attribute__((vector_size(16)));
+typedef uint32_t uint32x2_t __attribute__((vector_size(8)));
+typedef int64_t int64x2_t __attribute__((vector_size(16)));
+typedef uint64_t uint64x2_t __attribute__((vector_size(16)));
+typedef int64_t int64x1_t __attribute__((vector_size(8)));
+typedef float float32x4_t __attribute__((vector_size(16)));
+typedef float float32x2_t __attribute__((vector_size(8)));
+typedef struct { float32x4_t val[2]; } float32x4x2_t;
+typedef struct { float32x4_t val[3]; } float32x4x3_t;
+typedef struct { float32x4_t val[4]; } float32x4x4_t;
+typedef struct { float32x2_t val[2]; } float32x2x2_t;
+typedef struct { float32x2_t val[3]; } float32x2x3_t;
+typedef struct { float32x2_t val[4]; } float32x2x4_t;
+
+typedef struct { int32x4_t val[2]; } int32x4x2_t;
+typedef struct { int32x4_t val[3]; } int32x4x3_t;
+typedef struct { int32x4_t val[4]; } int32x4x4_t;
+typedef struct { int16x8_t val[2]; } int16x8x2_t;
+typedef struct { int16x8_t val[3]; } int16x8x3_t;
+typedef struct { int16x8_t val[4]; } int16x8x4_t;
+typedef struct { int8x16_t val[2]; } int8x16x2_t;
+typedef struct { int8x16_t val[3]; } int8x16x3_t;
+typedef struct { int8x16_t val[4]; } int8x16x4_t;
+typedef struct { int32x2_t val[2]; } int32x2x2_t;
+typedef struct { int32x2_t val[3]; } int32x2x3_t;
+typedef struct { int32x2_t val[4]; } int32x2x4_t;
+typedef struct { int16x4_t val[2]; } int16x4x2_t;
+typedef struct { int16x4_t val[3]; } int16x4x3_t;
+typedef struct { int16x4_t val[4]; } int16x4x4_t;
+typedef struct { int8x8_t val[2]; } int8x8x2_t;
+typedef struct { int8x8_t val[3]; } int8x8x3_t;
+typedef struct { int8x8_t val[4]; } int8x8x4_t;
+
+#define EMU static inline
+EMU int16x8_t vld1q_s16(const int16_t *p){ int16x8_t r; for(int i=0;i<8;i++) r[i]=p[i]; return r; }
+EMU int16x4_t vld1_s16(const int16_t *p){ int16x4_t r; for(int i=0;i<4;i++) r[i]=p[i]; return r; }
+EMU void vst1q_s16(int16_t *p, int16x8_t v){ for(int i=0;i<8;i++) p[i]=v[i]; }
+EMU void vst1_s16(int16_t *p, int16x4_t v){ for(int i=0;i<4;i++) p[i]=v[i]; }
+EMU int8x16_t vld1q_s8(const int8_t *p){ int8x16_t r; for(int i=0;i<16;i++) r[i]=p[i]; return r; }
+EMU int8x8_t vld1_s8(const int8_t *p){ int8x8_t r; for(int i=0;i<8;i++) r[i]=p[i]; return r; }
+EMU void vst1q_s8(int8_t *p, int8x16_t v){ for(int i=0;i<16;i++) p[i]=v[i]; }
+EMU void vst1_s8(int8_t *p, int8x8_t v){ for(int i=0;i<8;i++) p[i]=v[i]; }
+EMU int16x4_t vget_low_s16(int16x8_t v){ int16x4_t r={v[0],v[1],v[2],v[3]}; return r; }
+EMU int16x4_t vget_high_s16(int16x8_t v){ int16x4_t r={v[4],v[5],v[6],v[7]}; return r; }
+EMU int32x2_t vget_low_s32(int32x4_t v){ int32x2_t r={v[0],v[1]}; return r; }
+EMU int32x2_t vget_high_s32(int32x4_t v){ int32x2_t r={v[2],v[3]}; return r; }
+EMU int8x8_t vget_low_s8(int8x16_t v){ int8x8_t r; for(int i=0;i<8;i++) r[i]=v[i]; return r; }
+EMU int8x8_t vget_high_s8(int8x16_t v){ int8x8_t r; for(int i=0;i<8;i++) r[i]=v[i+8]; return r; }
+EMU int32x4_t vdupq_n_s32(int32_t x){ int32x4_t r={x,x,x,x}; return r; }
+EMU int16x8_t vdupq_n_s16(int16_t x){ int16x8_t r={x,x,x,x,x,x,x,x}; return r; }
+EMU int16x4_t vdup_n_s16(int16_t x){ int16x4_t r={x,x,x,x}; return r; }
+EMU int8x16_t vdupq_n_s8(int8_t x){ int8x16_t r; for(int i=0;i<16;i++) r[i]=x; return r; }
+EMU int32x4_t vmlal_s16(int32x4_t a, int16x4_t b, int16x4_t c){ int32x4_t r; for(int i=0;i<4;i++) r[i]=(int32_t)((uint32_t)a[i]+(uint32_t)((int32_t)b[i]*c[i])); return r; }
+EMU int32x4_t vmull_s16(int16x4_t b, int16x4_t c){ int32x4_t r; for(int i=0;i<4;i++) r[i]=(int32_t)b[i]*c[i]; return r; }
+EMU int32x4_t vmlal_n_s16(int32x4_t a, int16x4_t b, int16_t c){ return vmlal_s16(a,b,vdup_n_s16(c)); }
+EMU int32x4_t vmlal_lane_s16_f(int32x4_t a, int16x4_t b, int16x4_t c, int l){ return vmlal_s16(a,b,vdup_n_s16(c[l])); }
+#define vmlal_lane_s16(a,b,c,l) vmlal_lane_s16_f(a,b,c,l)
+EMU int32x4_t vaddq_s32(int32x4_t a, int32x4_t b){ int32x4_t r; for(int i=0;i<4;i++) r[i]=(int32_t)((uint32_t)a[i]+(uint32_t)b[i]); return r; }
+EMU int32x2_t vpadd_s32(int32x2_t a, int32x2_t b){ int32x2_t r={(int32_t)((uint32_t)a[0]+(uint32_t)a[1]),(int32_t)((uint32_t)b[0]+(uint32_t)b[1])}; return r; }
+EMU int32x2_t vadd_s32(int32x2_t a, int32x2_t b){ int32x2_t r={(int32_t)((uint32_t)a[0]+(uint32_t)b[0]),(int32_t)((uint32_t)a[1]+(uint32_t)b[1])}; return r; }
+EMU int32_t vget_lane_s32_f(int32x2_t v, int l){ return v[l]; }
+#define vget_lane_s32(v,l) vget_lane_s32_f(v,l)
+EMU int32_t vgetq_lane_s32_f(int32x4_t v, int l){ return v[l]; }
+#define vgetq_lane_s32(v,l) vgetq_lane_s32_f(v,l)
+EMU int32x4_t vshlq_s32(int32x4_t a, int32x4_t s){ int32x4_t r; for(int i=0;i<4;i++) r[i]= s[i]>=0 ? (int32_t)((uint32_t)a[i]<<s[i]) : (a[i]>>(-s[i])); return r; }
+EMU int16x4_t vqmovn_s32(int32x4_t a){ int16x4_t r; for(int i=0;i<4;i++) r[i]= a[i]>32767?32767:a[i]<-32768?-32768:a[i]; return r; }
+EMU int16x8_t vcombine_s16(int16x4_t a, int16x4_t b){ int16x8_t r={a[0],a[1],a[2],a[3],b[0],b[1],b[2],b[3]}; return r; }
+EMU int16x8_t vmaxq_s16(int16x8_t a, int16x8_t b){ int16x8_t r; for(int i=0;i<8;i++) r[i]=a[i]>b[i]?a[i]:b[i]; return r; }
+EMU int16x4_t vmax_s16(int16x4_t a, int16x4_t b){ int16x4_t r; for(int i=0;i<4;i++) r[i]=a[i]>b[i]?a[i]:b[i]; return r; }
+EMU int8x16_t vmaxq_s8(int8x16_t a, int8x16_t b){ int8x16_t r; for(int i=0;i<16;i++) r[i]=a[i]>b[i]?a[i]:b[i]; return r; }
+EMU int16x8_t vmovl_s8(int8x8_t a){ int16x8_t r; for(int i=0;i<8;i++) r[i]=a[i]; return r; }
+EMU int32x4_t vmovl_s16(int16x4_t a){ int32x4_t r; for(int i=0;i<4;i++) r[i]=a[i]; return r; }
+EMU int8x8_t vqmovn_s16(int16x8_t a){ int8x8_t r; for(int i=0;i<8;i++) r[i]= a[i]>127?127:a[i]<-128?-128:a[i]; return r; }
+EMU int16x8_t vextq_s16_f(int16x8_t a, int16x8_t b, int n){ int16x8_t r; for(int i=0;i<8;i++) r[i]= i+n<8 ? a[i+n] : b[i+n-8]; return r; }
+#define vextq_s16(a,b,n) vextq_s16_f(a,b,n)
+EMU int16x4_t vext_s16_f(int16x4_t a, int16x4_t b, int n){ int16x4_t r; for(int i=0;i<4;i++) r[i]= i+n<4 ? a[i+n] : b[i+n-4]; return r; }
+#define vext_s16(a,b,n) vext_s16_f(a,b,n)
+EMU int16x8_t vmull_s8(int8x8_t a, int8x8_t b){ int16x8_t r; for(int i=0;i<8;i++) r[i]=(int16_t)(a[i]*b[i]); return r; }
+EMU int32x4_t vpadalq_s16(int32x4_t a, int16x8_t b){ int32x4_t r; for(int i=0;i<4;i++) r[i]=(int32_t)((uint32_t)a[i]+(uint32_t)(b[2*i]+b[2*i+1])); return r; }
+EMU int16x4x2_t vzip_s16(int16x4_t a, int16x4_t b){ int16x4x2_t r; for(int i=0;i<2;i++){ r.val[0][2*i]=a[i]; r.val[0][2*i+1]=b[i]; r.val[1][2*i]=a[i+2]; r.val[1][2*i+1]=b[i+2]; } return r; }
+EMU int32x4_t vsubl_s16(int16x4_t a, int16x4_t b){ int32x4_t r; for(int i=0;i<4;i++) r[i]=(int32_t)a[i]-b[i]; return r; }
+EMU int32x4_t vmulq_n_s32(int32x4_t a, int32_t b){ int32x4_t r; for(int i=0;i<4;i++) r[i]=(int32_t)((uint32_t)a[i]*(uint32_t)b); return r; }
+EMU int32x4_t vrshrq_n_s32_f(int32x4_t a, int n){ int32x4_t r; for(int i=0;i<4;i++) r[i]=(int32_t)(((int64_t)a[i]+((int64_t)1<<(n-1)))>>n); return r; }
+#define vrshrq_n_s32(a,n) vrshrq_n_s32_f(a,n)
+EMU int16x8_t vrshrq_n_s16_f(int16x8_t a, int n){ int16x8_t r; for(int i=0;i<8;i++) r[i]=(int16_t)(((int32_t)a[i]+(1<<(n-1)))>>n); return r; }
+#define vrshrq_n_s16(a,n) vrshrq_n_s16_f(a,n)
+EMU int16x8_t vshrq_n_s16_f(int16x8_t a, int n){ int16x8_t r; for(int i=0;i<8;i++) r[i]=(int16_t)(a[i]>>n); return r; }
+#define vshrq_n_s16(a,n) vshrq_n_s16_f(a,n)
+EMU int16x8_t vqaddq_s16(int16x8_t a, int16x8_t b){ int16x8_t r; for(int i=0;i<8;i++){ int32_t v=(int32_t)a[i]+b[i]; r[i]= v>32767?32767:v<-32768?-32768:v; } return r; }
+EMU int8x16_t vcombine_s8(int8x8_t a, int8x8_t b){ int8x16_t r; for(int i=0;i<8;i++){ r[i]=a[i]; r[i+8]=b[i]; } return r; }
+EMU float32x4_t vcvtq_f32_s32(int32x4_t a){ float32x4_t r; for(int i=0;i<4;i++) r[i]=(float)a[i]; return r; }
+EMU float32x4_t vmulq_n_f32(float32x4_t a, float b){ float32x4_t r; for(int i=0;i<4;i++) r[i]=a[i]*b; return r; }
+EMU void vst1q_f32(float *p, float32x4_t v){ for(int i=0;i<4;i++) p[i]=v[i]; }
+EMU int16x8_t vminq_s16(int16x8_t a, int16x8_t b){ int16x8_t r; for(int i=0;i<8;i++) r[i]=a[i]<b[i]?a[i]:b[i]; return r; }
+EMU int8x16_t vminq_s8(int8x16_t a, int8x16_t b){ int8x16_t r; for(int i=0;i<16;i++) r[i]=a[i]<b[i]?a[i]:b[i]; return r; }
+EMU float32x4_t vdupq_n_f32(float x){ float32x4_t r={x,x,x,x}; return r; }
+EMU float32x4_t vld1q_f32(const float *p){ float32x4_t r; for(int i=0;i<4;i++) r[i]=p[i]; return r; }
+EMU float32x4_t vminq_f32(float32x4_t a, float32x4_t b){ float32x4_t r; for(int i=0;i<4;i++) r[i]=a[i]<b[i]?a[i]:b[i]; return r; }
+EMU float32x4_t vmaxq_f32(float32x4_t a, float32x4_t b){ float32x4_t r; for(int i=0;i<4;i++) r[i]=a[i]>b[i]?a[i]:b[i]; return r; }
+EMU int64x2_t vdupq_n_s64(int64_t x){ int64x2_t r={x,x}; return r; }
+EMU uint32x2_t vdup_n_u32(uint32_t x){ uint32x2_t r={x,x}; return r; }
+EMU uint16x4_t vdup_n_u16(uint16_t x){ uint16x4_t r={x,x,x,x}; return r; }
+EMU int8x8_t vdup_n_s8(int8_t x){ int8x8_t r; for(int i=0;i<8;i++) r[i]=x; return r; }
+EMU uint32x2_t vget_low_u32(uint32x4_t v){ uint32x2_t r={v[0],v[1]}; return r; }
+EMU uint32x2_t vget_high_u32(uint32x4_t v){ uint32x2_t r={v[2],v[3]}; return r; }
+EMU uint16x4_t vget_low_u16(uint16x8_t v){ uint16x4_t r={v[0],v[1],v[2],v[3]}; return r; }
+EMU uint16x4_t vget_high_u16(uint16x8_t v){ uint16x4_t r={v[4],v[5],v[6],v[7]}; return r; }
+EMU uint64x2_t vmull_u32(uint32x2_t a, uint32x2_t b){ uint64x2_t r={(uint64_t)a[0]*b[0],(uint64_t)a[1]*b[1]}; return r; }
+EMU uint64x2_t vshlq_u64(uint64x2_t a, int64x2_t s){ uint64x2_t r; for(int i=0;i<2;i++) r[i]= s[i]>=0 ? a[i]<<s[i] : a[i]>>(-s[i]); return r; }
+EMU uint32x2_t vmovn_u64(uint64x2_t a){ uint32x2_t r={(uint32_t)a[0],(uint32_t)a[1]}; return r; }
+EMU uint32x4_t vcombine_u32(uint32x2_t a, uint32x2_t b){ uint32x4_t r={a[0],a[1],b[0],b[1]}; return r; }
+EMU uint16x4_t vmovn_u32(uint32x4_t a){ uint16x4_t r; for(int i=0;i<4;i++) r[i]=(uint16_t)a[i]; return r; }
+EMU uint16x8_t vcombine_u16(uint16x4_t a, uint16x4_t b){ uint16x8_t r={a[0],a[1],a[2],a[3],b[0],b[1],b[2],b[3]}; return r; }
+EMU uint8x8_t vmovn_u16(uint16x8_t a){ uint8x8_t r; for(int i=0;i<8;i++) r[i]=(uint8_t)a[i]; return r; }
+EMU uint8x16_t vcombine_u8(uint8x8_t a, uint8x8_t b){ uint8x16_t r; for(int i=0;i<8;i++){ r[i]=a[i]; r[i+8]=b[i]; } return r; }
+EMU uint32x4_t vmovl_u16(uint16x4_t a){ uint32x4_t r; for(int i=0;i<4;i++) r[i]=a[i]; return r; }
+EMU uint32x4_t vmull_u16(uint16x4_t a, uint16x4_t b){ uint32x4_t r; for(int i=0;i<4;i++) r[i]=(uint32_t)a[i]*b[i]; return r; }
+EMU uint32x4_t vshlq_u32(uint32x4_t a, int32x4_t s){ uint32x4_t r; for(int i=0;i<4;i++) r[i]= s[i]>=0 ? a[i]<<s[i] : a[i]>>(-s[i]); return r; }
+EMU int16x8_t vsubq_s16(int16x8_t a, int16x8_t b){ int16x8_t r; for(int i=0;i<8;i++) r[i]=(int16_t)(a[i]-b[i]); return r; }
+EMU int16x8_t vsubl_s8(int8x8_t a, int8x8_t b){ int16x8_t r; for(int i=0;i<8;i++) r[i]=(int16_t)(a[i]-b[i]); return r; }
+EMU uint16x8_t vreinterpretq_u16_s16(int16x8_t a){ return (uint16x8_t)a; }
+EMU int16x8_t vreinterpretq_s16_u16(uint16x8_t a){ return (int16x8_t)a; }
+EMU int8x16_t vreinterpretq_s8_u8(uint8x16_t a){ return (int8x16_t)a; }
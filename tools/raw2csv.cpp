@@ -0,0 +1,165 @@
+/* raw2csv.cpp */
+
+// Offline converter from the binary raw-sample recordings (RawRecord.hpp) to the CSV layout
+// write_data_csv produces: one line per window, samples separated by commas, and a blank line before
+// each window listed in the gap table.
+//
+//   raw2csv data_ch1.bin [data_ch1.csv]
+//
+// Without an output path the CSV goes to stdout. Only needs the standard library and RawRecord.hpp,
+// so it builds on any host (make raw2csv).
+
+#include "RawRecord.hpp"
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static constexpr size_t OUT_BUFFER_SIZE = 1 << 20;
+
+template <typename T>
+static char *format_value(char *out, char *end, const uint8_t *src)
+{
+    T value;
+    std::memcpy(&value, src, sizeof(T));
+    if constexpr (std::is_floating_point_v<T>)
+        return std::to_chars(out, end, value, std::chars_format::fixed, 6).ptr;
+    else
+        return std::to_chars(out, end, static_cast<int>(value)).ptr;
+}
+
+template <typename T>
+static bool convert(const uint8_t *file, const raw_record_header_t &header, uint64_t windows, FILE *out)
+{
+    const uint8_t *data = file + header.header_size;
+    const uint32_t values_per_window = header.dim0 * header.dim1;
+    const uint64_t gap_entries = raw_record_gap_entries(header);
+    uint64_t gap = 0;
+
+    std::vector<char> buffer(OUT_BUFFER_SIZE);
+    char *begin = buffer.data();
+    char *end = begin + buffer.size();
+    char *pos = begin;
+
+    // Widest value is a float in fixed notation, keep room for a whole line and a gap mark before formatting it
+    const size_t max_line = values_per_window * 48 + 2;
+    if (max_line > buffer.size())
+    {
+        buffer.resize(max_line);
+        begin = buffer.data();
+        end = begin + buffer.size();
+        pos = begin;
+    }
+
+    for (uint64_t w = 0; w < windows; ++w)
+    {
+        if (static_cast<size_t>(end - pos) < max_line)
+        {
+            if (fwrite(begin, 1, pos - begin, out) != static_cast<size_t>(pos - begin))
+                return false;
+            pos = begin;
+        }
+
+        if (gap < gap_entries && raw_record_gap(file, gap).window == w)
+        {
+            *pos++ = '\n';
+            ++gap;
+        }
+        for (uint32_t k = 0; k < values_per_window; ++k)
+        {
+            pos = format_value<T>(pos, end, data);
+            data += sizeof(T);
+            *pos++ = (k + 1 < values_per_window) ? ',' : '\n';
+        }
+    }
+
+    return fwrite(begin, 1, pos - begin, out) == static_cast<size_t>(pos - begin);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2 || argc > 3)
+    {
+        fprintf(stderr, "Usage: %s <recording.bin> [output.csv]\n", argv[0]);
+        return 1;
+    }
+
+    int fd = open(argv[1], O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0)
+    {
+        fprintf(stderr, "Error opening %s\n", argv[1]);
+        return 1;
+    }
+    if (static_cast<size_t>(st.st_size) < sizeof(raw_record_header_t))
+    {
+        fprintf(stderr, "%s is too short for a raw recording\n", argv[1]);
+        return 1;
+    }
+
+    void *mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED)
+    {
+        fprintf(stderr, "mmap of %s failed\n", argv[1]);
+        return 1;
+    }
+    madvise(mapping, st.st_size, MADV_SEQUENTIAL);
+
+    raw_record_header_t header;
+    std::memcpy(&header, mapping, sizeof(header));
+    if (!raw_record_header_valid(header) || raw_record_sample_size(header.sample_type) != header.sample_size ||
+        static_cast<uint64_t>(st.st_size) < header.header_size)
+    {
+        fprintf(stderr, "%s is not a raw recording\n", argv[1]);
+        return 1;
+    }
+
+    const uint32_t values_per_window = header.dim0 * header.dim1;
+    const uint64_t window_bytes = static_cast<uint64_t>(values_per_window) * header.sample_size;
+    uint64_t windows = (st.st_size - header.header_size) / window_bytes;
+    if (header.window_count && header.window_count < windows)
+        windows = header.window_count;
+    if (!header.window_count)
+        fprintf(stderr, "Recording was not closed cleanly, converting the %llu complete windows found\n",
+                static_cast<unsigned long long>(windows));
+
+    FILE *out = argc == 3 ? fopen(argv[2], "w") : stdout;
+    if (!out)
+    {
+        fprintf(stderr, "Error opening %s\n", argv[2]);
+        return 1;
+    }
+
+    const uint8_t *file = static_cast<const uint8_t *>(mapping);
+    bool ok = false;
+    switch (header.sample_type)
+    {
+    case RAW_SAMPLE_INT8:
+        ok = convert<int8_t>(file, header, windows, out);
+        break;
+    case RAW_SAMPLE_INT16:
+        ok = convert<int16_t>(file, header, windows, out);
+        break;
+    case RAW_SAMPLE_FLOAT32:
+        ok = convert<float>(file, header, windows, out);
+        break;
+    }
+
+    if (out != stdout)
+        fclose(out);
+    munmap(mapping, st.st_size);
+    close(fd);
+
+    if (!ok)
+    {
+        fprintf(stderr, "Error writing CSV output\n");
+        return 1;
+    }
+    return 0;
+}